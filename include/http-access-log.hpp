@@ -0,0 +1,166 @@
+/*
+ * $Id: http-access-log.hpp,v 1.0.0 2026/10/18 17:28:40 Jaya Wikrama Exp $
+ *
+ * Copyright (c) 2024 Jaya Wikrama
+ * jayawikrama89@gmail.com
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *  claim that you wrote the original software. If you use this software
+ *  in a product, an acknowledgment in the product documentation would be
+ *  appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *  misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+/**
+ * @file
+ * @brief This file defines the HTTPAccessLog class, an asynchronous access logger.
+ *
+ * Every worker owns one single-producer single-consumer ring of fixed size binary records (timestamp, status
+ * code, bytes, latency and the offsets of the captured strings: client address, method, target, version and
+ * the selected header values). `log` only copies the strings into the next free record and publishes it, it
+ * never waits: a record is dropped and counted when the ring is full.
+ *
+ * A background thread drains the rings in batches, formats the records as Common Log Format, Combined Log
+ * Format or JSON lines and writes them with large buffered writes.
+ *
+ * Example:
+ * @code
+ * HTTPAccessLog accessLog("/var/log/app/access.log", HTTPAccessLog::COMBINED, workerCount);
+ * accessLog.log(workerIndex, request, HttpStatus::OK, bytesSent, latencyUs, peerAddress);
+ * @endcode
+ *
+ * @version 1.0.0
+ * @date 2026-10-18
+ * @author Jaya Wikrama
+ */
+
+#ifndef __HTTP_ACCESS_LOG_HPP__
+#define __HTTP_ACCESS_LOG_HPP__
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "http-header.hpp"
+
+#define HTTP_ACCESS_LOG_RING 4096
+#define HTTP_ACCESS_LOG_RECORD 512
+#define HTTP_ACCESS_LOG_MAX_FIELD 8
+#define HTTP_ACCESS_LOG_BUFFER (256 * 1024)
+#define HTTP_ACCESS_LOG_INTERVAL 50
+
+class HTTPAccessLog {
+  public:
+    typedef enum _format_t {
+      COMMON = 0,
+      COMBINED,
+      JSON
+    } format_t;
+
+    /**
+    * @brief Custom constructor.
+    *
+    * This method is responsible to open the log file (append mode), allocate one ring per worker and start the
+    * background thread. `HTTPAccessLog::COMBINED` always captures `Referer` and `User-Agent`, the other fields
+    * are written by `HTTPAccessLog::JSON` only.
+    * This method will throw an error if the file can not be opened.
+    *
+    * @param[in] path The log file path.
+    * @param[in] format The line format.
+    * @param[in] workers The number of workers (producers).
+    * @param[in] fields The header fields to capture (at most `HTTP_ACCESS_LOG_MAX_FIELD`).
+    * @param[in] ringSize The number of records per ring (rounded up to a power of two).
+    */
+    HTTPAccessLog(const std::string &path, HTTPAccessLog::format_t format, size_t workers, const std::vector<HeaderNode::headerField_t> &fields = {}, size_t ringSize = HTTP_ACCESS_LOG_RING);
+
+    /**
+    * @brief Destructor.
+    *
+    * This method is responsible to stop the background thread, write the remaining records and close the file.
+    */
+    ~HTTPAccessLog();
+
+    HTTPAccessLog(const HTTPAccessLog &) = delete;
+    HTTPAccessLog &operator=(const HTTPAccessLog &) = delete;
+
+    /**
+    * @brief Record one request.
+    *
+    * This method is responsible to copy the request data into the next free record of the worker ring. The
+    * strings are truncated to fit the record. Only the owner thread of the worker may call this method.
+    *
+    * @param[in] worker The worker index.
+    * @param[in] request The request header.
+    * @param[in] code The response status code.
+    * @param[in] bytes The number of body bytes sent.
+    * @param[in] latency The request latency in microseconds.
+    * @param[in] clientAddress The client address.
+    * @return `true` in success.
+    * @return `false` if the ring is full (the record is dropped and counted) or the worker index is invalid.
+    */
+    bool log(size_t worker, const HTTPHeader &request, HttpStatus::Code_t code, uint64_t bytes, uint32_t latency, std::string_view clientAddress);
+
+    /**
+    * @brief Gets the number of dropped records.
+    *
+    * @return The number of records dropped because their ring was full.
+    */
+    uint64_t getDropped() const;
+
+  private:
+    typedef struct _record_t {
+      uint64_t timestamp;
+      uint64_t bytes;
+      uint32_t latency;
+      uint16_t code;
+      uint16_t offset[4 + HTTP_ACCESS_LOG_MAX_FIELD];
+      uint16_t length[4 + HTTP_ACCESS_LOG_MAX_FIELD];
+      char data[HTTP_ACCESS_LOG_RECORD - 24 - 4 * (4 + HTTP_ACCESS_LOG_MAX_FIELD)];
+    } record_t;
+
+    typedef struct _ring_t {
+      alignas(64) std::atomic<uint64_t> head;
+      alignas(64) std::atomic<uint64_t> tail;
+      alignas(64) std::atomic<uint64_t> dropped;
+      std::unique_ptr<HTTPAccessLog::record_t[]> records;
+    } ring_t;
+
+    int fd;
+    HTTPAccessLog::format_t lineFormat;
+    std::vector<HeaderNode::headerField_t> fields;
+    std::vector<std::unique_ptr<HTTPAccessLog::ring_t>> rings;
+    size_t mask;
+    std::string buffer;
+    /* time prefix cache of the formatter, the integer fields of `struct tm` are at most 11 characters each */
+    time_t second;
+    char clf[96];
+    char iso[96];
+    bool stopping;
+    std::mutex lock;
+    std::condition_variable wakeup;
+    std::thread thread;
+
+    void run();
+    bool drain();
+    void append(const HTTPAccessLog::record_t &record);
+    void write();
+};
+
+#endif
@@ -0,0 +1,220 @@
+/*
+ * $Id: http-bundle.hpp,v 1.0.0 2026/10/18 19:21:47 Jaya Wikrama Exp $
+ *
+ * Copyright (c) 2024 Jaya Wikrama
+ * jayawikrama89@gmail.com
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *  claim that you wrote the original software. If you use this software
+ *  in a product, an acknowledgment in the product documentation would be
+ *  appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *  misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+/**
+ * @file
+ * @brief This file defines the HTTPBundle class, a memory mapped bundle of precompressed static assets.
+ *
+ * The bundle is built offline by `cwl-pack` (see `tools/cwl-pack.cpp`). For every asset it stores the identity,
+ * gzip and (if the packer was built with brotli) brotli variants, each with its pre-serialized response head
+ * (`Content-Type`, `ETag`, `Last-Modified`, `Content-Length`, `Content-Encoding`, `Vary`), and an open
+ * addressing hash index of the asset paths (CRC-32C, see `HTTPSimd::crc32c`).
+ *
+ * The bundle is mapped once, so the startup cost does not depend on the number of assets. Serving an asset is one
+ * hash lookup, the `Accept-Encoding` negotiation among the stored variants and one `writev` of the head and the
+ * body, both directly from the mapping.
+ *
+ * Example:
+ * @code
+ * HTTPBundle assets("/usr/share/app/assets.cwlb");
+ * const HTTPBundle::entry_t *asset = assets.find(request.getTarget());
+ * if (asset != nullptr){
+ *   HTTPBundle::encoding_t encoding = assets.select(asset, request);
+ *   bool head = (request.getMethod() == "HEAD");
+ *   ssize_t ret = assets.send(fd, asset, encoding, head, connection->offset);
+ *   if (ret >= 0) connection->offset += ret;
+ *   // wait for EPOLLOUT while connection->offset < assets.getLength(asset, encoding, head)
+ * }
+ * @endcode
+ *
+ * The file format uses the native byte order, a bundle is built on the architecture which serves it.
+ *
+ * @version 1.0.0
+ * @date 2026-10-18
+ * @author Jaya Wikrama
+ */
+
+#ifndef __HTTP_BUNDLE_HPP__
+#define __HTTP_BUNDLE_HPP__
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <sys/types.h>
+#include "http-header.hpp"
+
+#define HTTP_BUNDLE_MAGIC 0x424C5743U
+#define HTTP_BUNDLE_VERSION 1
+
+class HTTPBundle {
+  public:
+    typedef enum _encoding_t {
+      IDENTITY = 0,
+      GZIP,
+      BROTLI,
+      SZ_ENCODING
+    } encoding_t;
+
+    /**
+    * @brief The bundle header, at offset 0.
+    */
+    typedef struct _header_t {
+      uint32_t magic;
+      uint32_t version;
+      uint32_t count;
+      uint32_t slots;
+      uint64_t index;
+      uint64_t entries;
+      uint64_t size;
+    } header_t;
+
+    /**
+    * @brief One stored variant, `headLength` is `0` if the variant is not stored.
+    */
+    typedef struct _variant_t {
+      uint64_t head;
+      uint64_t body;
+      uint64_t bodyLength;
+      uint32_t headLength;
+      uint32_t reserved;
+    } variant_t;
+
+    /**
+    * @brief One asset, the index slots hold the entry number plus one (`0` is an empty slot).
+    */
+    typedef struct _entry_t {
+      uint64_t path;
+      uint32_t pathLength;
+      uint32_t hash;
+      HTTPBundle::variant_t variant[HTTPBundle::SZ_ENCODING];
+    } entry_t;
+
+    /**
+    * @brief Custom constructor.
+    *
+    * This method is responsible to map the bundle and validate its header.
+    * This method will throw an error if the bundle can not be opened or is malformed.
+    *
+    * @param[in] path The bundle path.
+    */
+    HTTPBundle(const std::string &path);
+
+    /**
+    * @brief Destructor.
+    *
+    * This method is responsible to unmap the bundle.
+    */
+    ~HTTPBundle();
+
+    HTTPBundle(const HTTPBundle &) = delete;
+    HTTPBundle &operator=(const HTTPBundle &) = delete;
+
+    /**
+    * @brief Find one asset.
+    *
+    * @param[in] path The asset path (e.g. `/css/site.css`, the query is ignored).
+    * @return The asset or `nullptr` if it is not in the bundle.
+    */
+    const HTTPBundle::entry_t *find(std::string_view path) const;
+
+    /**
+    * @brief Select the variant.
+    *
+    * This method is responsible to negotiate the `Accept-Encoding` of the request among the stored variants.
+    *
+    * @param[in] asset The asset.
+    * @param[in] request The request header.
+    * @return The selected encoding (`HTTPBundle::IDENTITY` if nothing else is acceptable).
+    */
+    HTTPBundle::encoding_t select(const HTTPBundle::entry_t *asset, const HTTPHeader &request) const;
+
+    /**
+    * @brief Gets the serialized response head of the variant.
+    *
+    * @param[in] asset The asset.
+    * @param[in] encoding The encoding.
+    * @return The head (status line, fields and the empty row) or an empty view if the variant is not stored.
+    */
+    std::string_view getHead(const HTTPBundle::entry_t *asset, HTTPBundle::encoding_t encoding) const;
+
+    /**
+    * @brief Gets the body of the variant.
+    *
+    * @param[in] asset The asset.
+    * @param[in] encoding The encoding.
+    * @return The body or an empty view if the variant is not stored.
+    */
+    std::string_view getBody(const HTTPBundle::entry_t *asset, HTTPBundle::encoding_t encoding) const;
+
+    /**
+    * @brief Gets the length of the response.
+    *
+    * @param[in] asset The asset.
+    * @param[in] encoding The encoding.
+    * @param[in] head `true` for the head only (`HEAD` request).
+    * @return The number of bytes of the head and the body or `0` if the variant is not stored.
+    */
+    size_t getLength(const HTTPBundle::entry_t *asset, HTTPBundle::encoding_t encoding, bool head = false) const;
+
+    /**
+    * @brief Send the variant.
+    *
+    * This method is responsible to write the head and the body from the offset with one `writev` (repeated until
+    * everything is written). On non-blocking socket, the caller adds the returned count to the offset and calls
+    * it again when the socket is writable, until the offset reaches `getLength`.
+    *
+    * @param[in] fd The socket file descriptor.
+    * @param[in] asset The asset.
+    * @param[in] encoding The encoding.
+    * @param[in] head `true` to send the head only (`HEAD` request).
+    * @param[in] offset The number of bytes of the response written by the previous calls.
+    * @return The number of bytes written by this call.
+    * @return `-1` on fail (see `errno`).
+    */
+    ssize_t send(int fd, const HTTPBundle::entry_t *asset, HTTPBundle::encoding_t encoding, bool head = false, size_t offset = 0) const;
+
+    /**
+    * @brief Gets the number of assets.
+    *
+    * @return The number of assets.
+    */
+    size_t size() const;
+
+    /**
+    * @brief Gets the name of the encoding.
+    *
+    * @param[in] encoding The encoding.
+    * @return The `Content-Encoding` token (`identity`, `gzip` or `br`).
+    */
+    static const char *getEncodingName(HTTPBundle::encoding_t encoding);
+
+  private:
+    const char *data;
+    size_t length;
+    const HTTPBundle::header_t *header;
+    const uint32_t *index;
+    const HTTPBundle::entry_t *entries;
+};
+
+#endif
@@ -0,0 +1,220 @@
+/*
+ * $Id: http-client.hpp,v 1.0.0 2026/10/18 16:41:55 Jaya Wikrama Exp $
+ *
+ * Copyright (c) 2024 Jaya Wikrama
+ * jayawikrama89@gmail.com
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *  claim that you wrote the original software. If you use this software
+ *  in a product, an acknowledgment in the product documentation would be
+ *  appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *  misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+/**
+ * @file
+ * @brief This file defines the HTTPClient class, a non-blocking HTTP/1.1 client with per-host connection pools.
+ *
+ * The requests are serialized with `HTTPHeader::serialize` and the responses are parsed with `HTTPHeader::parse`.
+ * Every host has a pool of keep-alive connections. A request takes an idle connection, opens a new one up to
+ * `HTTP_CLIENT_MAX_CONNECTION`, or, when the pool is full, is pipelined behind other idempotent requests up to
+ * `HTTP_CLIENT_MAX_PIPELINE`. Other requests wait for a free connection.
+ *
+ * The event loop integration is `getPollSet` (the descriptors and the events to wait for) and `process` (the
+ * returned events). The synchronous `request` runs the same code path on its own `poll` loop.
+ *
+ * A response body larger than `HTTP_CLIENT_MAX_BODY` or a malformed chunk fails the request and its connection.
+ *
+ * Example:
+ * @code
+ * HTTPClient client;
+ * HTTPHeader request, response;
+ * std::string body;
+ * request.setRequestLine("GET", "/status");
+ * if (client.request("127.0.0.1", 8080, request, "", response, body, 1000)) use(response, body);
+ * @endcode
+ *
+ * @version 1.0.0
+ * @date 2026-10-18
+ * @author Jaya Wikrama
+ */
+
+#ifndef __HTTP_CLIENT_HPP__
+#define __HTTP_CLIENT_HPP__
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <poll.h>
+#include <sys/socket.h>
+#include "http-header.hpp"
+
+#define HTTP_CLIENT_MAX_CONNECTION 8
+#define HTTP_CLIENT_MAX_PIPELINE 8
+#define HTTP_CLIENT_MAX_HEAD 16384
+#define HTTP_CLIENT_MAX_BODY 67108864
+
+class HTTPClient {
+  public:
+    /**
+    * @brief Response handler.
+    *
+    * The response is `nullptr` if the request failed. The response and the body are valid until the handler returns.
+    */
+    typedef void (*response_t)(HTTPClient &client, uint64_t id, HTTPHeader *response, const std::string &body, void *context);
+
+    /**
+    * @brief Default constructor for empty pools.
+    */
+    HTTPClient();
+
+    /**
+    * @brief Destructor.
+    *
+    * This method is responsible to close all connections. The handlers of unfinished requests are not called.
+    */
+    ~HTTPClient();
+
+    HTTPClient(const HTTPClient &) = delete;
+    HTTPClient &operator=(const HTTPClient &) = delete;
+
+    /**
+    * @brief Start one request.
+    *
+    * This method is responsible to serialize the request (`Host` and `Content-Length` are added if they are
+    * missing) and assign it to a connection of the host pool. The host name is resolved once per pool.
+    *
+    * @param[in] host The host name or address.
+    * @param[in] port The port.
+    * @param[in] request The request header (see `HTTPHeader::setRequestLine`).
+    * @param[in] body The request body.
+    * @param[in] handler The response handler.
+    * @param[in] context The handler context.
+    * @return The request identifier.
+    * @return `0` if the host can not be resolved or the request has no request line.
+    */
+    uint64_t send(const std::string &host, uint16_t port, HTTPHeader &request, const std::string &body, HTTPClient::response_t handler, void *context);
+
+    /**
+    * @brief Cancel one request.
+    *
+    * This method is responsible to detach the handler of the request. A request which is already written still
+    * reads its response to keep the connection in order.
+    *
+    * @param[in] id The request identifier.
+    */
+    void cancel(uint64_t id);
+
+    /**
+    * @brief Gets the descriptors to wait for.
+    *
+    * @param[out] fds The poll set.
+    * @param[in] max The capacity of the poll set.
+    * @return The number of descriptors written to the poll set.
+    */
+    size_t getPollSet(struct pollfd *fds, size_t max) const;
+
+    /**
+    * @brief Handle the returned events.
+    *
+    * This method is responsible to continue the connects, the writes and the reads of the ready descriptors and
+    * call the handlers of the complete responses.
+    *
+    * @param[in] fds The poll set with the returned events.
+    * @param[in] count The number of descriptors.
+    */
+    void process(const struct pollfd *fds, size_t count);
+
+    /**
+    * @brief Check the unfinished requests.
+    *
+    * @return `true` if some requests are waiting for the response.
+    */
+    bool isPending() const;
+
+    /**
+    * @brief Perform one request synchronously.
+    *
+    * This method is responsible to start the request and run the poll loop until the response is complete or
+    * the timeout expires.
+    *
+    * @param[in] host The host name or address.
+    * @param[in] port The port.
+    * @param[in] request The request header.
+    * @param[in] body The request body.
+    * @param[out] response The response header.
+    * @param[out] responseBody The response body.
+    * @param[in] timeout The timeout in milliseconds or `-1` to wait forever.
+    * @return `true` in success.
+    * @return `false` if the request failed or the timeout expired.
+    */
+    bool request(const std::string &host, uint16_t port, HTTPHeader &request, const std::string &body, HTTPHeader &response, std::string &responseBody, int timeout = -1);
+
+  private:
+    typedef enum _framing_t {
+      NONE = 0,
+      LENGTH,
+      CHUNKED,
+      UNTIL_CLOSE
+    } framing_t;
+
+    typedef struct _exchange_t {
+      uint64_t id;
+      std::string payload;
+      bool head;
+      bool idempotent;
+      int retry;
+      HTTPClient::response_t handler;
+      void *context;
+    } exchange_t;
+
+    typedef struct _connection_t {
+      int fd;
+      bool connecting;
+      std::string output;
+      size_t written;
+      std::deque<HTTPClient::exchange_t> inflight;
+      std::string input;
+      HTTPHeader response;
+      bool haveHead;
+      HTTPClient::framing_t framing;
+      uint64_t remaining;
+      std::string body;
+      bool closing;
+    } connection_t;
+
+    typedef struct _host_t {
+      struct sockaddr_storage address;
+      socklen_t addressLength;
+      std::vector<std::unique_ptr<HTTPClient::connection_t>> connections;
+      std::deque<HTTPClient::exchange_t> pending;
+    } host_t;
+
+    std::unordered_map<std::string, HTTPClient::host_t> hosts;
+    uint64_t nextId;
+
+    HTTPClient::host_t *resolve(const std::string &host, uint16_t port);
+    void dispatch(HTTPClient::host_t &host);
+    bool open(HTTPClient::host_t &host);
+    bool flush(HTTPClient::connection_t &connection);
+    bool receive(HTTPClient::connection_t &connection, bool &closed);
+    bool parse(HTTPClient::connection_t &connection, bool closed);
+    void finish(HTTPClient::connection_t &connection);
+    void fail(HTTPClient::host_t &host, HTTPClient::connection_t &connection);
+};
+
+#endif
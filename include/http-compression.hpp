@@ -0,0 +1,211 @@
+/*
+ * $Id: http-compression.hpp,v 1.0.0 2026/10/18 10:47:03 Jaya Wikrama Exp $
+ *
+ * Copyright (c) 2024 Jaya Wikrama
+ * jayawikrama89@gmail.com
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *  claim that you wrote the original software. If you use this software
+ *  in a product, an acknowledgment in the product documentation would be
+ *  appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *  misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+/**
+ * @file
+ * @brief This file defines the HTTPCompressor class (streaming gzip/deflate `Content-Encoding`) and the
+ *        HTTPCompressionCache class (compressed variants of static and templated responses).
+ *
+ * The zlib stream of each encoding is allocated once per thread and reused (`deflateReset`) by every
+ * HTTPCompressor created on that thread.
+ *
+ * @version 1.0.0
+ * @date 2026-10-18
+ * @author Jaya Wikrama
+ */
+
+#ifndef __HTTP_COMPRESSION_HPP__
+#define __HTTP_COMPRESSION_HPP__
+
+#include <string>
+#include <string_view>
+#include <memory>
+#include <mutex>
+#include <list>
+#include <unordered_map>
+#include "http-header.hpp"
+
+#define HTTP_COMPRESSION_MIN_LENGTH 1024
+
+class HTTPCompressor {
+  public:
+    typedef enum _encoding_t {
+      ENCODING_IDENTITY = 0,
+      ENCODING_GZIP,
+      ENCODING_DEFLATE
+    } encoding_t;
+
+    /**
+    * @brief Custom constructor for content encoding.
+    *
+    * This method is responsible for create new compressor which borrows the per-thread zlib stream of the encoding.
+    * A private stream is allocated only if the per-thread stream is already used by another compressor.
+    * This method will throw an error if the zlib stream can not be initialized.
+    */
+    HTTPCompressor(HTTPCompressor::encoding_t encoding, int level = -1);
+
+    HTTPCompressor(const HTTPCompressor &) = delete;
+    HTTPCompressor &operator=(const HTTPCompressor &) = delete;
+
+    /**
+    * @brief Compressor destructor.
+    *
+    * Return the zlib stream to the per-thread context.
+    */
+    ~HTTPCompressor();
+
+    /**
+    * @brief Compress one chunk of the body.
+    *
+    * This method is responsible to compress the input and append the available compressed data to the output.
+    *
+    * @return `true` in success.
+    * @return `false` on fail.
+    */
+    bool compress(const char *data, size_t length, std::string &output);
+
+    /**
+    * @brief Flush the pending compressed data.
+    *
+    * This method is responsible to append all pending compressed data to the output (`Z_SYNC_FLUSH`), so the
+    * client can decode everything sent so far (e.g. for streaming responses).
+    *
+    * @return `true` in success.
+    * @return `false` on fail.
+    */
+    bool flush(std::string &output);
+
+    /**
+    * @brief Finish the compressed stream.
+    *
+    * This method is responsible to append the remaining compressed data and the stream trailer to the output.
+    * The compressor can be used for the next body after this call.
+    *
+    * @return `true` in success.
+    * @return `false` on fail.
+    */
+    bool finish(std::string &output);
+
+    /**
+    * @brief Gets the content encoding.
+    *
+    * @return The content encoding.
+    */
+    HTTPCompressor::encoding_t getEncoding() const;
+
+    /**
+    * @brief Gets the content encoding name.
+    *
+    * @return The `Content-Encoding` value.
+    */
+    static const char *getEncodingName(HTTPCompressor::encoding_t encoding);
+
+    /**
+    * @brief Check if the content is worth to compress.
+    *
+    * This method is responsible to reject small content and content types which are already compressed
+    * (images, audio, video, archives and fonts).
+    *
+    * @return `true` if the content is compressible.
+    * @return `false` if the content should be sent as is.
+    */
+    static bool isCompressible(std::string_view contentType, size_t length);
+
+    /**
+    * @brief Select the content encoding of the response.
+    *
+    * This method is responsible to negotiate the content encoding with the `Accept-Encoding` node of the request.
+    * For compressible responses, `Accept-Encoding` is merged into the `Vary` row of the response and
+    * `Content-Encoding` is appended if the selected encoding is not `identity`. The response `Content-Length`
+    * (if any) must be appended by the caller after the body is compressed.
+    *
+    * @param[in] request The request HTTP Header.
+    * @param[in,out] response The response HTTP Header (must already contain `Content-Type`).
+    * @param[in] length The length of the uncompressed body.
+    * @return The selected content encoding.
+    */
+    static HTTPCompressor::encoding_t prepare(const HTTPHeader &request, HTTPHeader &response, size_t length);
+
+  private:
+    encoding_t encoding;
+    void *stream;
+    bool borrowed;
+
+    bool process(const char *data, size_t length, int flush, std::string &output);
+};
+
+class HTTPCompressionCache {
+  public:
+    /**
+    * @brief Custom constructor for cache budget.
+    *
+    * This method is responsible for create new compressed variant cache limited to `budget` bytes of compressed data
+    * (the key and version of every variant are counted too, so bodies which are sent as is also take their share).
+    */
+    HTTPCompressionCache(size_t budget);
+
+    /**
+    * @brief Gets the compressed variant.
+    *
+    * This method is responsible to return the compressed variant of the body. The body is compressed only once
+    * for each key, version and encoding, the cached variant is replaced if the version of the same key changes.
+    * The body is not inspected on a hit, so the version must change whenever the body changes.
+    *
+    * @param[in] key The resource key (e.g. the target path).
+    * @param[in] version The version of the body (e.g. its `ETag` or modification time).
+    * @param[in] contentType The content type of the body.
+    * @param[in] body The uncompressed body.
+    * @param[in] encoding The content encoding.
+    * @return The compressed variant.
+    * @return `nullptr` if the body should be sent as is (too small, not compressible or not smaller after compression).
+    */
+    std::shared_ptr<const std::string> get(std::string_view key, std::string_view version, std::string_view contentType, std::string_view body, HTTPCompressor::encoding_t encoding);
+
+    /**
+    * @brief Remove all variants.
+    */
+    void clear();
+
+    /**
+    * @brief Gets the total size of the cached variants.
+    *
+    * @return The total size in bytes (compressed data, keys and versions).
+    */
+    size_t getSize();
+
+  private:
+    typedef struct _variant_t {
+      std::string key;
+      std::string version;
+      size_t sourceLength;
+      std::shared_ptr<const std::string> data;
+    } variant_t;
+
+    std::mutex mutex;
+    size_t budget;
+    size_t size;
+    std::list<variant_t> variants;
+    std::unordered_map<std::string_view, std::list<variant_t>::iterator> index;
+};
+
+#endif
@@ -0,0 +1,225 @@
+/*
+ * $Id: http-cookie.hpp,v 1.0.0 2026/10/18 09:12:40 Jaya Wikrama Exp $
+ *
+ * Copyright (c) 2024 Jaya Wikrama
+ * jayawikrama89@gmail.com
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *  claim that you wrote the original software. If you use this software
+ *  in a product, an acknowledgment in the product documentation would be
+ *  appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *  misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+/**
+ * @file
+ * @brief This file defines the HTTPCookie class (read-only view of the `Cookie` request header) and
+ *        the HTTPSetCookie class (builder for the `Set-Cookie` response header).
+ *
+ * HTTPCookie never copies the header value. Name/value pairs are split on demand into `std::string_view`
+ * that point into the original header value, so the header (or the HTTPHeader that owns it) must outlive
+ * the view.
+ *
+ * @version 1.0.0
+ * @date 2026-10-18
+ * @author Jaya Wikrama
+ */
+
+#ifndef __HTTP_COOKIE_HPP__
+#define __HTTP_COOKIE_HPP__
+
+#include <string>
+#include <string_view>
+#include <ctime>
+#include "http-header.hpp"
+
+#define HTTP_COOKIE_INDEX_SIZE 16
+
+class HTTPCookie {
+  public:
+    typedef struct _cookie_t {
+      std::string_view name;
+      std::string_view value;
+    } cookie_t;
+
+    /**
+    * @brief Default constructor for empty cookie list.
+    *
+    * This method is responsible for create blank cookie view.
+    */
+    HTTPCookie();
+
+    /**
+    * @brief Custom constructor for raw `Cookie` header value.
+    *
+    * This method is responsible for create cookie view over the raw header value (without copying it).
+    */
+    HTTPCookie(std::string_view cookieHeader);
+
+    /**
+    * @brief Overloaded custom constructor for raw `Cookie` header value.
+    *
+    * This method is responsible for create cookie view over the raw header value (without copying it).
+    */
+    HTTPCookie(const char *cookieHeader);
+
+    /**
+    * @brief Custom constructor for HTTP Header.
+    *
+    * This method is responsible for create cookie view over the `Cookie` node of the HTTP Header.
+    * The view is empty if the HTTP Header has no `Cookie` node.
+    */
+    HTTPCookie(const HTTPHeader &header);
+
+    /**
+    * @brief Gets the next cookie.
+    *
+    * This method is responsible for tokenizing the cookie header one name/value pair at a time.
+    * Pairs without `=` or with an empty name are skipped.
+    * Start with `pos` = 0 and call repeatedly until it returns `false`.
+    *
+    * @param[in,out] pos The scan position inside the raw header value.
+    * @param[out] cookie The next cookie name and value.
+    * @return `true` if one cookie was found.
+    * @return `false` when there are no more cookies.
+    */
+    bool next(size_t &pos, HTTPCookie::cookie_t &cookie) const;
+
+    /**
+    * @brief Gets the value of a single cookie by name.
+    *
+    * This method is responsible for searching one cookie. The scan stops at the first match, and every
+    * pair scanned on the way is kept in a small index so the following lookups never rescan the
+    * same part of the header.
+    *
+    * @param[in] name The cookie name.
+    * @param[out] value The cookie value (view into the raw header value).
+    * @return `true` if the cookie is available.
+    * @return `false` if the cookie is not available.
+    */
+    bool get(std::string_view name, std::string_view &value);
+
+    /**
+    * @brief Overloading of `get` method.
+    *
+    * This method is responsible for searching one cookie.
+    *
+    * @param[in] name The cookie name.
+    * @return The cookie value or empty view if the cookie is not available.
+    */
+    std::string_view get(std::string_view name);
+
+    /**
+    * @brief Check the cookie availability.
+    *
+    * This method is responsible for checking the cookie availability by name.
+    *
+    * @param[in] name The cookie name.
+    * @return `true` if the cookie is available.
+    * @return `false` if the cookie is not available.
+    */
+    bool has(std::string_view name);
+
+    /**
+    * @brief Gets the raw `Cookie` header value.
+    *
+    * @return The raw header value.
+    */
+    std::string_view getRaw() const;
+
+  private:
+    std::string_view raw;
+    size_t scanned;
+    size_t indexed;
+    HTTPCookie::cookie_t index[HTTP_COOKIE_INDEX_SIZE];
+};
+
+class HTTPSetCookie {
+  public:
+    typedef enum _sameSite_t {
+      SAME_SITE_UNSET,
+      SAME_SITE_STRICT,
+      SAME_SITE_LAX,
+      SAME_SITE_NONE
+    } sameSite_t;
+
+    /**
+    * @brief Custom constructor for cookie name and value.
+    *
+    * This method is responsible for create new `Set-Cookie` builder. The builder keeps views of the
+    * input, so every string passed to it must outlive the call to `serialize`.
+    */
+    HTTPSetCookie(std::string_view name, std::string_view value);
+
+    /**
+    * @brief Set the `Path` attribute.
+    */
+    void setPath(std::string_view path);
+
+    /**
+    * @brief Set the `Domain` attribute.
+    */
+    void setDomain(std::string_view domain);
+
+    /**
+    * @brief Set the `Max-Age` attribute (in seconds). Negative value removes the attribute.
+    */
+    void setMaxAge(long maxAge);
+
+    /**
+    * @brief Set the `Expires` attribute (unix epoch). Zero removes the attribute.
+    */
+    void setExpires(time_t expires);
+
+    /**
+    * @brief Set the `Secure` attribute.
+    */
+    void setSecure(bool secure);
+
+    /**
+    * @brief Set the `HttpOnly` attribute.
+    */
+    void setHttpOnly(bool httpOnly);
+
+    /**
+    * @brief Set the `SameSite` attribute.
+    */
+    void setSameSite(HTTPSetCookie::sameSite_t sameSite);
+
+    /**
+    * @brief Write the `Set-Cookie` row to the response payload.
+    *
+    * This method is responsible to append one complete `Set-Cookie` header row (terminated by CRLF)
+    * straight into the payload buffer used by `HTTPHeader::serialize`. Nothing is appended if the name is not
+    * a token, the value has a byte which is not a `cookie-octet` or the path or the domain has a control byte
+    * or `;` (RFC 6265 section 4.1.1), so no input can inject another attribute or header row.
+    *
+    * @param[in,out] payload The response payload buffer.
+    * @return `true` in success.
+    * @return `false` if the cookie is not valid.
+    */
+    bool serialize(std::string &payload) const;
+
+  private:
+    std::string_view name;
+    std::string_view value;
+    std::string_view path;
+    std::string_view domain;
+    long maxAge;
+    time_t expires;
+    bool secure;
+    bool httpOnly;
+    sameSite_t sameSite;
+};
+
+#endif
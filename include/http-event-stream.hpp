@@ -0,0 +1,334 @@
+/*
+ * $Id: http-event-stream.hpp,v 1.0.0 2026/10/18 18:36:02 Jaya Wikrama Exp $
+ *
+ * Copyright (c) 2024 Jaya Wikrama
+ * jayawikrama89@gmail.com
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *  claim that you wrote the original software. If you use this software
+ *  in a product, an acknowledgment in the product documentation would be
+ *  appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *  misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+/**
+ * @file
+ * @brief This file defines the HTTPEventStream, HTTPEventHub and HTTPEventChannel classes, the Server-Sent Events
+ *        (`text/event-stream`) streaming responses.
+ *
+ * An `HTTPEventStream` turns one connection into an event stream: the head is queued once when the stream is
+ * attached to the hub of its reactor, then every event is formatted directly into the write buffer of the
+ * connection pipeline (see `HTTPPipeline::getBuffer`). Nothing is written by `send`, the hub flushes every
+ * stream with new data once per event loop iteration, so a burst of events costs one `writev`. A stream which
+ * still has data after the flush (the socket buffer is full) is listed by `HTTPEventHub::getPending`, the caller
+ * waits for `EPOLLOUT` and continues with `HTTPEventStream::flush`. A stream which queues more than its high-water
+ * mark (a client which does not read) is closed, the client reconnects with `Last-Event-ID`.
+ *
+ * An `HTTPEventChannel` formats a broadcast event once and queues the same shared buffer to every subscriber.
+ * The idle streams are kept alive with a comment ping scheduled on the reactor timer wheel
+ * (`HTTPTimer::EVENT_PING`), a stream which sent an event since the last ping is not pinged.
+ *
+ * Example:
+ * @code
+ * HTTPEventHub hub(wheel);
+ * HTTPEventChannel prices;
+ * connection->stream.reset(new HTTPEventStream(connection->pipeline, connection->fd));
+ * hub.attach(*connection->stream);
+ * prices.subscribe(*connection->stream);
+ * for (;;){
+ *   int n = epoll_wait(epfd, events, 64, wheel.getTimeout(HTTPTimerWheel::now()));
+ *   ...
+ *   prices.publish(quote, "price");
+ *   wheel.advance(HTTPTimerWheel::now(), onTimeout, &hub);
+ *   hub.flush();
+ *   for (HTTPEventStream *stream : hub.getPending()) armWritable(stream);
+ * }
+ * @endcode
+ *
+ * The classes are not thread safe, each reactor owns its hub, its channels and its streams. An event published
+ * to the channels of several reactors should be formatted once (`HTTPEventStream::format`) and published as a
+ * shared buffer.
+ *
+ * @version 1.0.0
+ * @date 2026-10-18
+ * @author Jaya Wikrama
+ */
+
+#ifndef __HTTP_EVENT_STREAM_HPP__
+#define __HTTP_EVENT_STREAM_HPP__
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "http-pipeline.hpp"
+#include "http-timer-wheel.hpp"
+
+#define HTTP_EVENT_STREAM_HIGH_WATER (1024 * 1024)
+
+class HTTPEventHub;
+class HTTPEventChannel;
+
+class HTTPEventStream {
+  public:
+    /**
+    * @brief Custom constructor.
+    *
+    * @param[in] pipeline The pipeline of the connection, the events are queued to its write buffer.
+    * @param[in] fd The socket file descriptor.
+    * @param[in] highWater The maximum number of queued bytes, the stream is closed if an event is sent above it.
+    */
+    HTTPEventStream(HTTPPipeline &pipeline, int fd, size_t highWater = HTTP_EVENT_STREAM_HIGH_WATER);
+
+    /**
+    * @brief Destructor.
+    *
+    * This method is responsible to detach the stream from the hub and unsubscribe it from every channel.
+    */
+    ~HTTPEventStream();
+
+    HTTPEventStream(const HTTPEventStream &) = delete;
+    HTTPEventStream &operator=(const HTTPEventStream &) = delete;
+
+    /**
+    * @brief Send one event.
+    *
+    * This method is responsible to format the event into the write buffer, it is written by the next
+    * `HTTPEventHub::flush`.
+    *
+    * @param[in] data The event data (a multi-line data is sent as several `data` fields).
+    * @param[in] event The event type or empty for the default `message` type.
+    * @param[in] id The event identifier or empty.
+    */
+    void send(std::string_view data, std::string_view event = std::string_view(), std::string_view id = std::string_view());
+
+    /**
+    * @brief Send one formatted event.
+    *
+    * This method is responsible to queue the shared event (see `format`) without copying it.
+    *
+    * @param[in] event The formatted event.
+    */
+    void send(std::shared_ptr<const std::string> event);
+
+    /**
+    * @brief Write the queued events.
+    *
+    * This method is responsible to write the pending data, e.g. when the socket is writable again after
+    * `HTTPEventHub::flush` left some data queued.
+    *
+    * @return The number of bytes written.
+    * @return `-1` on fail (the stream is closed).
+    */
+    ssize_t flush();
+
+    /**
+    * @brief Check the stream state.
+    *
+    * @return `true` if a write failed or the high-water mark was exceeded, the connection should be closed.
+    */
+    bool isClosed() const;
+
+    /**
+    * @brief Check the queued data.
+    *
+    * @return `true` if some data is not written yet, the caller should wait until the socket is writable.
+    */
+    bool isPending() const;
+
+    /**
+    * @brief Gets the number of queued bytes.
+    *
+    * @return The number of bytes queued by the stream and not written yet.
+    */
+    size_t getQueued() const;
+
+    /**
+    * @brief Format one event.
+    *
+    * @param[out] output The formatted event is appended here.
+    * @param[in] data The event data.
+    * @param[in] event The event type or empty.
+    * @param[in] id The event identifier or empty.
+    */
+    static void format(std::string &output, std::string_view data, std::string_view event = std::string_view(), std::string_view id = std::string_view());
+
+    /**
+    * @brief Gets the response head.
+    *
+    * @return The serialized `200 OK` head of the event stream (without `Content-Length`).
+    */
+    static std::string_view getHead();
+
+  private:
+    friend class HTTPEventHub;
+    friend class HTTPEventChannel;
+
+    HTTPPipeline *pipeline;
+    int fd;
+    HTTPEventHub *hub;
+    size_t slot;
+    HTTPTimer timer;
+    size_t queued;
+    size_t highWater;
+    bool dirty;
+    bool blocked;
+    bool active;
+    bool closed;
+    std::vector<HTTPEventChannel *> channels;
+
+    bool reserve();
+    void touch();
+};
+
+class HTTPEventHub {
+  public:
+    /**
+    * @brief Custom constructor.
+    *
+    * @param[in] wheel The timer wheel of the reactor (the ping interval is the `HTTPTimer::EVENT_PING` timeout).
+    */
+    HTTPEventHub(HTTPTimerWheel &wheel);
+
+    /**
+    * @brief Destructor.
+    *
+    * This method is responsible to detach all streams.
+    */
+    ~HTTPEventHub();
+
+    HTTPEventHub(const HTTPEventHub &) = delete;
+    HTTPEventHub &operator=(const HTTPEventHub &) = delete;
+
+    /**
+    * @brief Attach one stream.
+    *
+    * This method is responsible to queue the response head and schedule the ping of the stream.
+    *
+    * @param[in] stream The stream.
+    */
+    void attach(HTTPEventStream &stream);
+
+    /**
+    * @brief Detach one stream.
+    *
+    * @param[in] stream The stream.
+    */
+    void detach(HTTPEventStream &stream);
+
+    /**
+    * @brief Write the streams.
+    *
+    * This method is responsible to write every stream which has new data since the last call, it should be
+    * called once per event loop iteration. The streams which still have data are listed by `getPending`.
+    *
+    * @return The number of streams which failed or exceeded the high-water mark (they are closed, see
+    * `HTTPEventStream::isClosed`).
+    */
+    size_t flush();
+
+    /**
+    * @brief Gets the blocked streams.
+    *
+    * This method is responsible to return the streams which still had data after the last `flush`, the caller
+    * should arm `EPOLLOUT` for them and call `HTTPEventStream::flush` when the socket is writable. The list is
+    * valid until the next `flush`.
+    *
+    * @return The blocked streams.
+    */
+    const std::vector<HTTPEventStream *> &getPending() const;
+
+    /**
+    * @brief Handle one expired ping timer.
+    *
+    * This method is responsible to queue a comment ping if the stream was idle since the last ping and schedule
+    * the next ping. It should be called by the expired handler of the wheel for the `HTTPTimer::EVENT_PING` timers.
+    *
+    * @param[in] timer The expired timer.
+    */
+    void expire(HTTPTimer &timer);
+
+  private:
+    friend class HTTPEventStream;
+
+    HTTPTimerWheel &wheel;
+    std::vector<HTTPEventStream *> streams;
+    std::vector<HTTPEventStream *> ready;
+    std::vector<HTTPEventStream *> pending;
+};
+
+class HTTPEventChannel {
+  public:
+    /**
+    * @brief Default constructor for empty channel.
+    */
+    HTTPEventChannel();
+
+    /**
+    * @brief Destructor.
+    *
+    * This method is responsible to unsubscribe all streams.
+    */
+    ~HTTPEventChannel();
+
+    HTTPEventChannel(const HTTPEventChannel &) = delete;
+    HTTPEventChannel &operator=(const HTTPEventChannel &) = delete;
+
+    /**
+    * @brief Subscribe one stream.
+    *
+    * @param[in] stream The stream.
+    */
+    void subscribe(HTTPEventStream &stream);
+
+    /**
+    * @brief Unsubscribe one stream.
+    *
+    * @param[in] stream The stream.
+    */
+    void unsubscribe(HTTPEventStream &stream);
+
+    /**
+    * @brief Publish one event.
+    *
+    * This method is responsible to format the event once and queue the shared buffer to every subscriber.
+    *
+    * @param[in] data The event data.
+    * @param[in] event The event type or empty.
+    * @param[in] id The event identifier or empty.
+    * @return The number of subscribers.
+    */
+    size_t publish(std::string_view data, std::string_view event = std::string_view(), std::string_view id = std::string_view());
+
+    /**
+    * @brief Publish one formatted event.
+    *
+    * @param[in] event The formatted event (see `HTTPEventStream::format`).
+    * @return The number of subscribers.
+    */
+    size_t publish(std::shared_ptr<const std::string> event);
+
+    /**
+    * @brief Gets the number of subscribers.
+    *
+    * @return The number of subscribers.
+    */
+    size_t size() const;
+
+  private:
+    std::vector<HTTPEventStream *> subscribers;
+};
+
+#endif
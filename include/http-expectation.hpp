@@ -0,0 +1,133 @@
+/*
+ * $Id: http-expectation.hpp,v 1.0.0 2026/10/18 18:14:37 Jaya Wikrama Exp $
+ *
+ * Copyright (c) 2024 Jaya Wikrama
+ * jayawikrama89@gmail.com
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *  claim that you wrote the original software. If you use this software
+ *  in a product, an acknowledgment in the product documentation would be
+ *  appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *  misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+/**
+ * @file
+ * @brief This file defines the HTTPExpectation class, the header-only admission of a request body.
+ *
+ * `evaluate` runs right after the request head is parsed (see `HTTPPipeline::parse`, which stops before the
+ * body): the `Content-Length` limit and the registered checks (authentication, rate limiting, routing) decide
+ * if the body is wanted. A client which sent `Expect: 100-continue` waits for the interim response before it
+ * transfers the body, so a refused upload is never transferred.
+ *
+ * The interim `100 Continue` and the `413 Payload Too Large` / `417 Expectation Failed` rejections are
+ * precompiled. The rejections close the connection, because the client may send the body anyway.
+ *
+ * Example:
+ * @code
+ * HTTPExpectation expectation(8 * 1024 * 1024);
+ * expectation.addCheck(authenticate, &users);
+ * HttpStatus::Code_t code = expectation.evaluate(request);
+ * std::string_view response = HTTPExpectation::getResponse(code);
+ * if (code == HttpStatus::CONTINUE) write(fd, response.data(), response.size());
+ * if (code == HttpStatus::CONTINUE || code == HttpStatus::OK) readBody(fd);
+ * else reject(fd, code, response);
+ * @endcode
+ *
+ * @version 1.0.0
+ * @date 2026-10-18
+ * @author Jaya Wikrama
+ */
+
+#ifndef __HTTP_EXPECTATION_HPP__
+#define __HTTP_EXPECTATION_HPP__
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include "http-header.hpp"
+
+#define HTTP_EXPECTATION_MAX_BODY (16 * 1024 * 1024)
+
+class HTTPExpectation {
+  public:
+    /**
+    * @brief Header-only check.
+    *
+    * The check returns `HttpStatus::OK` to accept the request or the status code of the rejection.
+    */
+    typedef HttpStatus::Code_t (*check_t)(const HTTPHeader &request, void *context);
+
+    /**
+    * @brief Custom constructor.
+    *
+    * @param[in] maxBody The largest accepted `Content-Length`.
+    */
+    HTTPExpectation(uint64_t maxBody = HTTP_EXPECTATION_MAX_BODY);
+
+    /**
+    * @brief Add one header-only check.
+    *
+    * This method is responsible to register one check, the checks run in the registration order and the
+    * first rejection wins.
+    *
+    * @param[in] check The check.
+    * @param[in] context The check context.
+    */
+    void addCheck(HTTPExpectation::check_t check, void *context);
+
+    /**
+    * @brief Evaluate the request head.
+    *
+    * This method is responsible to validate the expectation (only `100-continue` is supported, it is ignored
+    * for HTTP/1.0), compare the `Content-Length` with the limit and run the checks, before the body is read.
+    *
+    * @param[in] request The request header.
+    * @return `HttpStatus::CONTINUE` if the client waits for `100 Continue` and the body is accepted.
+    * @return `HttpStatus::OK` if the body (if any) is accepted and no interim response is expected.
+    * @return `HttpStatus::EXPECTATION_FAILED` if the expectation is not supported.
+    * @return `HttpStatus::BAD_REQUEST` if the `Content-Length` is malformed.
+    * @return `HttpStatus::PAYLOAD_TOO_LARGE` if the `Content-Length` exceeds the limit.
+    * @return The status code returned by the first rejecting check.
+    */
+    HttpStatus::Code_t evaluate(const HTTPHeader &request) const;
+
+    /**
+    * @brief Check the expectation of the request.
+    *
+    * @param[in] request The request header.
+    * @return `true` if the request has `Expect: 100-continue` and the client waits for the interim response.
+    */
+    static bool isExpectingContinue(const HTTPHeader &request);
+
+    /**
+    * @brief Gets the precompiled response.
+    *
+    * @param[in] code `HttpStatus::CONTINUE`, `HttpStatus::EXPECTATION_FAILED`, `HttpStatus::BAD_REQUEST` or
+    * `HttpStatus::PAYLOAD_TOO_LARGE`.
+    * @return The serialized response or an empty view for the other status codes.
+    */
+    static std::string_view getResponse(HttpStatus::Code_t code);
+
+  private:
+    typedef struct _entry_t {
+      HTTPExpectation::check_t check;
+      void *context;
+    } entry_t;
+
+    uint64_t maxBody;
+    std::vector<HTTPExpectation::entry_t> checks;
+};
+
+#endif
@@ -0,0 +1,234 @@
+/*
+ * $Id: http-handover.hpp,v 1.0.0 2026/10/18 18:58:24 Jaya Wikrama Exp $
+ *
+ * Copyright (c) 2024 Jaya Wikrama
+ * jayawikrama89@gmail.com
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *  claim that you wrote the original software. If you use this software
+ *  in a product, an acknowledgment in the product documentation would be
+ *  appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *  misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+/**
+ * @file
+ * @brief This file defines the HTTPHandover class, the zero-downtime restart by handing over the listening sockets.
+ *
+ * The running (old) process serves a Unix control socket. The new process connects to it and receives the
+ * listening sockets (`SCM_RIGHTS`), so the kernel keeps accepting connections on the same sockets during the
+ * restart. The old process keeps accepting while the new process warms up (the registered warm-up callbacks:
+ * static response templates, caches), then the new process sends `READY` and the old process stops accepting
+ * and drains its keep-alive connections (`Connection: close` on the remaining responses) until the deadline.
+ * If the new process dies before it is ready, or does not report ready in time, the old process simply continues
+ * to serve. Only a process of the same effective user may connect (`SO_PEERCRED`) and the control socket file is
+ * created with mode 0600.
+ *
+ * Example (old process):
+ * @code
+ * HTTPHandover handover("/run/app/handover.sock");
+ * handover.serve(listeners);
+ * // in the event loop, when handover.getFd() is readable:
+ * if (handover.process(30000) == HTTPHandover::DRAINING) stopAccepting();
+ * // for every response: handover.prepare(response);
+ * // on every timer tick:
+ * handover.check(HTTPTimerWheel::now());
+ * if (handover.isExpired(HTTPTimerWheel::now())) exit(0);
+ * @endcode
+ *
+ * Example (new process):
+ * @code
+ * HTTPHandover handover("/run/app/handover.sock");
+ * std::vector<int> listeners;
+ * if (!handover.connect(listeners, 5000)) listeners = openListeners();
+ * handover.addWarmup(loadTemplates, &templates);
+ * handover.ready();
+ * handover.serve(listeners);
+ * @endcode
+ *
+ * A path starting with `@` is an abstract socket name (Linux), so no file is left behind.
+ *
+ * @version 1.0.0
+ * @date 2026-10-18
+ * @author Jaya Wikrama
+ */
+
+#ifndef __HTTP_HANDOVER_HPP__
+#define __HTTP_HANDOVER_HPP__
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <sys/types.h>
+#include "http-header.hpp"
+
+#define HTTP_HANDOVER_MAX_FD 16
+#define HTTP_HANDOVER_DRAIN_TIMEOUT 30000
+#define HTTP_HANDOVER_READY_TIMEOUT 60000
+
+class HTTPHandover {
+  public:
+    typedef enum _state_t {
+      IDLE = 0,
+      SERVING,
+      HANDING_OVER,
+      DRAINING
+    } state_t;
+
+    /**
+    * @brief Warm-up callback.
+    *
+    * The callback runs in the new process before it reports ready, while the old process still accepts.
+    */
+    typedef void (*warmup_t)(void *context);
+
+    /**
+    * @brief Custom constructor.
+    *
+    * @param[in] path The control socket path or `@name` for an abstract socket.
+    */
+    HTTPHandover(const std::string &path);
+
+    /**
+    * @brief Destructor.
+    *
+    * This method is responsible to close the control socket (the listening sockets are owned by the caller).
+    */
+    ~HTTPHandover();
+
+    HTTPHandover(const HTTPHandover &) = delete;
+    HTTPHandover &operator=(const HTTPHandover &) = delete;
+
+    /**
+    * @brief Serve the listening sockets.
+    *
+    * This method is responsible to open the non-blocking control socket which hands the listening sockets over to
+    * the next process. A stale control socket file is replaced, the new file is created with mode 0600.
+    *
+    * @param[in] listeners The listening sockets (at most `HTTP_HANDOVER_MAX_FD`).
+    * @return `true` in success.
+    * @return `false` if the control socket can not be opened.
+    */
+    bool serve(const std::vector<int> &listeners);
+
+    /**
+    * @brief Gets the descriptor to wait for.
+    *
+    * @return The control socket (`SERVING`), the connection of the new process (`HANDING_OVER`) or `-1`.
+    */
+    int getFd() const;
+
+    /**
+    * @brief Handle the readable control descriptor.
+    *
+    * This method is responsible to send the listening sockets to the connecting process, then wait for its
+    * `READY`. On `READY` the control socket is closed and the handover starts draining: the caller must stop
+    * accepting and close its listening sockets.
+    *
+    * @param[in] drainTimeout The drain deadline in milliseconds from the `READY`.
+    * @param[in] readyTimeout The deadline of the `READY` in milliseconds from the connection (see `check`).
+    * @return The state after the event.
+    */
+    HTTPHandover::state_t process(uint64_t drainTimeout = HTTP_HANDOVER_DRAIN_TIMEOUT, uint64_t readyTimeout = HTTP_HANDOVER_READY_TIMEOUT);
+
+    /**
+    * @brief Check the ready deadline.
+    *
+    * This method is responsible to give up the handover if the new process did not report `READY` in time
+    * (e.g. it hangs in the warm-up): the connection is closed and the process keeps serving.
+    *
+    * @param[in] now The current time in milliseconds (see `HTTPTimerWheel::now`).
+    * @return The state after the check.
+    */
+    HTTPHandover::state_t check(uint64_t now);
+
+    /**
+    * @brief Gets the state.
+    *
+    * @return The handover state.
+    */
+    HTTPHandover::state_t getState() const;
+
+    /**
+    * @brief Check the drain deadline.
+    *
+    * @param[in] now The current time in milliseconds (see `HTTPTimerWheel::now`).
+    * @return `true` if the process is draining and the deadline passed (the remaining connections should be closed).
+    */
+    bool isExpired(uint64_t now) const;
+
+    /**
+    * @brief Prepare one response while draining.
+    *
+    * This method is responsible to add `Connection: close` to the response while draining, so the keep-alive
+    * clients reconnect to the new process.
+    *
+    * @param[in,out] response The response header.
+    * @return `true` if the connection should be closed after the response.
+    */
+    bool prepare(HTTPHeader &response) const;
+
+    /**
+    * @brief Receive the listening sockets.
+    *
+    * This method is responsible to connect to the control socket of the running process and receive its
+    * listening sockets.
+    *
+    * @param[out] listeners The received listening sockets.
+    * @param[in] timeout The timeout in milliseconds.
+    * @return `true` in success.
+    * @return `false` if no process serves the control socket or the timeout expired.
+    */
+    bool connect(std::vector<int> &listeners, int timeout);
+
+    /**
+    * @brief Add one warm-up callback.
+    *
+    * @param[in] warmup The callback.
+    * @param[in] context The callback context.
+    */
+    void addWarmup(HTTPHandover::warmup_t warmup, void *context);
+
+    /**
+    * @brief Report ready.
+    *
+    * This method is responsible to run the warm-up callbacks and then tell the old process to stop accepting.
+    *
+    * @return `true` in success.
+    * @return `false` if there is no old process (the callbacks still run).
+    */
+    bool ready();
+
+  private:
+    typedef struct _warmupEntry_t {
+      HTTPHandover::warmup_t warmup;
+      void *context;
+    } warmupEntry_t;
+
+    std::string path;
+    int control;
+    int peer;
+    HTTPHandover::state_t state;
+    std::vector<int> listeners;
+    uint64_t deadline;
+    /* identity of the bound control socket file, so a file of the next process is never removed */
+    dev_t device;
+    ino_t inode;
+    std::vector<HTTPHandover::warmupEntry_t> warmups;
+
+    void closePeer();
+    void closeControl();
+};
+
+#endif
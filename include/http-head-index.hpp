@@ -0,0 +1,173 @@
+/*
+ * $Id: http-head-index.hpp,v 1.0.0 2026/10/18 13:52:37 Jaya Wikrama Exp $
+ *
+ * Copyright (c) 2024 Jaya Wikrama
+ * jayawikrama89@gmail.com
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *  claim that you wrote the original software. If you use this software
+ *  in a product, an acknowledgment in the product documentation would be
+ *  appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *  misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+/**
+ * @file
+ * @brief This file defines the HTTPHeadIndex class, a columnar index of captured request heads for offline
+ *        analysis.
+ *
+ * The input is a large buffer (usually a memory mapped capture file) of request heads, each terminated by an
+ * empty row. The buffer is split on head boundaries and the chunks are parsed by a work-stealing thread pool.
+ * The result is one column per `HeaderNode::headerField_t`, one entry per head, holding the offset and the
+ * length of the value in the buffer. Aggregations (e.g. counting `User-Agent` or `Host`) scan one contiguous
+ * column and never touch the other fields.
+ *
+ * Example:
+ * @code
+ * HTTPHeadIndex index;
+ * if (index.open("capture.raw") && index.build()){
+ *   for (const auto &item : index.countValues(HeaderNode::USER_AGENT)) printf("%zu %.*s\n", item.second, (int) item.first.length(), item.first.data());
+ * }
+ * @endcode
+ *
+ * @version 1.0.0
+ * @date 2026-10-18
+ * @author Jaya Wikrama
+ */
+
+#ifndef __HTTP_HEAD_INDEX_HPP__
+#define __HTTP_HEAD_INDEX_HPP__
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "http-header-node.hpp"
+
+#define HTTP_HEAD_INDEX_MIN_CHUNK (256 * 1024)
+#define HTTP_HEAD_INDEX_CHUNK_PER_THREAD 8
+
+class HTTPHeadIndex {
+  public:
+    typedef struct _span_t {
+      uint64_t offset;
+      uint32_t length;
+    } span_t;
+
+    /**
+    * @brief Default constructor for empty index.
+    */
+    HTTPHeadIndex();
+
+    /**
+    * @brief Destructor.
+    *
+    * This method is responsible to unmap the file opened by `open`.
+    */
+    ~HTTPHeadIndex();
+
+    HTTPHeadIndex(const HTTPHeadIndex &) = delete;
+    HTTPHeadIndex &operator=(const HTTPHeadIndex &) = delete;
+
+    /**
+    * @brief Map the capture file.
+    *
+    * This method is responsible to map the whole capture file (read only) as the source buffer.
+    *
+    * @param[in] path The capture file path.
+    * @return `true` in success.
+    * @return `false` if the file can not be opened or mapped.
+    */
+    bool open(const std::string &path);
+
+    /**
+    * @brief Use caller-owned buffer.
+    *
+    * This method is responsible to set the source buffer. The buffer must be available as long as the index is used.
+    *
+    * @param[in] buffer The captured request heads.
+    * @param[in] length The buffer length.
+    */
+    void assign(const char *buffer, size_t length);
+
+    /**
+    * @brief Build the columns.
+    *
+    * This method is responsible to split the source buffer on head boundaries and parse the chunks in parallel.
+    * A head without any valid row is still counted (all of its columns are empty).
+    *
+    * @param[in] threads The number of worker threads (`0` means the number of online CPUs).
+    * @return `true` in success.
+    * @return `false` if no source buffer is available.
+    */
+    bool build(size_t threads = 0);
+
+    /**
+    * @brief Gets the number of heads.
+    *
+    * @return The number of indexed heads.
+    */
+    size_t getCount() const;
+
+    /**
+    * @brief Gets the column of the field.
+    *
+    * This method is responsible to get the value spans of the field, one entry per head in the buffer order.
+    * Heads without the field have zero length entry. If the field is repeated in a head, the first row is used.
+    *
+    * @param[in] field The field identifier.
+    * @return The pointer to `getCount()` entries or `nullptr` if no head has the field.
+    */
+    const HTTPHeadIndex::span_t *getColumn(HeaderNode::headerField_t field) const;
+
+    /**
+    * @brief Gets the start line column.
+    *
+    * @return The pointer to `getCount()` entries of the request lines.
+    */
+    const HTTPHeadIndex::span_t *getStartLines() const;
+
+    /**
+    * @brief Gets one value.
+    *
+    * @param[in] field The field identifier.
+    * @param[in] head The head number.
+    * @return The value as view to the source buffer or empty view if it is not available.
+    */
+    std::string_view getValue(HeaderNode::headerField_t field, size_t head) const;
+
+    /**
+    * @brief Count the distinct values of the field.
+    *
+    * This method is responsible to scan only the column of the field and count each distinct value.
+    *
+    * @param[in] field The field identifier.
+    * @return The count of each value (heads without the field are not counted).
+    */
+    std::unordered_map<std::string_view, size_t> countValues(HeaderNode::headerField_t field) const;
+
+  private:
+    const char *buffer;
+    size_t length;
+    void *mapping;
+    size_t count;
+    std::unique_ptr<span_t[]> starts;
+    std::vector<std::unique_ptr<span_t[]>> columns;
+
+    void release();
+};
+
+#endif
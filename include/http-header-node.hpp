@@ -35,8 +35,90 @@
 #define __HTTP_HEADER_NODE_HPP__
 
 #include <string>
+#include <string_view>
 
-extern const char *fieldName[];
+/* the table is constexpr so that the field names are usable in compile-time serialization */
+inline constexpr const char *fieldName[] = {
+  "Unknown",
+  "Accept",
+  "Accept-Charset",
+  "Accept-Encoding",
+  "Accept-Language",
+  "Authorization",
+  "Cache-Control",
+  "Connection",
+  "Cookie",
+  "Expect",
+  "From",
+  "Host",
+  "If-Match",
+  "If-Modified-Since",
+  "If-None-Match",
+  "If-Unmodified-Since",
+  "Max-Forwards",
+  "Origin",
+  "Pragma",
+  "Proxy-Authorization",
+  "Range",
+  "Referer",
+  "TE",
+  "User-Agent",
+  "Date",
+  "Server",
+  "Content-Length",
+  "Content-Type",
+  "Content-Encoding",
+  "Content-Language",
+  "Content-Disposition",
+  "Last-Modified",
+  "ETag",
+  "Accept-Ranges",
+  "Content-Location",
+  "Content-Range",
+  "Vary",
+  "Cache-Control",
+  "Expires",
+  "Pragma",
+  "Age",
+  "Strict-Transport-Security",
+  "Content-Security-Policy",
+  "X-Content-Type-Options",
+  "X-Frame-Options",
+  "X-XSS-Protection",
+  "Referrer-Policy",
+  "Public-Key-Pins",
+  "Expect-CT",
+  "X-Content-Security-Policy",
+  "X-Download-Options",
+  "X-Permitted-Cross-Domain-Policies",
+  "Location",
+  "Proxy-Authenticate",
+  "Set-Cookie",
+  "Set-Cookie2",
+  "Multi-Status",
+  "Link",
+  "Allow",
+  "Retry-After",
+  "Access-Control-Allow-Origin",
+  "Access-Control-Allow-Methods",
+  "Access-Control-Allow-Headers",
+  "Access-Control-Expose-Headers",
+  "Access-Control-Max-Age",
+  "X-Forwarded-For",
+  "X-Forwarded-Proto",
+  "X-Real-IP",
+  "Transfer-Encoding",
+  "Trailer",
+  "Keep-Alive",
+  "Upgrade",
+  "If-Range",
+  "Sec-WebSocket-Key",
+  "Sec-WebSocket-Accept",
+  "Sec-WebSocket-Version",
+  "Sec-WebSocket-Protocol",
+  "Sec-WebSocket-Extensions",
+  "Unknown"
+};
 
 class HeaderNode {
   public:
@@ -46,7 +128,8 @@ class HeaderNode {
       VALUE_TYPE_TEXT
     } valueType_t;
 
-    typedef enum _headerField_t {
+    /* fixed underlying type, extension fields use identifiers above SZ_TOTAL (see HeaderTable) */
+    typedef enum _headerField_t : int {
       UNKNOWN = 0,
       // General Request Headers
       ACCEPT,
@@ -123,6 +206,17 @@ class HeaderNode {
       X_FORWARDED_FOR,
       X_FORWARDED_PROTO,
       X_REAL_IP,
+      // Framing and Upgrade Headers
+      TRANSFER_ENCODING,
+      TRAILER,
+      KEEP_ALIVE,
+      UPGRADE,
+      IF_RANGE,
+      SEC_WEBSOCKET_KEY,
+      SEC_WEBSOCKET_ACCEPT,
+      SEC_WEBSOCKET_VERSION,
+      SEC_WEBSOCKET_PROTOCOL,
+      SEC_WEBSOCKET_EXTENSIONS,
       SZ_TOTAL
     } headerField_t;
 
@@ -161,39 +255,85 @@ class HeaderNode {
     *
     * This method is responsible for create new node with string data value.
     */
-    HeaderNode(HeaderNode::headerField_t field, const std::string data);
+    HeaderNode(HeaderNode::headerField_t field, const std::string &data);
 
     /**
-    * @brief Node constructor for string field and string data.
+    * @brief Node constructor for temporary string data.
     *
-    * This method is responsible for create new node with string field and string data value.
-    * This method will throw an error if input field is not match with available field list.
+    * This method is responsible for create new node which adopts the string data value without copying it.
     */
-    HeaderNode(const std::string field, int data);
+    HeaderNode(HeaderNode::headerField_t field, std::string &&data);
 
     /**
     * @brief Node constructor for string field and integer data.
     *
     * This method is responsible for create new node with string field and integer data value.
-    * This method will throw an error if input field is not match with available field list.
+    * Extension field names are interned in the HeaderTable.
+    * This method will throw an error if the field name can not be interned.
     */
-    HeaderNode(const std::string field, long data);
+    HeaderNode(const std::string &field, int data);
 
     /**
     * @brief Node constructor for string field and long integer data.
     *
     * This method is responsible for create new node with string field and long integer data value.
-    * This method will throw an error if input field is not match with available field list.
+    * Extension field names are interned in the HeaderTable.
+    * This method will throw an error if the field name can not be interned.
+    */
+    HeaderNode(const std::string &field, long data);
+
+    /**
+    * @brief Node constructor for string field and boolean data.
+    *
+    * This method is responsible for create new node with string field and boolean data value.
+    * Extension field names are interned in the HeaderTable.
+    * This method will throw an error if the field name can not be interned.
     */
-    HeaderNode(const std::string field, bool data);
+    HeaderNode(const std::string &field, bool data);
 
     /**
     * @brief Node constructor for string field and string data.
     *
     * This method is responsible for create new node with string field and string data value.
-    * This method will throw an error if input field is not match with available field list.
+    * Extension field names are interned in the HeaderTable.
+    * This method will throw an error if the field name can not be interned.
+    */
+    HeaderNode(const std::string &field, const std::string &data);
+
+    /**
+    * @brief Node constructor for string field and temporary string data.
+    *
+    * This method is responsible for create new node with string field which adopts the string data value without copying it.
+    * Extension field names are interned in the HeaderTable.
+    * This method will throw an error if the field name can not be interned.
+    */
+    HeaderNode(const std::string &field, std::string &&data);
+
+    /**
+    * @brief Node constructor for field name which is not in the HeaderTable.
+    *
+    * This method is responsible for create new node which keeps the field name
+    * (e.g. as written on the wire) on the node itself, so parsing never grows the HeaderTable.
+    * The name is kept only for `HeaderNode::UNKNOWN` field.
+    */
+    HeaderNode(HeaderNode::headerField_t field, std::string_view name, std::string &&data);
+
+    /**
+    * @brief Move constructor.
+    *
+    * This method is responsible for taking over the field, the value and the link of the other node.
+    */
+    HeaderNode(HeaderNode &&other) noexcept;
+
+    /**
+    * @brief Move assignment.
+    *
+    * This method is responsible for taking over the field, the value and the link of the other node.
     */
-    HeaderNode(const std::string field, const std::string data);
+    HeaderNode &operator=(HeaderNode &&other) noexcept;
+
+    HeaderNode(const HeaderNode &) = delete;
+    HeaderNode &operator=(const HeaderNode &) = delete;
 
     /**
     * @brief Node destructor.
@@ -202,6 +342,15 @@ class HeaderNode {
     */
     ~HeaderNode();
 
+    /**
+    * @brief Create a copy of the node.
+    *
+    * This method is responsible for explicitly copying the field and the value to a new unlinked node.
+    *
+    * @return The new node.
+    */
+    HeaderNode *clone() const;
+
     /**
     * @brief Gets the HTTP Header field name.
     *
@@ -211,6 +360,24 @@ class HeaderNode {
     */
     std::string getFieldName() const;
 
+    /**
+    * @brief Gets the HTTP Header field name without copying it.
+    *
+    * This method is responsible for getting the HTTP Header field name as view to the node storage or the HeaderTable.
+    *
+    * @return The HTTP Header field name as view.
+    */
+    std::string_view getFieldNameView() const;
+
+    /**
+    * @brief Gets the HTTP Header field.
+    *
+    * This method is responsible for getting the HTTP Header field identifier.
+    *
+    * @return The HTTP Header field identifier.
+    */
+    HeaderNode::headerField_t getField() const;
+
     /**
     * @brief Gets the HTTP Header field value.
     *
@@ -220,6 +387,40 @@ class HeaderNode {
     */
     std::string getValue();
 
+    /**
+    * @brief Gets the HTTP Header field value without copying it.
+    *
+    * This method is responsible for getting the text value as view to the node storage.
+    * The view is valid as long as the node is alive and is empty for number and boolean nodes.
+    *
+    * @return The HTTP Header field value as view.
+    */
+    std::string_view getValueView() const;
+
+    /**
+    * @brief Gets the HTTP Header field value as number.
+    *
+    * This method is responsible for getting the value of the number node or converting the text value
+    * (decimal digits only, e.g. `Content-Length`, `Age`).
+    *
+    * @param[out] number The value.
+    * @return `true` in success.
+    * @return `false` if the value is not a non-negative decimal number.
+    */
+    bool getNumber(long &number) const;
+
+    /**
+    * @brief Gets the HTTP Header field value as Unix epoch.
+    *
+    * This method is responsible for getting the value of the number node or converting the text value
+    * (IMF-fixdate, e.g. `Date`, `Last-Modified`).
+    *
+    * @param[out] epoch The value.
+    * @return `true` in success.
+    * @return `false` if the value is not a valid HTTP-date.
+    */
+    bool getDate(long &epoch) const;
+
     /**
     * @brief Parse the HTTP Header node (single row).
     *
@@ -228,7 +429,44 @@ class HeaderNode {
     * @return `true` in success.
     * @return `false` on fail.
     */
-    bool parseRow(const char *headerRow, HeaderNode::headerField_t &field, std::string &data);
+    static bool parseRow(const char *headerRow, HeaderNode::headerField_t &field, std::string &data);
+
+    /**
+    * @brief Overloading of `parseRow` method for row which is not null terminated.
+    *
+    * This method is responsible for getting parse the HTTP Header node (single row) to separate field name and field value.
+    * The trailing CR (if any) is not part of the value.
+    *
+    * @return `true` in success.
+    * @return `false` on fail.
+    */
+    static bool parseRow(const char *headerRow, size_t length, HeaderNode::headerField_t &field, std::string &data);
+
+    /**
+    * @brief Overloading of `parseRow` method without copying the value.
+    *
+    * This method is responsible for getting parse the HTTP Header node (single row) to separate field name and field value.
+    * The value is a view to the row, so its offset in the source buffer is known.
+    * The field name must be a token (RFC 7230 `tchar`) directly followed by the colon, it is matched
+    * case-insensitively.
+    *
+    * @return `true` in success.
+    * @return `false` on fail.
+    */
+    static bool parseRow(const char *headerRow, size_t length, HeaderNode::headerField_t &field, std::string_view &data);
+
+    /**
+    * @brief Overloading of `parseRow` method which also gives the field name.
+    *
+    * This method is responsible for getting parse the HTTP Header node (single row) to separate field name and field value.
+    * The field name is only searched in the HeaderTable (never interned), so the field is `HeaderNode::UNKNOWN`
+    * for a valid name which is not in the table and the caller keeps the name from the view.
+    *
+    * @return `true` in success.
+    * @return `false` if the field name is not a token directly followed by the colon or is too long, or the value
+    * holds a control byte.
+    */
+    static bool parseRow(const char *headerRow, size_t length, HeaderNode::headerField_t &field, std::string_view &name, std::string_view &data);
 
     /**
     * @brief Overloading of `parseRow` method.
@@ -238,12 +476,16 @@ class HeaderNode {
     * @return `true` in success.
     * @return `false` on fail.
     */
-    bool parseRow(const std::string headerRow, HeaderNode::headerField_t &field, std::string &data);
+    static bool parseRow(const std::string &headerRow, HeaderNode::headerField_t &field, std::string &data);
 
   private:
     valueType_t vType;
     void *data;
     headerField_t field;
+    /* field name of the `HeaderNode::UNKNOWN` node, empty for the fields of the HeaderTable */
+    std::string name;
+    /* text value, short values (e.g. "keep-alive", "gzip") are kept inline without heap allocation */
+    std::string text;
 };
 
 #endif
\ No newline at end of file
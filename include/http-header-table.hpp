@@ -0,0 +1,129 @@
+/*
+ * $Id: http-header-table.hpp,v 1.0.0 2026/10/18 12:40:52 Jaya Wikrama Exp $
+ *
+ * Copyright (c) 2024 Jaya Wikrama
+ * jayawikrama89@gmail.com
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *  claim that you wrote the original software. If you use this software
+ *  in a product, an acknowledgment in the product documentation would be
+ *  appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *  misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+/**
+ * @file
+ * @brief This file defines the HeaderTable class, the process-wide table of interned HTTP Header field names.
+ *
+ * The table contains every built-in field of `HeaderNode::headerField_t` and every extension field name
+ * (e.g. `X-Request-Id`, `traceparent`) seen by the process. Extension fields get dynamic identifiers above
+ * `HeaderNode::SZ_TOTAL`, so they are compared and looked up by identifier exactly like the built-in ones,
+ * and the name bytes are stored once for the whole process.
+ *
+ * Names are compared case-insensitively (`content-length`, `Content-Length` and `CONTENT-LENGTH` are one field).
+ * The table keeps the canonical name of the built-in fields and the first spelling seen of the extension fields.
+ *
+ * Lookups never lock. Interning a new name takes a mutex, and the table never shrinks.
+ *
+ * @version 1.0.0
+ * @date 2026-10-18
+ * @author Jaya Wikrama
+ */
+
+#ifndef __HTTP_HEADER_TABLE_HPP__
+#define __HTTP_HEADER_TABLE_HPP__
+
+#include <cstddef>
+#include <string_view>
+#include "http-header-node.hpp"
+
+#define HTTP_HEADER_TABLE_CAPACITY 4096
+#define HTTP_HEADER_NAME_MAX 256
+
+class HeaderTable {
+  public:
+    /**
+    * @brief Find the field of the name.
+    *
+    * This method is responsible to search the interned field name without locking.
+    *
+    * @param[in] name The field name (any case).
+    * @return The field identifier or `HeaderNode::UNKNOWN` if the name is not interned.
+    */
+    static HeaderNode::headerField_t find(std::string_view name);
+
+    /**
+    * @brief Overloading of `find` method for name which is already lowercased.
+    *
+    * This method is responsible to skip the case folding when the caller already has the lowercased name
+    * (e.g. from `HTTPSimd::lowerToken`).
+    *
+    * @param[in] key The lowercased field name.
+    * @return The field identifier or `HeaderNode::UNKNOWN` if the name is not interned.
+    */
+    static HeaderNode::headerField_t findLowercase(std::string_view key);
+
+    /**
+    * @brief Intern the field name.
+    *
+    * This method is responsible to search the field name and add it to the table if it is not available.
+    *
+    * @param[in] name The field name (any case).
+    * @return The field identifier.
+    * @return `HeaderNode::UNKNOWN` if the name is empty, longer than `HTTP_HEADER_NAME_MAX` or the table is full.
+    */
+    static HeaderNode::headerField_t intern(std::string_view name);
+
+    /**
+    * @brief Overloading of `intern` method for name which is already lowercased.
+    *
+    * This method is responsible to skip the case folding when the caller already has the lowercased name
+    * (e.g. from `HTTPSimd::lowerToken`).
+    *
+    * @param[in] name The field name as written.
+    * @param[in] key The lowercased field name.
+    * @return The field identifier.
+    * @return `HeaderNode::UNKNOWN` if the name is empty, longer than `HTTP_HEADER_NAME_MAX` or the table is full.
+    */
+    static HeaderNode::headerField_t intern(std::string_view name, std::string_view key);
+
+    /**
+    * @brief Gets the name of the field.
+    *
+    * This method is responsible to get the interned name of the built-in or extension field without locking.
+    *
+    * @param[in] field The field identifier.
+    * @return The field name or "Unknown" if the identifier is not available.
+    */
+    static std::string_view getName(HeaderNode::headerField_t field);
+
+    /**
+    * @brief Check if the field is an extension field.
+    *
+    * @return `true` if the identifier is above `HeaderNode::SZ_TOTAL`.
+    * @return `false` for built-in fields.
+    */
+    static bool isExtension(HeaderNode::headerField_t field);
+
+    /**
+    * @brief Gets the upper bound of the field identifiers.
+    *
+    * This method is responsible to get the number of identifiers (built-in and extension) in use, so per-field
+    * arrays can be sized by `HeaderTable::size()`.
+    *
+    * @return The highest field identifier plus one.
+    */
+    static size_t size();
+};
+
+#endif
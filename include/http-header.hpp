@@ -34,16 +34,92 @@
 #ifndef __HTTP_HEADER_HPP__
 #define __HTTP_HEADER_HPP__
 
-#include <string> 
+#include <string>
+#include <sys/types.h>
 #include "http-header-node.hpp"
 #include "http-code.hpp"
 
+#define HTTP_HEADER_MAX_LINE 8192
+#define HTTP_HEADER_MAX_TARGET 8192
+#define HTTP_HEADER_MAX_COUNT 100
+#define HTTP_HEADER_MAX_SIZE 65536
+#define HTTP_HEADER_MAX_VALUE 8192
+
+/**
+ * @brief Convert the HTTP-date to Unix epoch.
+ *
+ * This function is responsible to convert the IMF-fixdate (e.g. `Sun, 06 Nov 1994 08:49:37 GMT`) to Unix epoch.
+ *
+ * @param[in] dateStr The HTTP-date.
+ * @return The Unix epoch or `-1` if the date is malformed.
+ */
+long convertToUnixEpoch(const std::string &dateStr);
+
 class HTTPHeader {
   private:
     std::string version;
+    std::string method;
+    std::string target;
     HttpStatus::Code_t code;
 
+    /**
+    * @brief Append new node to the tail of the list.
+    *
+    * This method is responsible to link one allocated node at the end of the list.
+    *
+    * @return `true` in success.
+    * @return `false` on fail.
+    */
+    bool append(HeaderNode *next);
+
+    /**
+    * @brief Release all available nodes.
+    */
+    void release();
+
+    /**
+    * @brief Parse the complete head.
+    *
+    * This method is responsible to parse the start line (if any) and all rows of the head.
+    *
+    * @return `true` in success.
+    * @return `false` if the start line, the field name or the value of one row is malformed, or the body framing is
+    * ambiguous.
+    */
+    bool parseHead(const char *head, size_t length);
+
+    /**
+    * @brief Parse the start line.
+    *
+    * This method is responsible to parse the status line (`HTTP/<version> <code> <reason>`) or the request
+    * line (`<method> <target> HTTP/<version>`).
+    *
+    * @return `true` in success.
+    * @return `false` if the start line is malformed.
+    */
+    bool parseStartLine(const char *line, size_t length);
+
   public:
+    /**
+    * @brief The limits of a received head, checked while the head is scanned.
+    */
+    typedef struct _limits_t {
+      size_t line = HTTP_HEADER_MAX_LINE;
+      size_t target = HTTP_HEADER_MAX_TARGET;
+      size_t count = HTTP_HEADER_MAX_COUNT;
+      size_t size = HTTP_HEADER_MAX_SIZE;
+      size_t value = HTTP_HEADER_MAX_VALUE;
+    } limits_t;
+
+    /**
+    * @brief The scan state of an incomplete received head, so the next `parse` continues after the complete rows.
+    */
+    typedef struct _scan_t {
+      size_t offset = 0;
+      size_t rows = 0;
+      bool start = false;
+    } scan_t;
+
     HeaderNode *node;
 
     /**
@@ -79,14 +155,22 @@ class HTTPHeader {
     *
     * This method is responsible for create new HTTP Header wich automatically create one node with string data value.
     */
-    HTTPHeader(HeaderNode::headerField_t field, const std::string data);
+    HTTPHeader(HeaderNode::headerField_t field, const std::string &data);
+
+    /**
+    * @brief Custom constructor for temporary string data.
+    *
+    * This method is responsible for create new HTTP Header wich automatically create one node which adopts the string data value.
+    */
+    HTTPHeader(HeaderNode::headerField_t field, std::string &&data);
 
     /**
     * @brief Custom constructor for Complete HTTP Header Payload.
     *
     * This method is responsible for create new HTTP Header wich automatically parse the input to linked list form.
+    * This method will throw an error if the payload is malformed.
     */
-    HTTPHeader(const std::string httpHeaderPayload);
+    HTTPHeader(const std::string &httpHeaderPayload);
 
     /**
      * @brief Overloaded custom constructor for Complete HTTP Header Payload.
@@ -95,6 +179,23 @@ class HTTPHeader {
      */
     HTTPHeader(const char *httpHeaderPayload);
 
+    /**
+    * @brief Move constructor.
+    *
+    * This method is responsible for taking over all nodes of the other HTTP Header, which is left blank.
+    */
+    HTTPHeader(HTTPHeader &&other) noexcept;
+
+    /**
+    * @brief Move assignment.
+    *
+    * This method is responsible for releasing all available nodes and taking over all nodes of the other HTTP Header.
+    */
+    HTTPHeader &operator=(HTTPHeader &&other) noexcept;
+
+    HTTPHeader(const HTTPHeader &) = delete;
+    HTTPHeader &operator=(const HTTPHeader &) = delete;
+
     /**
     * @brief Destructor for HTTP Header class.
     *
@@ -102,6 +203,15 @@ class HTTPHeader {
     */
     ~HTTPHeader();
 
+    /**
+    * @brief Create a copy of the HTTP Header.
+    *
+    * This method is responsible for explicitly copying the status line and all available nodes.
+    *
+    * @return The new HTTP Header.
+    */
+    HTTPHeader clone() const;
+
     /**
     * @brief Append new node with Integer data.
     *
@@ -140,7 +250,178 @@ class HTTPHeader {
     * @return `true` in success.
     * @return `false` on fail.
     */
-    bool append(HeaderNode::headerField_t field, const std::string data);
+    bool append(HeaderNode::headerField_t field, const std::string &data);
+
+    /**
+    * @brief Append new node with temporary string data.
+    *
+    * This method is responsible to append one node which adopts the string data value without copying it.
+    *
+    * @return `true` in success.
+    * @return `false` on fail.
+    */
+    bool append(HeaderNode::headerField_t field, std::string &&data);
+
+    /**
+    * @brief Append new node with field name and temporary string data.
+    *
+    * This method is responsible to append one node of the field name without interning it, the name is kept on
+    * the node if it is not in the HeaderTable.
+    *
+    * @return `true` in success.
+    * @return `false` on fail.
+    */
+    bool append(std::string_view name, std::string &&data);
+
+    /**
+    * @brief Gets the first node of the HTTP Header field.
+    *
+    * This method is responsible to search the node of the HTTP Header field.
+    *
+    * @return The node pointer or `nullptr` if the field is not available.
+    */
+    HeaderNode *getNode(HeaderNode::headerField_t field) const;
+
+    /**
+    * @brief Overloading of `getNode` method for field name.
+    *
+    * This method is responsible to search the node by the case-insensitive field name, including the nodes of
+    * the parsed field names which are not in the HeaderTable.
+    *
+    * @return The node pointer or `nullptr` if the field is not available.
+    */
+    HeaderNode *getNode(std::string_view name) const;
+
+    /**
+    * @brief Remove all nodes of the HTTP Header field.
+    *
+    * This method is responsible to unlink and release every node of the HTTP Header field.
+    *
+    * @return `true` if at least one node is removed.
+    * @return `false` if the field is not available.
+    */
+    bool remove(HeaderNode::headerField_t field);
+
+    /**
+    * @brief Overloading of `remove` method for field name.
+    *
+    * This method is responsible to unlink and release every node of the case-insensitive field name, including
+    * the nodes of the parsed field names which are not in the HeaderTable.
+    *
+    * @return `true` if at least one node is removed.
+    * @return `false` if the field is not available.
+    */
+    bool remove(std::string_view name);
+
+    /**
+    * @brief Set HTTP Status Code.
+    *
+    * This method is responsible for setting the HTTP Status Code of the response status line.
+    *
+    * @param[in] code The HTTP Status Code.
+    */
+    void setHTTPStatusCode(HttpStatus::Code_t code);
+
+    /**
+    * @brief Gets the HTTP Status Code.
+    *
+    * @return The HTTP Status Code.
+    */
+    HttpStatus::Code_t getHTTPStatusCode() const;
+
+    /**
+    * @brief Set the request line.
+    *
+    * This method is responsible for setting the method and the target of the request line, the head is
+    * serialized as a request after this call.
+    *
+    * @param[in] method The request method (e.g. "GET").
+    * @param[in] target The request target (e.g. "/index.html").
+    */
+    void setRequestLine(const std::string &method, const std::string &target);
+
+    /**
+    * @brief Write the start line and all available nodes to the payload.
+    *
+    * This method is responsible to append the start line (the request line of a parsed request, otherwise the
+    * status line) and one row for each node to the payload buffer. The terminating empty row is not written, so
+    * other rows (e.g. `HTTPSetCookie::serialize`) can be appended directly to the same buffer before the head is
+    * closed with CRLF.
+    *
+    * @param[in,out] payload The payload buffer.
+    */
+    void serialize(std::string &payload);
+
+    /**
+    * @brief Parse one HTTP Header from the buffer.
+    *
+    * This method is responsible to find the end of the first head available in the buffer (empty row) and parse
+    * the start line and all rows into this (blank) HTTP Header. The buffer may hold more data after the head
+    * (body or the next pipelined request), it is not consumed.
+    *
+    * @param[in] buffer The received data.
+    * @param[in] length The length of the received data.
+    * @return The number of bytes of the head (including the empty row).
+    * @return `0` if the head is not complete yet.
+    * @return `-1` if the head is malformed (including a head without start line).
+    */
+    ssize_t parse(const char *buffer, size_t length);
+
+    /**
+    * @brief Overloading of `parse` method with limits.
+    *
+    * This method is responsible to check the limits while the head is scanned, so an oversized head is rejected
+    * as soon as the received part exceeds a limit, before the rest of it is buffered.
+    *
+    * @param[in] buffer The received data.
+    * @param[in] length The length of the received data.
+    * @param[in] limits The limits (line length, request target length, number of rows, head size, value length).
+    * @param[out] status The rejection status if the head is rejected: `URI_TOO_LONG` (request line or target),
+    * `REQUEST_HEADER_FIELDS_TOO_LARGE` (row, number of rows, head or value) or `BAD_REQUEST` (malformed).
+    * @return The number of bytes of the head (including the empty row).
+    * @return `0` if the head is not complete yet.
+    * @return `-1` if the head is rejected.
+    */
+    ssize_t parse(const char *buffer, size_t length, const HTTPHeader::limits_t &limits, HttpStatus::Code_t &status);
+
+    /**
+    * @brief Overloading of `parse` method with limits and scan state.
+    *
+    * This method is responsible to continue the scan of an incomplete head after the rows which were complete in
+    * the previous call, so a head which arrives in many small reads is scanned once. The buffer must start at the
+    * same byte as in the previous call. The state is reset when the head is complete or rejected.
+    *
+    * @param[in] buffer The received data.
+    * @param[in] length The length of the received data.
+    * @param[in] limits The limits (line length, request target length, number of rows, head size, value length).
+    * @param[out] status The rejection status if the head is rejected (see the overloading with limits).
+    * @param[in,out] scan The scan state of the head.
+    * @return The number of bytes of the head (including the empty row).
+    * @return `0` if the head is not complete yet.
+    * @return `-1` if the head is rejected.
+    */
+    ssize_t parse(const char *buffer, size_t length, const HTTPHeader::limits_t &limits, HttpStatus::Code_t &status, HTTPHeader::scan_t &scan);
+
+    /**
+    * @brief Gets the request method.
+    *
+    * @return The request method or empty string if the head is not a request.
+    */
+    const std::string &getMethod() const;
+
+    /**
+    * @brief Gets the request target.
+    *
+    * @return The request target or empty string if the head is not a request.
+    */
+    const std::string &getTarget() const;
+
+    /**
+    * @brief Gets the HTTP version.
+    *
+    * @return The HTTP version (e.g. "1.1").
+    */
+    const std::string &getVersion() const;
 
     /**
     * @brief Gets HTTP Header as String.
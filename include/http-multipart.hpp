@@ -0,0 +1,168 @@
+/*
+ * $Id: http-multipart.hpp,v 1.0.0 2026/10/18 15:27:44 Jaya Wikrama Exp $
+ *
+ * Copyright (c) 2024 Jaya Wikrama
+ * jayawikrama89@gmail.com
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *  claim that you wrote the original software. If you use this software
+ *  in a product, an acknowledgment in the product documentation would be
+ *  appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *  misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+/**
+ * @file
+ * @brief This file defines the HTTPMultipart class, a push-style streaming parser of `multipart/form-data` bodies.
+ *
+ * The body is fed in arbitrary slices (e.g. every `read` of the socket). The delimiters are searched with
+ * Boyer-Moore-Horspool directly in the fed slices, the part headers are parsed with `HeaderNode::parseRow` and
+ * the part bodies are delivered as slices of the fed data. Only a partial delimiter at the end of a slice and
+ * the part headers are buffered, so the memory does not depend on the upload size.
+ *
+ * Example:
+ * @code
+ * static bool onPart(HTTPMultipart &parser, HTTPHeader &part, void *context){
+ *   std::string name, filename;
+ *   if (HTTPMultipart::getDisposition(part, name, filename) && !filename.empty()) parser.setOutput(openUpload(filename));
+ *   return true;
+ * }
+ * HTTPMultipart parser(boundary, onPart, onData, onPartEnd, context);
+ * while ((n = read(fd, buffer, sizeof(buffer))) > 0 && parser.feed(buffer, n));
+ * @endcode
+ *
+ * @version 1.0.0
+ * @date 2026-10-18
+ * @author Jaya Wikrama
+ */
+
+#ifndef __HTTP_MULTIPART_HPP__
+#define __HTTP_MULTIPART_HPP__
+
+#include <cstddef>
+#include <string>
+#include "http-header.hpp"
+
+#define HTTP_MULTIPART_MAX_HEAD 8192
+#define HTTP_MULTIPART_MAX_BOUNDARY 70
+
+class HTTPMultipart {
+  public:
+    typedef bool (*part_t)(HTTPMultipart &parser, HTTPHeader &part, void *context);
+    typedef bool (*data_t)(HTTPMultipart &parser, const char *data, size_t length, void *context);
+    typedef bool (*end_t)(HTTPMultipart &parser, void *context);
+
+    /**
+    * @brief Custom constructor.
+    *
+    * Every handler may be `nullptr` and every handler may return `false` to stop the parser.
+    * This method will throw an error if the boundary is empty or longer than `HTTP_MULTIPART_MAX_BOUNDARY`.
+    *
+    * @param[in] boundary The boundary (see `getBoundary`).
+    * @param[in] onPart The handler of the parsed part header.
+    * @param[in] onData The handler of the part body slices (not called while the output is set).
+    * @param[in] onPartEnd The handler of the end of the part.
+    * @param[in] context The handlers context.
+    */
+    HTTPMultipart(const std::string &boundary, HTTPMultipart::part_t onPart, HTTPMultipart::data_t onData, HTTPMultipart::end_t onPartEnd, void *context);
+
+    /**
+    * @brief Parse the next slice of the body.
+    *
+    * This method is responsible to parse the slice and call the handlers. The slice is not referenced after the
+    * method returns.
+    *
+    * @param[in] data The body slice.
+    * @param[in] length The slice length.
+    * @return `true` in success (call `isComplete` to check the final delimiter).
+    * @return `false` if the body is malformed (e.g. a part header row is not a field), a handler stopped the parser or
+    * the output can not be written.
+    */
+    bool feed(const char *data, size_t length);
+
+    /**
+    * @brief Check the final delimiter.
+    *
+    * @return `true` if the final delimiter is parsed.
+    * @return `false` if the body is not complete yet.
+    */
+    bool isComplete() const;
+
+    /**
+    * @brief Write the current part body to the file descriptor.
+    *
+    * This method is responsible to write the rest of the current part body straight from the fed slices to the
+    * file descriptor instead of calling the data handler. The output is reset at the end of the part, the file
+    * descriptor is not closed.
+    *
+    * @param[in] fd The output file descriptor.
+    */
+    void setOutput(int fd);
+
+    /**
+    * @brief Gets the boundary of the request.
+    *
+    * This method is responsible to get the boundary parameter of `Content-Type: multipart/form-data`.
+    *
+    * @param[in] request The request header.
+    * @param[out] boundary The boundary.
+    * @return `true` in success.
+    * @return `false` if the request is not multipart or the boundary is malformed.
+    */
+    static bool getBoundary(const HTTPHeader &request, std::string &boundary);
+
+    /**
+    * @brief Gets the form field of the part.
+    *
+    * This method is responsible to get the `name` and `filename` parameters of `Content-Disposition: form-data`.
+    *
+    * @param[in] part The part header.
+    * @param[out] name The form field name.
+    * @param[out] filename The file name or empty string.
+    * @return `true` in success.
+    * @return `false` if the part has no form-data disposition.
+    */
+    static bool getDisposition(const HTTPHeader &part, std::string &name, std::string &filename);
+
+  private:
+    typedef enum _state_t {
+      PREAMBLE = 0,
+      DELIMITER,
+      DELIMITER_DASH,
+      DELIMITER_CR,
+      HEAD,
+      BODY,
+      EPILOGUE,
+      FAILED
+    } state_t;
+
+    std::string delimiter;
+    size_t skip[256];
+    std::string carry;
+    std::string head;
+    HTTPMultipart::part_t onPart;
+    HTTPMultipart::data_t onData;
+    HTTPMultipart::end_t onPartEnd;
+    void *context;
+    HTTPMultipart::state_t state;
+    bool partOpen;
+    int output;
+
+    size_t search(const char *data, size_t length) const;
+    size_t partial(const char *data, size_t length) const;
+    bool deliver(const char *data, size_t length);
+    bool parseHead();
+    bool closePart();
+};
+
+#endif
@@ -0,0 +1,176 @@
+/*
+ * $Id: http-negotiation.hpp,v 1.0.0 2026/10/18 10:02:15 Jaya Wikrama Exp $
+ *
+ * Copyright (c) 2024 Jaya Wikrama
+ * jayawikrama89@gmail.com
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *  claim that you wrote the original software. If you use this software
+ *  in a product, an acknowledgment in the product documentation would be
+ *  appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *  misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+/**
+ * @file
+ * @brief This file defines the HTTPPreferenceList class (parsed `Accept`, `Accept-Encoding`, `Accept-Language`
+ *        and `Accept-Charset` header value) and the HTTPNegotiation class (content negotiation).
+ *
+ * Parsed preference lists are memoized in a small per-thread LRU keyed by the hash of the header value,
+ * so a header value that was seen before by the same thread is never parsed again.
+ *
+ * @version 1.0.0
+ * @date 2026-10-18
+ * @author Jaya Wikrama
+ */
+
+#ifndef __HTTP_NEGOTIATION_HPP__
+#define __HTTP_NEGOTIATION_HPP__
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include "http-header.hpp"
+
+#define HTTP_NEGOTIATION_CACHE_SIZE 32
+
+class HTTPPreferenceList {
+  public:
+    typedef enum _kind_t {
+      KIND_MEDIA_TYPE,
+      KIND_ENCODING,
+      KIND_LANGUAGE,
+      KIND_CHARSET
+    } kind_t;
+
+    typedef struct _preference_t {
+      uint16_t offset;
+      uint16_t length;
+      uint16_t quality;
+      uint8_t specificity;
+      uint8_t order;
+    } preference_t;
+
+    /**
+    * @brief Default constructor for empty preference list.
+    *
+    * This method is responsible for create blank preference list (every offer is acceptable).
+    */
+    HTTPPreferenceList();
+
+    /**
+    * @brief Custom constructor for header value.
+    *
+    * This method is responsible for parse the header value into preference list sorted by quality
+    * (highest first). Elements with the same quality keep the header order.
+    */
+    HTTPPreferenceList(HTTPPreferenceList::kind_t kind, std::string_view headerValue);
+
+    /**
+    * @brief Gets the number of preferences.
+    *
+    * @return The number of preferences.
+    */
+    size_t size() const;
+
+    /**
+    * @brief Gets the preference token (lower-cased, without parameters).
+    *
+    * @param[in] idx The preference index (0 is the most preferred).
+    * @return The preference token.
+    */
+    std::string_view getToken(size_t idx) const;
+
+    /**
+    * @brief Gets the preference quality (q-value multiplied by 1000).
+    *
+    * @param[in] idx The preference index (0 is the most preferred).
+    * @return The preference quality.
+    */
+    int getQuality(size_t idx) const;
+
+    /**
+    * @brief Gets the quality of one offer.
+    *
+    * This method is responsible to find the most specific preference which matches the offer and
+    * return its quality.
+    *
+    * @param[in] offer The offered representation (media type, coding, language tag or charset).
+    * @return The quality (0 to 1000) or 0 if the offer is not acceptable.
+    */
+    int getQuality(std::string_view offer) const;
+
+  private:
+    kind_t kind;
+    std::string tokens;
+    std::vector<HTTPPreferenceList::preference_t> preferences;
+};
+
+class HTTPNegotiation {
+  public:
+    /**
+    * @brief Gets the parsed preference list of the header value.
+    *
+    * This method is responsible to return the memoized preference list of the header value. The header
+    * value is parsed only if it is not available in the per-thread cache. The returned reference is valid
+    * until the next call on the same thread.
+    *
+    * @param[in] kind The preference list kind.
+    * @param[in] headerValue The raw header value.
+    * @return The preference list.
+    */
+    static const HTTPPreferenceList &getPreferences(HTTPPreferenceList::kind_t kind, std::string_view headerValue);
+
+    /**
+    * @brief Select the best offer.
+    *
+    * This method is responsible to pick the offer with the highest quality. Offers with the same quality
+    * are selected by the server order (first offer wins).
+    *
+    * @param[in] kind The preference list kind.
+    * @param[in] headerValue The raw header value.
+    * @param[in] offers The offered representations ordered by server preference.
+    * @param[in] count The number of offers.
+    * @return The index of the selected offer.
+    * @return `-1` if no offer is acceptable (`NOT_ACCEPTABLE`).
+    */
+    static int select(HTTPPreferenceList::kind_t kind, std::string_view headerValue, const std::string_view *offers, size_t count);
+
+    /**
+    * @brief Overloading of `select` method.
+    *
+    * This method is responsible to pick the best offer based on the `Accept`, `Accept-Encoding`,
+    * `Accept-Language` or `Accept-Charset` node of the HTTP Header. A missing `Accept-Encoding` node
+    * accepts `identity` only, the other missing nodes accept any offer.
+    *
+    * @param[in] header The request HTTP Header.
+    * @param[in] field The negotiated field.
+    * @param[in] offers The offered representations ordered by server preference.
+    * @param[in] count The number of offers.
+    * @return The index of the selected offer.
+    * @return `-1` if no offer is acceptable (`NOT_ACCEPTABLE`).
+    */
+    static int select(const HTTPHeader &header, HeaderNode::headerField_t field, const std::string_view *offers, size_t count);
+
+    /**
+    * @brief Gets the hash of the header value.
+    *
+    * This method is responsible to compute the 64 bit FNV-1a hash used as the cache key.
+    *
+    * @return The hash value.
+    */
+    static uint64_t hash(std::string_view value);
+};
+
+#endif
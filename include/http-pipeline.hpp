@@ -0,0 +1,170 @@
+/*
+ * $Id: http-pipeline.hpp,v 1.0.0 2026/10/18 13:31:08 Jaya Wikrama Exp $
+ *
+ * Copyright (c) 2024 Jaya Wikrama
+ * jayawikrama89@gmail.com
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *  claim that you wrote the original software. If you use this software
+ *  in a product, an acknowledgment in the product documentation would be
+ *  appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *  misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+/**
+ * @file
+ * @brief This file defines the HTTPPipeline class, which parses every complete pipelined request head
+ *        available in one read buffer and coalesces the responses into one `writev`.
+ *
+ * @version 1.0.0
+ * @date 2026-10-18
+ * @author Jaya Wikrama
+ */
+
+#ifndef __HTTP_PIPELINE_HPP__
+#define __HTTP_PIPELINE_HPP__
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <deque>
+#include <sys/types.h>
+#include "http-header.hpp"
+
+#define HTTP_PIPELINE_MAX_IOV 64
+
+class HTTPPipeline {
+  public:
+    typedef struct _batch_t {
+      HTTPHeader *headers;
+      size_t count;
+      size_t consumed;
+      bool malformed;
+      HttpStatus::Code_t status;
+    } batch_t;
+
+    /**
+    * @brief Default constructor for empty pipeline.
+    */
+    HTTPPipeline();
+
+    /**
+    * @brief Parse all complete request heads.
+    *
+    * This method is responsible to parse every complete request head available in the buffer in one call.
+    * Parsing stops after a request which carries a body (`Content-Length` greater than zero or
+    * `Transfer-Encoding`), because the body must be read before the next head. The returned headers are
+    * valid until the next call of `parse`. The scanned rows of an incomplete head are kept, so the next call
+    * must pass the buffer from the first byte which was not consumed.
+    *
+    * @param[in] buffer The received data.
+    * @param[in] length The length of the received data.
+    * @return The parsed headers, the number of bytes consumed by them, and the malformed flag which is set
+    * if the head after the parsed ones is malformed or exceeds the limits (the connection should be closed after
+    * the responses, with the rejection response of the status, see `getRejection`). An incomplete head which
+    * already exceeds the limits is rejected, so the caller stops reading.
+    */
+    HTTPPipeline::batch_t parse(const char *buffer, size_t length);
+
+    /**
+    * @brief Set the head limits.
+    *
+    * @param[in] limits The limits checked while the request heads are scanned (see `HTTPHeader::limits_t`).
+    */
+    void setLimits(const HTTPHeader::limits_t &limits);
+
+    /**
+    * @brief Gets the rejection response.
+    *
+    * @param[in] code The rejection status of the batch.
+    * @return The precompiled response (`400`, `414` or `431` with `Connection: close`) or an empty view.
+    */
+    static std::string_view getRejection(HttpStatus::Code_t code);
+
+    /**
+    * @brief Queue one response.
+    *
+    * This method is responsible to queue one serialized response, the pipeline takes the ownership of the data.
+    */
+    void queue(std::string &&response);
+
+    /**
+    * @brief Queue one response without copying it.
+    *
+    * This method is responsible to queue one serialized response (e.g. `HTTPStaticResponse`) which is owned by
+    * the caller. The data must be available until it is flushed.
+    */
+    void queue(const char *data, size_t length);
+
+    /**
+    * @brief Queue one shared response.
+    *
+    * This method is responsible to queue one serialized response which is shared with other pipelines (e.g. one
+    * WebSocket frame sent to many connections). The pipeline keeps a reference until the data is flushed.
+    */
+    void queue(std::shared_ptr<const std::string> response);
+
+    /**
+    * @brief Gets the write buffer.
+    *
+    * This method is responsible to return the last queued response if it is owned by the pipeline, otherwise a
+    * new empty owned response is queued. The data appended to the buffer is written by the next `flush`, so small
+    * writes (e.g. streamed events) are coalesced without one queued response per write.
+    *
+    * @return The write buffer.
+    */
+    std::string &getBuffer();
+
+    /**
+    * @brief Write the queued responses.
+    *
+    * This method is responsible to write all queued responses with as few `writev` calls as possible (one for up
+    * to `HTTP_PIPELINE_MAX_IOV` responses). On non-blocking socket, the unwritten data stays queued if the socket
+    * buffer is full.
+    *
+    * @param[in] fd The socket file descriptor.
+    * @return The number of bytes written.
+    * @return `-1` on fail (see `errno`).
+    */
+    ssize_t flush(int fd);
+
+    /**
+    * @brief Check the queued responses.
+    *
+    * @return `true` if some responses are not written yet.
+    * @return `false` if the queue is empty.
+    */
+    bool isPending() const;
+
+    /**
+    * @brief Remove all parsed headers and queued responses.
+    */
+    void clear();
+
+  private:
+    typedef struct _response_t {
+      std::string owned;
+      std::shared_ptr<const std::string> shared;
+      const char *data;
+      size_t length;
+    } response_t;
+
+    std::vector<HTTPHeader> headers;
+    std::deque<response_t> responses;
+    size_t offset;
+    HTTPHeader::limits_t limits;
+    HTTPHeader::scan_t scan;
+};
+
+#endif
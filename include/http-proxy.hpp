@@ -0,0 +1,173 @@
+/*
+ * $Id: http-proxy.hpp,v 1.0.0 2026/10/18 16:14:08 Jaya Wikrama Exp $
+ *
+ * Copyright (c) 2024 Jaya Wikrama
+ * jayawikrama89@gmail.com
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *  claim that you wrote the original software. If you use this software
+ *  in a product, an acknowledgment in the product documentation would be
+ *  appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *  misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+/**
+ * @file
+ * @brief This file defines the HTTPProxy class, a reverse proxy handler with pooled upstream connections.
+ *
+ * `forward` rewrites the parsed request in place (hop-by-hop fields are removed, `X-Forwarded-For`,
+ * `X-Forwarded-Proto` and `X-Real-IP` are set), writes it to a keep-alive connection of the upstream pool and
+ * relays the response to the client. The bodies keep their original framing and are moved between the sockets
+ * with `splice` through a pipe, so only the heads and the chunk size lines pass through user space.
+ *
+ * The sockets are used in blocking mode, `forward` is meant to run on the worker thread of the client
+ * connection. The upstream sockets get a send and receive timeout, so a stalled upstream fails the relay. The upstreams must be added before the proxy is shared between threads. `splice` can not suppress
+ * `SIGPIPE`, so the process should ignore it.
+ *
+ * Example:
+ * @code
+ * HTTPProxy proxy;
+ * size_t backend = proxy.addUpstream("127.0.0.1", 8080);
+ * HTTPProxy::result_t result = proxy.forward(fd, request, backend, peerAddress);
+ * if (result == HTTPProxy::BAD_REQUEST) send400(fd);
+ * else if (result == HTTPProxy::BAD_GATEWAY) send502(fd);
+ * @endcode
+ *
+ * @version 1.0.0
+ * @date 2026-10-18
+ * @author Jaya Wikrama
+ */
+
+#ifndef __HTTP_PROXY_HPP__
+#define __HTTP_PROXY_HPP__
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <sys/socket.h>
+#include "http-header.hpp"
+
+#define HTTP_PROXY_MAX_IDLE 16
+#define HTTP_PROXY_MAX_HEAD 16384
+#define HTTP_PROXY_SPLICE_SIZE 65536
+#define HTTP_PROXY_TIMEOUT 30000
+
+class HTTPProxy {
+  public:
+    typedef enum _result_t {
+      BAD_GATEWAY = 0,
+      COMPLETE,
+      CLOSE,
+      BAD_REQUEST
+    } result_t;
+
+    /**
+    * @brief Default constructor for empty upstream list.
+    */
+    HTTPProxy();
+
+    /**
+    * @brief Destructor.
+    *
+    * This method is responsible to close all idle upstream connections.
+    */
+    ~HTTPProxy();
+
+    HTTPProxy(const HTTPProxy &) = delete;
+    HTTPProxy &operator=(const HTTPProxy &) = delete;
+
+    /**
+    * @brief Add one upstream.
+    *
+    * This method is responsible to resolve the upstream address once and create its connection pool.
+    * This method will throw an error if the address can not be resolved.
+    *
+    * @param[in] host The upstream host name or address.
+    * @param[in] port The upstream port.
+    * @param[in] maxIdle The maximum number of idle keep-alive connections.
+    * @param[in] timeout The send and receive timeout of the upstream sockets in milliseconds (0 for none).
+    * @return The upstream index.
+    */
+    size_t addUpstream(const std::string &host, uint16_t port, size_t maxIdle = HTTP_PROXY_MAX_IDLE, uint32_t timeout = HTTP_PROXY_TIMEOUT);
+
+    /**
+    * @brief Forward one request.
+    *
+    * This method is responsible to rewrite the request, write it and its body (`Content-Length`) to the upstream
+    * and relay the response (interim responses, head and body) to the client. The upstream connection returns
+    * to the pool if the response allows it. A stale pooled connection is replaced once if the method is idempotent.
+    *
+    * @param[in] client The client socket.
+    * @param[in] request The parsed request header (it is rewritten in place).
+    * @param[in] upstream The upstream index.
+    * @param[in] clientAddress The client address for `X-Forwarded-For` and `X-Real-IP`.
+    * @param[in] secure `true` if the client connection uses TLS.
+    * @param[in] body The part of the request body which is already received with the head.
+    * @param[in] bodyLength The length of the received part of the request body.
+    * @return `HTTPProxy::COMPLETE` if the response is relayed and the client connection may be kept.
+    * @return `HTTPProxy::CLOSE` if the response ends with the upstream connection or the relay failed after the
+    * response head is written (the client connection must be closed).
+    * @return `HTTPProxy::BAD_GATEWAY` if nothing is written to the client (the caller should respond with 502).
+    * @return `HTTPProxy::BAD_REQUEST` if the request has differing `Content-Length` values, a control byte in a
+    * value or a `Connection` field which lists a framing field (the caller should respond with 400).
+    */
+    HTTPProxy::result_t forward(int client, HTTPHeader &request, size_t upstream, const std::string &clientAddress, bool secure = false, const char *body = nullptr, size_t bodyLength = 0);
+
+    /**
+    * @brief Rewrite the request for the upstream.
+    *
+    * This method is responsible to remove the hop-by-hop fields, append the client address to `X-Forwarded-For`
+    * and set `X-Forwarded-Proto` and `X-Real-IP`.
+    *
+    * @param[in] request The request header.
+    * @param[in] clientAddress The client address.
+    * @param[in] secure `true` if the client connection uses TLS.
+    * @return `false` if the hop-by-hop fields can not be removed (see `strip`).
+    */
+    static bool rewrite(HTTPHeader &request, const std::string &clientAddress, bool secure);
+
+    /**
+    * @brief Remove the hop-by-hop fields.
+    *
+    * This method is responsible to remove `Connection`, every field listed by `Connection`, `Keep-Alive`,
+    * `Proxy-Authenticate`, `Proxy-Authorization`, `TE`, `Trailer` and `Upgrade`. `Transfer-Encoding` is kept
+    * because the body is relayed with its original framing. The header is left as it is if `Connection` lists
+    * `Content-Length`, `Transfer-Encoding` or `Host`, removing them would change how the message is framed or
+    * routed by the next hop.
+    *
+    * @param[in] header The header.
+    * @return `true` on success.
+    * @return `false` if `Connection` lists `Content-Length`, `Transfer-Encoding` or `Host`.
+    */
+    static bool strip(HTTPHeader &header);
+
+  private:
+    typedef struct _upstream_t {
+      struct sockaddr_storage address;
+      socklen_t addressLength;
+      size_t maxIdle;
+      uint32_t timeout;
+      std::mutex lock;
+      std::vector<int> idle;
+    } upstream_t;
+
+    std::vector<std::unique_ptr<HTTPProxy::upstream_t>> upstreams;
+
+    int acquire(HTTPProxy::upstream_t &upstream, bool &reused);
+    void release(HTTPProxy::upstream_t &upstream, int fd);
+};
+
+#endif
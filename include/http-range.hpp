@@ -0,0 +1,199 @@
+/*
+ * $Id: http-range.hpp,v 1.0.0 2026/10/18 15:02:13 Jaya Wikrama Exp $
+ *
+ * Copyright (c) 2024 Jaya Wikrama
+ * jayawikrama89@gmail.com
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *  claim that you wrote the original software. If you use this software
+ *  in a product, an acknowledgment in the product documentation would be
+ *  appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *  misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+/**
+ * @file
+ * @brief This file defines the HTTPRange class, which serves a file or a cached body with `Range` support.
+ *
+ * `prepare` evaluates `Range` and `If-Range` of the request and completes the response header (status code,
+ * `Accept-Ranges`, `ETag`, `Last-Modified`, `Content-Range`, `Content-Length`). `send` then writes the head and
+ * the body without copying it:
+ *   - the full file and single ranges of the file are written with `sendfile` from the file offset,
+ *   - multiple ranges (`multipart/byteranges`) are written with `writev` over slices of the mapped file,
+ *   - cached bodies are written with `writev` over slices of the body.
+ *
+ * Example:
+ * @code
+ * HTTPRange range;
+ * HTTPHeader response(HeaderNode::CONTENT_TYPE, "video/mp4");
+ * if (range.open("/srv/video.mp4")){
+ *   range.prepare(request, response);
+ *   while (!range.isComplete() && range.send(fd) >= 0) wait_writable(fd);
+ * }
+ * @endcode
+ *
+ * @version 1.0.0
+ * @date 2026-10-18
+ * @author Jaya Wikrama
+ */
+
+#ifndef __HTTP_RANGE_HPP__
+#define __HTTP_RANGE_HPP__
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <sys/types.h>
+#include "http-header.hpp"
+
+#define HTTP_RANGE_MAX 16
+
+class HTTPRange {
+  public:
+    typedef enum _status_t {
+      INVALID = 0,
+      SATISFIABLE,
+      UNSATISFIABLE
+    } status_t;
+
+    typedef struct _range_t {
+      uint64_t first;
+      uint64_t last;
+    } range_t;
+
+    /**
+    * @brief Default constructor for empty source.
+    */
+    HTTPRange();
+
+    /**
+    * @brief Destructor.
+    *
+    * This method is responsible to close and unmap the file.
+    */
+    ~HTTPRange();
+
+    HTTPRange(const HTTPRange &) = delete;
+    HTTPRange &operator=(const HTTPRange &) = delete;
+
+    /**
+    * @brief Use the file as source.
+    *
+    * This method is responsible to open the file and create the validators (`ETag` from the size and the
+    * modification time, `Last-Modified` from the modification time).
+    *
+    * @param[in] path The file path.
+    * @return `true` in success.
+    * @return `false` if the file is not a readable regular file.
+    */
+    bool open(const std::string &path);
+
+    /**
+    * @brief Use the cached body as source.
+    *
+    * @param[in] body The body (shared with the cache).
+    * @param[in] etag The entity tag (including the quotes) or empty string.
+    * @param[in] lastModified The modification time (Unix epoch) or `-1`.
+    */
+    void assign(std::shared_ptr<const std::string> body, const std::string &etag, long lastModified);
+
+    /**
+    * @brief Prepare the response of the request.
+    *
+    * This method is responsible to evaluate the `Range` and `If-Range` of the request, complete the response
+    * header and plan the body. The response header may contain the `Content-Type` of the source. An invalid
+    * `Range`, a failed `If-Range`, more than `HTTP_RANGE_MAX` ranges or a request other than `GET` gets the
+    * full source. Overlapping and adjacent ranges are coalesced (RFC 9110 section 15.3.7.2), so no byte of the
+    * source is sent twice.
+    *
+    * @param[in] request The request header.
+    * @param[in] response The response header.
+    * @return `HttpStatus::OK`, `HttpStatus::PARTIAL_CONTENT` or `HttpStatus::RANGE_NOT_SATISFIABLE`.
+    */
+    HttpStatus::Code_t prepare(const HTTPHeader &request, HTTPHeader &response);
+
+    /**
+    * @brief Send the prepared response.
+    *
+    * This method is responsible to write the prepared head and body. On non-blocking socket, the method returns
+    * when the socket buffer is full and continues from the same position in the next call.
+    *
+    * @param[in] fd The socket file descriptor.
+    * @return The number of bytes written in this call.
+    * @return `-1` on fail (see `errno`).
+    */
+    ssize_t send(int fd);
+
+    /**
+    * @brief Check the prepared response.
+    *
+    * @return `true` if the whole prepared response is written.
+    * @return `false` if some data is not written yet.
+    */
+    bool isComplete() const;
+
+    /**
+    * @brief Gets the source size.
+    *
+    * @return The number of bytes of the source.
+    */
+    uint64_t getSize() const;
+
+    /**
+    * @brief Gets the source entity tag.
+    *
+    * @return The entity tag (including the quotes).
+    */
+    const std::string &getETag() const;
+
+    /**
+    * @brief Parse the `Range` value.
+    *
+    * This method is responsible to parse the byte ranges (`bytes=0-499`, `bytes=500-`, `bytes=-500` and the comma
+    * separated lists of them) of the source size. The ranges are clipped to the source.
+    *
+    * @param[in] value The `Range` value.
+    * @param[in] size The source size.
+    * @param[out] ranges The satisfiable ranges (inclusive).
+    * @return `HTTPRange::SATISFIABLE` if at least one range is satisfiable.
+    * @return `HTTPRange::UNSATISFIABLE` if no range is satisfiable.
+    * @return `HTTPRange::INVALID` if the value is malformed (the `Range` must be ignored).
+    */
+    static HTTPRange::status_t parse(const std::string &value, uint64_t size, std::vector<HTTPRange::range_t> &ranges);
+
+  private:
+    typedef struct _segment_t {
+      const char *data;
+      uint64_t offset;
+      uint64_t length;
+    } segment_t;
+
+    int fd;
+    void *mapping;
+    uint64_t size;
+    long lastModified;
+    std::string etag;
+    std::shared_ptr<const std::string> body;
+    std::string head;
+    std::vector<std::string> parts;
+    std::vector<segment_t> segments;
+    size_t current;
+    uint64_t written;
+
+    void release();
+    const char *getData();
+};
+
+#endif
@@ -0,0 +1,173 @@
+/*
+ * $Id: http-rate-limit.hpp,v 1.0.0 2026/10/18 17:06:12 Jaya Wikrama Exp $
+ *
+ * Copyright (c) 2024 Jaya Wikrama
+ * jayawikrama89@gmail.com
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *  claim that you wrote the original software. If you use this software
+ *  in a product, an acknowledgment in the product documentation would be
+ *  appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *  misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+/**
+ * @file
+ * @brief This file defines the HTTPRateLimiter class, a lock-free token bucket table for admission control.
+ *
+ * Every bucket is one 64-bit word updated with compare-and-swap: a 16-bit key tag and the theoretical arrival
+ * time of the next request (GCRA, the single timestamp form of the token bucket). The full 64-bit key hash sits
+ * next to it and is compared on every match, so keys which only share the short tag never share a bucket. The
+ * keys are hashed with SipHash-2-4 under a random per-process secret, so a client can not pick a key which
+ * collides with the key of another client. The buckets are grouped in shards of `HTTP_RATE_LIMIT_SHARD_SLOTS`
+ * slots (the bucket words share one cache line, the hashes the next one), a key probes only its shard and takes
+ * over an idle (full) bucket of another key. When every bucket of the shard is busy, the new key evicts the bucket which
+ * is nearest to idle.
+ *
+ * The key is the client address (the `X-Forwarded-For` / `X-Real-IP` of trusted proxies are taken into account)
+ * or the value of the configured API key field. A rejected request is answered with a precompiled
+ * `429 Too Many Requests` response carrying `Retry-After`, before routing or reading the body.
+ *
+ * Example:
+ * @code
+ * HTTPRateLimiter limiter(50.0, 100.0);
+ * limiter.addTrustedProxy("10.0.0.0/8");
+ * uint32_t retryAfter = limiter.admit(request, peerAddress);
+ * if (retryAfter > 0){
+ *   std::string_view response = HTTPRateLimiter::getResponse(retryAfter);
+ *   write(fd, response.data(), response.size());
+ * }
+ * @endcode
+ *
+ * @version 1.0.0
+ * @date 2026-10-18
+ * @author Jaya Wikrama
+ */
+
+#ifndef __HTTP_RATE_LIMIT_HPP__
+#define __HTTP_RATE_LIMIT_HPP__
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "http-header.hpp"
+
+#define HTTP_RATE_LIMIT_CAPACITY 65536
+#define HTTP_RATE_LIMIT_SHARD_SLOTS 8
+#define HTTP_RATE_LIMIT_MAX_RETRY 60
+
+class HTTPRateLimiter {
+  public:
+    /**
+    * @brief Custom constructor.
+    *
+    * This method will throw an error if the rate is not positive or the burst is less than one request.
+    *
+    * @param[in] rate The sustained rate in requests per second.
+    * @param[in] burst The bucket size in requests.
+    * @param[in] capacity The number of buckets (rounded up to a power of two).
+    */
+    HTTPRateLimiter(double rate, double burst, size_t capacity = HTTP_RATE_LIMIT_CAPACITY);
+
+    /**
+    * @brief Add one trusted proxy.
+    *
+    * This method is responsible to add the address or the network (CIDR notation) of a proxy whose
+    * `X-Forwarded-For` and `X-Real-IP` are trusted. The proxies must be added before the limiter is shared
+    * between threads.
+    *
+    * @param[in] network The address (e.g. `10.0.0.1`) or the network (e.g. `10.0.0.0/8`, `fd00::/8`).
+    * @return `true` in success.
+    * @return `false` if the network is malformed.
+    */
+    bool addTrustedProxy(const std::string &network);
+
+    /**
+    * @brief Use the API key as the bucket key.
+    *
+    * This method is responsible to set the field which carries the API key (e.g. `Authorization` or an
+    * extension field). Requests without the field are keyed by the client address.
+    *
+    * @param[in] field The API key field or `HeaderNode::UNKNOWN` to key by the client address only.
+    */
+    void setKeyField(HeaderNode::headerField_t field);
+
+    /**
+    * @brief Gets the client address.
+    *
+    * This method is responsible to return the peer address, or, if the peer is a trusted proxy, the nearest
+    * untrusted address of `X-Forwarded-For` (or `X-Real-IP` if it is missing).
+    *
+    * @param[in] request The request header.
+    * @param[in] peerAddress The address of the connected peer.
+    * @return The client address.
+    */
+    std::string getClientAddress(const HTTPHeader &request, const std::string &peerAddress) const;
+
+    /**
+    * @brief Take one token for the request.
+    *
+    * @param[in] request The request header.
+    * @param[in] peerAddress The address of the connected peer.
+    * @return `0` if the request is admitted.
+    * @return The number of seconds until the next token (for `Retry-After`) if the request is rejected.
+    */
+    uint32_t admit(const HTTPHeader &request, const std::string &peerAddress);
+
+    /**
+    * @brief Take one token of the key.
+    *
+    * @param[in] key The bucket key.
+    * @return `0` if the request is admitted.
+    * @return The number of seconds until the next token (for `Retry-After`) if the request is rejected.
+    */
+    uint32_t admit(std::string_view key);
+
+    /**
+    * @brief Gets the precompiled rejection.
+    *
+    * @param[in] retryAfter The `Retry-After` seconds (clamped to `1` ... `HTTP_RATE_LIMIT_MAX_RETRY`).
+    * @return The serialized `429 Too Many Requests` response.
+    */
+    static std::string_view getResponse(uint32_t retryAfter);
+
+  private:
+    typedef struct _network_t {
+      int family;
+      uint8_t address[16];
+      unsigned int prefix;
+    } network_t;
+
+    typedef struct alignas(64) _shard_t {
+      std::atomic<uint64_t> slot[HTTP_RATE_LIMIT_SHARD_SLOTS];
+      /* the full key hash of every bucket, written by the request which takes the bucket over */
+      std::atomic<uint64_t> hash[HTTP_RATE_LIMIT_SHARD_SLOTS];
+    } shard_t;
+
+    std::unique_ptr<HTTPRateLimiter::shard_t[]> shards;
+    size_t mask;
+    uint64_t interval;
+    uint64_t tolerance;
+    std::vector<HTTPRateLimiter::network_t> trusted;
+    HeaderNode::headerField_t keyField;
+
+    bool isTrusted(std::string_view address) const;
+    std::string_view findClientAddress(const HTTPHeader &request, std::string_view peerAddress) const;
+    uint32_t take(uint64_t hash);
+};
+
+#endif
@@ -0,0 +1,173 @@
+/*
+ * $Id: http-response-cache.hpp,v 1.0.0 2026/10/18 14:34:50 Jaya Wikrama Exp $
+ *
+ * Copyright (c) 2024 Jaya Wikrama
+ * jayawikrama89@gmail.com
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *  claim that you wrote the original software. If you use this software
+ *  in a product, an acknowledgment in the product documentation would be
+ *  appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *  misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+/**
+ * @file
+ * @brief This file defines the HTTPResponseCache class, a shared in-memory cache of fully serialized responses.
+ *
+ * The cache key is the method, the `Host` and the target of the request plus the request values of every field
+ * named in the `Vary` of the cached response. Only `GET` and `HEAD` responses with `Cache-Control: max-age`
+ * (or `s-maxage`) are stored, `no-store`, `no-cache`, `private` and `Vary: *` responses are never stored. The
+ * response of a request with `Authorization` is stored only if it is explicitly shareable (`public`, `s-maxage`
+ * or `must-revalidate`, RFC 9111 section 3.5). The `Age` of a hit is the age of the stored response plus the
+ * time it spent in the cache.
+ *
+ * A fresh entry answers conditional requests (`If-None-Match`, `If-Modified-Since`) with a prebuilt
+ * `304 Not Modified` response, so the handler is not called at all.
+ *
+ * The cache is split in shards (each with its own lock and byte budget) and every shard evicts with the CLOCK
+ * algorithm.
+ *
+ * Example:
+ * @code
+ * std::shared_ptr<const std::string> cached;
+ * if (cache.lookup(request, cached) != HTTPResponseCache::MISS) send(fd, cached->data(), cached->length(), 0);
+ * else {
+ *   ... call the handler ...
+ *   cache.store(request, response, body);
+ * }
+ * @endcode
+ *
+ * @version 1.0.0
+ * @date 2026-10-18
+ * @author Jaya Wikrama
+ */
+
+#ifndef __HTTP_RESPONSE_CACHE_HPP__
+#define __HTTP_RESPONSE_CACHE_HPP__
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "http-header.hpp"
+
+#define HTTP_RESPONSE_CACHE_SHARD 16
+
+class HTTPResponseCache {
+  public:
+    typedef enum _result_t {
+      MISS = 0,
+      HIT,
+      NOT_MODIFIED
+    } result_t;
+
+    /**
+    * @brief Custom constructor.
+    *
+    * @param[in] budget The maximum number of bytes of all cached responses.
+    * @param[in] shards The number of shards (the budget is shared equally).
+    */
+    HTTPResponseCache(size_t budget, size_t shards = HTTP_RESPONSE_CACHE_SHARD);
+
+    HTTPResponseCache(const HTTPResponseCache &) = delete;
+    HTTPResponseCache &operator=(const HTTPResponseCache &) = delete;
+
+    /**
+    * @brief Find the response of the request.
+    *
+    * This method is responsible to find the fresh response of the request and evaluate the conditional fields.
+    * A request with `Cache-Control: no-cache` or `no-store` (or `Pragma: no-cache` without `Cache-Control`)
+    * always misses.
+    *
+    * @param[in] request The request header.
+    * @param[out] response The serialized response (the cached response or the `304 Not Modified` response).
+    * @return `HTTPResponseCache::HIT` if the cached response is available.
+    * @return `HTTPResponseCache::NOT_MODIFIED` if the conditional request matches the cached response.
+    * @return `HTTPResponseCache::MISS` if the handler must be called.
+    */
+    HTTPResponseCache::result_t lookup(const HTTPHeader &request, std::shared_ptr<const std::string> &response);
+
+    /**
+    * @brief Store the response of the request.
+    *
+    * This method is responsible to serialize and store the response if it is cacheable.
+    *
+    * @param[in] request The request header.
+    * @param[in] response The response header.
+    * @param[in] body The response body.
+    * @return `true` if the response is stored.
+    * @return `false` if the response is not cacheable or larger than the shard budget.
+    */
+    bool store(const HTTPHeader &request, HTTPHeader &response, const std::string &body);
+
+    /**
+    * @brief Remove all cached responses.
+    */
+    void clear();
+
+    /**
+    * @brief Gets the number of bytes of all cached responses.
+    *
+    * @return The number of bytes.
+    */
+    size_t getSize();
+
+  private:
+    typedef struct _slot_t {
+      /* the key starts with the primary key, the selecting values of the Vary fields follow */
+      std::string key;
+      size_t primaryLength;
+      std::shared_ptr<const std::string> response;
+      std::shared_ptr<const std::string> notModified;
+      std::string etag;
+      long lastModified;
+      uint64_t expire;
+      /* the Age value of the response is rewritten (once per second) on hit */
+      uint64_t stored;
+      long age;
+      long served;
+      size_t agePosition;
+      size_t ageLength;
+      bool referenced;
+      bool used;
+    } slot_t;
+
+    /* the Vary fields of a primary key live as long as one of its variants */
+    typedef struct _vary_t {
+      std::vector<std::string> fields;
+      size_t variants;
+    } vary_t;
+
+    typedef struct _shard_t {
+      std::mutex mutex;
+      std::unordered_map<std::string, HTTPResponseCache::vary_t> vary;
+      std::unordered_map<std::string, size_t> index;
+      std::vector<slot_t> ring;
+      std::vector<size_t> free;
+      size_t hand;
+      size_t size;
+    } shard_t;
+
+    std::vector<std::unique_ptr<shard_t>> shards;
+    size_t budget;
+
+    void evict(shard_t &shard, size_t position);
+    void evictPrimary(shard_t &shard, const std::string &primary);
+    void refreshAge(shard_t &shard, slot_t &slot);
+};
+
+#endif
@@ -0,0 +1,152 @@
+/*
+ * $Id: http-simd.hpp,v 1.0.0 2026/10/18 17:52:10 Jaya Wikrama Exp $
+ *
+ * Copyright (c) 2024 Jaya Wikrama
+ * jayawikrama89@gmail.com
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *  claim that you wrote the original software. If you use this software
+ *  in a product, an acknowledgment in the product documentation would be
+ *  appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *  misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+/**
+ * @file
+ * @brief This file defines the HTTPSimd class, the vectorized kernels with runtime CPU feature dispatch.
+ *
+ * The library is built for the baseline of the target architecture, so one package runs on every host. The hot
+ * kernels (byte scanning, ASCII lowercasing, token validation, WebSocket unmasking and CRC-32C hashing) are
+ * compiled in several variants with the `target` attribute and the best variant supported by the CPU is selected
+ * once, when the library is loaded. Until then (e.g. from the static initializers of other libraries) the scalar
+ * variant is used.
+ *
+ * `verify` runs every variant supported by the CPU against the scalar reference.
+ *
+ * Example:
+ * @code
+ * size_t end = HTTPSimd::find(data, length, '\r', '\n');
+ * HTTPSimd::lower(token, tokenLength);
+ * std::string path;
+ * if (!HTTPSimd::percentDecode(target, targetLength, path)) reject();
+ * @endcode
+ *
+ * @version 1.0.0
+ * @date 2026-10-18
+ * @author Jaya Wikrama
+ */
+
+#ifndef __HTTP_SIMD_HPP__
+#define __HTTP_SIMD_HPP__
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+class HTTPSimd {
+  public:
+    typedef enum _level_t {
+      SCALAR = 0,
+      SSE2,
+      AVX2
+    } level_t;
+
+    /**
+    * @brief Gets the selected variant.
+    *
+    * @return The instruction set of the selected variant.
+    */
+    static HTTPSimd::level_t getLevel();
+
+    /**
+    * @brief Find the first of two bytes.
+    *
+    * @param[in] data The input.
+    * @param[in] length The length of the input.
+    * @param[in] first The first byte to find.
+    * @param[in] second The second byte to find (pass `first` again to find one byte).
+    * @return The position of the first match or `length` if there is none.
+    */
+    static size_t find(const char *data, size_t length, char first, char second);
+
+    /**
+    * @brief Lowercase the ASCII letters in place.
+    *
+    * @param[in,out] data The input.
+    * @param[in] length The length of the input.
+    */
+    static void lower(char *data, size_t length);
+
+    /**
+    * @brief Apply the XOR mask in place.
+    *
+    * This method is responsible to XOR the input with the repeated 4 byte pattern (the first byte of the pattern
+    * in memory is applied to the first byte of the input), as used by the WebSocket frames.
+    *
+    * @param[in,out] data The input.
+    * @param[in] length The length of the input.
+    * @param[in] pattern The 4 byte pattern.
+    */
+    static void mask(char *data, size_t length, uint32_t pattern);
+
+    /**
+    * @brief Compute the CRC-32C (Castagnoli) checksum.
+    *
+    * @param[in] data The input.
+    * @param[in] length The length of the input.
+    * @param[in] crc The checksum of the previous input (to continue a checksum) or `0`.
+    * @return The checksum.
+    */
+    static uint32_t crc32c(const char *data, size_t length, uint32_t crc = 0);
+
+    /**
+    * @brief Decode the percent-encoded input.
+    *
+    * This method is responsible to append the decoded input to the output. The runs without escapes are copied
+    * as a whole, they are found with `find`.
+    *
+    * @param[in] data The input.
+    * @param[in] length The length of the input.
+    * @param[out] output The decoded input is appended here.
+    * @param[in] plus `true` to decode `+` as space (`application/x-www-form-urlencoded`).
+    * @return `true` in success.
+    * @return `false` if the input has a malformed escape (the output is left unchanged).
+    */
+    static bool percentDecode(const char *data, size_t length, std::string &output, bool plus = false);
+
+    /**
+    * @brief Validate and lowercase the token.
+    *
+    * This method is responsible to copy the leading token characters (RFC 7230 `tchar`) of the input to the output
+    * in lowercase, one pass over the input. The vector variants write whole vectors, so the output bytes after the
+    * token (up to `length`) are unspecified.
+    *
+    * @param[in] data The input.
+    * @param[in] length The length of the input.
+    * @param[out] output The lowercased token (at least `length` bytes).
+    * @return The length of the token (the position of the first byte which is not a `tchar` or `length`).
+    */
+    static size_t lowerToken(const char *data, size_t length, char *output);
+
+    /**
+    * @brief Verify the variants.
+    *
+    * This method is responsible to run every kernel of every variant supported by the CPU against the scalar
+    * reference with generated inputs (all byte values, lengths and alignments around the vector widths).
+    *
+    * @return `true` if every variant matches the scalar reference.
+    */
+    static bool verify();
+};
+
+#endif
@@ -0,0 +1,205 @@
+/*
+ * $Id: http-static-response.hpp,v 1.0.0 2026/10/18 11:58:21 Jaya Wikrama Exp $
+ *
+ * Copyright (c) 2024 Jaya Wikrama
+ * jayawikrama89@gmail.com
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *  claim that you wrote the original software. If you use this software
+ *  in a product, an acknowledgment in the product documentation would be
+ *  appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *  misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+/**
+ * @file
+ * @brief This file defines the HTTPStaticResponse class template, a fully serialized response built at
+ *        compile time (health checks, error pages, redirects, preflight replies).
+ *
+ * Example:
+ * @code
+ * static constexpr auto notFound = HTTPStaticResponse<256>::build(
+ *   HttpStatus::NOT_FOUND, "Not Found",
+ *   HeaderNode::CONTENT_TYPE, "text/plain",
+ *   HeaderNode::CONNECTION, "keep-alive"
+ * );
+ * notFound.send(fd);
+ * @endcode
+ *
+ * `Content-Length` is always generated from the body, except for the status codes which never carry
+ * a body (1xx, 204 and 304). A payload larger than the capacity fails to compile.
+ *
+ * @version 1.0.0
+ * @date 2026-10-18
+ * @author Jaya Wikrama
+ */
+
+#ifndef __HTTP_STATIC_RESPONSE_HPP__
+#define __HTTP_STATIC_RESPONSE_HPP__
+
+#include <cstddef>
+#include <cerrno>
+#include <stdexcept>
+#include <string_view>
+#include <unistd.h>
+#include "http-header-node.hpp"
+#include "http-code.hpp"
+
+template <size_t N = 512>
+class HTTPStaticResponse {
+  public:
+    /**
+    * @brief Default constructor for empty response.
+    */
+    constexpr HTTPStaticResponse() : payload{}, length(0) {}
+
+    /**
+    * @brief Build the response without body.
+    *
+    * This method is responsible to serialize the status line and the field/value pairs at compile time.
+    *
+    * @param[in] code The HTTP Status Code.
+    * @param[in] pairs The list of `HeaderNode::headerField_t` and string literal value pairs.
+    * @return The serialized response.
+    */
+    template <typename... Pairs>
+    static constexpr HTTPStaticResponse build(HttpStatus::Code_t code, Pairs... pairs){
+      return HTTPStaticResponse::buildWithBody(code, "", pairs...);
+    }
+
+    /**
+    * @brief Build the response with body.
+    *
+    * This method is responsible to serialize the status line, the field/value pairs, the `Content-Length`
+    * and the body at compile time.
+    *
+    * @param[in] code The HTTP Status Code.
+    * @param[in] body The body (string literal).
+    * @param[in] pairs The list of `HeaderNode::headerField_t` and string literal value pairs.
+    * @return The serialized response.
+    */
+    template <typename... Pairs>
+    static constexpr HTTPStaticResponse buildWithBody(HttpStatus::Code_t code, const char *body, Pairs... pairs){
+      static_assert(sizeof...(Pairs) % 2 == 0, "HTTPStaticResponse: field without value");
+      HTTPStaticResponse response;
+      size_t bodyLength = HTTPStaticResponse::measure(body);
+      response.write("HTTP/1.1 ");
+      response.write(static_cast<long>(code));
+      response.write(" ");
+      response.write(HttpStatus::getReasonPhrase(code));
+      response.write("\r\n");
+      response.writePairs(pairs...);
+      if (!(code < 200 || code == HttpStatus::NO_CONTENT || code == HttpStatus::NOT_MODIFIED)){
+        response.write(fieldName[HeaderNode::CONTENT_LENGTH]);
+        response.write(": ");
+        response.write(static_cast<long>(bodyLength));
+        response.write("\r\n");
+      }
+      response.write("\r\n");
+      response.write(body);
+      return response;
+    }
+
+    /**
+    * @brief Gets the serialized response.
+    *
+    * @return The pointer to the first byte.
+    */
+    constexpr const char *data() const {
+      return this->payload;
+    }
+
+    /**
+    * @brief Gets the serialized response length.
+    *
+    * @return The number of bytes.
+    */
+    constexpr size_t size() const {
+      return this->length;
+    }
+
+    /**
+    * @brief Gets the serialized response as view.
+    *
+    * @return The serialized response.
+    */
+    constexpr std::string_view view() const {
+      return std::string_view(this->payload, this->length);
+    }
+
+    /**
+    * @brief Send the response.
+    *
+    * This method is responsible to write the whole serialized response to the file descriptor. Normally this
+    * is a single `write` call, the call is repeated only for partial writes and `EINTR`.
+    *
+    * @param[in] fd The socket file descriptor.
+    * @return The number of bytes written or `-1` on fail (see `errno`).
+    */
+    ssize_t send(int fd) const {
+      size_t written = 0;
+      while (written < this->length){
+        ssize_t ret = ::write(fd, this->payload + written, this->length - written);
+        if (ret < 0){
+          if (errno == EINTR) continue;
+          return (written > 0 ? static_cast<ssize_t>(written) : -1);
+        }
+        written += static_cast<size_t>(ret);
+      }
+      return static_cast<ssize_t>(written);
+    }
+
+  private:
+    char payload[N];
+    size_t length;
+
+    static constexpr size_t measure(const char *text){
+      size_t i = 0;
+      while (text[i] != 0x00) i++;
+      return i;
+    }
+
+    constexpr void write(const char *text){
+      for (size_t i = 0; text[i] != 0x00; i++){
+        if (this->length >= N) throw std::length_error("HTTPStaticResponse: capacity exceeded");
+        this->payload[this->length++] = text[i];
+      }
+    }
+
+    constexpr void write(long number){
+      char digits[24] = {};
+      int count = 0;
+      if (number == 0) digits[count++] = '0';
+      while (number > 0){
+        digits[count++] = static_cast<char>('0' + (number % 10));
+        number /= 10;
+      }
+      while (count > 0){
+        char text[2] = { digits[--count], 0x00 };
+        this->write(text);
+      }
+    }
+
+    constexpr void writePairs(){}
+
+    template <typename... Pairs>
+    constexpr void writePairs(HeaderNode::headerField_t field, const char *value, Pairs... pairs){
+      this->write(fieldName[field]);
+      this->write(": ");
+      this->write(value);
+      this->write("\r\n");
+      this->writePairs(pairs...);
+    }
+};
+
+#endif
@@ -0,0 +1,223 @@
+/*
+ * $Id: http-timer-wheel.hpp,v 1.0.0 2026/10/18 14:10:26 Jaya Wikrama Exp $
+ *
+ * Copyright (c) 2024 Jaya Wikrama
+ * jayawikrama89@gmail.com
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *  claim that you wrote the original software. If you use this software
+ *  in a product, an acknowledgment in the product documentation would be
+ *  appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *  misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+/**
+ * @file
+ * @brief This file defines the HTTPTimer and HTTPTimerWheel classes, the per-connection timeouts of one reactor
+ *        (event loop thread).
+ *
+ * The wheel is hierarchical (4 levels of 256 slots), so schedule, reset and cancel are O(1) and the timers are
+ * intrusive (embedded in the connection), so they never allocate. The reactor uses `getTimeout` as the wait
+ * timeout (e.g. `epoll_wait`) and calls `advance` after every wake up.
+ *
+ * Example:
+ * @code
+ * HTTPTimerWheel wheel;
+ * wheel.schedule(connection->timer, HTTPTimer::HEADER_READ);
+ * for (;;){
+ *   int n = epoll_wait(epfd, events, 64, wheel.getTimeout(HTTPTimerWheel::now()));
+ *   ...
+ *   wheel.advance(HTTPTimerWheel::now(), onTimeout, nullptr);
+ * }
+ * @endcode
+ *
+ * The wheel is not thread safe, each reactor owns its wheel.
+ *
+ * @version 1.0.0
+ * @date 2026-10-18
+ * @author Jaya Wikrama
+ */
+
+#ifndef __HTTP_TIMER_WHEEL_HPP__
+#define __HTTP_TIMER_WHEEL_HPP__
+
+#include <cstddef>
+#include <cstdint>
+
+#define HTTP_TIMER_WHEEL_LEVEL 4
+#define HTTP_TIMER_WHEEL_SLOT 256
+#define HTTP_TIMER_WHEEL_RESOLUTION 10
+#define HTTP_TIMEOUT_HEADER_READ 10000
+#define HTTP_TIMEOUT_KEEP_ALIVE 5000
+#define HTTP_TIMEOUT_WRITE_STALL 30000
+#define HTTP_TIMEOUT_EVENT_PING 15000
+
+class HTTPTimerWheel;
+
+class HTTPTimer {
+  public:
+    typedef enum _kind_t {
+      HEADER_READ = 0,
+      KEEP_ALIVE,
+      WRITE_STALL,
+      EVENT_PING,
+      SZ_KIND
+    } kind_t;
+
+    HTTPTimer::kind_t kind;
+    void *data;
+
+    /**
+    * @brief Default constructor for idle timer.
+    *
+    * @param[in] data The user data (e.g. the connection), available in the expired handler.
+    */
+    HTTPTimer(void *data = nullptr);
+
+    /**
+    * @brief Destructor.
+    *
+    * This method is responsible to cancel the timer if it is still scheduled.
+    */
+    ~HTTPTimer();
+
+    HTTPTimer(const HTTPTimer &) = delete;
+    HTTPTimer &operator=(const HTTPTimer &) = delete;
+
+    /**
+    * @brief Check the timer state.
+    *
+    * @return `true` if the timer is scheduled.
+    * @return `false` if the timer is idle (cancelled or expired).
+    */
+    bool isPending() const;
+
+  private:
+    friend class HTTPTimerWheel;
+
+    HTTPTimer *next;
+    HTTPTimer **prev;
+    HTTPTimerWheel *wheel;
+    uint64_t expire;
+};
+
+class HTTPTimerWheel {
+  public:
+    typedef void (*handler_t)(HTTPTimer &timer, void *context);
+
+    /**
+    * @brief Default constructor.
+    *
+    * @param[in] resolution The tick length in milliseconds.
+    */
+    HTTPTimerWheel(uint64_t resolution = HTTP_TIMER_WHEEL_RESOLUTION);
+
+    /**
+    * @brief Destructor.
+    *
+    * This method is responsible to detach all scheduled timers.
+    */
+    ~HTTPTimerWheel();
+
+    HTTPTimerWheel(const HTTPTimerWheel &) = delete;
+    HTTPTimerWheel &operator=(const HTTPTimerWheel &) = delete;
+
+    /**
+    * @brief Set the timeout of the timer kind.
+    *
+    * @param[in] kind The timer kind.
+    * @param[in] timeout The timeout in milliseconds.
+    */
+    void setTimeout(HTTPTimer::kind_t kind, uint64_t timeout);
+
+    /**
+    * @brief Schedule or reset the timer.
+    *
+    * This method is responsible to (re)schedule the timer to expire after the timeout of the kind. A scheduled timer
+    * is moved, so resetting a keep-alive timer is O(1). The header read timer should be scheduled once per request
+    * and not reset on every received byte, otherwise a slow client keeps the connection open forever.
+    *
+    * @param[in] timer The timer.
+    * @param[in] kind The timer kind.
+    */
+    void schedule(HTTPTimer &timer, HTTPTimer::kind_t kind);
+
+    /**
+    * @brief Schedule or reset the timer with explicit timeout.
+    *
+    * The timeout counts from the current time, also if `advance` was not called for a while.
+    *
+    * @param[in] timer The timer.
+    * @param[in] kind The timer kind.
+    * @param[in] timeout The timeout in milliseconds.
+    */
+    void schedule(HTTPTimer &timer, HTTPTimer::kind_t kind, uint64_t timeout);
+
+    /**
+    * @brief Cancel the timer.
+    *
+    * @param[in] timer The timer (cancelling an idle timer has no effect).
+    */
+    void cancel(HTTPTimer &timer);
+
+    /**
+    * @brief Expire the timers.
+    *
+    * This method is responsible to move the wheel to the time and call the handler for every expired timer. The timer
+    * is idle when the handler is called, so the handler may schedule it again or destroy it.
+    *
+    * @param[in] now The current time in milliseconds (see `now`).
+    * @param[in] handler The expired handler.
+    * @param[in] context The handler context.
+    * @return The number of expired timers.
+    */
+    size_t advance(uint64_t now, HTTPTimerWheel::handler_t handler, void *context);
+
+    /**
+    * @brief Gets the wait timeout for the event loop.
+    *
+    * This method is responsible to get the time until the wheel must be advanced. It never sleeps past the next
+    * expiry, but it may return earlier (at the next cascade of the upper levels).
+    *
+    * @param[in] now The current time in milliseconds (see `now`).
+    * @return The timeout in milliseconds or `-1` if no timer is scheduled.
+    */
+    int getTimeout(uint64_t now) const;
+
+    /**
+    * @brief Gets the number of scheduled timers.
+    *
+    * @return The number of scheduled timers.
+    */
+    size_t size() const;
+
+    /**
+    * @brief Gets the monotonic time.
+    *
+    * @return The coarse monotonic time in milliseconds.
+    */
+    static uint64_t now();
+
+  private:
+    HTTPTimer *slot[HTTP_TIMER_WHEEL_LEVEL][HTTP_TIMER_WHEEL_SLOT];
+    uint64_t timeout[HTTPTimer::SZ_KIND];
+    uint64_t resolution;
+    uint64_t current;
+    size_t count;
+
+    void link(HTTPTimer &timer);
+    void unlink(HTTPTimer &timer);
+    void cascade(int level);
+};
+
+#endif
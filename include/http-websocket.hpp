@@ -0,0 +1,237 @@
+/*
+ * $Id: http-websocket.hpp,v 1.0.0 2026/10/18 15:52:31 Jaya Wikrama Exp $
+ *
+ * Copyright (c) 2024 Jaya Wikrama
+ * jayawikrama89@gmail.com
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *  claim that you wrote the original software. If you use this software
+ *  in a product, an acknowledgment in the product documentation would be
+ *  appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *  misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+/**
+ * @file
+ * @brief This file defines the HTTPWebSocket class, the WebSocket (RFC 6455) handshake and frame codec.
+ *
+ * `handshake` validates the upgrade request and completes the `101 Switching Protocols` response. After the
+ * response is written, the received data is fed to `feed` which decodes the frames, unmasks the payload (16 or
+ * 32 bytes per step with SSE2 or AVX2, see `HTTPSimd`), reassembles the fragmented messages and calls the message handler once
+ * per message or control frame.
+ *
+ * `encode` builds the frame of a message once. The shared frame may be queued to every recipient pipeline
+ * (see `HTTPPipeline::queue`) without copying it.
+ *
+ * Example:
+ * @code
+ * if (HTTPWebSocket::handshake(request, response) == HttpStatus::SWITCHING_PROTOCOLS) upgrade(fd);
+ * std::shared_ptr<const std::string> frame = HTTPWebSocket::encode(HTTPWebSocket::TEXT, data, length);
+ * for (Connection &connection : subscribers) connection.pipeline.queue(frame);
+ * @endcode
+ *
+ * @version 1.0.0
+ * @date 2026-10-18
+ * @author Jaya Wikrama
+ */
+
+#ifndef __HTTP_WEBSOCKET_HPP__
+#define __HTTP_WEBSOCKET_HPP__
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include "http-header.hpp"
+
+#define HTTP_WEBSOCKET_VERSION "13"
+#define HTTP_WEBSOCKET_MAX_MESSAGE (16 * 1024 * 1024)
+#define HTTP_WEBSOCKET_MAX_CONTROL 125
+
+class HTTPWebSocket {
+  public:
+    typedef enum _opcode_t {
+      CONTINUATION = 0x0,
+      TEXT = 0x1,
+      BINARY = 0x2,
+      CLOSE = 0x8,
+      PING = 0x9,
+      PONG = 0xA
+    } opcode_t;
+
+    typedef enum _close_t {
+      NORMAL_CLOSURE = 1000,
+      GOING_AWAY = 1001,
+      PROTOCOL_ERROR = 1002,
+      UNSUPPORTED_DATA = 1003,
+      NO_STATUS = 1005,
+      INVALID_PAYLOAD = 1007,
+      POLICY_VIOLATION = 1008,
+      MESSAGE_TOO_BIG = 1009,
+      INTERNAL_ERROR = 1011
+    } close_t;
+
+    typedef bool (*message_t)(HTTPWebSocket &socket, HTTPWebSocket::opcode_t opcode, const char *data, size_t length, void *context);
+
+    /**
+    * @brief Custom constructor.
+    *
+    * @param[in] server `true` for the server side (the received frames must be masked) or `false` for the client
+    * side (the received frames must not be masked).
+    * @param[in] maxMessage The maximum size of the reassembled message.
+    */
+    HTTPWebSocket(bool server = true, size_t maxMessage = HTTP_WEBSOCKET_MAX_MESSAGE);
+
+    /**
+    * @brief Decode the next slice of the stream.
+    *
+    * This method is responsible to decode the frames of the slice and call the handler with every complete
+    * message (`TEXT` or `BINARY`, reassembled from the fragments) and every control frame (`CLOSE`, `PING`,
+    * `PONG`, which may arrive between the fragments). The handler data is unmasked and valid until the handler
+    * returns. Nothing is decoded after the `CLOSE` frame. A `TEXT` message or a close reason which is not valid
+    * UTF-8 fails with `INVALID_PAYLOAD`, the text is validated as it arrives.
+    *
+    * @param[in] data The received data.
+    * @param[in] length The length of the received data.
+    * @param[in] handler The message handler, it may return `false` to stop the decoder.
+    * @param[in] context The handler context.
+    * @return `true` in success.
+    * @return `false` if the stream violates the protocol (see `getCloseCode`) or the handler stopped the decoder.
+    */
+    bool feed(const char *data, size_t length, HTTPWebSocket::message_t handler, void *context);
+
+    /**
+    * @brief Check the closing handshake.
+    *
+    * @return `true` if the `CLOSE` frame is received.
+    * @return `false` if the stream is open.
+    */
+    bool isClosed() const;
+
+    /**
+    * @brief Gets the close code.
+    *
+    * @return The status code of the received `CLOSE` frame, or the code that should be sent to the peer after
+    * the protocol violation, or `0` if the stream is open.
+    */
+    uint16_t getCloseCode() const;
+
+    /**
+    * @brief Complete the handshake response.
+    *
+    * This method is responsible to validate the upgrade request (`GET`, `Upgrade: websocket`,
+    * `Connection: Upgrade`, `Sec-WebSocket-Key` and `Sec-WebSocket-Version: 13`), set the status code of the
+    * response and append the `Upgrade`, `Connection` and `Sec-WebSocket-Accept` fields.
+    *
+    * @param[in] request The request header.
+    * @param[in] response The response header.
+    * @param[in] protocol The selected subprotocol or empty string.
+    * @return `HttpStatus::SWITCHING_PROTOCOLS` in success.
+    * @return `HttpStatus::UPGRADE_REQUIRED` if the version is not supported (`Sec-WebSocket-Version: 13` is appended).
+    * @return `HttpStatus::BAD_REQUEST` if the request is not a valid upgrade request.
+    */
+    static HttpStatus::Code_t handshake(const HTTPHeader &request, HTTPHeader &response, const std::string &protocol = "");
+
+    /**
+    * @brief Gets the accept key.
+    *
+    * This method is responsible to compute the `Sec-WebSocket-Accept` value, base64 of the SHA-1 of the key and
+    * the WebSocket GUID.
+    *
+    * @param[in] key The `Sec-WebSocket-Key` value.
+    * @return The `Sec-WebSocket-Accept` value.
+    */
+    static std::string getAcceptKey(const std::string &key);
+
+    /**
+    * @brief Append one frame.
+    *
+    * This method is responsible to append the frame header and the payload to the output. The client side
+    * frames are masked with a random key.
+    *
+    * @param[out] frame The output.
+    * @param[in] opcode The frame opcode.
+    * @param[in] data The payload.
+    * @param[in] length The payload length.
+    * @param[in] fin `false` if more fragments of the message follow.
+    * @param[in] masked `true` for the client side frame.
+    */
+    static void encode(std::string &frame, HTTPWebSocket::opcode_t opcode, const char *data, size_t length, bool fin = true, bool masked = false);
+
+    /**
+    * @brief Build one shared server side frame.
+    *
+    * This method is responsible to encode the message once for any number of recipients.
+    *
+    * @param[in] opcode The frame opcode.
+    * @param[in] data The payload.
+    * @param[in] length The payload length.
+    * @return The frame.
+    */
+    static std::shared_ptr<const std::string> encode(HTTPWebSocket::opcode_t opcode, const char *data, size_t length);
+
+    /**
+    * @brief Append one close frame.
+    *
+    * @param[out] frame The output.
+    * @param[in] code The close code.
+    * @param[in] reason The close reason (truncated to fit the control frame).
+    * @param[in] masked `true` for the client side frame.
+    */
+    static void encodeClose(std::string &frame, uint16_t code, const std::string &reason = "", bool masked = false);
+
+    /**
+    * @brief Apply the masking key.
+    *
+    * This method is responsible to mask or unmask the data in place with `HTTPSimd::mask` (32 bytes per step with
+    * AVX2, 16 bytes per step with SSE2 and 8 bytes per step otherwise).
+    *
+    * @param[in] data The data.
+    * @param[in] length The data length.
+    * @param[in] key The masking key (wire order).
+    * @param[in] offset The position of the data in the payload.
+    */
+    static void mask(char *data, size_t length, const uint8_t key[4], size_t offset);
+
+  private:
+    typedef enum _state_t {
+      HEAD = 0,
+      PAYLOAD,
+      CLOSED,
+      FAILED
+    } state_t;
+
+    bool server;
+    size_t maxMessage;
+    HTTPWebSocket::state_t state;
+    uint8_t head[14];
+    size_t headLength;
+    bool fin;
+    HTTPWebSocket::opcode_t opcode;
+    uint8_t key[4];
+    bool masked;
+    uint64_t remaining;
+    size_t offset;
+    HTTPWebSocket::opcode_t messageOpcode;
+    bool fragmented;
+    size_t validated;
+    std::string message;
+    std::string control;
+    uint16_t closeCode;
+
+    bool parseHead();
+    bool complete(HTTPWebSocket::message_t handler, void *context);
+    bool fail(HTTPWebSocket::close_t code);
+};
+
+#endif
@@ -0,0 +1,368 @@
+/*
+ * $Id: http-access-log.cpp,v 1.0.0 2026/10/18 17:28:40 Jaya Wikrama Exp $
+ *
+ * Copyright (c) 2024 Jaya Wikrama
+ * jayawikrama89@gmail.com
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *  claim that you wrote the original software. If you use this software
+ *  in a product, an acknowledgment in the product documentation would be
+ *  appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *  misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include <cerrno>
+#include <cstdio>
+#include <chrono>
+#include <cstring>
+#include <ctime>
+#include <stdexcept>
+#include <fcntl.h>
+#include <unistd.h>
+#include "http-access-log.hpp"
+#include "http-header-table.hpp"
+
+#define HTTP_ACCESS_LOG_ADDRESS 0
+#define HTTP_ACCESS_LOG_METHOD 1
+#define HTTP_ACCESS_LOG_TARGET 2
+#define HTTP_ACCESS_LOG_VERSION 3
+#define HTTP_ACCESS_LOG_FIELD 4
+
+static const char *__month[12] = {
+  "Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"
+};
+
+static const char __hex[] = "0123456789ABCDEF";
+
+static uint64_t __now(){
+  struct timespec ts;
+  clock_gettime(CLOCK_REALTIME_COARSE, &ts);
+  return static_cast<uint64_t>(ts.tv_sec) * 1000000ULL + static_cast<uint64_t>(ts.tv_nsec / 1000);
+}
+
+static void __appendNumber(std::string &output, uint64_t value){
+  char digit[20];
+  int count = 0;
+  do {
+    digit[count++] = static_cast<char>('0' + value % 10);
+    value /= 10;
+  } while (value > 0);
+  while (count > 0) output.push_back(digit[--count]);
+}
+
+static void __appendTwo(std::string &output, int value){
+  output.push_back(static_cast<char>('0' + value / 10 % 10));
+  output.push_back(static_cast<char>('0' + value % 10));
+}
+
+static void __appendQuoted(std::string &output, std::string_view value){
+  /* Common Log Format: the quote, the backslash and the non printable bytes are written as \xHH */
+  output.push_back('"');
+  if (value.empty()) output.push_back('-');
+  for (char c : value){
+    unsigned char byte = static_cast<unsigned char>(c);
+    if (byte < 0x20 || byte >= 0x7F || c == '"' || c == '\\'){
+      output.append("\\x", 2);
+      output.push_back(__hex[byte >> 4]);
+      output.push_back(__hex[byte & 0x0F]);
+    }
+    else {
+      output.push_back(c);
+    }
+  }
+  output.push_back('"');
+}
+
+/* Common Log Format: the unquoted parts and the request line are separated by space, so it is escaped as well */
+static void __appendEscaped(std::string &output, std::string_view value){
+  for (char c : value){
+    unsigned char byte = static_cast<unsigned char>(c);
+    if (byte <= 0x20 || byte >= 0x7F || c == '"' || c == '\\'){
+      output.append("\\x", 2);
+      output.push_back(__hex[byte >> 4]);
+      output.push_back(__hex[byte & 0x0F]);
+    }
+    else {
+      output.push_back(c);
+    }
+  }
+}
+
+static void __appendJSON(std::string &output, std::string_view value){
+  output.push_back('"');
+  for (char c : value){
+    unsigned char byte = static_cast<unsigned char>(c);
+    if (c == '"' || c == '\\'){
+      output.push_back('\\');
+      output.push_back(c);
+    }
+    else if (byte < 0x20){
+      output.append("\\u00", 4);
+      output.push_back(__hex[byte >> 4]);
+      output.push_back(__hex[byte & 0x0F]);
+    }
+    else {
+      output.push_back(c);
+    }
+  }
+  output.push_back('"');
+}
+
+static std::string_view __view(const char *data, const uint16_t *offset, const uint16_t *length, size_t index){
+  return std::string_view(data + offset[index], length[index]);
+}
+
+/**
+ * @brief Custom constructor.
+ *
+ * This method is responsible to open the log file (append mode), allocate one ring per worker and start the
+ * background thread. `HTTPAccessLog::COMBINED` always captures `Referer` and `User-Agent`, the other fields
+ * are written by `HTTPAccessLog::JSON` only.
+ * This method will throw an error if the file can not be opened.
+ *
+ * @param[in] path The log file path.
+ * @param[in] format The line format.
+ * @param[in] workers The number of workers (producers).
+ * @param[in] fields The header fields to capture (at most `HTTP_ACCESS_LOG_MAX_FIELD`).
+ * @param[in] ringSize The number of records per ring (rounded up to a power of two).
+ */
+HTTPAccessLog::HTTPAccessLog(const std::string &path, HTTPAccessLog::format_t format, size_t workers, const std::vector<HeaderNode::headerField_t> &fields, size_t ringSize){
+  static_assert(sizeof(HTTPAccessLog::record_t) == HTTP_ACCESS_LOG_RECORD, "HTTPAccessLog: invalid record size");
+  this->fd = ::open(path.c_str(), O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0644);
+  if (this->fd < 0){
+    throw std::runtime_error(std::string(__func__) + ": failed to open " + path + " (" + strerror(errno) + ")");
+  }
+  this->lineFormat = format;
+  if (format == HTTPAccessLog::COMBINED){
+    this->fields.push_back(HeaderNode::REFERER);
+    this->fields.push_back(HeaderNode::USER_AGENT);
+  }
+  for (HeaderNode::headerField_t field : fields){
+    if (this->fields.size() >= HTTP_ACCESS_LOG_MAX_FIELD) break;
+    if (field == HeaderNode::UNKNOWN) continue;
+    bool exist = false;
+    for (HeaderNode::headerField_t captured : this->fields){
+      if (captured == field) exist = true;
+    }
+    if (!exist) this->fields.push_back(field);
+  }
+  size_t size = 2;
+  while (size < ringSize) size <<= 1;
+  this->mask = size - 1;
+  if (workers == 0) workers = 1;
+  for (size_t i = 0; i < workers; i++){
+    std::unique_ptr<HTTPAccessLog::ring_t> ring(new HTTPAccessLog::ring_t());
+    ring->head.store(0, std::memory_order_relaxed);
+    ring->tail.store(0, std::memory_order_relaxed);
+    ring->dropped.store(0, std::memory_order_relaxed);
+    ring->records.reset(new HTTPAccessLog::record_t[size]);
+    this->rings.push_back(std::move(ring));
+  }
+  this->buffer.reserve(HTTP_ACCESS_LOG_BUFFER + HTTP_ACCESS_LOG_RECORD * 8);
+  this->second = -1;
+  this->stopping = false;
+  this->thread = std::thread(&HTTPAccessLog::run, this);
+}
+
+/**
+ * @brief Destructor.
+ *
+ * This method is responsible to stop the background thread, write the remaining records and close the file.
+ */
+HTTPAccessLog::~HTTPAccessLog(){
+  {
+    std::lock_guard<std::mutex> guard(this->lock);
+    this->stopping = true;
+  }
+  this->wakeup.notify_one();
+  if (this->thread.joinable()) this->thread.join();
+  ::close(this->fd);
+}
+
+/**
+ * @brief Record one request.
+ *
+ * This method is responsible to copy the request data into the next free record of the worker ring. The
+ * strings are truncated to fit the record. Only the owner thread of the worker may call this method.
+ *
+ * @param[in] worker The worker index.
+ * @param[in] request The request header.
+ * @param[in] code The response status code.
+ * @param[in] bytes The number of body bytes sent.
+ * @param[in] latency The request latency in microseconds.
+ * @param[in] clientAddress The client address.
+ * @return `true` in success.
+ * @return `false` if the ring is full (the record is dropped and counted) or the worker index is invalid.
+ */
+bool HTTPAccessLog::log(size_t worker, const HTTPHeader &request, HttpStatus::Code_t code, uint64_t bytes, uint32_t latency, std::string_view clientAddress){
+  if (worker >= this->rings.size()) return false;
+  HTTPAccessLog::ring_t &ring = *this->rings[worker];
+  uint64_t head = ring.head.load(std::memory_order_relaxed);
+  if (head - ring.tail.load(std::memory_order_acquire) > this->mask){
+    ring.dropped.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  HTTPAccessLog::record_t &record = ring.records[head & this->mask];
+  record.timestamp = __now();
+  record.bytes = bytes;
+  record.latency = latency;
+  record.code = static_cast<uint16_t>(code);
+  size_t used = 0;
+  auto copy = [&record, &used](size_t index, std::string_view value){
+    size_t length = value.size();
+    if (length > sizeof(record.data) - used) length = sizeof(record.data) - used;
+    memcpy(record.data + used, value.data(), length);
+    record.offset[index] = static_cast<uint16_t>(used);
+    record.length[index] = static_cast<uint16_t>(length);
+    used += length;
+  };
+  copy(HTTP_ACCESS_LOG_ADDRESS, clientAddress);
+  copy(HTTP_ACCESS_LOG_METHOD, request.getMethod());
+  copy(HTTP_ACCESS_LOG_TARGET, request.getTarget());
+  copy(HTTP_ACCESS_LOG_VERSION, request.getVersion());
+  for (size_t i = 0; i < this->fields.size(); i++){
+    const HeaderNode *node = request.getNode(this->fields[i]);
+    copy(HTTP_ACCESS_LOG_FIELD + i, node ? node->getValueView() : std::string_view());
+  }
+  ring.head.store(head + 1, std::memory_order_release);
+  return true;
+}
+
+/**
+ * @brief Gets the number of dropped records.
+ *
+ * @return The number of records dropped because their ring was full.
+ */
+uint64_t HTTPAccessLog::getDropped() const {
+  uint64_t dropped = 0;
+  for (const std::unique_ptr<HTTPAccessLog::ring_t> &ring : this->rings){
+    dropped += ring->dropped.load(std::memory_order_relaxed);
+  }
+  return dropped;
+}
+
+void HTTPAccessLog::run(){
+  std::unique_lock<std::mutex> guard(this->lock);
+  while (!this->stopping){
+    this->wakeup.wait_for(guard, std::chrono::milliseconds(HTTP_ACCESS_LOG_INTERVAL));
+    guard.unlock();
+    while (this->drain());
+    this->write();
+    guard.lock();
+  }
+  guard.unlock();
+  while (this->drain());
+  this->write();
+}
+
+bool HTTPAccessLog::drain(){
+  bool more = false;
+  for (const std::unique_ptr<HTTPAccessLog::ring_t> &ring : this->rings){
+    uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+    uint64_t head = ring->head.load(std::memory_order_acquire);
+    while (tail != head && this->buffer.size() < HTTP_ACCESS_LOG_BUFFER){
+      this->append(ring->records[tail & this->mask]);
+      tail++;
+    }
+    ring->tail.store(tail, std::memory_order_release);
+    if (tail != head) more = true;
+    if (this->buffer.size() >= HTTP_ACCESS_LOG_BUFFER) this->write();
+  }
+  return more;
+}
+
+void HTTPAccessLog::append(const HTTPAccessLog::record_t &record){
+  /* the time prefix of this log is rebuilt once per second */
+  time_t now = static_cast<time_t>(record.timestamp / 1000000ULL);
+  if (now != this->second){
+    struct tm tm;
+    gmtime_r(&now, &tm);
+    snprintf(this->clf, sizeof(this->clf), "%02d/%s/%04d:%02d:%02d:%02d +0000", tm.tm_mday, __month[tm.tm_mon], tm.tm_year + 1900, tm.tm_hour, tm.tm_min, tm.tm_sec);
+    snprintf(this->iso, sizeof(this->iso), "%04d-%02d-%02dT%02d:%02d:%02d", tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday, tm.tm_hour, tm.tm_min, tm.tm_sec);
+    this->second = now;
+  }
+  std::string &output = this->buffer;
+  std::string_view address = __view(record.data, record.offset, record.length, HTTP_ACCESS_LOG_ADDRESS);
+  std::string_view method = __view(record.data, record.offset, record.length, HTTP_ACCESS_LOG_METHOD);
+  std::string_view target = __view(record.data, record.offset, record.length, HTTP_ACCESS_LOG_TARGET);
+  std::string_view version = __view(record.data, record.offset, record.length, HTTP_ACCESS_LOG_VERSION);
+  if (this->lineFormat == HTTPAccessLog::JSON){
+    output.append("{\"time\":\"", 9);
+    output.append(this->iso);
+    output.push_back('.');
+    int millisecond = static_cast<int>(record.timestamp / 1000ULL % 1000ULL);
+    output.push_back(static_cast<char>('0' + millisecond / 100));
+    __appendTwo(output, millisecond);
+    output.append("Z\",\"address\":", 13);
+    __appendJSON(output, address);
+    output.append(",\"method\":", 10);
+    __appendJSON(output, method);
+    output.append(",\"target\":", 10);
+    __appendJSON(output, target);
+    output.append(",\"version\":", 11);
+    __appendJSON(output, version);
+    output.append(",\"status\":", 10);
+    __appendNumber(output, record.code);
+    output.append(",\"bytes\":", 9);
+    __appendNumber(output, record.bytes);
+    output.append(",\"latency_us\":", 14);
+    __appendNumber(output, record.latency);
+    for (size_t i = 0; i < this->fields.size(); i++){
+      output.push_back(',');
+      __appendJSON(output, HeaderTable::getName(this->fields[i]));
+      output.push_back(':');
+      __appendJSON(output, __view(record.data, record.offset, record.length, HTTP_ACCESS_LOG_FIELD + i));
+    }
+    output.append("}\n", 2);
+    return;
+  }
+  /* addr - - [10/Oct/2000:13:55:36 +0000] "GET /index.html HTTP/1.1" 200 2326 */
+  if (address.empty()) output.push_back('-');
+  else __appendEscaped(output, address);
+  output.append(" - - [", 6);
+  output.append(this->clf);
+  output.append("] \"", 3);
+  __appendEscaped(output, method);
+  output.push_back(' ');
+  __appendEscaped(output, target);
+  if (!version.empty()){
+    output.append(" HTTP/", 6);
+    __appendEscaped(output, version);
+  }
+  output.append("\" ", 2);
+  __appendNumber(output, record.code);
+  output.push_back(' ');
+  if (record.bytes == 0) output.push_back('-');
+  else __appendNumber(output, record.bytes);
+  if (this->lineFormat == HTTPAccessLog::COMBINED){
+    output.push_back(' ');
+    __appendQuoted(output, __view(record.data, record.offset, record.length, HTTP_ACCESS_LOG_FIELD));
+    output.push_back(' ');
+    __appendQuoted(output, __view(record.data, record.offset, record.length, HTTP_ACCESS_LOG_FIELD + 1));
+  }
+  output.push_back('\n');
+}
+
+void HTTPAccessLog::write(){
+  size_t written = 0;
+  while (written < this->buffer.size()){
+    ssize_t result = ::write(this->fd, this->buffer.data() + written, this->buffer.size() - written);
+    if (result < 0){
+      if (errno == EINTR) continue;
+      /* the log is best effort, a failing disk must not grow the buffer forever */
+      break;
+    }
+    written += static_cast<size_t>(result);
+  }
+  this->buffer.clear();
+}
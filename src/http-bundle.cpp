@@ -0,0 +1,249 @@
+/*
+ * $Id: http-bundle.cpp,v 1.0.0 2026/10/18 19:21:47 Jaya Wikrama Exp $
+ *
+ * Copyright (c) 2024 Jaya Wikrama
+ * jayawikrama89@gmail.com
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *  claim that you wrote the original software. If you use this software
+ *  in a product, an acknowledgment in the product documentation would be
+ *  appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *  misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include "http-bundle.hpp"
+#include "http-negotiation.hpp"
+#include "http-simd.hpp"
+
+static bool __inside(size_t size, uint64_t offset, uint64_t length){
+  return (offset <= size && length <= size - offset);
+}
+
+/**
+ * @brief Custom constructor.
+ *
+ * This method is responsible to map the bundle and validate its header.
+ * This method will throw an error if the bundle can not be opened or is malformed.
+ *
+ * @param[in] path The bundle path.
+ */
+HTTPBundle::HTTPBundle(const std::string &path){
+  int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0){
+    throw std::runtime_error(std::string(__func__) + ": failed to open " + path + " (" + strerror(errno) + ")");
+  }
+  struct stat info;
+  if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(HTTPBundle::header_t)){
+    close(fd);
+    throw std::runtime_error(std::string(__func__) + ": invalid bundle " + path);
+  }
+  this->length = static_cast<size_t>(info.st_size);
+  void *mapping = mmap(nullptr, this->length, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (mapping == MAP_FAILED){
+    throw std::runtime_error(std::string(__func__) + ": failed to map " + path + " (" + strerror(errno) + ")");
+  }
+  this->data = static_cast<const char *>(mapping);
+  this->header = reinterpret_cast<const HTTPBundle::header_t *>(this->data);
+  const HTTPBundle::header_t &header = *this->header;
+  bool valid = (header.magic == HTTP_BUNDLE_MAGIC && header.version == HTTP_BUNDLE_VERSION && header.size == this->length &&
+    header.slots > 0 && (header.slots & (header.slots - 1)) == 0 && header.count < header.slots &&
+    header.index % alignof(uint32_t) == 0 && header.entries % alignof(HTTPBundle::entry_t) == 0 &&
+    __inside(this->length, header.index, static_cast<uint64_t>(header.slots) * sizeof(uint32_t)) &&
+    __inside(this->length, header.entries, static_cast<uint64_t>(header.count) * sizeof(HTTPBundle::entry_t)));
+  if (!valid){
+    munmap(mapping, this->length);
+    throw std::runtime_error(std::string(__func__) + ": invalid bundle " + path);
+  }
+  this->index = reinterpret_cast<const uint32_t *>(this->data + header.index);
+  this->entries = reinterpret_cast<const HTTPBundle::entry_t *>(this->data + header.entries);
+}
+
+/**
+ * @brief Destructor.
+ *
+ * This method is responsible to unmap the bundle.
+ */
+HTTPBundle::~HTTPBundle(){
+  munmap(const_cast<char *>(this->data), this->length);
+}
+
+/**
+ * @brief Find one asset.
+ *
+ * @param[in] path The asset path (e.g. `/css/site.css`, the query is ignored).
+ * @return The asset or `nullptr` if it is not in the bundle.
+ */
+const HTTPBundle::entry_t *HTTPBundle::find(std::string_view path) const {
+  path = path.substr(0, path.find('?'));
+  uint32_t hash = HTTPSimd::crc32c(path.data(), path.length());
+  uint32_t mask = this->header->slots - 1;
+  /* the packer keeps the load factor below one, so there is always an empty slot */
+  for (uint32_t i = hash & mask; this->index[i] != 0; i = (i + 1) & mask){
+    uint32_t number = this->index[i] - 1;
+    if (number >= this->header->count) return nullptr;
+    const HTTPBundle::entry_t *entry = &this->entries[number];
+    if (entry->hash != hash || entry->pathLength != path.length()) continue;
+    if (!__inside(this->length, entry->path, entry->pathLength)) return nullptr;
+    if (memcmp(this->data + entry->path, path.data(), path.length()) == 0) return entry;
+  }
+  return nullptr;
+}
+
+/**
+ * @brief Select the variant.
+ *
+ * This method is responsible to negotiate the `Accept-Encoding` of the request among the stored variants.
+ *
+ * @param[in] asset The asset.
+ * @param[in] request The request header.
+ * @return The selected encoding (`HTTPBundle::IDENTITY` if nothing else is acceptable).
+ */
+HTTPBundle::encoding_t HTTPBundle::select(const HTTPBundle::entry_t *asset, const HTTPHeader &request) const {
+  if (asset == nullptr) return HTTPBundle::IDENTITY;
+  /* the smallest variant first, it wins the ties of the client preferences */
+  static const HTTPBundle::encoding_t order[] = { HTTPBundle::BROTLI, HTTPBundle::GZIP, HTTPBundle::IDENTITY };
+  std::string_view offers[HTTPBundle::SZ_ENCODING];
+  HTTPBundle::encoding_t encodings[HTTPBundle::SZ_ENCODING];
+  size_t count = 0;
+  for (HTTPBundle::encoding_t encoding : order){
+    if (asset->variant[encoding].headLength == 0) continue;
+    offers[count] = HTTPBundle::getEncodingName(encoding);
+    encodings[count++] = encoding;
+  }
+  if (count <= 1) return HTTPBundle::IDENTITY;
+  int selected = HTTPNegotiation::select(request, HeaderNode::ACCEPT_ENCODING, offers, count);
+  return (selected < 0 ? HTTPBundle::IDENTITY : encodings[selected]);
+}
+
+/**
+ * @brief Gets the serialized response head of the variant.
+ *
+ * @param[in] asset The asset.
+ * @param[in] encoding The encoding.
+ * @return The head (status line, fields and the empty row) or an empty view if the variant is not stored.
+ */
+std::string_view HTTPBundle::getHead(const HTTPBundle::entry_t *asset, HTTPBundle::encoding_t encoding) const {
+  if (asset == nullptr || encoding < HTTPBundle::IDENTITY || encoding >= HTTPBundle::SZ_ENCODING) return std::string_view();
+  const HTTPBundle::variant_t &variant = asset->variant[encoding];
+  if (variant.headLength == 0 || !__inside(this->length, variant.head, variant.headLength)) return std::string_view();
+  return std::string_view(this->data + variant.head, variant.headLength);
+}
+
+/**
+ * @brief Gets the body of the variant.
+ *
+ * @param[in] asset The asset.
+ * @param[in] encoding The encoding.
+ * @return The body or an empty view if the variant is not stored.
+ */
+std::string_view HTTPBundle::getBody(const HTTPBundle::entry_t *asset, HTTPBundle::encoding_t encoding) const {
+  if (asset == nullptr || encoding < HTTPBundle::IDENTITY || encoding >= HTTPBundle::SZ_ENCODING) return std::string_view();
+  const HTTPBundle::variant_t &variant = asset->variant[encoding];
+  if (variant.headLength == 0 || !__inside(this->length, variant.body, variant.bodyLength)) return std::string_view();
+  return std::string_view(this->data + variant.body, variant.bodyLength);
+}
+
+/**
+ * @brief Gets the length of the response.
+ *
+ * @param[in] asset The asset.
+ * @param[in] encoding The encoding.
+ * @param[in] head `true` for the head only (`HEAD` request).
+ * @return The number of bytes of the head and the body or `0` if the variant is not stored.
+ */
+size_t HTTPBundle::getLength(const HTTPBundle::entry_t *asset, HTTPBundle::encoding_t encoding, bool head) const {
+  std::string_view view = this->getHead(asset, encoding);
+  if (view.empty() || head) return view.length();
+  return view.length() + this->getBody(asset, encoding).length();
+}
+
+/**
+ * @brief Send the variant.
+ *
+ * This method is responsible to write the head and the body from the offset with one `writev` (repeated until
+ * everything is written). On non-blocking socket, the caller adds the returned count to the offset and calls
+ * it again when the socket is writable, until the offset reaches `getLength`.
+ *
+ * @param[in] fd The socket file descriptor.
+ * @param[in] asset The asset.
+ * @param[in] encoding The encoding.
+ * @param[in] head `true` to send the head only (`HEAD` request).
+ * @param[in] offset The number of bytes of the response written by the previous calls.
+ * @return The number of bytes written by this call.
+ * @return `-1` on fail (see `errno`).
+ */
+ssize_t HTTPBundle::send(int fd, const HTTPBundle::entry_t *asset, HTTPBundle::encoding_t encoding, bool head, size_t offset) const {
+  std::string_view part[2] = { this->getHead(asset, encoding), (head ? std::string_view() : this->getBody(asset, encoding)) };
+  size_t total = part[0].length() + part[1].length();
+  if (part[0].empty() || offset > total){
+    errno = EINVAL;
+    return -1;
+  }
+  size_t written = offset;
+  while (written < total){
+    struct iovec iov[2];
+    int count = 0;
+    size_t skip = written;
+    for (const std::string_view &view : part){
+      if (skip >= view.length()){
+        skip -= view.length();
+        continue;
+      }
+      iov[count].iov_base = const_cast<char *>(view.data() + skip);
+      iov[count].iov_len = view.length() - skip;
+      count++;
+      skip = 0;
+    }
+    ssize_t ret = writev(fd, iov, count);
+    if (ret < 0){
+      if (errno == EINTR) continue;
+      if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+      return -1;
+    }
+    written += static_cast<size_t>(ret);
+  }
+  return static_cast<ssize_t>(written - offset);
+}
+
+/**
+ * @brief Gets the number of assets.
+ *
+ * @return The number of assets.
+ */
+size_t HTTPBundle::size() const {
+  return this->header->count;
+}
+
+/**
+ * @brief Gets the name of the encoding.
+ *
+ * @param[in] encoding The encoding.
+ * @return The `Content-Encoding` token (`identity`, `gzip` or `br`).
+ */
+const char *HTTPBundle::getEncodingName(HTTPBundle::encoding_t encoding){
+  switch (encoding){
+    case HTTPBundle::GZIP: return "gzip";
+    case HTTPBundle::BROTLI: return "br";
+    default: break;
+  }
+  return "identity";
+}
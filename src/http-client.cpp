@@ -0,0 +1,547 @@
+/*
+ * $Id: http-client.cpp,v 1.0.0 2026/10/18 16:41:55 Jaya Wikrama Exp $
+ *
+ * Copyright (c) 2024 Jaya Wikrama
+ * jayawikrama89@gmail.com
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *  claim that you wrote the original software. If you use this software
+ *  in a product, an acknowledgment in the product documentation would be
+ *  appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *  misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <strings.h>
+#include <netdb.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include "http-client.hpp"
+
+typedef struct _result_t {
+  bool done;
+  bool success;
+  HTTPHeader *response;
+  std::string *body;
+} result_t;
+
+static bool __isIdempotent(const std::string &method){
+  return (method == "GET" || method == "HEAD" || method == "OPTIONS" || method == "TRACE" || method == "PUT" || method == "DELETE");
+}
+
+static std::string __trim(const std::string &text){
+  size_t first = text.find_first_not_of(" \t");
+  if (first == std::string::npos) return std::string();
+  size_t last = text.find_last_not_of(" \t");
+  return text.substr(first, last - first + 1);
+}
+
+static bool __hasToken(const HTTPHeader &header, HeaderNode::headerField_t field, const char *token){
+  HeaderNode *node = (field == HeaderNode::UNKNOWN ? nullptr : header.getNode(field));
+  if (node == nullptr) return false;
+  std::string value = node->getValue();
+  size_t start = 0;
+  while (start <= value.length()){
+    size_t end = value.find(',', start);
+    if (end == std::string::npos) end = value.length();
+    if (strcasecmp(__trim(value.substr(start, end - start)).c_str(), token) == 0) return true;
+    start = end + 1;
+  }
+  return false;
+}
+
+static bool __number(const std::string &text, uint64_t &number){
+  std::string value = __trim(text);
+  if (value.empty() || value.length() > 19) return false;
+  number = 0;
+  for (char c : value){
+    if (c < '0' || c > '9') return false;
+    number = number * 10 + static_cast<uint64_t>(c - '0');
+  }
+  return true;
+}
+
+/* chunk-size [ BWS ] [ ";" chunk-ext ], at most 15 digits so the size can not overflow */
+static bool __chunkSize(std::string_view line, uint64_t &size){
+  size_t digits = 0;
+  size = 0;
+  while (digits < line.length() && isxdigit(static_cast<unsigned char>(line[digits]))){
+    char c = line[digits++];
+    if (digits > 15) return false;
+    size = size * 16 + static_cast<uint64_t>(c <= '9' ? c - '0' : (c | 0x20) - 'a' + 10);
+  }
+  if (digits == 0) return false;
+  size_t position = digits;
+  while (position < line.length() && (line[position] == ' ' || line[position] == '\t')) position++;
+  if (position < line.length() && line[position] != ';') return false;
+  for (; position < line.length(); position++){
+    unsigned char c = static_cast<unsigned char>(line[position]);
+    if ((c < 0x20 && c != '\t') || c == 0x7F) return false;
+  }
+  return true;
+}
+
+static long __now(){
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return static_cast<long>(ts.tv_sec) * 1000L + static_cast<long>(ts.tv_nsec / 1000000L);
+}
+
+static void __collect(HTTPClient &client, uint64_t id, HTTPHeader *response, const std::string &body, void *context){
+  (void) client;
+  (void) id;
+  result_t *result = static_cast<result_t *>(context);
+  result->done = true;
+  if (response == nullptr) return;
+  *result->response = std::move(*response);
+  *result->body = body;
+  result->success = true;
+}
+
+/**
+ * @brief Default constructor for empty pools.
+ */
+HTTPClient::HTTPClient(){
+  this->nextId = 1;
+}
+
+/**
+ * @brief Destructor.
+ *
+ * This method is responsible to close all connections. The handlers of unfinished requests are not called.
+ */
+HTTPClient::~HTTPClient(){
+  for (auto &entry : this->hosts){
+    for (std::unique_ptr<HTTPClient::connection_t> &connection : entry.second.connections) close(connection->fd);
+  }
+}
+
+HTTPClient::host_t *HTTPClient::resolve(const std::string &host, uint16_t port){
+  std::string key = host + ":" + std::to_string(port);
+  auto found = this->hosts.find(key);
+  if (found != this->hosts.end()) return &found->second;
+  struct addrinfo hints;
+  struct addrinfo *result = nullptr;
+  memset(&hints, 0, sizeof(hints));
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  if (getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &result) != 0 || result == nullptr) return nullptr;
+  HTTPClient::host_t &entry = this->hosts[key];
+  memcpy(&entry.address, result->ai_addr, result->ai_addrlen);
+  entry.addressLength = result->ai_addrlen;
+  freeaddrinfo(result);
+  return &entry;
+}
+
+bool HTTPClient::open(HTTPClient::host_t &host){
+  int fd = socket(host.address.ss_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (fd < 0) return false;
+  bool connecting = false;
+  if (connect(fd, reinterpret_cast<const struct sockaddr *>(&host.address), host.addressLength) != 0){
+    if (errno != EINPROGRESS){
+      close(fd);
+      return false;
+    }
+    connecting = true;
+  }
+  int enable = 1;
+  setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+  std::unique_ptr<HTTPClient::connection_t> connection(new HTTPClient::connection_t());
+  connection->fd = fd;
+  connection->connecting = connecting;
+  connection->written = 0;
+  connection->haveHead = false;
+  connection->framing = HTTPClient::NONE;
+  connection->remaining = 0;
+  connection->closing = false;
+  host.connections.push_back(std::move(connection));
+  return true;
+}
+
+void HTTPClient::dispatch(HTTPClient::host_t &host){
+  while (!host.pending.empty()){
+    HTTPClient::exchange_t &next = host.pending.front();
+    HTTPClient::connection_t *target = nullptr;
+    for (std::unique_ptr<HTTPClient::connection_t> &connection : host.connections){
+      if (!connection->closing && connection->inflight.empty()){
+        target = connection.get();
+        break;
+      }
+    }
+    if (target == nullptr && host.connections.size() < HTTP_CLIENT_MAX_CONNECTION){
+      if (!this->open(host)){
+        HTTPClient::exchange_t failed = std::move(next);
+        host.pending.pop_front();
+        if (failed.handler != nullptr) failed.handler(*this, failed.id, nullptr, std::string(), failed.context);
+        continue;
+      }
+      target = host.connections.back().get();
+    }
+    if (target == nullptr && next.idempotent){
+      /* the pool is full, pipeline behind the shortest queue of idempotent requests */
+      for (std::unique_ptr<HTTPClient::connection_t> &connection : host.connections){
+        if (connection->closing || connection->inflight.size() >= HTTP_CLIENT_MAX_PIPELINE) continue;
+        bool idempotent = true;
+        for (const HTTPClient::exchange_t &exchange : connection->inflight) idempotent = (idempotent && exchange.idempotent);
+        if (idempotent && (target == nullptr || connection->inflight.size() < target->inflight.size())) target = connection.get();
+      }
+    }
+    if (target == nullptr) break;
+    target->output.append(next.payload);
+    target->inflight.push_back(std::move(next));
+    host.pending.pop_front();
+  }
+}
+
+bool HTTPClient::flush(HTTPClient::connection_t &connection){
+  while (connection.written < connection.output.length()){
+    ssize_t ret = ::send(connection.fd, connection.output.data() + connection.written, connection.output.length() - connection.written, MSG_NOSIGNAL | MSG_DONTWAIT);
+    if (ret < 0 && errno == EINTR) continue;
+    if (ret < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return true;
+    if (ret <= 0) return false;
+    connection.written += static_cast<size_t>(ret);
+  }
+  connection.output.clear();
+  connection.written = 0;
+  return true;
+}
+
+bool HTTPClient::receive(HTTPClient::connection_t &connection, bool &closed){
+  char chunk[16384];
+  for (;;){
+    ssize_t ret = recv(connection.fd, chunk, sizeof(chunk), MSG_DONTWAIT);
+    if (ret < 0 && errno == EINTR) continue;
+    if (ret < 0) return (errno == EAGAIN || errno == EWOULDBLOCK);
+    if (ret == 0){
+      closed = true;
+      return true;
+    }
+    connection.input.append(chunk, static_cast<size_t>(ret));
+  }
+}
+
+void HTTPClient::finish(HTTPClient::connection_t &connection){
+  HTTPClient::exchange_t exchange = std::move(connection.inflight.front());
+  connection.inflight.pop_front();
+  HTTPHeader response = std::move(connection.response);
+  std::string body = std::move(connection.body);
+  connection.response = HTTPHeader();
+  connection.body.clear();
+  connection.haveHead = false;
+  if (exchange.handler != nullptr) exchange.handler(*this, exchange.id, &response, body, exchange.context);
+}
+
+bool HTTPClient::parse(HTTPClient::connection_t &connection, bool closed){
+  while (!connection.inflight.empty() && !(connection.closing && !connection.haveHead)){
+    if (!connection.haveHead){
+      if (connection.input.empty()) return true;
+      ssize_t ret = connection.response.parse(connection.input.data(), connection.input.length());
+      if (ret < 0) return false;
+      if (ret == 0) return (connection.input.length() <= HTTP_CLIENT_MAX_HEAD);
+      connection.input.erase(0, static_cast<size_t>(ret));
+      int code = static_cast<int>(connection.response.getHTTPStatusCode());
+      if (code >= 100 && code < 200){
+        /* interim responses are skipped, the final response follows */
+        connection.response = HTTPHeader();
+        continue;
+      }
+      HeaderNode *length = connection.response.getNode(HeaderNode::CONTENT_LENGTH);
+      if (connection.inflight.front().head || code == 204 || code == 304){
+        connection.framing = HTTPClient::NONE;
+      }
+      else if (connection.response.getNode(HeaderNode::TRANSFER_ENCODING) != nullptr){
+        connection.framing = (__hasToken(connection.response, HeaderNode::TRANSFER_ENCODING, "chunked") ? HTTPClient::CHUNKED : HTTPClient::UNTIL_CLOSE);
+      }
+      else if (length != nullptr){
+        if (!__number(length->getValue(), connection.remaining) || connection.remaining > HTTP_CLIENT_MAX_BODY) return false;
+        connection.framing = HTTPClient::LENGTH;
+      }
+      else {
+        connection.framing = HTTPClient::UNTIL_CLOSE;
+      }
+      connection.closing = (connection.response.getVersion() == "1.1" ?
+        __hasToken(connection.response, HeaderNode::CONNECTION, "close") :
+        !__hasToken(connection.response, HeaderNode::CONNECTION, "keep-alive"));
+      if (connection.framing == HTTPClient::UNTIL_CLOSE) connection.closing = true;
+      connection.body.clear();
+      connection.haveHead = true;
+    }
+
+    bool complete = false;
+    switch (connection.framing){
+      case HTTPClient::NONE:
+        complete = true;
+        break;
+      case HTTPClient::LENGTH: {
+        size_t take = (connection.input.length() < connection.remaining ? connection.input.length() : static_cast<size_t>(connection.remaining));
+        connection.body.append(connection.input, 0, take);
+        connection.input.erase(0, take);
+        connection.remaining -= take;
+        complete = (connection.remaining == 0);
+        break;
+      }
+      case HTTPClient::CHUNKED:
+        for (;;){
+          size_t eol = connection.input.find("\r\n");
+          if (eol == std::string::npos){
+            if (connection.input.length() > HTTP_CLIENT_MAX_HEAD) return false;
+            break;
+          }
+          uint64_t size = 0;
+          if (!__chunkSize(std::string_view(connection.input.data(), eol), size)) return false;
+          if (size == 0){
+            /* the trailer fields are skipped, they are bounded like a head */
+            size_t end = connection.input.find("\r\n\r\n", eol);
+            if (end == std::string::npos){
+              if (connection.input.length() > HTTP_CLIENT_MAX_HEAD) return false;
+              break;
+            }
+            connection.input.erase(0, end + 4);
+            complete = true;
+            break;
+          }
+          if (size > HTTP_CLIENT_MAX_BODY - connection.body.length()) return false;
+          if (connection.input.length() < eol + 2 + size + 2) break;
+          if (connection.input.compare(eol + 2 + static_cast<size_t>(size), 2, "\r\n") != 0) return false;
+          connection.body.append(connection.input, eol + 2, static_cast<size_t>(size));
+          connection.input.erase(0, eol + 2 + static_cast<size_t>(size) + 2);
+        }
+        break;
+      case HTTPClient::UNTIL_CLOSE:
+        if (connection.input.length() > HTTP_CLIENT_MAX_BODY - connection.body.length()) return false;
+        connection.body.append(connection.input);
+        connection.input.clear();
+        complete = closed;
+        break;
+    }
+    if (!complete) return true;
+    this->finish(connection);
+  }
+  return true;
+}
+
+void HTTPClient::fail(HTTPClient::host_t &host, HTTPClient::connection_t &connection){
+  std::unique_ptr<HTTPClient::connection_t> owned;
+  for (size_t i = 0; i < host.connections.size(); i++){
+    if (host.connections[i].get() != &connection) continue;
+    owned = std::move(host.connections[i]);
+    host.connections.erase(host.connections.begin() + static_cast<long>(i));
+    break;
+  }
+  if (owned == nullptr) return;
+  close(owned->fd);
+  /* idempotent requests are retried once (e.g. a keep-alive connection closed by the server) */
+  std::vector<HTTPClient::exchange_t> failed;
+  while (!owned->inflight.empty()){
+    HTTPClient::exchange_t exchange = std::move(owned->inflight.back());
+    owned->inflight.pop_back();
+    if (exchange.idempotent && exchange.retry == 0){
+      exchange.retry++;
+      host.pending.push_front(std::move(exchange));
+    }
+    else {
+      failed.push_back(std::move(exchange));
+    }
+  }
+  for (auto it = failed.rbegin(); it != failed.rend(); it++){
+    if (it->handler != nullptr) it->handler(*this, it->id, nullptr, std::string(), it->context);
+  }
+  this->dispatch(host);
+}
+
+/**
+ * @brief Start one request.
+ *
+ * This method is responsible to serialize the request (`Host` and `Content-Length` are added if they are
+ * missing) and assign it to a connection of the host pool. The host name is resolved once per pool.
+ *
+ * @param[in] host The host name or address.
+ * @param[in] port The port.
+ * @param[in] request The request header (see `HTTPHeader::setRequestLine`).
+ * @param[in] body The request body.
+ * @param[in] handler The response handler.
+ * @param[in] context The handler context.
+ * @return The request identifier.
+ * @return `0` if the host can not be resolved or the request has no request line.
+ */
+uint64_t HTTPClient::send(const std::string &host, uint16_t port, HTTPHeader &request, const std::string &body, HTTPClient::response_t handler, void *context){
+  if (request.getMethod().empty()) return 0;
+  HTTPClient::host_t *entry = this->resolve(host, port);
+  if (entry == nullptr) return 0;
+  if (request.getNode(HeaderNode::HOST) == nullptr) request.append(HeaderNode::HOST, (port == 80 ? host : host + ":" + std::to_string(port)));
+  if (!body.empty() && request.getNode(HeaderNode::CONTENT_LENGTH) == nullptr) request.append(HeaderNode::CONTENT_LENGTH, std::to_string(body.length()));
+
+  HTTPClient::exchange_t exchange;
+  exchange.id = this->nextId++;
+  request.serialize(exchange.payload);
+  exchange.payload.append("\r\n");
+  exchange.payload.append(body);
+  exchange.head = (request.getMethod() == "HEAD");
+  exchange.idempotent = __isIdempotent(request.getMethod());
+  exchange.retry = 0;
+  exchange.handler = handler;
+  exchange.context = context;
+  uint64_t id = exchange.id;
+  entry->pending.push_back(std::move(exchange));
+  this->dispatch(*entry);
+  return id;
+}
+
+/**
+ * @brief Cancel one request.
+ *
+ * This method is responsible to detach the handler of the request. A request which is already written still
+ * reads its response to keep the connection in order.
+ *
+ * @param[in] id The request identifier.
+ */
+void HTTPClient::cancel(uint64_t id){
+  for (auto &entry : this->hosts){
+    for (auto it = entry.second.pending.begin(); it != entry.second.pending.end(); it++){
+      if (it->id != id) continue;
+      entry.second.pending.erase(it);
+      return;
+    }
+    for (std::unique_ptr<HTTPClient::connection_t> &connection : entry.second.connections){
+      for (HTTPClient::exchange_t &exchange : connection->inflight){
+        if (exchange.id != id) continue;
+        exchange.handler = nullptr;
+        return;
+      }
+    }
+  }
+}
+
+/**
+ * @brief Gets the descriptors to wait for.
+ *
+ * @param[out] fds The poll set.
+ * @param[in] max The capacity of the poll set.
+ * @return The number of descriptors written to the poll set.
+ */
+size_t HTTPClient::getPollSet(struct pollfd *fds, size_t max) const {
+  size_t count = 0;
+  for (const auto &entry : this->hosts){
+    for (const std::unique_ptr<HTTPClient::connection_t> &connection : entry.second.connections){
+      if (count >= max) return count;
+      fds[count].fd = connection->fd;
+      fds[count].events = POLLIN;
+      if (connection->connecting || connection->written < connection->output.length()) fds[count].events |= POLLOUT;
+      fds[count].revents = 0;
+      count++;
+    }
+  }
+  return count;
+}
+
+/**
+ * @brief Handle the returned events.
+ *
+ * This method is responsible to continue the connects, the writes and the reads of the ready descriptors and
+ * call the handlers of the complete responses.
+ *
+ * @param[in] fds The poll set with the returned events.
+ * @param[in] count The number of descriptors.
+ */
+void HTTPClient::process(const struct pollfd *fds, size_t count){
+  for (size_t i = 0; i < count; i++){
+    if (fds[i].revents == 0) continue;
+    HTTPClient::host_t *host = nullptr;
+    HTTPClient::connection_t *connection = nullptr;
+    for (auto &entry : this->hosts){
+      for (std::unique_ptr<HTTPClient::connection_t> &candidate : entry.second.connections){
+        if (candidate->fd != fds[i].fd) continue;
+        host = &entry.second;
+        connection = candidate.get();
+        break;
+      }
+      if (connection != nullptr) break;
+    }
+    if (connection == nullptr) continue;
+
+    bool success = true;
+    bool closed = false;
+    if (connection->connecting && (fds[i].revents & (POLLOUT | POLLERR | POLLHUP))){
+      int error = 0;
+      socklen_t length = sizeof(error);
+      success = (getsockopt(connection->fd, SOL_SOCKET, SO_ERROR, &error, &length) == 0 && error == 0);
+      connection->connecting = false;
+    }
+    if (success && !connection->connecting) success = this->flush(*connection);
+    if (success && !connection->connecting && (fds[i].revents & (POLLIN | POLLHUP | POLLERR))){
+      success = (this->receive(*connection, closed) && this->parse(*connection, closed));
+    }
+    if (!success || closed || (connection->closing && !connection->haveHead)) this->fail(*host, *connection);
+    else this->dispatch(*host);
+  }
+}
+
+/**
+ * @brief Check the unfinished requests.
+ *
+ * @return `true` if some requests are waiting for the response.
+ */
+bool HTTPClient::isPending() const {
+  for (const auto &entry : this->hosts){
+    if (!entry.second.pending.empty()) return true;
+    for (const std::unique_ptr<HTTPClient::connection_t> &connection : entry.second.connections){
+      if (!connection->inflight.empty()) return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief Perform one request synchronously.
+ *
+ * This method is responsible to start the request and run the poll loop until the response is complete or
+ * the timeout expires.
+ *
+ * @param[in] host The host name or address.
+ * @param[in] port The port.
+ * @param[in] request The request header.
+ * @param[in] body The request body.
+ * @param[out] response The response header.
+ * @param[out] responseBody The response body.
+ * @param[in] timeout The timeout in milliseconds or `-1` to wait forever.
+ * @return `true` in success.
+ * @return `false` if the request failed or the timeout expired.
+ */
+bool HTTPClient::request(const std::string &host, uint16_t port, HTTPHeader &request, const std::string &body, HTTPHeader &response, std::string &responseBody, int timeout){
+  result_t result = { false, false, &response, &responseBody };
+  uint64_t id = this->send(host, port, request, body, __collect, &result);
+  if (id == 0) return false;
+  long deadline = __now() + timeout;
+  std::vector<struct pollfd> fds;
+  while (!result.done){
+    size_t total = 0;
+    for (const auto &entry : this->hosts) total += entry.second.connections.size();
+    fds.resize(total > 0 ? total : 1);
+    size_t count = this->getPollSet(fds.data(), fds.size());
+    int wait = -1;
+    if (timeout >= 0){
+      long left = deadline - __now();
+      if (left <= 0) break;
+      wait = static_cast<int>(left);
+    }
+    int ret = poll(fds.data(), count, wait);
+    if (ret < 0 && errno != EINTR) break;
+    if (ret > 0) this->process(fds.data(), count);
+  }
+  if (!result.done) this->cancel(id);
+  return result.success;
+}
@@ -0,0 +1,395 @@
+/*
+ * $Id: http-compression.cpp,v 1.0.0 2026/10/18 10:47:03 Jaya Wikrama Exp $
+ *
+ * Copyright (c) 2024 Jaya Wikrama
+ * jayawikrama89@gmail.com
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *  claim that you wrote the original software. If you use this software
+ *  in a product, an acknowledgment in the product documentation would be
+ *  appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *  misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include <cstring>
+#include <strings.h>
+#include <stdexcept>
+#include <zlib.h>
+#include "http-compression.hpp"
+#include "http-negotiation.hpp"
+
+#define COMPRESSION_CHUNK 16384
+
+typedef struct _context_t {
+  z_stream stream[3];
+  bool ready[3];
+  bool busy[3];
+  int level[3];
+
+  _context_t(){
+    memset(this->ready, 0x00, sizeof(this->ready));
+    memset(this->busy, 0x00, sizeof(this->busy));
+  }
+
+  ~_context_t(){
+    for (int i = 0; i < 3; i++){
+      if (this->ready[i]) deflateEnd(&(this->stream[i]));
+    }
+  }
+} context_t;
+
+static thread_local context_t __context;
+
+static bool __init(z_stream *stream, HTTPCompressor::encoding_t encoding, int level){
+  memset(stream, 0x00, sizeof(z_stream));
+  /* gzip wrapper for `gzip`, zlib wrapper for `deflate` (RFC 9110 section 8.4.1.2) */
+  int windowBits = (encoding == HTTPCompressor::ENCODING_GZIP ? 15 + 16 : 15);
+  return (deflateInit2(stream, level, Z_DEFLATED, windowBits, 8, Z_DEFAULT_STRATEGY) == Z_OK);
+}
+
+/**
+ * @brief Custom constructor for content encoding.
+ *
+ * This method is responsible for create new compressor which borrows the per-thread zlib stream of the encoding.
+ * A private stream is allocated only if the per-thread stream is already used by another compressor.
+ * This method will throw an error if the zlib stream can not be initialized.
+ */
+HTTPCompressor::HTTPCompressor(HTTPCompressor::encoding_t encoding, int level){
+  this->encoding = encoding;
+  this->stream = nullptr;
+  this->borrowed = false;
+  if (encoding == HTTPCompressor::ENCODING_IDENTITY) return;
+  int idx = static_cast<int>(encoding);
+  if (!__context.busy[idx]){
+    z_stream *stream = &(__context.stream[idx]);
+    if (!__context.ready[idx]){
+      if (!__init(stream, encoding, level)) throw std::runtime_error(std::string(__func__) + ": fail to init zlib stream");
+      __context.ready[idx] = true;
+      __context.level[idx] = level;
+    }
+    else if (__context.level[idx] != level){
+      deflateParams(stream, level, Z_DEFAULT_STRATEGY);
+      __context.level[idx] = level;
+    }
+    __context.busy[idx] = true;
+    this->stream = stream;
+    this->borrowed = true;
+    return;
+  }
+  z_stream *stream = new z_stream;
+  if (!__init(stream, encoding, level)){
+    delete stream;
+    throw std::runtime_error(std::string(__func__) + ": fail to init zlib stream");
+  }
+  this->stream = stream;
+}
+
+/**
+ * @brief Compressor destructor.
+ *
+ * Return the zlib stream to the per-thread context.
+ */
+HTTPCompressor::~HTTPCompressor(){
+  if (this->stream == nullptr) return;
+  z_stream *stream = static_cast<z_stream *>(this->stream);
+  if (this->borrowed){
+    deflateReset(stream);
+    __context.busy[static_cast<int>(this->encoding)] = false;
+  }
+  else {
+    deflateEnd(stream);
+    delete stream;
+  }
+  this->stream = nullptr;
+}
+
+bool HTTPCompressor::process(const char *data, size_t length, int flush, std::string &output){
+  if (this->stream == nullptr){
+    if (length > 0) output.append(data, length);
+    return true;
+  }
+  z_stream *stream = static_cast<z_stream *>(this->stream);
+  stream->next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data));
+  stream->avail_in = static_cast<uInt>(length);
+  int ret = Z_OK;
+  do {
+    size_t offset = output.length();
+    output.resize(offset + COMPRESSION_CHUNK);
+    stream->next_out = reinterpret_cast<Bytef *>(&output[offset]);
+    stream->avail_out = COMPRESSION_CHUNK;
+    ret = ::deflate(stream, flush);
+    output.resize(offset + COMPRESSION_CHUNK - stream->avail_out);
+    if (ret == Z_STREAM_ERROR) return false;
+  } while (stream->avail_out == 0 || (flush == Z_FINISH && ret != Z_STREAM_END));
+  if (flush == Z_FINISH) deflateReset(stream);
+  return true;
+}
+
+/**
+ * @brief Compress one chunk of the body.
+ *
+ * This method is responsible to compress the input and append the available compressed data to the output.
+ *
+ * @return `true` in success.
+ * @return `false` on fail.
+ */
+bool HTTPCompressor::compress(const char *data, size_t length, std::string &output){
+  return this->process(data, length, Z_NO_FLUSH, output);
+}
+
+/**
+ * @brief Flush the pending compressed data.
+ *
+ * This method is responsible to append all pending compressed data to the output (`Z_SYNC_FLUSH`), so the
+ * client can decode everything sent so far (e.g. for streaming responses).
+ *
+ * @return `true` in success.
+ * @return `false` on fail.
+ */
+bool HTTPCompressor::flush(std::string &output){
+  return this->process(nullptr, 0, Z_SYNC_FLUSH, output);
+}
+
+/**
+ * @brief Finish the compressed stream.
+ *
+ * This method is responsible to append the remaining compressed data and the stream trailer to the output.
+ * The compressor can be used for the next body after this call.
+ *
+ * @return `true` in success.
+ * @return `false` on fail.
+ */
+bool HTTPCompressor::finish(std::string &output){
+  return this->process(nullptr, 0, Z_FINISH, output);
+}
+
+/**
+ * @brief Gets the content encoding.
+ *
+ * @return The content encoding.
+ */
+HTTPCompressor::encoding_t HTTPCompressor::getEncoding() const {
+  return this->encoding;
+}
+
+/**
+ * @brief Gets the content encoding name.
+ *
+ * @return The `Content-Encoding` value.
+ */
+const char *HTTPCompressor::getEncodingName(HTTPCompressor::encoding_t encoding){
+  switch (encoding){
+    case HTTPCompressor::ENCODING_GZIP: return "gzip";
+    case HTTPCompressor::ENCODING_DEFLATE: return "deflate";
+    default: break;
+  }
+  return "identity";
+}
+
+/**
+ * @brief Check if the content is worth to compress.
+ *
+ * This method is responsible to reject small content and content types which are already compressed
+ * (images, audio, video, archives and fonts).
+ *
+ * @return `true` if the content is compressible.
+ * @return `false` if the content should be sent as is.
+ */
+bool HTTPCompressor::isCompressible(std::string_view contentType, size_t length){
+  static const char *compressible[] = {
+    "text/",
+    "application/json",
+    "application/javascript",
+    "application/xml",
+    "application/xhtml+xml",
+    "application/rss+xml",
+    "application/atom+xml",
+    "application/ld+json",
+    "application/manifest+json",
+    "application/wasm",
+    "image/svg+xml",
+    "image/x-icon",
+    "font/ttf",
+    "font/otf",
+    nullptr
+  };
+  if (length < HTTP_COMPRESSION_MIN_LENGTH) return false;
+  for (int i = 0; compressible[i] != nullptr; i++){
+    size_t prefix = strlen(compressible[i]);
+    if (contentType.length() < prefix) continue;
+    if (strncasecmp(contentType.data(), compressible[i], prefix) == 0) return true;
+  }
+  return false;
+}
+
+/* true if the comma separated list holds the token (or `*`, which already varies on every field) */
+static bool __hasToken(std::string_view list, std::string_view token){
+  size_t start = 0;
+  while (start <= list.length()){
+    size_t end = list.find(',', start);
+    if (end == std::string_view::npos) end = list.length();
+    std::string_view item = list.substr(start, end - start);
+    while (!item.empty() && (item.front() == ' ' || item.front() == '\t')) item.remove_prefix(1);
+    while (!item.empty() && (item.back() == ' ' || item.back() == '\t')) item.remove_suffix(1);
+    if (item == "*") return true;
+    if (item.length() == token.length() && strncasecmp(item.data(), token.data(), token.length()) == 0) return true;
+    start = end + 1;
+  }
+  return false;
+}
+
+/* the token is merged into the existing `Vary` rows, so the response keeps one `Vary` row */
+static void __vary(HTTPHeader &response, std::string_view token){
+  std::string merged;
+  for (HeaderNode *current = response.node; current != nullptr; current = current->next){
+    if (current->getField() != HeaderNode::VARY) continue;
+    std::string_view value = current->getValueView();
+    if (__hasToken(value, token)) return;
+    if (value.find_first_not_of(" \t") == std::string_view::npos) continue;
+    if (!merged.empty()) merged.append(", ");
+    merged.append(value);
+  }
+  if (!merged.empty()){
+    response.remove(HeaderNode::VARY);
+    merged.append(", ");
+  }
+  merged.append(token);
+  response.append(HeaderNode::VARY, std::move(merged));
+}
+
+/**
+ * @brief Select the content encoding of the response.
+ *
+ * This method is responsible to negotiate the content encoding with the `Accept-Encoding` node of the request.
+ * For compressible responses, `Accept-Encoding` is merged into the `Vary` row of the response and
+ * `Content-Encoding` is appended if the selected encoding is not `identity`. The response `Content-Length`
+ * (if any) must be appended by the caller after the body is compressed.
+ *
+ * @param[in] request The request HTTP Header.
+ * @param[in,out] response The response HTTP Header (must already contain `Content-Type`).
+ * @param[in] length The length of the uncompressed body.
+ * @return The selected content encoding.
+ */
+HTTPCompressor::encoding_t HTTPCompressor::prepare(const HTTPHeader &request, HTTPHeader &response, size_t length){
+  static const std::string_view offers[] = { "gzip", "deflate", "identity" };
+  static const HTTPCompressor::encoding_t encodings[] = {
+    HTTPCompressor::ENCODING_GZIP,
+    HTTPCompressor::ENCODING_DEFLATE,
+    HTTPCompressor::ENCODING_IDENTITY
+  };
+  if (response.getNode(HeaderNode::CONTENT_ENCODING) != nullptr) return HTTPCompressor::ENCODING_IDENTITY;
+  const HeaderNode *contentType = response.getNode(HeaderNode::CONTENT_TYPE);
+  if (contentType == nullptr || !HTTPCompressor::isCompressible(contentType->getValueView(), length)){
+    return HTTPCompressor::ENCODING_IDENTITY;
+  }
+  __vary(response, fieldName[HeaderNode::ACCEPT_ENCODING]);
+  int selected = HTTPNegotiation::select(request, HeaderNode::ACCEPT_ENCODING, offers, 3);
+  if (selected < 0 || encodings[selected] == HTTPCompressor::ENCODING_IDENTITY) return HTTPCompressor::ENCODING_IDENTITY;
+  response.append(HeaderNode::CONTENT_ENCODING, HTTPCompressor::getEncodingName(encodings[selected]));
+  return encodings[selected];
+}
+
+/* a variant without data (the body is sent as is) still holds its key and version */
+static size_t __charge(const std::string &key, const std::string &version, const std::shared_ptr<const std::string> &data){
+  return key.length() + version.length() + (data ? data->length() : 0);
+}
+
+/**
+ * @brief Custom constructor for cache budget.
+ *
+ * This method is responsible for create new compressed variant cache limited to `budget` bytes of compressed data
+ * (the key and version of every variant are counted too, so bodies which are sent as is also take their share).
+ */
+HTTPCompressionCache::HTTPCompressionCache(size_t budget){
+  this->budget = budget;
+  this->size = 0;
+}
+
+/**
+ * @brief Gets the compressed variant.
+ *
+ * This method is responsible to return the compressed variant of the body. The body is compressed only once
+ * for each key, version and encoding, the cached variant is replaced if the version of the same key changes.
+ * The body is not inspected on a hit, so the version must change whenever the body changes.
+ *
+ * @param[in] key The resource key (e.g. the target path).
+ * @param[in] version The version of the body (e.g. its `ETag` or modification time).
+ * @param[in] contentType The content type of the body.
+ * @param[in] body The uncompressed body.
+ * @param[in] encoding The content encoding.
+ * @return The compressed variant.
+ * @return `nullptr` if the body should be sent as is (too small, not compressible or not smaller after compression).
+ */
+std::shared_ptr<const std::string> HTTPCompressionCache::get(std::string_view key, std::string_view version, std::string_view contentType, std::string_view body, HTTPCompressor::encoding_t encoding){
+  if (encoding == HTTPCompressor::ENCODING_IDENTITY || !HTTPCompressor::isCompressible(contentType, body.length())) return nullptr;
+  std::string variantKey;
+  variantKey.reserve(key.length() + 2);
+  variantKey.append(key);
+  variantKey.push_back('\0');
+  variantKey.push_back(static_cast<char>('0' + encoding));
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    auto found = this->index.find(variantKey);
+    if (found != this->index.end()){
+      std::list<variant_t>::iterator variant = found->second;
+      if (variant->version == version && variant->sourceLength == body.length()){
+        this->variants.splice(this->variants.begin(), this->variants, variant);
+        return variant->data;
+      }
+      this->size -= __charge(variant->key, variant->version, variant->data);
+      this->index.erase(found);
+      this->variants.erase(variant);
+    }
+  }
+  /* compress outside of the lock, concurrent misses of the same key only waste one compression */
+  std::string compressed;
+  compressed.reserve(body.length() / 2);
+  HTTPCompressor compressor(encoding, 9);
+  if (!compressor.compress(body.data(), body.length(), compressed) || !compressor.finish(compressed)) return nullptr;
+  std::shared_ptr<const std::string> data;
+  if (compressed.length() < body.length()) data = std::make_shared<const std::string>(std::move(compressed));
+  size_t length = variantKey.length() + version.length() + (data ? data->length() : 0);
+  if (length > this->budget) return data;
+  std::lock_guard<std::mutex> lock(this->mutex);
+  if (this->index.find(variantKey) != this->index.end()) return data;
+  while (this->size + length > this->budget && !this->variants.empty()){
+    variant_t &victim = this->variants.back();
+    this->size -= __charge(victim.key, victim.version, victim.data);
+    this->index.erase(victim.key);
+    this->variants.pop_back();
+  }
+  this->variants.push_front(variant_t{ std::move(variantKey), std::string(version), body.length(), data });
+  this->index[this->variants.front().key] = this->variants.begin();
+  this->size += length;
+  return data;
+}
+
+/**
+ * @brief Remove all variants.
+ */
+void HTTPCompressionCache::clear(){
+  std::lock_guard<std::mutex> lock(this->mutex);
+  this->index.clear();
+  this->variants.clear();
+  this->size = 0;
+}
+
+/**
+ * @brief Gets the total size of the cached variants.
+ *
+ * @return The total size in bytes (compressed data, keys and versions).
+ */
+size_t HTTPCompressionCache::getSize(){
+  std::lock_guard<std::mutex> lock(this->mutex);
+  return this->size;
+}
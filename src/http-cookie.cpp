@@ -0,0 +1,324 @@
+/*
+ * $Id: http-cookie.cpp,v 1.0.0 2026/10/18 09:12:40 Jaya Wikrama Exp $
+ *
+ * Copyright (c) 2024 Jaya Wikrama
+ * jayawikrama89@gmail.com
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *  claim that you wrote the original software. If you use this software
+ *  in a product, an acknowledgment in the product documentation would be
+ *  appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *  misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include <cctype>
+#include <cstring>
+#include <cstdio>
+#include "http-cookie.hpp"
+
+static std::string_view __trim(std::string_view input){
+  while (!input.empty() && (input.front() == ' ' || input.front() == '\t')) input.remove_prefix(1);
+  while (!input.empty() && (input.back() == ' ' || input.back() == '\t')) input.remove_suffix(1);
+  return input;
+}
+
+/* cookie-name is a token (RFC 7230 `tchar`) */
+static bool __isToken(std::string_view name){
+  if (name.empty()) return false;
+  for (char c : name){
+    if (isalnum(static_cast<unsigned char>(c))) continue;
+    if (strchr("!#$%&'*+-.^_`|~", c) == nullptr || c == 0x00) return false;
+  }
+  return true;
+}
+
+/* cookie-value is *cookie-octet, optionally in double quotes (no CTL, whitespace, DQUOTE, comma, semicolon or backslash) */
+static bool __isValue(std::string_view value){
+  if (value.length() >= 2 && value.front() == '"' && value.back() == '"') value = value.substr(1, value.length() - 2);
+  for (char c : value){
+    unsigned char octet = static_cast<unsigned char>(c);
+    if (octet < 0x21 || octet > 0x7E || octet == '"' || octet == ',' || octet == ';' || octet == '\\') return false;
+  }
+  return true;
+}
+
+/* av-octet is any CHAR except CTL and semicolon */
+static bool __isAttribute(std::string_view value){
+  for (char c : value){
+    unsigned char octet = static_cast<unsigned char>(c);
+    if (octet < 0x20 || octet > 0x7E || octet == ';') return false;
+  }
+  return true;
+}
+
+/**
+ * @brief Default constructor for empty cookie list.
+ *
+ * This method is responsible for create blank cookie view.
+ */
+HTTPCookie::HTTPCookie(){
+  this->scanned = 0;
+  this->indexed = 0;
+}
+
+/**
+ * @brief Custom constructor for raw `Cookie` header value.
+ *
+ * This method is responsible for create cookie view over the raw header value (without copying it).
+ */
+HTTPCookie::HTTPCookie(std::string_view cookieHeader) : HTTPCookie::HTTPCookie() {
+  this->raw = cookieHeader;
+}
+
+/**
+ * @brief Overloaded custom constructor for raw `Cookie` header value.
+ *
+ * This method is responsible for create cookie view over the raw header value (without copying it).
+ */
+HTTPCookie::HTTPCookie(const char *cookieHeader) : HTTPCookie::HTTPCookie() {
+  if (cookieHeader != nullptr) this->raw = std::string_view(cookieHeader);
+}
+
+/**
+ * @brief Custom constructor for HTTP Header.
+ *
+ * This method is responsible for create cookie view over the `Cookie` node of the HTTP Header.
+ * The view is empty if the HTTP Header has no `Cookie` node.
+ */
+HTTPCookie::HTTPCookie(const HTTPHeader &header) : HTTPCookie::HTTPCookie() {
+  const HeaderNode *cookie = header.getNode(HeaderNode::COOKIE);
+  if (cookie != nullptr) this->raw = cookie->getValueView();
+}
+
+/**
+ * @brief Gets the next cookie.
+ *
+ * This method is responsible for tokenizing the cookie header one name/value pair at a time.
+ * Pairs without `=` or with an empty name are skipped.
+ * Start with `pos` = 0 and call repeatedly until it returns `false`.
+ *
+ * @param[in,out] pos The scan position inside the raw header value.
+ * @param[out] cookie The next cookie name and value.
+ * @return `true` if one cookie was found.
+ * @return `false` when there are no more cookies.
+ */
+bool HTTPCookie::next(size_t &pos, HTTPCookie::cookie_t &cookie) const {
+  while (pos < this->raw.length()){
+    const char *start = this->raw.data() + pos;
+    const char *end = static_cast<const char *>(memchr(start, ';', this->raw.length() - pos));
+    size_t length = (end == nullptr ? this->raw.length() - pos : static_cast<size_t>(end - start));
+    pos += length + 1;
+    std::string_view pair = __trim(std::string_view(start, length));
+    if (pair.empty()) continue;
+    /* a pair without a name can never be looked up, skip it */
+    size_t eq = pair.find('=');
+    if (eq == std::string_view::npos) continue;
+    cookie.name = __trim(pair.substr(0, eq));
+    if (cookie.name.empty()) continue;
+    cookie.value = __trim(pair.substr(eq + 1));
+    if (cookie.value.length() >= 2 && cookie.value.front() == '"' && cookie.value.back() == '"'){
+      cookie.value = cookie.value.substr(1, cookie.value.length() - 2);
+    }
+    return true;
+  }
+  pos = this->raw.length();
+  return false;
+}
+
+/**
+ * @brief Gets the value of a single cookie by name.
+ *
+ * This method is responsible for searching one cookie. The scan stops at the first match, and every
+ * pair scanned on the way is kept in a small index so the following lookups never rescan the
+ * same part of the header.
+ *
+ * @param[in] name The cookie name.
+ * @param[out] value The cookie value (view into the raw header value).
+ * @return `true` if the cookie is available.
+ * @return `false` if the cookie is not available.
+ */
+bool HTTPCookie::get(std::string_view name, std::string_view &value){
+  for (size_t i = 0; i < this->indexed; i++){
+    if (this->index[i].name == name){
+      value = this->index[i].value;
+      return true;
+    }
+  }
+  /* resume where the previous lookup stopped, pairs beyond the index capacity are never kept */
+  size_t pos = this->scanned;
+  HTTPCookie::cookie_t cookie;
+  while (this->next(pos, cookie)){
+    if (this->indexed < HTTP_COOKIE_INDEX_SIZE){
+      this->index[this->indexed++] = cookie;
+      this->scanned = pos;
+    }
+    if (cookie.name == name){
+      value = cookie.value;
+      return true;
+    }
+  }
+  if (this->indexed < HTTP_COOKIE_INDEX_SIZE) this->scanned = pos;
+  return false;
+}
+
+/**
+ * @brief Overloading of `get` method.
+ *
+ * This method is responsible for searching one cookie.
+ *
+ * @param[in] name The cookie name.
+ * @return The cookie value or empty view if the cookie is not available.
+ */
+std::string_view HTTPCookie::get(std::string_view name){
+  std::string_view value;
+  this->get(name, value);
+  return value;
+}
+
+/**
+ * @brief Check the cookie availability.
+ *
+ * This method is responsible for checking the cookie availability by name.
+ *
+ * @param[in] name The cookie name.
+ * @return `true` if the cookie is available.
+ * @return `false` if the cookie is not available.
+ */
+bool HTTPCookie::has(std::string_view name){
+  std::string_view value;
+  return this->get(name, value);
+}
+
+/**
+ * @brief Gets the raw `Cookie` header value.
+ *
+ * @return The raw header value.
+ */
+std::string_view HTTPCookie::getRaw() const {
+  return this->raw;
+}
+
+/**
+ * @brief Custom constructor for cookie name and value.
+ *
+ * This method is responsible for create new `Set-Cookie` builder. The builder keeps views of the
+ * input, so every string passed to it must outlive the call to `serialize`.
+ */
+HTTPSetCookie::HTTPSetCookie(std::string_view name, std::string_view value){
+  this->name = name;
+  this->value = value;
+  this->maxAge = -1;
+  this->expires = 0;
+  this->secure = false;
+  this->httpOnly = false;
+  this->sameSite = HTTPSetCookie::SAME_SITE_UNSET;
+}
+
+/**
+ * @brief Set the `Path` attribute.
+ */
+void HTTPSetCookie::setPath(std::string_view path){
+  this->path = path;
+}
+
+/**
+ * @brief Set the `Domain` attribute.
+ */
+void HTTPSetCookie::setDomain(std::string_view domain){
+  this->domain = domain;
+}
+
+/**
+ * @brief Set the `Max-Age` attribute (in seconds). Negative value removes the attribute.
+ */
+void HTTPSetCookie::setMaxAge(long maxAge){
+  this->maxAge = maxAge;
+}
+
+/**
+ * @brief Set the `Expires` attribute (unix epoch). Zero removes the attribute.
+ */
+void HTTPSetCookie::setExpires(time_t expires){
+  this->expires = expires;
+}
+
+/**
+ * @brief Set the `Secure` attribute.
+ */
+void HTTPSetCookie::setSecure(bool secure){
+  this->secure = secure;
+}
+
+/**
+ * @brief Set the `HttpOnly` attribute.
+ */
+void HTTPSetCookie::setHttpOnly(bool httpOnly){
+  this->httpOnly = httpOnly;
+}
+
+/**
+ * @brief Set the `SameSite` attribute.
+ */
+void HTTPSetCookie::setSameSite(HTTPSetCookie::sameSite_t sameSite){
+  this->sameSite = sameSite;
+}
+
+/**
+ * @brief Write the `Set-Cookie` row to the response payload.
+ *
+ * This method is responsible to append one complete `Set-Cookie` header row (terminated by CRLF)
+ * straight into the payload buffer used by `HTTPHeader::serialize`. Nothing is appended if the name is not
+ * a token, the value has a byte which is not a `cookie-octet` or the path or the domain has a control byte
+ * or `;` (RFC 6265 section 4.1.1), so no input can inject another attribute or header row.
+ *
+ * @param[in,out] payload The response payload buffer.
+ * @return `true` in success.
+ * @return `false` if the cookie is not valid.
+ */
+bool HTTPSetCookie::serialize(std::string &payload) const {
+  char tmp[64];
+  if (!__isToken(this->name) || !__isValue(this->value) || !__isAttribute(this->path) || !__isAttribute(this->domain)) return false;
+  payload.append(fieldName[HeaderNode::SET_COOKIE]);
+  payload.append(": ");
+  payload.append(this->name);
+  payload.push_back('=');
+  payload.append(this->value);
+  if (!this->path.empty()){
+    payload.append("; Path=");
+    payload.append(this->path);
+  }
+  if (!this->domain.empty()){
+    payload.append("; Domain=");
+    payload.append(this->domain);
+  }
+  if (this->maxAge >= 0){
+    int length = snprintf(tmp, sizeof(tmp), "; Max-Age=%li", this->maxAge);
+    payload.append(tmp, length);
+  }
+  if (this->expires != 0){
+    struct tm gmt;
+    gmtime_r(&(this->expires), &gmt);
+    size_t length = strftime(tmp, sizeof(tmp), "; Expires=%a, %d %b %Y %H:%M:%S GMT", &gmt);
+    payload.append(tmp, length);
+  }
+  if (this->secure) payload.append("; Secure");
+  if (this->httpOnly) payload.append("; HttpOnly");
+  switch (this->sameSite){
+    case HTTPSetCookie::SAME_SITE_STRICT: payload.append("; SameSite=Strict"); break;
+    case HTTPSetCookie::SAME_SITE_LAX: payload.append("; SameSite=Lax"); break;
+    case HTTPSetCookie::SAME_SITE_NONE: payload.append("; SameSite=None"); break;
+    default: break;
+  }
+  payload.append("\r\n");
+  return true;
+}
@@ -0,0 +1,410 @@
+/*
+ * $Id: http-event-stream.cpp,v 1.0.0 2026/10/18 18:36:02 Jaya Wikrama Exp $
+ *
+ * Copyright (c) 2024 Jaya Wikrama
+ * jayawikrama89@gmail.com
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *  claim that you wrote the original software. If you use this software
+ *  in a product, an acknowledgment in the product documentation would be
+ *  appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *  misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include <algorithm>
+#include "http-event-stream.hpp"
+
+/* the stream ends when the connection is closed, so the head has no Content-Length */
+static const char __head[] =
+  "HTTP/1.1 200 OK\r\n"
+  "Content-Type: text/event-stream\r\n"
+  "Cache-Control: no-cache\r\n"
+  "X-Accel-Buffering: no\r\n"
+  "\r\n";
+
+static const char __ping[] = ":\n\n";
+
+/* the identifier and the event type are single line fields */
+static void __appendField(std::string &output, const char *name, size_t nameLength, std::string_view value){
+  output.append(name, nameLength);
+  for (char c : value){
+    if (c != '\r' && c != '\n') output.push_back(c);
+  }
+  output.push_back('\n');
+}
+
+static void __remove(std::vector<HTTPEventStream *> &list, HTTPEventStream *stream){
+  std::vector<HTTPEventStream *>::iterator it = std::find(list.begin(), list.end(), stream);
+  if (it == list.end()) return;
+  *it = list.back();
+  list.pop_back();
+}
+
+/**
+ * @brief Custom constructor.
+ *
+ * @param[in] pipeline The pipeline of the connection, the events are queued to its write buffer.
+ * @param[in] fd The socket file descriptor.
+ * @param[in] highWater The maximum number of queued bytes, the stream is closed if an event is sent above it.
+ */
+HTTPEventStream::HTTPEventStream(HTTPPipeline &pipeline, int fd, size_t highWater) : timer(this) {
+  this->pipeline = &pipeline;
+  this->fd = fd;
+  this->hub = nullptr;
+  this->slot = 0;
+  this->queued = 0;
+  this->highWater = highWater;
+  this->dirty = false;
+  this->blocked = false;
+  this->active = false;
+  this->closed = false;
+}
+
+/**
+ * @brief Destructor.
+ *
+ * This method is responsible to detach the stream from the hub and unsubscribe it from every channel.
+ */
+HTTPEventStream::~HTTPEventStream(){
+  while (!this->channels.empty()) this->channels.back()->unsubscribe(*this);
+  if (this->hub != nullptr) this->hub->detach(*this);
+}
+
+/**
+ * @brief Send one event.
+ *
+ * This method is responsible to format the event into the write buffer, it is written by the next
+ * `HTTPEventHub::flush`.
+ *
+ * @param[in] data The event data (a multi-line data is sent as several `data` fields).
+ * @param[in] event The event type or empty for the default `message` type.
+ * @param[in] id The event identifier or empty.
+ */
+void HTTPEventStream::send(std::string_view data, std::string_view event, std::string_view id){
+  if (!this->reserve()) return;
+  std::string &buffer = this->pipeline->getBuffer();
+  size_t length = buffer.length();
+  HTTPEventStream::format(buffer, data, event, id);
+  this->queued += buffer.length() - length;
+  this->touch();
+}
+
+/**
+ * @brief Send one formatted event.
+ *
+ * This method is responsible to queue the shared event (see `format`) without copying it.
+ *
+ * @param[in] event The formatted event.
+ */
+void HTTPEventStream::send(std::shared_ptr<const std::string> event){
+  if (event == nullptr || !this->reserve()) return;
+  this->queued += event->length();
+  this->pipeline->queue(std::move(event));
+  this->touch();
+}
+
+/**
+ * @brief Write the queued events.
+ *
+ * This method is responsible to write the pending data, e.g. when the socket is writable again after
+ * `HTTPEventHub::flush` left some data queued.
+ *
+ * @return The number of bytes written.
+ * @return `-1` on fail (the stream is closed).
+ */
+ssize_t HTTPEventStream::flush(){
+  if (this->closed) return -1;
+  ssize_t ret = this->pipeline->flush(this->fd);
+  if (ret < 0){
+    this->closed = true;
+    return ret;
+  }
+  /* the pipeline may also hold the data queued before the stream was attached */
+  if (!this->pipeline->isPending()) this->queued = 0;
+  else this->queued -= std::min(this->queued, static_cast<size_t>(ret));
+  return ret;
+}
+
+/**
+ * @brief Check the stream state.
+ *
+ * @return `true` if a write failed or the high-water mark was exceeded, the connection should be closed.
+ */
+bool HTTPEventStream::isClosed() const {
+  return this->closed;
+}
+
+/**
+ * @brief Check the queued data.
+ *
+ * @return `true` if some data is not written yet, the caller should wait until the socket is writable.
+ */
+bool HTTPEventStream::isPending() const {
+  return this->pipeline->isPending();
+}
+
+/**
+ * @brief Gets the number of queued bytes.
+ *
+ * @return The number of bytes queued by the stream and not written yet.
+ */
+size_t HTTPEventStream::getQueued() const {
+  return this->queued;
+}
+
+/**
+ * @brief Format one event.
+ *
+ * @param[out] output The formatted event is appended here.
+ * @param[in] data The event data.
+ * @param[in] event The event type or empty.
+ * @param[in] id The event identifier or empty.
+ */
+void HTTPEventStream::format(std::string &output, std::string_view data, std::string_view event, std::string_view id){
+  if (!id.empty()) __appendField(output, "id: ", 4, id);
+  if (!event.empty()) __appendField(output, "event: ", 7, event);
+  /* every line of the data is one data field, CRLF, LF and CR are line ends */
+  size_t pos = 0;
+  do {
+    size_t end = data.find_first_of("\r\n", pos);
+    if (end == std::string_view::npos) end = data.length();
+    output.append("data: ", 6);
+    output.append(data.data() + pos, end - pos);
+    output.push_back('\n');
+    pos = end;
+    if (pos < data.length() && data[pos] == '\r') pos++;
+    if (pos < data.length() && data[pos] == '\n') pos++;
+  } while (pos < data.length());
+  output.push_back('\n');
+}
+
+/**
+ * @brief Gets the response head.
+ *
+ * @return The serialized `200 OK` head of the event stream (without `Content-Length`).
+ */
+std::string_view HTTPEventStream::getHead(){
+  return std::string_view(__head, sizeof(__head) - 1);
+}
+
+bool HTTPEventStream::reserve(){
+  if (this->closed) return false;
+  if (this->queued < this->highWater) return true;
+  /* the client does not read, dropping events would leave a hole in the stream */
+  this->closed = true;
+  this->touch();
+  return false;
+}
+
+void HTTPEventStream::touch(){
+  this->active = true;
+  if (this->hub == nullptr || this->dirty) return;
+  this->dirty = true;
+  this->hub->ready.push_back(this);
+}
+
+/**
+ * @brief Custom constructor.
+ *
+ * @param[in] wheel The timer wheel of the reactor (the ping interval is the `HTTPTimer::EVENT_PING` timeout).
+ */
+HTTPEventHub::HTTPEventHub(HTTPTimerWheel &wheel) : wheel(wheel) {}
+
+/**
+ * @brief Destructor.
+ *
+ * This method is responsible to detach all streams.
+ */
+HTTPEventHub::~HTTPEventHub(){
+  while (!this->streams.empty()) this->detach(*this->streams.back());
+}
+
+/**
+ * @brief Attach one stream.
+ *
+ * This method is responsible to queue the response head and schedule the ping of the stream.
+ *
+ * @param[in] stream The stream.
+ */
+void HTTPEventHub::attach(HTTPEventStream &stream){
+  if (stream.hub != nullptr) return;
+  stream.hub = this;
+  stream.slot = this->streams.size();
+  this->streams.push_back(&stream);
+  stream.pipeline->queue(__head, sizeof(__head) - 1);
+  stream.queued += sizeof(__head) - 1;
+  stream.touch();
+  this->wheel.schedule(stream.timer, HTTPTimer::EVENT_PING);
+}
+
+/**
+ * @brief Detach one stream.
+ *
+ * @param[in] stream The stream.
+ */
+void HTTPEventHub::detach(HTTPEventStream &stream){
+  if (stream.hub != this) return;
+  this->wheel.cancel(stream.timer);
+  if (stream.dirty) __remove(this->ready, &stream);
+  if (stream.blocked) __remove(this->pending, &stream);
+  HTTPEventStream *last = this->streams.back();
+  this->streams[stream.slot] = last;
+  last->slot = stream.slot;
+  this->streams.pop_back();
+  stream.hub = nullptr;
+  stream.dirty = false;
+  stream.blocked = false;
+}
+
+/**
+ * @brief Write the streams.
+ *
+ * This method is responsible to write every stream which has new data since the last call, it should be
+ * called once per event loop iteration. The streams which still have data are listed by `getPending`.
+ *
+ * @return The number of streams which failed or exceeded the high-water mark (they are closed, see
+ * `HTTPEventStream::isClosed`).
+ */
+size_t HTTPEventHub::flush(){
+  size_t failed = 0;
+  /* the blocked streams which were written by the caller (or closed) since the last call leave the list */
+  size_t count = 0;
+  for (HTTPEventStream *stream : this->pending){
+    if (stream->closed || !stream->pipeline->isPending()){
+      stream->blocked = false;
+      continue;
+    }
+    this->pending[count++] = stream;
+  }
+  this->pending.resize(count);
+  for (HTTPEventStream *stream : this->ready){
+    stream->dirty = false;
+    if (stream->closed || stream->flush() < 0){
+      failed++;
+      continue;
+    }
+    if (stream->blocked || !stream->pipeline->isPending()) continue;
+    stream->blocked = true;
+    this->pending.push_back(stream);
+  }
+  this->ready.clear();
+  return failed;
+}
+
+/**
+ * @brief Gets the blocked streams.
+ *
+ * This method is responsible to return the streams which still had data after the last `flush`, the caller
+ * should arm `EPOLLOUT` for them and call `HTTPEventStream::flush` when the socket is writable. The list is
+ * valid until the next `flush`.
+ *
+ * @return The blocked streams.
+ */
+const std::vector<HTTPEventStream *> &HTTPEventHub::getPending() const {
+  return this->pending;
+}
+
+/**
+ * @brief Handle one expired ping timer.
+ *
+ * This method is responsible to queue a comment ping if the stream was idle since the last ping and schedule
+ * the next ping. It should be called by the expired handler of the wheel for the `HTTPTimer::EVENT_PING` timers.
+ *
+ * @param[in] timer The expired timer.
+ */
+void HTTPEventHub::expire(HTTPTimer &timer){
+  HTTPEventStream *stream = static_cast<HTTPEventStream *>(timer.data);
+  if (stream == nullptr || stream->hub != this || stream->closed) return;
+  if (!stream->active){
+    if (!stream->reserve()) return;
+    stream->pipeline->queue(__ping, sizeof(__ping) - 1);
+    stream->queued += sizeof(__ping) - 1;
+    stream->touch();
+  }
+  stream->active = false;
+  this->wheel.schedule(stream->timer, HTTPTimer::EVENT_PING);
+}
+
+/**
+ * @brief Default constructor for empty channel.
+ */
+HTTPEventChannel::HTTPEventChannel(){}
+
+/**
+ * @brief Destructor.
+ *
+ * This method is responsible to unsubscribe all streams.
+ */
+HTTPEventChannel::~HTTPEventChannel(){
+  while (!this->subscribers.empty()) this->unsubscribe(*this->subscribers.back());
+}
+
+/**
+ * @brief Subscribe one stream.
+ *
+ * @param[in] stream The stream.
+ */
+void HTTPEventChannel::subscribe(HTTPEventStream &stream){
+  if (std::find(stream.channels.begin(), stream.channels.end(), this) != stream.channels.end()) return;
+  stream.channels.push_back(this);
+  this->subscribers.push_back(&stream);
+}
+
+/**
+ * @brief Unsubscribe one stream.
+ *
+ * @param[in] stream The stream.
+ */
+void HTTPEventChannel::unsubscribe(HTTPEventStream &stream){
+  std::vector<HTTPEventChannel *>::iterator it = std::find(stream.channels.begin(), stream.channels.end(), this);
+  if (it == stream.channels.end()) return;
+  stream.channels.erase(it);
+  __remove(this->subscribers, &stream);
+}
+
+/**
+ * @brief Publish one event.
+ *
+ * This method is responsible to format the event once and queue the shared buffer to every subscriber.
+ *
+ * @param[in] data The event data.
+ * @param[in] event The event type or empty.
+ * @param[in] id The event identifier or empty.
+ * @return The number of subscribers.
+ */
+size_t HTTPEventChannel::publish(std::string_view data, std::string_view event, std::string_view id){
+  if (this->subscribers.empty()) return 0;
+  std::shared_ptr<std::string> formatted = std::make_shared<std::string>();
+  HTTPEventStream::format(*formatted, data, event, id);
+  return this->publish(std::shared_ptr<const std::string>(std::move(formatted)));
+}
+
+/**
+ * @brief Publish one formatted event.
+ *
+ * @param[in] event The formatted event (see `HTTPEventStream::format`).
+ * @return The number of subscribers.
+ */
+size_t HTTPEventChannel::publish(std::shared_ptr<const std::string> event){
+  for (HTTPEventStream *stream : this->subscribers) stream->send(event);
+  return this->subscribers.size();
+}
+
+/**
+ * @brief Gets the number of subscribers.
+ *
+ * @return The number of subscribers.
+ */
+size_t HTTPEventChannel::size() const {
+  return this->subscribers.size();
+}
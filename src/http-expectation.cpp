@@ -0,0 +1,154 @@
+/*
+ * $Id: http-expectation.cpp,v 1.0.0 2026/10/18 18:14:37 Jaya Wikrama Exp $
+ *
+ * Copyright (c) 2024 Jaya Wikrama
+ * jayawikrama89@gmail.com
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *  claim that you wrote the original software. If you use this software
+ *  in a product, an acknowledgment in the product documentation would be
+ *  appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *  misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include <strings.h>
+#include "http-expectation.hpp"
+#include "http-static-response.hpp"
+
+static constexpr auto __continue = HTTPStaticResponse<64>::build(HttpStatus::CONTINUE);
+
+static constexpr auto __expectationFailed = HTTPStaticResponse<128>::build(
+  HttpStatus::EXPECTATION_FAILED,
+  HeaderNode::CONNECTION, "close"
+);
+
+static constexpr auto __badRequest = HTTPStaticResponse<128>::build(
+  HttpStatus::BAD_REQUEST,
+  HeaderNode::CONNECTION, "close"
+);
+
+static constexpr auto __payloadTooLarge = HTTPStaticResponse<128>::build(
+  HttpStatus::PAYLOAD_TOO_LARGE,
+  HeaderNode::CONNECTION, "close"
+);
+
+static std::string_view __trim(std::string_view input){
+  while (!input.empty() && (input.front() == ' ' || input.front() == '\t')) input.remove_prefix(1);
+  while (!input.empty() && (input.back() == ' ' || input.back() == '\t')) input.remove_suffix(1);
+  return input;
+}
+
+/* the expectation of the request, empty if there is none or it must be ignored (HTTP/1.0) */
+static std::string_view __expectation(const HTTPHeader &request){
+  if (request.getVersion() == "1.0") return std::string_view();
+  HeaderNode *expect = request.getNode(HeaderNode::EXPECT);
+  if (expect == nullptr) return std::string_view();
+  return __trim(expect->getValueView());
+}
+
+static bool __isContinue(std::string_view expectation){
+  static const char token[] = "100-continue";
+  return (expectation.length() == sizeof(token) - 1 && strncasecmp(expectation.data(), token, sizeof(token) - 1) == 0);
+}
+
+static bool __number(const std::string &text, uint64_t &number){
+  if (text.empty()) return false;
+  number = 0;
+  for (char c : text){
+    if (c < '0' || c > '9' || number > (UINT64_MAX - 9) / 10) return false;
+    number = number * 10 + static_cast<uint64_t>(c - '0');
+  }
+  return true;
+}
+
+/**
+ * @brief Custom constructor.
+ *
+ * @param[in] maxBody The largest accepted `Content-Length`.
+ */
+HTTPExpectation::HTTPExpectation(uint64_t maxBody){
+  this->maxBody = maxBody;
+}
+
+/**
+ * @brief Add one header-only check.
+ *
+ * This method is responsible to register one check, the checks run in the registration order and the
+ * first rejection wins.
+ *
+ * @param[in] check The check.
+ * @param[in] context The check context.
+ */
+void HTTPExpectation::addCheck(HTTPExpectation::check_t check, void *context){
+  if (check == nullptr) return;
+  this->checks.push_back(HTTPExpectation::entry_t{ check, context });
+}
+
+/**
+ * @brief Evaluate the request head.
+ *
+ * This method is responsible to validate the expectation (only `100-continue` is supported, it is ignored
+ * for HTTP/1.0), compare the `Content-Length` with the limit and run the checks, before the body is read.
+ *
+ * @param[in] request The request header.
+ * @return `HttpStatus::CONTINUE` if the client waits for `100 Continue` and the body is accepted.
+ * @return `HttpStatus::OK` if the body (if any) is accepted and no interim response is expected.
+ * @return `HttpStatus::EXPECTATION_FAILED` if the expectation is not supported.
+ * @return `HttpStatus::BAD_REQUEST` if the `Content-Length` is malformed.
+ * @return `HttpStatus::PAYLOAD_TOO_LARGE` if the `Content-Length` exceeds the limit.
+ * @return The status code returned by the first rejecting check.
+ */
+HttpStatus::Code_t HTTPExpectation::evaluate(const HTTPHeader &request) const {
+  std::string_view expectation = __expectation(request);
+  bool expecting = __isContinue(expectation);
+  if (!expectation.empty() && !expecting) return HttpStatus::EXPECTATION_FAILED;
+  HeaderNode *length = request.getNode(HeaderNode::CONTENT_LENGTH);
+  if (length != nullptr){
+    uint64_t contentLength = 0;
+    if (!__number(length->getValue(), contentLength)) return HttpStatus::BAD_REQUEST;
+    if (contentLength > this->maxBody) return HttpStatus::PAYLOAD_TOO_LARGE;
+  }
+  for (const HTTPExpectation::entry_t &entry : this->checks){
+    HttpStatus::Code_t code = entry.check(request, entry.context);
+    if (code != HttpStatus::OK) return code;
+  }
+  return (expecting ? HttpStatus::CONTINUE : HttpStatus::OK);
+}
+
+/**
+ * @brief Check the expectation of the request.
+ *
+ * @param[in] request The request header.
+ * @return `true` if the request has `Expect: 100-continue` and the client waits for the interim response.
+ */
+bool HTTPExpectation::isExpectingContinue(const HTTPHeader &request){
+  return __isContinue(__expectation(request));
+}
+
+/**
+ * @brief Gets the precompiled response.
+ *
+ * @param[in] code `HttpStatus::CONTINUE`, `HttpStatus::EXPECTATION_FAILED`, `HttpStatus::BAD_REQUEST` or
+ * `HttpStatus::PAYLOAD_TOO_LARGE`.
+ * @return The serialized response or an empty view for the other status codes.
+ */
+std::string_view HTTPExpectation::getResponse(HttpStatus::Code_t code){
+  switch (code){
+    case HttpStatus::CONTINUE: return __continue.view();
+    case HttpStatus::EXPECTATION_FAILED: return __expectationFailed.view();
+    case HttpStatus::BAD_REQUEST: return __badRequest.view();
+    case HttpStatus::PAYLOAD_TOO_LARGE: return __payloadTooLarge.view();
+    default: break;
+  }
+  return std::string_view();
+}
@@ -0,0 +1,390 @@
+/*
+ * $Id: http-handover.cpp,v 1.0.0 2026/10/18 18:58:24 Jaya Wikrama Exp $
+ *
+ * Copyright (c) 2024 Jaya Wikrama
+ * jayawikrama89@gmail.com
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *  claim that you wrote the original software. If you use this software
+ *  in a product, an acknowledgment in the product documentation would be
+ *  appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *  misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "http-handover.hpp"
+#include "http-timer-wheel.hpp"
+
+#define HTTP_HANDOVER_MAGIC "CWL-HANDOVER"
+#define HTTP_HANDOVER_READY "READY\n"
+
+static bool __address(const std::string &path, struct sockaddr_un &address, socklen_t &length){
+  memset(&address, 0x00, sizeof(address));
+  address.sun_family = AF_UNIX;
+  if (path.empty() || path.length() >= sizeof(address.sun_path)) return false;
+  if (path[0] == '@'){
+    /* abstract name, the leading zero byte is the marker */
+    memcpy(address.sun_path + 1, path.data() + 1, path.length() - 1);
+    length = static_cast<socklen_t>(offsetof(struct sockaddr_un, sun_path) + path.length());
+  }
+  else {
+    memcpy(address.sun_path, path.data(), path.length());
+    length = static_cast<socklen_t>(offsetof(struct sockaddr_un, sun_path) + path.length() + 1);
+  }
+  return true;
+}
+
+static bool __isFile(const std::string &path){
+  return (!path.empty() && path[0] != '@');
+}
+
+static bool __sendFds(int fd, const std::vector<int> &fds){
+  char text[32];
+  int textLength = snprintf(text, sizeof(text), HTTP_HANDOVER_MAGIC " %zu\n", fds.size());
+  struct iovec iov;
+  iov.iov_base = text;
+  iov.iov_len = static_cast<size_t>(textLength);
+  union {
+    char buffer[CMSG_SPACE(sizeof(int) * HTTP_HANDOVER_MAX_FD)];
+    struct cmsghdr align;
+  } control;
+  memset(&control, 0x00, sizeof(control));
+  struct msghdr message;
+  memset(&message, 0x00, sizeof(message));
+  message.msg_iov = &iov;
+  message.msg_iovlen = 1;
+  if (!fds.empty()){
+    message.msg_control = control.buffer;
+    message.msg_controllen = CMSG_SPACE(sizeof(int) * fds.size());
+    struct cmsghdr *header = CMSG_FIRSTHDR(&message);
+    header->cmsg_level = SOL_SOCKET;
+    header->cmsg_type = SCM_RIGHTS;
+    header->cmsg_len = CMSG_LEN(sizeof(int) * fds.size());
+    memcpy(CMSG_DATA(header), fds.data(), sizeof(int) * fds.size());
+  }
+  ssize_t ret;
+  do {
+    ret = sendmsg(fd, &message, MSG_NOSIGNAL);
+  } while (ret < 0 && errno == EINTR);
+  return (ret == textLength);
+}
+
+static bool __receiveFds(int fd, std::vector<int> &fds){
+  char text[32];
+  struct iovec iov;
+  iov.iov_base = text;
+  iov.iov_len = sizeof(text) - 1;
+  union {
+    char buffer[CMSG_SPACE(sizeof(int) * HTTP_HANDOVER_MAX_FD)];
+    struct cmsghdr align;
+  } control;
+  struct msghdr message;
+  memset(&message, 0x00, sizeof(message));
+  message.msg_iov = &iov;
+  message.msg_iovlen = 1;
+  message.msg_control = control.buffer;
+  message.msg_controllen = sizeof(control.buffer);
+  ssize_t ret;
+  do {
+    ret = recvmsg(fd, &message, MSG_CMSG_CLOEXEC);
+  } while (ret < 0 && errno == EINTR);
+  if (ret <= 0) return false;
+  text[ret] = 0x00;
+  /* the received descriptors are installed even if the message is malformed, so they are always collected */
+  std::vector<int> received;
+  for (struct cmsghdr *header = CMSG_FIRSTHDR(&message); header != nullptr; header = CMSG_NXTHDR(&message, header)){
+    if (header->cmsg_level != SOL_SOCKET || header->cmsg_type != SCM_RIGHTS) continue;
+    size_t count = (header->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+    for (size_t i = 0; i < count; i++){
+      int descriptor;
+      memcpy(&descriptor, CMSG_DATA(header) + i * sizeof(int), sizeof(int));
+      received.push_back(descriptor);
+    }
+  }
+  size_t expected = 0;
+  bool valid = (sscanf(text, HTTP_HANDOVER_MAGIC " %zu", &expected) == 1 && expected == received.size() && !(message.msg_flags & MSG_CTRUNC));
+  if (!valid){
+    for (int descriptor : received) close(descriptor);
+    return false;
+  }
+  fds = std::move(received);
+  return true;
+}
+
+/**
+ * @brief Custom constructor.
+ *
+ * @param[in] path The control socket path or `@name` for an abstract socket.
+ */
+HTTPHandover::HTTPHandover(const std::string &path){
+  this->path = path;
+  this->control = -1;
+  this->peer = -1;
+  this->state = HTTPHandover::IDLE;
+  this->deadline = 0;
+  this->device = 0;
+  this->inode = 0;
+}
+
+/**
+ * @brief Destructor.
+ *
+ * This method is responsible to close the control socket (the listening sockets are owned by the caller).
+ */
+HTTPHandover::~HTTPHandover(){
+  this->closePeer();
+  this->closeControl();
+}
+
+/**
+ * @brief Serve the listening sockets.
+ *
+ * This method is responsible to open the non-blocking control socket which hands the listening sockets over to
+ * the next process. A stale control socket file is replaced, the new file is created with mode 0600.
+ *
+ * @param[in] listeners The listening sockets (at most `HTTP_HANDOVER_MAX_FD`).
+ * @return `true` in success.
+ * @return `false` if the control socket can not be opened.
+ */
+bool HTTPHandover::serve(const std::vector<int> &listeners){
+  struct sockaddr_un address;
+  socklen_t length = 0;
+  if (listeners.size() > HTTP_HANDOVER_MAX_FD || !__address(this->path, address, length)) return false;
+  this->closePeer();
+  this->closeControl();
+  this->control = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (this->control < 0) return false;
+  if (__isFile(this->path)) unlink(this->path.c_str());
+  if (bind(this->control, reinterpret_cast<struct sockaddr *>(&address), length) != 0){
+    close(this->control);
+    this->control = -1;
+    return false;
+  }
+  if (__isFile(this->path)){
+    /* nobody can connect before listen, so the mode is restricted before the socket is reachable */
+    struct stat info;
+    if (chmod(this->path.c_str(), S_IRUSR | S_IWUSR) != 0 || stat(this->path.c_str(), &info) != 0){
+      unlink(this->path.c_str());
+      close(this->control);
+      this->control = -1;
+      return false;
+    }
+    this->device = info.st_dev;
+    this->inode = info.st_ino;
+  }
+  if (listen(this->control, 1) != 0){
+    this->closeControl();
+    return false;
+  }
+  this->listeners = listeners;
+  this->state = HTTPHandover::SERVING;
+  return true;
+}
+
+/**
+ * @brief Gets the descriptor to wait for.
+ *
+ * @return The control socket (`SERVING`), the connection of the new process (`HANDING_OVER`) or `-1`.
+ */
+int HTTPHandover::getFd() const {
+  if (this->state == HTTPHandover::SERVING) return this->control;
+  if (this->state == HTTPHandover::HANDING_OVER) return this->peer;
+  return -1;
+}
+
+/**
+ * @brief Handle the readable control descriptor.
+ *
+ * This method is responsible to send the listening sockets to the connecting process, then wait for its
+ * `READY`. On `READY` the control socket is closed and the handover starts draining: the caller must stop
+ * accepting and close its listening sockets.
+ *
+ * @param[in] drainTimeout The drain deadline in milliseconds from the `READY`.
+ * @param[in] readyTimeout The deadline of the `READY` in milliseconds from the connection (see `check`).
+ * @return The state after the event.
+ */
+HTTPHandover::state_t HTTPHandover::process(uint64_t drainTimeout, uint64_t readyTimeout){
+  if (this->state == HTTPHandover::SERVING){
+    this->peer = accept4(this->control, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (this->peer < 0) return this->state;
+    /* the listening sockets are given to the processes of the same user only */
+    struct ucred credential;
+    socklen_t length = sizeof(credential);
+    if (getsockopt(this->peer, SOL_SOCKET, SO_PEERCRED, &credential, &length) != 0 || credential.uid != geteuid() ||
+        !__sendFds(this->peer, this->listeners)){
+      this->closePeer();
+      return this->state;
+    }
+    this->state = HTTPHandover::HANDING_OVER;
+    this->deadline = HTTPTimerWheel::now() + readyTimeout;
+  }
+  else if (this->state == HTTPHandover::HANDING_OVER){
+    char buffer[16];
+    ssize_t ret = read(this->peer, buffer, sizeof(buffer));
+    if (ret < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) return this->state;
+    this->closePeer();
+    if (ret == static_cast<ssize_t>(sizeof(HTTP_HANDOVER_READY) - 1) && memcmp(buffer, HTTP_HANDOVER_READY, sizeof(HTTP_HANDOVER_READY) - 1) == 0){
+      this->closeControl();
+      this->state = HTTPHandover::DRAINING;
+      this->deadline = HTTPTimerWheel::now() + drainTimeout;
+    }
+    else {
+      /* the new process died before it was ready, keep serving */
+      this->state = HTTPHandover::SERVING;
+    }
+  }
+  return this->state;
+}
+
+/**
+ * @brief Check the ready deadline.
+ *
+ * This method is responsible to give up the handover if the new process did not report `READY` in time
+ * (e.g. it hangs in the warm-up): the connection is closed and the process keeps serving.
+ *
+ * @param[in] now The current time in milliseconds (see `HTTPTimerWheel::now`).
+ * @return The state after the check.
+ */
+HTTPHandover::state_t HTTPHandover::check(uint64_t now){
+  if (this->state == HTTPHandover::HANDING_OVER && now >= this->deadline){
+    this->closePeer();
+    this->state = HTTPHandover::SERVING;
+  }
+  return this->state;
+}
+
+/**
+ * @brief Gets the state.
+ *
+ * @return The handover state.
+ */
+HTTPHandover::state_t HTTPHandover::getState() const {
+  return this->state;
+}
+
+/**
+ * @brief Check the drain deadline.
+ *
+ * @param[in] now The current time in milliseconds (see `HTTPTimerWheel::now`).
+ * @return `true` if the process is draining and the deadline passed (the remaining connections should be closed).
+ */
+bool HTTPHandover::isExpired(uint64_t now) const {
+  return (this->state == HTTPHandover::DRAINING && now >= this->deadline);
+}
+
+/**
+ * @brief Prepare one response while draining.
+ *
+ * This method is responsible to add `Connection: close` to the response while draining, so the keep-alive
+ * clients reconnect to the new process.
+ *
+ * @param[in,out] response The response header.
+ * @return `true` if the connection should be closed after the response.
+ */
+bool HTTPHandover::prepare(HTTPHeader &response) const {
+  if (this->state != HTTPHandover::DRAINING) return false;
+  response.remove(HeaderNode::CONNECTION);
+  response.append(HeaderNode::CONNECTION, std::string("close"));
+  return true;
+}
+
+/**
+ * @brief Receive the listening sockets.
+ *
+ * This method is responsible to connect to the control socket of the running process and receive its
+ * listening sockets.
+ *
+ * @param[out] listeners The received listening sockets.
+ * @param[in] timeout The timeout in milliseconds.
+ * @return `true` in success.
+ * @return `false` if no process serves the control socket or the timeout expired.
+ */
+bool HTTPHandover::connect(std::vector<int> &listeners, int timeout){
+  struct sockaddr_un address;
+  socklen_t length = 0;
+  if (!__address(this->path, address, length)) return false;
+  this->closePeer();
+  this->peer = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (this->peer < 0) return false;
+  if (::connect(this->peer, reinterpret_cast<struct sockaddr *>(&address), length) != 0){
+    this->closePeer();
+    return false;
+  }
+  struct pollfd pfd = { this->peer, POLLIN, 0 };
+  int ret;
+  do {
+    ret = poll(&pfd, 1, timeout);
+  } while (ret < 0 && errno == EINTR);
+  if (ret <= 0 || !__receiveFds(this->peer, listeners)){
+    this->closePeer();
+    return false;
+  }
+  return true;
+}
+
+/**
+ * @brief Add one warm-up callback.
+ *
+ * @param[in] warmup The callback.
+ * @param[in] context The callback context.
+ */
+void HTTPHandover::addWarmup(HTTPHandover::warmup_t warmup, void *context){
+  if (warmup == nullptr) return;
+  this->warmups.push_back(HTTPHandover::warmupEntry_t{ warmup, context });
+}
+
+/**
+ * @brief Report ready.
+ *
+ * This method is responsible to run the warm-up callbacks and then tell the old process to stop accepting.
+ *
+ * @return `true` in success.
+ * @return `false` if there is no old process (the callbacks still run).
+ */
+bool HTTPHandover::ready(){
+  for (const HTTPHandover::warmupEntry_t &entry : this->warmups) entry.warmup(entry.context);
+  if (this->peer < 0) return false;
+  ssize_t ret;
+  do {
+    ret = send(this->peer, HTTP_HANDOVER_READY, sizeof(HTTP_HANDOVER_READY) - 1, MSG_NOSIGNAL);
+  } while (ret < 0 && errno == EINTR);
+  this->closePeer();
+  return (ret == static_cast<ssize_t>(sizeof(HTTP_HANDOVER_READY) - 1));
+}
+
+void HTTPHandover::closePeer(){
+  if (this->peer < 0) return;
+  close(this->peer);
+  this->peer = -1;
+}
+
+void HTTPHandover::closeControl(){
+  if (this->control < 0) return;
+  struct stat current;
+  /* the file is removed only if it was not replaced by the next process */
+  if (__isFile(this->path) && stat(this->path.c_str(), &current) == 0 && current.st_dev == this->device && current.st_ino == this->inode){
+    unlink(this->path.c_str());
+  }
+  this->device = 0;
+  this->inode = 0;
+  close(this->control);
+  this->control = -1;
+}
@@ -0,0 +1,333 @@
+/*
+ * $Id: http-head-index.cpp,v 1.0.0 2026/10/18 13:52:37 Jaya Wikrama Exp $
+ *
+ * Copyright (c) 2024 Jaya Wikrama
+ * jayawikrama89@gmail.com
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *  claim that you wrote the original software. If you use this software
+ *  in a product, an acknowledgment in the product documentation would be
+ *  appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *  misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "http-head-index.hpp"
+#include "http-header-table.hpp"
+
+typedef struct _chunk_t {
+  size_t begin;
+  size_t end;
+  size_t heads;
+  size_t base;
+} chunk_t;
+
+typedef struct _queue_t {
+  std::mutex mutex;
+  std::deque<size_t> tasks;
+} queue_t;
+
+/* every worker owns a contiguous range of tasks and takes them from the front, an idle worker steals from the back of the others */
+static bool __take(std::vector<queue_t> &queues, size_t worker, size_t &task){
+  for (size_t i = 0; i < queues.size(); i++){
+    queue_t &queue = queues[(worker + i) % queues.size()];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty()) continue;
+    if (i == 0){
+      task = queue.tasks.front();
+      queue.tasks.pop_front();
+    }
+    else {
+      task = queue.tasks.back();
+      queue.tasks.pop_back();
+    }
+    return true;
+  }
+  return false;
+}
+
+static void __run(size_t threads, size_t tasks, const std::function<void(size_t)> &job){
+  if (threads > tasks) threads = tasks;
+  if (threads <= 1){
+    for (size_t i = 0; i < tasks; i++) job(i);
+    return;
+  }
+  std::vector<queue_t> queues(threads);
+  for (size_t i = 0; i < tasks; i++) queues[i * threads / tasks].tasks.push_back(i);
+  auto worker = [&queues, &job](size_t id){
+    size_t task = 0;
+    while (__take(queues, id, task)) job(task);
+  };
+  std::vector<std::thread> pool;
+  for (size_t i = 1; i < threads; i++) pool.emplace_back(worker, i);
+  worker(0);
+  for (std::thread &thread : pool) thread.join();
+}
+
+static size_t __lineEnd(const char *buffer, size_t pos, size_t end){
+  const char *lf = static_cast<const char *>(memchr(buffer + pos, '\n', end - pos));
+  return (lf == nullptr ? end : static_cast<size_t>(lf - buffer));
+}
+
+/* the end of the first empty row (`\n\n` or `\n\r\n`) at or after `from`, or `length` */
+static size_t __boundary(const char *buffer, size_t from, size_t length){
+  while (from < length){
+    const char *lf = static_cast<const char *>(memchr(buffer + from, '\n', length - from));
+    if (lf == nullptr) break;
+    size_t pos = static_cast<size_t>(lf - buffer) + 1;
+    if (pos < length && buffer[pos] == '\n') return pos + 1;
+    if (pos + 1 < length && buffer[pos] == '\r' && buffer[pos + 1] == '\n') return pos + 2;
+    from = pos;
+  }
+  return length;
+}
+
+/*
+ * without columns the heads are only counted, with columns every value is written directly to its entry (the
+ * columns are allocated by the first chunk which has the field)
+ */
+static void __parse(const char *buffer, chunk_t &chunk, HTTPHeadIndex::span_t *starts, const std::function<HTTPHeadIndex::span_t *(size_t)> *columns){
+  std::vector<HTTPHeadIndex::span_t *> local;
+  size_t pos = chunk.begin;
+  chunk.heads = 0;
+  while (pos < chunk.end){
+    size_t eol = __lineEnd(buffer, pos, chunk.end);
+    size_t lineLength = eol - pos;
+    if (lineLength > 0 && buffer[eol - 1] == '\r') lineLength--;
+    if (lineLength == 0){
+      /* stray empty row between heads */
+      pos = eol + 1;
+      continue;
+    }
+    size_t head = chunk.base + chunk.heads++;
+    if (starts != nullptr) starts[head] = HTTPHeadIndex::span_t{ pos, static_cast<uint32_t>(lineLength) };
+    pos = eol + 1;
+    while (pos < chunk.end){
+      eol = __lineEnd(buffer, pos, chunk.end);
+      lineLength = eol - pos;
+      if (lineLength > 0 && buffer[eol - 1] == '\r') lineLength--;
+      size_t row = pos;
+      pos = eol + 1;
+      if (lineLength == 0) break;
+      if (columns == nullptr) continue;
+      HeaderNode::headerField_t field = HeaderNode::UNKNOWN;
+      std::string_view value;
+      /* only the fields of the HeaderTable have a column */
+      if (!HeaderNode::parseRow(buffer + row, lineLength, field, value) || field == HeaderNode::UNKNOWN) continue;
+      size_t id = static_cast<size_t>(field);
+      if (id >= local.size()) local.resize(id + 1, nullptr);
+      if (local[id] == nullptr) local[id] = (*columns)(id);
+      HTTPHeadIndex::span_t &span = local[id][head];
+      /* values never start at offset zero, so zero marks an unused entry */
+      if (span.offset != 0) continue;
+      span.offset = static_cast<uint64_t>(value.data() - buffer);
+      span.length = static_cast<uint32_t>(value.length());
+    }
+  }
+}
+
+/**
+ * @brief Default constructor for empty index.
+ */
+HTTPHeadIndex::HTTPHeadIndex(){
+  this->buffer = nullptr;
+  this->length = 0;
+  this->mapping = nullptr;
+  this->count = 0;
+}
+
+/**
+ * @brief Destructor.
+ *
+ * This method is responsible to unmap the file opened by `open`.
+ */
+HTTPHeadIndex::~HTTPHeadIndex(){
+  this->release();
+}
+
+void HTTPHeadIndex::release(){
+  if (this->mapping != nullptr) munmap(this->mapping, this->length);
+  this->mapping = nullptr;
+  this->buffer = nullptr;
+  this->length = 0;
+  this->count = 0;
+  this->starts.reset();
+  this->columns.clear();
+}
+
+/**
+ * @brief Map the capture file.
+ *
+ * This method is responsible to map the whole capture file (read only) as the source buffer.
+ *
+ * @param[in] path The capture file path.
+ * @return `true` in success.
+ * @return `false` if the file can not be opened or mapped.
+ */
+bool HTTPHeadIndex::open(const std::string &path){
+  this->release();
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) return false;
+  struct stat info;
+  if (fstat(fd, &info) != 0 || info.st_size <= 0){
+    close(fd);
+    return false;
+  }
+  void *mapping = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (mapping == MAP_FAILED) return false;
+  madvise(mapping, static_cast<size_t>(info.st_size), MADV_SEQUENTIAL);
+  this->mapping = mapping;
+  this->buffer = static_cast<const char *>(mapping);
+  this->length = static_cast<size_t>(info.st_size);
+  return true;
+}
+
+/**
+ * @brief Use caller-owned buffer.
+ *
+ * This method is responsible to set the source buffer. The buffer must be available as long as the index is used.
+ *
+ * @param[in] buffer The captured request heads.
+ * @param[in] length The buffer length.
+ */
+void HTTPHeadIndex::assign(const char *buffer, size_t length){
+  this->release();
+  this->buffer = buffer;
+  this->length = length;
+}
+
+/**
+ * @brief Build the columns.
+ *
+ * This method is responsible to split the source buffer on head boundaries and parse the chunks in parallel.
+ * A head without any valid row is still counted (all of its columns are empty).
+ *
+ * @param[in] threads The number of worker threads (`0` means the number of online CPUs).
+ * @return `true` in success.
+ * @return `false` if no source buffer is available.
+ */
+bool HTTPHeadIndex::build(size_t threads){
+  if (this->buffer == nullptr || this->length == 0) return false;
+  if (threads == 0) threads = std::thread::hardware_concurrency();
+  if (threads == 0) threads = 1;
+  size_t target = this->length / (threads * HTTP_HEAD_INDEX_CHUNK_PER_THREAD);
+  if (target < HTTP_HEAD_INDEX_MIN_CHUNK) target = HTTP_HEAD_INDEX_MIN_CHUNK;
+  /* chunks end right after an empty row, so no head crosses two chunks */
+  std::vector<chunk_t> chunks;
+  size_t begin = 0;
+  while (begin < this->length){
+    size_t end = (this->length - begin <= target ? this->length : __boundary(this->buffer, begin + target - 1, this->length));
+    chunks.push_back(chunk_t{ begin, end, 0, 0 });
+    begin = end;
+  }
+  /* the heads are counted first, so the values are written straight to their final entries */
+  const char *source = this->buffer;
+  __run(threads, chunks.size(), [&chunks, source](size_t i){
+    __parse(source, chunks[i], nullptr, nullptr);
+  });
+  this->count = 0;
+  for (chunk_t &chunk : chunks){
+    chunk.base = this->count;
+    this->count += chunk.heads;
+  }
+  this->starts.reset(new HTTPHeadIndex::span_t[this->count > 0 ? this->count : 1]);
+  this->columns.clear();
+  this->columns.resize(HeaderTable::size());
+  std::vector<std::once_flag> once(this->columns.size());
+  size_t count = this->count;
+  std::vector<std::unique_ptr<HTTPHeadIndex::span_t[]>> &columns = this->columns;
+  std::function<HTTPHeadIndex::span_t *(size_t)> column = [&once, &columns, count](size_t id){
+    std::call_once(once[id], [&columns, count, id](){
+      columns[id].reset(new HTTPHeadIndex::span_t[count]());
+    });
+    return columns[id].get();
+  };
+  HTTPHeadIndex::span_t *starts = this->starts.get();
+  __run(threads, chunks.size(), [&chunks, source, starts, &column](size_t i){
+    __parse(source, chunks[i], starts, &column);
+  });
+  return true;
+}
+
+/**
+ * @brief Gets the number of heads.
+ *
+ * @return The number of indexed heads.
+ */
+size_t HTTPHeadIndex::getCount() const {
+  return this->count;
+}
+
+/**
+ * @brief Gets the column of the field.
+ *
+ * This method is responsible to get the value spans of the field, one entry per head in the buffer order.
+ * Heads without the field have zero length entry. If the field is repeated in a head, the first row is used.
+ *
+ * @param[in] field The field identifier.
+ * @return The pointer to `getCount()` entries or `nullptr` if no head has the field.
+ */
+const HTTPHeadIndex::span_t *HTTPHeadIndex::getColumn(HeaderNode::headerField_t field) const {
+  if (field < 0 || static_cast<size_t>(field) >= this->columns.size()) return nullptr;
+  return this->columns[field].get();
+}
+
+/**
+ * @brief Gets the start line column.
+ *
+ * @return The pointer to `getCount()` entries of the request lines.
+ */
+const HTTPHeadIndex::span_t *HTTPHeadIndex::getStartLines() const {
+  return this->starts.get();
+}
+
+/**
+ * @brief Gets one value.
+ *
+ * @param[in] field The field identifier.
+ * @param[in] head The head number.
+ * @return The value as view to the source buffer or empty view if it is not available.
+ */
+std::string_view HTTPHeadIndex::getValue(HeaderNode::headerField_t field, size_t head) const {
+  const HTTPHeadIndex::span_t *column = this->getColumn(field);
+  if (column == nullptr || head >= this->count) return std::string_view();
+  return std::string_view(this->buffer + column[head].offset, column[head].length);
+}
+
+/**
+ * @brief Count the distinct values of the field.
+ *
+ * This method is responsible to scan only the column of the field and count each distinct value.
+ *
+ * @param[in] field The field identifier.
+ * @return The count of each value (heads without the field are not counted).
+ */
+std::unordered_map<std::string_view, size_t> HTTPHeadIndex::countValues(HeaderNode::headerField_t field) const {
+  std::unordered_map<std::string_view, size_t> result;
+  const HTTPHeadIndex::span_t *column = this->getColumn(field);
+  if (column == nullptr) return result;
+  for (size_t i = 0; i < this->count; i++){
+    if (column[i].offset == 0) continue;
+    result[std::string_view(this->buffer + column[i].offset, column[i].length)]++;
+  }
+  return result;
+}
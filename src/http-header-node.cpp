@@ -23,79 +23,11 @@
 
 #include <cstring>
 #include <iomanip>
+#include <stdexcept>
+#include "http-header.hpp"
 #include "http-header-node.hpp"
-
-const char *fieldName[] = {
-  "Unknown",
-  "Accept",
-  "Accept-Charset",
-  "Accept-Encoding",
-  "Accept-Language",
-  "Authorization",
-  "Cache-Control",
-  "Connection",
-  "Cookie",
-  "Expect",
-  "From",
-  "Host",
-  "If-Match",
-  "If-Modified-Since",
-  "If-None-Match",
-  "If-Unmodified-Since",
-  "Max-Forwards",
-  "Origin",
-  "Pragma",
-  "Proxy-Authorization",
-  "Range",
-  "Referer",
-  "TE",
-  "User-Agent",
-  "Date",
-  "Server",
-  "Content-Length",
-  "Content-Type",
-  "Content-Encoding",
-  "Content-Language",
-  "Content-Disposition",
-  "Last-Modified",
-  "ETag",
-  "Accept-Ranges",
-  "Content-Location",
-  "Content-Range",
-  "Vary",
-  "Cache-Control",
-  "Expires",
-  "Pragma",
-  "Age",
-  "Strict-Transport-Security",
-  "Content-Security-Policy",
-  "X-Content-Type-Options",
-  "X-Frame-Options",
-  "X-XSS-Protection",
-  "Referrer-Policy",
-  "Public-Key-Pins",
-  "Expect-CT",
-  "X-Content-Security-Policy",
-  "X-Download-Options",
-  "X-Permitted-Cross-Domain-Policies",
-  "Location",
-  "Proxy-Authenticate",
-  "Set-Cookie",
-  "Set-Cookie2",
-  "Multi-Status",
-  "Link",
-  "Allow",
-  "Retry-After",
-  "Access-Control-Allow-Origin",
-  "Access-Control-Allow-Methods",
-  "Access-Control-Allow-Headers",
-  "Access-Control-Expose-Headers",
-  "Access-Control-Max-Age",
-  "X-Forwarded-For",
-  "X-Forwarded-Proto",
-  "X-Real-IP",
-  "Unknown"
-};
+#include "http-header-table.hpp"
+#include "http-simd.hpp"
 
 /**
  * @brief Node constructor for Integer data.
@@ -133,20 +65,21 @@ HeaderNode::HeaderNode(HeaderNode::headerField_t field, bool data){
   this->next = nullptr;
 }
 
+static HeaderNode::headerField_t __field(const std::string &field){
+  HeaderNode::headerField_t id = HeaderTable::intern(field);
+  if (id == HeaderNode::UNKNOWN) throw std::runtime_error(std::string(__func__) + ": fail to create next node");
+  return id;
+}
+
 /**
  * @brief Node constructor for cstring data.
  *
  * This method is responsible for create new node with cstring data value.
  */
-HeaderNode::HeaderNode(HeaderNode::headerField_t field, const char *data){
+HeaderNode::HeaderNode(HeaderNode::headerField_t field, const char *data) : text(data) {
   this->field = field;
   this->vType = HeaderNode::VALUE_TYPE_TEXT;
-  char *tmp = new char[strlen(data) + 1];
-  if (tmp){
-    strcpy(tmp, data);
-    tmp[strlen(data)] = 0x00;
-  }
-  this->data = (void *) tmp;
+  this->data = nullptr;
   this->next = nullptr;
 }
 
@@ -155,72 +88,111 @@ HeaderNode::HeaderNode(HeaderNode::headerField_t field, const char *data){
  *
  * This method is responsible for create new node with string data value.
  */
-HeaderNode::HeaderNode(HeaderNode::headerField_t field, const std::string data){
-  HeaderNode(field, data.c_str());
+HeaderNode::HeaderNode(HeaderNode::headerField_t field, const std::string &data) : text(data) {
+  this->field = field;
+  this->vType = HeaderNode::VALUE_TYPE_TEXT;
+  this->data = nullptr;
+  this->next = nullptr;
 }
 
 /**
- * @brief Node constructor for string field and string data.
+ * @brief Node constructor for temporary string data.
  *
- * This method is responsible for create new node with string field and string data value.
- * This method will throw an error if input field is not match with available field list.
+ * This method is responsible for create new node which adopts the string data value without copying it.
  */
-HeaderNode::HeaderNode(const std::string field, int data){
-  int i = 0;
-  for (i = 0; i < static_cast<int>(HeaderNode::SZ_TOTAL); i++){
-    if (field.compare(fieldName[i]) == 0){
-      HeaderNode(static_cast<HeaderNode::headerField_t>(i), data);
-    }
-  }
-  if (i == static_cast<int>(HeaderNode::SZ_TOTAL)) throw std::runtime_error(std::string(__func__) + ": fail to create next node");
+HeaderNode::HeaderNode(HeaderNode::headerField_t field, std::string &&data) : text(std::move(data)) {
+  this->field = field;
+  this->vType = HeaderNode::VALUE_TYPE_TEXT;
+  this->data = nullptr;
+  this->next = nullptr;
 }
 
 /**
  * @brief Node constructor for string field and integer data.
  *
  * This method is responsible for create new node with string field and integer data value.
- * This method will throw an error if input field is not match with available field list.
+ * Extension field names are interned in the HeaderTable.
+ * This method will throw an error if the field name can not be interned.
  */
-HeaderNode::HeaderNode(const std::string field, long data){
-  int i = 0;
-  for (i = 0; i < static_cast<int>(HeaderNode::SZ_TOTAL); i++){
-    if (field.compare(fieldName[i]) == 0){
-      HeaderNode(static_cast<HeaderNode::headerField_t>(i), data);
-    }
-  }
-  if (i == static_cast<int>(HeaderNode::SZ_TOTAL)) throw std::runtime_error(std::string(__func__) + ": fail to create next node");
-}
+HeaderNode::HeaderNode(const std::string &field, int data) : HeaderNode::HeaderNode(__field(field), data) {}
 
 /**
  * @brief Node constructor for string field and long integer data.
  *
  * This method is responsible for create new node with string field and long integer data value.
- * This method will throw an error if input field is not match with available field list.
+ * Extension field names are interned in the HeaderTable.
+ * This method will throw an error if the field name can not be interned.
  */
-HeaderNode::HeaderNode(const std::string field, bool data){
-  int i = 0;
-  for (i = 0; i < static_cast<int>(HeaderNode::SZ_TOTAL); i++){
-    if (field.compare(fieldName[i]) == 0){
-      HeaderNode(static_cast<HeaderNode::headerField_t>(i), data);
-    }
-  }
-  if (i == static_cast<int>(HeaderNode::SZ_TOTAL)) throw std::runtime_error(std::string(__func__) + ": fail to create next node");
-}
+HeaderNode::HeaderNode(const std::string &field, long data) : HeaderNode::HeaderNode(__field(field), data) {}
+
+/**
+ * @brief Node constructor for string field and boolean data.
+ *
+ * This method is responsible for create new node with string field and boolean data value.
+ * Extension field names are interned in the HeaderTable.
+ * This method will throw an error if the field name can not be interned.
+ */
+HeaderNode::HeaderNode(const std::string &field, bool data) : HeaderNode::HeaderNode(__field(field), data) {}
 
 /**
  * @brief Node constructor for string field and string data.
  *
  * This method is responsible for create new node with string field and string data value.
- * This method will throw an error if input field is not match with available field list.
+ * Extension field names are interned in the HeaderTable.
+ * This method will throw an error if the field name can not be interned.
  */
-HeaderNode::HeaderNode(const std::string field, const std::string data){
-  int i = 0;
-  for (i = 0; i < static_cast<int>(HeaderNode::SZ_TOTAL); i++){
-    if (field.compare(fieldName[i]) == 0){
-      HeaderNode(static_cast<HeaderNode::headerField_t>(i), data);
-    }
-  }
-  if (i == static_cast<int>(HeaderNode::SZ_TOTAL)) throw std::runtime_error(std::string(__func__) + ": fail to create next node");
+HeaderNode::HeaderNode(const std::string &field, const std::string &data) : HeaderNode::HeaderNode(__field(field), data) {}
+
+/**
+ * @brief Node constructor for string field and temporary string data.
+ *
+ * This method is responsible for create new node with string field which adopts the string data value without copying it.
+ * Extension field names are interned in the HeaderTable.
+ * This method will throw an error if the field name can not be interned.
+ */
+HeaderNode::HeaderNode(const std::string &field, std::string &&data) : HeaderNode::HeaderNode(__field(field), std::move(data)) {}
+
+/**
+ * @brief Node constructor for field name which is not in the HeaderTable.
+ *
+ * This method is responsible for create new node which keeps the field name
+ * (e.g. as written on the wire) on the node itself, so parsing never grows the HeaderTable.
+ * The name is kept only for `HeaderNode::UNKNOWN` field.
+ */
+HeaderNode::HeaderNode(HeaderNode::headerField_t field, std::string_view name, std::string &&data) : HeaderNode::HeaderNode(field, std::move(data)) {
+  if (field == HeaderNode::UNKNOWN) this->name.assign(name.data(), name.length());
+}
+
+/**
+ * @brief Move constructor.
+ *
+ * This method is responsible for taking over the field, the value and the link of the other node.
+ */
+HeaderNode::HeaderNode(HeaderNode &&other) noexcept : name(std::move(other.name)), text(std::move(other.text)) {
+  this->field = other.field;
+  this->vType = other.vType;
+  this->data = other.data;
+  this->next = other.next;
+  other.data = nullptr;
+  other.next = nullptr;
+}
+
+/**
+ * @brief Move assignment.
+ *
+ * This method is responsible for taking over the field, the value and the link of the other node.
+ */
+HeaderNode &HeaderNode::operator=(HeaderNode &&other) noexcept {
+  if (this == &other) return *this;
+  this->field = other.field;
+  this->vType = other.vType;
+  this->data = other.data;
+  this->next = other.next;
+  this->name = std::move(other.name);
+  this->text = std::move(other.text);
+  other.data = nullptr;
+  other.next = nullptr;
+  return *this;
 }
 
 /**
@@ -229,13 +201,21 @@ HeaderNode::HeaderNode(const std::string field, const std::string data){
  * Release data pointer.
  */
 HeaderNode::~HeaderNode(){
-  if (this->vType == HeaderNode::VALUE_TYPE_TEXT){
-    if (this->data != nullptr){
-      char *tmp = (char *) (this->data);
-      delete[] tmp;
-      this->data = nullptr;
-    }
-  }
+  this->data = nullptr;
+  this->next = nullptr;
+}
+
+/**
+ * @brief Create a copy of the node.
+ *
+ * This method is responsible for explicitly copying the field and the value to a new unlinked node.
+ *
+ * @return The new node.
+ */
+HeaderNode *HeaderNode::clone() const {
+  if (this->vType == HeaderNode::VALUE_TYPE_TEXT) return new HeaderNode(this->field, this->name, std::string(this->text));
+  if (this->vType == HeaderNode::VALUE_TYPE_BOOLEAN) return new HeaderNode(this->field, this->data != nullptr);
+  return new HeaderNode(this->field, (long) (ssize_t) (this->data));
 }
 
 /**
@@ -246,7 +226,30 @@ HeaderNode::~HeaderNode(){
  * @return The HTTP Header field name as string.
  */
 std::string HeaderNode::getFieldName() const {
-  return std::string(fieldName[static_cast<int>(this->field)]);
+  return std::string(this->getFieldNameView());
+}
+
+/**
+ * @brief Gets the HTTP Header field name without copying it.
+ *
+ * This method is responsible for getting the HTTP Header field name as view to the node storage or the HeaderTable.
+ *
+ * @return The HTTP Header field name as view.
+ */
+std::string_view HeaderNode::getFieldNameView() const {
+  if (!this->name.empty()) return std::string_view(this->name);
+  return HeaderTable::getName(this->field);
+}
+
+/**
+ * @brief Gets the HTTP Header field.
+ *
+ * This method is responsible for getting the HTTP Header field identifier.
+ *
+ * @return The HTTP Header field identifier.
+ */
+HeaderNode::headerField_t HeaderNode::getField() const {
+  return this->field;
 }
 
 /**
@@ -258,7 +261,7 @@ std::string HeaderNode::getFieldName() const {
  */
 std::string HeaderNode::getValue(){
   if (this->vType == HeaderNode::VALUE_TYPE_TEXT){
-    return std::string((const char *) (this->data));
+    return this->text;
   }
   if (this->vType == HeaderNode::VALUE_TYPE_NUMBER){
     char tmp[16];
@@ -270,6 +273,63 @@ std::string HeaderNode::getValue(){
   return std::string("true");
 }
 
+/**
+ * @brief Gets the HTTP Header field value without copying it.
+ *
+ * This method is responsible for getting the text value as view to the node storage.
+ * The view is valid as long as the node is alive and is empty for number and boolean nodes.
+ *
+ * @return The HTTP Header field value as view.
+ */
+std::string_view HeaderNode::getValueView() const {
+  if (this->vType != HeaderNode::VALUE_TYPE_TEXT) return std::string_view();
+  return std::string_view(this->text);
+}
+
+/**
+ * @brief Gets the HTTP Header field value as number.
+ *
+ * This method is responsible for getting the value of the number node or converting the text value
+ * (decimal digits only, e.g. `Content-Length`, `Age`).
+ *
+ * @param[out] number The value.
+ * @return `true` in success.
+ * @return `false` if the value is not a non-negative decimal number.
+ */
+bool HeaderNode::getNumber(long &number) const {
+  if (this->vType == HeaderNode::VALUE_TYPE_NUMBER){
+    number = static_cast<long>(reinterpret_cast<ssize_t>(this->data));
+    return (number >= 0);
+  }
+  if (this->vType != HeaderNode::VALUE_TYPE_TEXT || this->text.empty() || this->text.length() > 18) return false;
+  long value = 0;
+  for (char c : this->text){
+    if (c < '0' || c > '9') return false;
+    value = value * 10 + (c - '0');
+  }
+  number = value;
+  return true;
+}
+
+/**
+ * @brief Gets the HTTP Header field value as Unix epoch.
+ *
+ * This method is responsible for getting the value of the number node or converting the text value
+ * (IMF-fixdate, e.g. `Date`, `Last-Modified`).
+ *
+ * @param[out] epoch The value.
+ * @return `true` in success.
+ * @return `false` if the value is not a valid HTTP-date.
+ */
+bool HeaderNode::getDate(long &epoch) const {
+  if (this->vType == HeaderNode::VALUE_TYPE_NUMBER) return this->getNumber(epoch);
+  if (this->vType != HeaderNode::VALUE_TYPE_TEXT) return false;
+  long value = convertToUnixEpoch(this->text);
+  if (value < 0) return false;
+  epoch = value;
+  return true;
+}
+
 /**
  * @brief Parse the HTTP Header node (single row).
  *
@@ -279,43 +339,76 @@ std::string HeaderNode::getValue(){
  * @return `false` on fail.
  */
 bool HeaderNode::parseRow(const char *headerRow, HeaderNode::headerField_t &field, std::string &data){
-  char fieldX[64];
-  int idx = 0;
-  size_t length = strlen(headerRow);
+  return HeaderNode::parseRow(headerRow, strlen(headerRow), field, data);
+}
+
+/**
+ * @brief Overloading of `parseRow` method for row which is not null terminated.
+ *
+ * This method is responsible for getting parse the HTTP Header node (single row) to separate field name and field value.
+ * The trailing CR (if any) is not part of the value.
+ *
+ * @return `true` in success.
+ * @return `false` on fail.
+ */
+bool HeaderNode::parseRow(const char *headerRow, size_t length, HeaderNode::headerField_t &field, std::string &data){
+  std::string_view value;
+  bool ret = HeaderNode::parseRow(headerRow, length, field, value);
+  data.assign(value.data(), value.length());
+  return ret;
+}
+
+/**
+ * @brief Overloading of `parseRow` method without copying the value.
+ *
+ * This method is responsible for getting parse the HTTP Header node (single row) to separate field name and field value.
+ * The value is a view to the row, so its offset in the source buffer is known.
+ * The field name must be a token (RFC 7230 `tchar`) directly followed by the colon, it is matched
+ * case-insensitively.
+ *
+ * @return `true` in success.
+ * @return `false` on fail.
+ */
+bool HeaderNode::parseRow(const char *headerRow, size_t length, HeaderNode::headerField_t &field, std::string_view &data){
+  std::string_view name;
+  return HeaderNode::parseRow(headerRow, length, field, name, data);
+}
+
+/**
+ * @brief Overloading of `parseRow` method which also gives the field name.
+ *
+ * This method is responsible for getting parse the HTTP Header node (single row) to separate field name and field value.
+ * The field name is only searched in the HeaderTable (never interned), so the field is `HeaderNode::UNKNOWN`
+ * for a valid name which is not in the table and the caller keeps the name from the view.
+ *
+ * @return `true` in success.
+ * @return `false` if the field name is not a token directly followed by the colon or is too long, or the value
+ * holds a control byte.
+ */
+bool HeaderNode::parseRow(const char *headerRow, size_t length, HeaderNode::headerField_t &field, std::string_view &name, std::string_view &data){
+  char key[HTTP_HEADER_NAME_MAX];
   field = HeaderNode::UNKNOWN;
-  /* parse field */
-  if (headerRow[0] >= 'a' && headerRow[0] <= 'z'){
-    fieldX[0] = (headerRow[0] - 'a') + 'A';
-  }
-  else {
-    fieldX[0] = headerRow[0];
-  }
-  for (idx = 1; idx < length; idx++){
-    if (headerRow[idx] == ':' || headerRow[idx] == ' ') break;
-    if (headerRow[idx - 1] == '-'){
-      if (headerRow[idx] >= 'a' && headerRow[idx] <= 'z'){
-        fieldX[idx] = (headerRow[idx] - 'a') + 'A';
-      }
-      else {
-        fieldX[idx] = headerRow[idx];
-      }
-    }
-    else {
-      fieldX[idx] = headerRow[idx];
-    }
-  }
-  for (int i = 0; i < static_cast<int>(HeaderNode::SZ_TOTAL); i++){
-    if (strcmp(fieldX, fieldName[i]) == 0){
-      field = static_cast<HeaderNode::headerField_t>(i);
-      break;
-    }
+  name = std::string_view();
+  data = std::string_view();
+  /* parse field, the name is validated and case folded in one pass and must be followed by the colon */
+  size_t idx = HTTPSimd::lowerToken(headerRow, (length < sizeof(key) ? length : sizeof(key)), key);
+  if (idx == 0 || idx >= length || headerRow[idx] != ':') return false;
+  /* the table is never grown by the peer, unknown names stay on the node */
+  field = HeaderTable::findLowercase(std::string_view(key, idx));
+  name = std::string_view(headerRow, idx);
+  idx++;
+  /* get start and end position of value */
+  while (idx < length && (headerRow[idx] == ' ' || headerRow[idx] == '\t')) idx++;
+  /* the line end (LF, CRLF) is not part of the value, then the optional white space (SP, HTAB) is trimmed */
+  if (length > idx && headerRow[length - 1] == '\n') length--;
+  if (length > idx && headerRow[length - 1] == '\r') length--;
+  while (length > idx && (headerRow[length - 1] == ' ' || headerRow[length - 1] == '\t')) length--;
+  /* a value never carries NUL, bare CR, LF or other control bytes, only HTAB is allowed (RFC 9110 section 5.5) */
+  for (size_t i = idx; i < length; i++){
+    unsigned char c = static_cast<unsigned char>(headerRow[i]);
+    if ((c < 0x20 && c != '\t') || c == 0x7F) return false;
   }
-  /* get start position of value */
-  do {
-    idx++;
-  } while (headerRow[idx] == ':' || headerRow[idx] == ' ');
-  data = std::string(headerRow + idx);
-  if (field == HeaderNode::UNKNOWN) return false;
+  data = std::string_view(headerRow + idx, length - idx);
   return true;
 }
 
@@ -327,6 +420,6 @@ bool HeaderNode::parseRow(const char *headerRow, HeaderNode::headerField_t &fiel
  * @return `true` in success.
  * @return `false` on fail.
  */
-bool HeaderNode::parseRow(const std::string headerRow, HeaderNode::headerField_t &field, std::string &data){
-  return this->parseRow(headerRow.c_str(), field, data);
+bool HeaderNode::parseRow(const std::string &headerRow, HeaderNode::headerField_t &field, std::string &data){
+  return HeaderNode::parseRow(headerRow.data(), headerRow.length(), field, data);
 }
\ No newline at end of file
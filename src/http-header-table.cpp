@@ -0,0 +1,217 @@
+/*
+ * $Id: http-header-table.cpp,v 1.0.0 2026/10/18 12:40:52 Jaya Wikrama Exp $
+ *
+ * Copyright (c) 2024 Jaya Wikrama
+ * jayawikrama89@gmail.com
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *  claim that you wrote the original software. If you use this software
+ *  in a product, an acknowledgment in the product documentation would be
+ *  appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *  misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include <atomic>
+#include <mutex>
+#include <cstring>
+#include <cstdint>
+#include "http-header-table.hpp"
+#include "http-simd.hpp"
+
+/* open addressing index, twice the capacity keeps the probe sequences short */
+#define INDEX_SIZE (HTTP_HEADER_TABLE_CAPACITY * 2)
+
+typedef struct _name_t {
+  std::atomic<const char *> data;
+  std::atomic<const char *> key;
+  std::atomic<size_t> length;
+} name_t;
+
+typedef struct _table_t {
+  name_t name[HTTP_HEADER_TABLE_CAPACITY];
+  std::atomic<uint32_t> index[INDEX_SIZE];
+  std::atomic<size_t> count;
+  std::mutex mutex;
+
+  _table_t();
+} table_t;
+
+/* the index is keyed by the lowercased name */
+static const char *__copy(std::string_view name, bool lower){
+  char *data = new char[name.length() + 1];
+  memcpy(data, name.data(), name.length());
+  data[name.length()] = 0x00;
+  if (lower) HTTPSimd::lower(data, name.length());
+  return data;
+}
+
+/* index entries hold the identifier plus one, zero marks an empty entry */
+static void __link(table_t &table, std::string_view key, size_t id){
+  uint32_t pos = HTTPSimd::crc32c(key.data(), key.length()) & (INDEX_SIZE - 1);
+  while (table.index[pos].load(std::memory_order_relaxed) != 0) pos = (pos + 1) & (INDEX_SIZE - 1);
+  table.index[pos].store(static_cast<uint32_t>(id + 1), std::memory_order_release);
+}
+
+static HeaderNode::headerField_t __find(table_t &table, std::string_view key){
+  uint32_t pos = HTTPSimd::crc32c(key.data(), key.length()) & (INDEX_SIZE - 1);
+  for (;;){
+    uint32_t entry = table.index[pos].load(std::memory_order_acquire);
+    if (entry == 0) return HeaderNode::UNKNOWN;
+    const name_t &candidate = table.name[entry - 1];
+    size_t length = candidate.length.load(std::memory_order_relaxed);
+    if (length == key.length() && memcmp(candidate.key.load(std::memory_order_relaxed), key.data(), length) == 0){
+      return static_cast<HeaderNode::headerField_t>(entry - 1);
+    }
+    pos = (pos + 1) & (INDEX_SIZE - 1);
+  }
+}
+
+_table_t::_table_t(){
+  for (size_t i = 0; i < HTTP_HEADER_TABLE_CAPACITY; i++){
+    this->name[i].data.store(nullptr, std::memory_order_relaxed);
+    this->name[i].key.store(nullptr, std::memory_order_relaxed);
+    this->name[i].length.store(0, std::memory_order_relaxed);
+  }
+  for (size_t i = 0; i < INDEX_SIZE; i++) this->index[i].store(0, std::memory_order_relaxed);
+  for (size_t i = 0; i <= static_cast<size_t>(HeaderNode::SZ_TOTAL); i++){
+    this->name[i].data.store(fieldName[i], std::memory_order_relaxed);
+    this->name[i].key.store(__copy(fieldName[i], true), std::memory_order_relaxed);
+    this->name[i].length.store(strlen(fieldName[i]), std::memory_order_relaxed);
+  }
+  /* duplicated names (e.g. CACHE_CONTROL_H) resolve to the first identifier */
+  for (size_t i = 1; i < static_cast<size_t>(HeaderNode::SZ_TOTAL); i++){
+    std::string_view key(this->name[i].key.load(std::memory_order_relaxed));
+    if (__find(*this, key) == HeaderNode::UNKNOWN) __link(*this, key, i);
+  }
+  this->count.store(static_cast<size_t>(HeaderNode::SZ_TOTAL) + 1, std::memory_order_release);
+}
+
+static table_t &__table(){
+  static table_t table;
+  return table;
+}
+
+/**
+ * @brief Find the field of the name.
+ *
+ * This method is responsible to search the interned field name without locking.
+ *
+ * @param[in] name The field name (any case).
+ * @return The field identifier or `HeaderNode::UNKNOWN` if the name is not interned.
+ */
+HeaderNode::headerField_t HeaderTable::find(std::string_view name){
+  char key[HTTP_HEADER_NAME_MAX];
+  if (name.length() > sizeof(key)) return HeaderNode::UNKNOWN;
+  memcpy(key, name.data(), name.length());
+  HTTPSimd::lower(key, name.length());
+  return __find(__table(), std::string_view(key, name.length()));
+}
+
+/**
+ * @brief Overloading of `find` method for name which is already lowercased.
+ *
+ * This method is responsible to skip the case folding when the caller already has the lowercased name
+ * (e.g. from `HTTPSimd::lowerToken`).
+ *
+ * @param[in] key The lowercased field name.
+ * @return The field identifier or `HeaderNode::UNKNOWN` if the name is not interned.
+ */
+HeaderNode::headerField_t HeaderTable::findLowercase(std::string_view key){
+  if (key.empty() || key.length() > HTTP_HEADER_NAME_MAX) return HeaderNode::UNKNOWN;
+  return __find(__table(), key);
+}
+
+/**
+ * @brief Intern the field name.
+ *
+ * This method is responsible to search the field name and add it to the table if it is not available.
+ *
+ * @param[in] name The field name (any case).
+ * @return The field identifier.
+ * @return `HeaderNode::UNKNOWN` if the name is empty, longer than `HTTP_HEADER_NAME_MAX` or the table is full.
+ */
+HeaderNode::headerField_t HeaderTable::intern(std::string_view name){
+  char key[HTTP_HEADER_NAME_MAX];
+  if (name.length() > sizeof(key)) return HeaderNode::UNKNOWN;
+  memcpy(key, name.data(), name.length());
+  HTTPSimd::lower(key, name.length());
+  return HeaderTable::intern(name, std::string_view(key, name.length()));
+}
+
+/**
+ * @brief Overloading of `intern` method for name which is already lowercased.
+ *
+ * This method is responsible to skip the case folding when the caller already has the lowercased name
+ * (e.g. from `HTTPSimd::lowerToken`).
+ *
+ * @param[in] name The field name as written.
+ * @param[in] key The lowercased field name.
+ * @return The field identifier.
+ * @return `HeaderNode::UNKNOWN` if the name is empty, longer than `HTTP_HEADER_NAME_MAX` or the table is full.
+ */
+HeaderNode::headerField_t HeaderTable::intern(std::string_view name, std::string_view key){
+  if (name.empty() || name.length() > HTTP_HEADER_NAME_MAX || key.length() != name.length()) return HeaderNode::UNKNOWN;
+  table_t &table = __table();
+  HeaderNode::headerField_t field = __find(table, key);
+  if (field != HeaderNode::UNKNOWN) return field;
+  std::lock_guard<std::mutex> lock(table.mutex);
+  field = __find(table, key);
+  if (field != HeaderNode::UNKNOWN) return field;
+  size_t id = table.count.load(std::memory_order_relaxed);
+  if (id >= HTTP_HEADER_TABLE_CAPACITY) return HeaderNode::UNKNOWN;
+  /* the name lives as long as the process, identifiers are never reused */
+  table.name[id].data.store(__copy(name, false), std::memory_order_relaxed);
+  table.name[id].key.store(__copy(key, false), std::memory_order_relaxed);
+  table.name[id].length.store(name.length(), std::memory_order_relaxed);
+  table.count.store(id + 1, std::memory_order_release);
+  __link(table, key, id);
+  return static_cast<HeaderNode::headerField_t>(id);
+}
+
+/**
+ * @brief Gets the name of the field.
+ *
+ * This method is responsible to get the interned name of the built-in or extension field without locking.
+ *
+ * @param[in] field The field identifier.
+ * @return The field name or "Unknown" if the identifier is not available.
+ */
+std::string_view HeaderTable::getName(HeaderNode::headerField_t field){
+  if (field >= 0 && field <= HeaderNode::SZ_TOTAL) return std::string_view(fieldName[field]);
+  table_t &table = __table();
+  size_t id = static_cast<size_t>(field);
+  if (field < 0 || id >= table.count.load(std::memory_order_acquire)) return std::string_view(fieldName[HeaderNode::UNKNOWN]);
+  return std::string_view(table.name[id].data.load(std::memory_order_relaxed), table.name[id].length.load(std::memory_order_relaxed));
+}
+
+/**
+ * @brief Check if the field is an extension field.
+ *
+ * @return `true` if the identifier is above `HeaderNode::SZ_TOTAL`.
+ * @return `false` for built-in fields.
+ */
+bool HeaderTable::isExtension(HeaderNode::headerField_t field){
+  return (field > HeaderNode::SZ_TOTAL);
+}
+
+/**
+ * @brief Gets the upper bound of the field identifiers.
+ *
+ * This method is responsible to get the number of identifiers (built-in and extension) in use, so per-field
+ * arrays can be sized by `HeaderTable::size()`.
+ *
+ * @return The highest field identifier plus one.
+ */
+size_t HeaderTable::size(){
+  return __table().count.load(std::memory_order_acquire);
+}
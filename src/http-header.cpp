@@ -22,51 +22,66 @@
  */
 
 #include <cstring>
-#include <unordered_map>
+#include <cstdlib>
 #include <iomanip>
 #include <ctime>
-#include <iostream>
+#include <strings.h>
 #include "http-header.hpp"
+#include "http-header-table.hpp"
+#include "http-simd.hpp"
 
-#define MAX_HEAD_ROW 2048
-
-
+/**
+ * @brief Convert the HTTP-date to Unix epoch.
+ *
+ * This function is responsible to convert the IMF-fixdate (e.g. `Sun, 06 Nov 1994 08:49:37 GMT`) to Unix epoch.
+ *
+ * @param[in] dateStr The HTTP-date.
+ * @return The Unix epoch or `-1` if the date is malformed.
+ */
 long convertToUnixEpoch(const std::string &dateStr) {
   std::tm timeStruct = {};
   std::istringstream ss(dateStr);
   ss >> std::get_time(&timeStruct, "%a, %d %b %Y %H:%M:%S GMT");
-  if (ss.fail()) {
-    std::cerr << "Failed to parse date string." << std::endl;
-    return -1;
-  }
-  // Set timezone to GMT
-  timeStruct.tm_isdst = -1;
-  return std::mktime(&timeStruct);
-}
-
-std::unordered_map<std::string, std::string> __parse(const std::string &input) {
-  std::unordered_map<std::string, std::string> dataMap;
-  std::istringstream stream(input);
-  std::string line;
-  while (std::getline(stream, line)) {
-    if (line.length() > 512) break;
-    size_t pos = line.find(": ");
-    if (pos != std::string::npos) {
-      std::string key = line.substr(0, pos);
-      std::string value = line.substr(pos + 2);
-      if (!value.empty() && value.back() == '\r') {
-          value.pop_back();
-      }
-      dataMap[key] = value;
-    }
-    else if (line.find("HTTP") == 0) {
-      if (!line.empty() && line.back() == '\r') {
-          line.pop_back();
-      }
-      dataMap["Protocol"] = line;
-    }
+  if (ss.fail()) return -1;
+  // The date is always GMT, mktime would apply the local timezone
+  return timegm(&timeStruct);
+}
+
+/* nodes of the field names which are not in the HeaderTable are matched by the name */
+static bool __isNamed(const HeaderNode *node, HeaderNode::headerField_t field, std::string_view name){
+  if (field != HeaderNode::UNKNOWN) return (node->getField() == field);
+  if (node->getField() != HeaderNode::UNKNOWN) return false;
+  std::string_view nodeName = node->getFieldNameView();
+  return (nodeName.length() == name.length() && strncasecmp(nodeName.data(), name.data(), name.length()) == 0);
+}
+
+/*
+ * the parsed value is kept as written, so relaying the head does not change it (the typed getters of the node
+ * convert it on demand), `nullptr` if the value is malformed
+ */
+static HeaderNode *__node(HeaderNode::headerField_t field, std::string_view name, std::string &&value){
+  HeaderNode *node = new HeaderNode(field, name, std::move(value));
+  long length = 0;
+  /* the body framing depends on it, a malformed length is never passed on */
+  if (field == HeaderNode::CONTENT_LENGTH && !node->getNumber(length)){
+    delete node;
+    return nullptr;
   }
-  return dataMap;
+  return node;
+}
+
+/* the start line is either a status line or a request line (`<method> <target> HTTP/<version>`) */
+static bool __isStartLine(const char *line, size_t length){
+  if (length >= 5 && memcmp(line, "HTTP/", 5) == 0) return true;
+  const char *space = static_cast<const char *>(memrchr(line, ' ', length));
+  return (space != nullptr && static_cast<size_t>(line + length - space) > 6 && memcmp(space + 1, "HTTP/", 5) == 0);
+}
+
+/* an oversized request line is a too long target, an oversized status line is malformed */
+static HttpStatus::Code_t __tooLarge(const char *line, size_t length, bool start){
+  if (!start) return HttpStatus::REQUEST_HEADER_FIELDS_TOO_LARGE;
+  if (length >= 5 && memcmp(line, "HTTP/", 5) == 0) return HttpStatus::BAD_REQUEST;
+  return HttpStatus::URI_TOO_LONG;
 }
 
 /**
@@ -112,57 +127,28 @@ HTTPHeader::HTTPHeader(HeaderNode::headerField_t field, const char *data) : HTTP
  *
  * This method is responsible for create new HTTP Header wich automatically create one node with string data value.
  */
-HTTPHeader::HTTPHeader(HeaderNode::headerField_t field, const std::string data) : HTTPHeader::HTTPHeader() {
+HTTPHeader::HTTPHeader(HeaderNode::headerField_t field, const std::string &data) : HTTPHeader::HTTPHeader() {
   this->node = new HeaderNode(field, data);
 }
 
+/**
+ * @brief Custom constructor for temporary string data.
+ *
+ * This method is responsible for create new HTTP Header wich automatically create one node which adopts the string data value.
+ */
+HTTPHeader::HTTPHeader(HeaderNode::headerField_t field, std::string &&data) : HTTPHeader::HTTPHeader() {
+  this->node = new HeaderNode(field, std::move(data));
+}
+
 /**
  * @brief Custom constructor for Complete HTTP Header Payload.
  *
  * This method is responsible for create new HTTP Header wich automatically parse the input to linked list form.
+ * This method will throw an error if the payload is malformed.
  */
-HTTPHeader::HTTPHeader(const std::string httpHeaderPayload){
-  std::unordered_map<std::string, std::string> parsed = __parse(httpHeaderPayload);
-  for (const auto &pair : parsed) {
-    HeaderNode *next = nullptr;
-    long tmp = 0;
-    if (pair.first.compare("Protocol") == 0){
-      /* Continue parsing protocol */
-    }
-    else if (pair.first.compare(fieldName[HeaderNode::DATE]) == 0){
-      tmp = convertToUnixEpoch(pair.second);
-      if (tmp == -1){
-        throw std::runtime_error(std::string(__func__) + ": unknown time format");
-      }
-      next = new HeaderNode(pair.first, std::to_string(tmp));
-    }
-    else if (pair.first.compare(fieldName[HeaderNode::CONTENT_LENGTH]) == 0 ||
-             pair.first.compare(fieldName[HeaderNode::MAX_FORWARDS]) == 0 ||
-             pair.first.compare(fieldName[HeaderNode::AGE]) == 0 ||
-             pair.first.compare(fieldName[HeaderNode::RETRY_AFTER]) == 0 ||
-             pair.first.compare(fieldName[HeaderNode::ACCESS_CONTROL_MAX_AGE]) == 0
-    ){
-      next = new HeaderNode(pair.first, stoi(pair.second));
-    }
-    else if (pair.first.compare(fieldName[HeaderNode::EXPECT]) == 0 ||
-             pair.first.compare(fieldName[HeaderNode::IF_MODIFIED_SINCE]) == 0 ||
-             pair.first.compare(fieldName[HeaderNode::IF_UNMODIFIED_SINCE]) == 0 ||
-             pair.first.compare(fieldName[HeaderNode::STRICT_TRANSPORT_SECURITY]) == 0 ||
-             pair.first.compare(fieldName[HeaderNode::X_XSS_PROTECTION]) == 0
-    ){
-      next = new HeaderNode(pair.first, (!pair.second.compare("true") || !pair.second.compare("True") || !pair.second.compare("TRUE")));
-    }
-    else {
-      next = new HeaderNode(pair.first, pair.second);
-    }
-    if (next == nullptr) throw std::runtime_error(std::string(__func__) + ": fail to create next node");
-    if (this->node == nullptr){
-      this->node = next;
-    }
-    else {
-      next->next = this->node;
-      this->node = next;
-    }
+HTTPHeader::HTTPHeader(const std::string &httpHeaderPayload) : HTTPHeader::HTTPHeader() {
+  if (!this->parseHead(httpHeaderPayload.data(), httpHeaderPayload.length())){
+    throw std::runtime_error(std::string(__func__) + ": malformed header");
   }
 }
 
@@ -171,8 +157,34 @@ HTTPHeader::HTTPHeader(const std::string httpHeaderPayload){
  *
  * This method is responsible for create new HTTP Header wich automatically parse the input to linked list form.
  */
-HTTPHeader::HTTPHeader(const char *httpHeaderPayload){
-  HTTPHeader(std::string(httpHeaderPayload));
+HTTPHeader::HTTPHeader(const char *httpHeaderPayload) : HTTPHeader::HTTPHeader(std::string(httpHeaderPayload)) {}
+
+/**
+ * @brief Move constructor.
+ *
+ * This method is responsible for taking over all nodes of the other HTTP Header, which is left blank.
+ */
+HTTPHeader::HTTPHeader(HTTPHeader &&other) noexcept : version(std::move(other.version)), method(std::move(other.method)), target(std::move(other.target)) {
+  this->code = other.code;
+  this->node = other.node;
+  other.node = nullptr;
+}
+
+/**
+ * @brief Move assignment.
+ *
+ * This method is responsible for releasing all available nodes and taking over all nodes of the other HTTP Header.
+ */
+HTTPHeader &HTTPHeader::operator=(HTTPHeader &&other) noexcept {
+  if (this == &other) return *this;
+  this->release();
+  this->version = std::move(other.version);
+  this->method = std::move(other.method);
+  this->target = std::move(other.target);
+  this->code = other.code;
+  this->node = other.node;
+  other.node = nullptr;
+  return *this;
 }
 
 /**
@@ -181,12 +193,549 @@ HTTPHeader::HTTPHeader(const char *httpHeaderPayload){
  * Release all available nodes.
  */
 HTTPHeader::~HTTPHeader(){
-  if (this->node == nullptr) return;
+  this->release();
+}
+
+/**
+ * @brief Release all available nodes.
+ */
+void HTTPHeader::release(){
   HeaderNode *next = nullptr;
-  while (this->node->next != nullptr){
+  while (this->node != nullptr){
     next = this->node->next;
     delete this->node;
     this->node = next;
   }
-  delete this->node;
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Create a copy of the HTTP Header.
+ *
+ * This method is responsible for explicitly copying the status line and all available nodes.
+ *
+ * @return The new HTTP Header.
+ */
+HTTPHeader HTTPHeader::clone() const {
+  HTTPHeader copy;
+  HeaderNode *tail = nullptr;
+  copy.version = this->version;
+  copy.method = this->method;
+  copy.target = this->target;
+  copy.code = this->code;
+  for (const HeaderNode *current = this->node; current != nullptr; current = current->next){
+    HeaderNode *next = current->clone();
+    if (tail == nullptr) copy.node = next;
+    else tail->next = next;
+    tail = next;
+  }
+  return copy;
+}
+
+/**
+ * @brief Append new node with Integer data.
+ *
+ * This method is responsible to append one node with integer data value.
+ *
+ * @return `true` in success.
+ * @return `false` on fail.
+ */
+bool HTTPHeader::append(HeaderNode::headerField_t field, int data){
+  return this->append(new HeaderNode(field, data));
+}
+
+/**
+ * @brief Append new node with boolean data.
+ *
+ * This method is responsible to append one node with boolean data value.
+ *
+ * @return `true` in success.
+ * @return `false` on fail.
+ */
+bool HTTPHeader::append(HeaderNode::headerField_t field, bool data){
+  return this->append(new HeaderNode(field, data));
+}
+
+/**
+ * @brief Append new node with cstring data.
+ *
+ * This method is responsible to append one node with cstring data value.
+ *
+ * @return `true` in success.
+ * @return `false` on fail.
+ */
+bool HTTPHeader::append(HeaderNode::headerField_t field, const char *data){
+  if (data == nullptr) return false;
+  return this->append(new HeaderNode(field, data));
+}
+
+/**
+ * @brief Append new node with string data.
+ *
+ * This method is responsible to append one node with string data value.
+ *
+ * @return `true` in success.
+ * @return `false` on fail.
+ */
+bool HTTPHeader::append(HeaderNode::headerField_t field, const std::string &data){
+  return this->append(new HeaderNode(field, data));
+}
+
+/**
+ * @brief Append new node with temporary string data.
+ *
+ * This method is responsible to append one node which adopts the string data value without copying it.
+ *
+ * @return `true` in success.
+ * @return `false` on fail.
+ */
+bool HTTPHeader::append(HeaderNode::headerField_t field, std::string &&data){
+  return this->append(new HeaderNode(field, std::move(data)));
+}
+
+/**
+ * @brief Append new node with field name and temporary string data.
+ *
+ * This method is responsible to append one node of the field name without interning it, the name is kept on
+ * the node if it is not in the HeaderTable.
+ *
+ * @return `true` in success.
+ * @return `false` on fail.
+ */
+bool HTTPHeader::append(std::string_view name, std::string &&data){
+  if (name.empty()) return false;
+  return this->append(new HeaderNode(HeaderTable::find(name), name, std::move(data)));
+}
+
+/**
+ * @brief Append new node to the tail of the list.
+ *
+ * This method is responsible to link one allocated node at the end of the list.
+ *
+ * @return `true` in success.
+ * @return `false` on fail.
+ */
+bool HTTPHeader::append(HeaderNode *next){
+  if (next == nullptr) return false;
+  if (this->node == nullptr){
+    this->node = next;
+    return true;
+  }
+  HeaderNode *tail = this->node;
+  while (tail->next != nullptr) tail = tail->next;
+  tail->next = next;
+  return true;
+}
+
+/**
+ * @brief Gets the first node of the HTTP Header field.
+ *
+ * This method is responsible to search the node of the HTTP Header field.
+ *
+ * @return The node pointer or `nullptr` if the field is not available.
+ */
+HeaderNode *HTTPHeader::getNode(HeaderNode::headerField_t field) const {
+  for (HeaderNode *current = this->node; current != nullptr; current = current->next){
+    if (current->getField() == field) return current;
+  }
+  return nullptr;
+}
+
+/**
+ * @brief Overloading of `getNode` method for field name.
+ *
+ * This method is responsible to search the node by the case-insensitive field name, including the nodes of
+ * the parsed field names which are not in the HeaderTable.
+ *
+ * @return The node pointer or `nullptr` if the field is not available.
+ */
+HeaderNode *HTTPHeader::getNode(std::string_view name) const {
+  if (name.empty()) return nullptr;
+  HeaderNode::headerField_t field = HeaderTable::find(name);
+  for (HeaderNode *current = this->node; current != nullptr; current = current->next){
+    if (__isNamed(current, field, name)) return current;
+  }
+  return nullptr;
+}
+
+/**
+ * @brief Remove all nodes of the HTTP Header field.
+ *
+ * This method is responsible to unlink and release every node of the HTTP Header field.
+ *
+ * @return `true` if at least one node is removed.
+ * @return `false` if the field is not available.
+ */
+bool HTTPHeader::remove(HeaderNode::headerField_t field){
+  bool removed = false;
+  HeaderNode **link = &this->node;
+  while (*link != nullptr){
+    HeaderNode *current = *link;
+    if (current->getField() != field){
+      link = &current->next;
+      continue;
+    }
+    *link = current->next;
+    delete current;
+    removed = true;
+  }
+  return removed;
+}
+
+/**
+ * @brief Overloading of `remove` method for field name.
+ *
+ * This method is responsible to unlink and release every node of the case-insensitive field name, including
+ * the nodes of the parsed field names which are not in the HeaderTable.
+ *
+ * @return `true` if at least one node is removed.
+ * @return `false` if the field is not available.
+ */
+bool HTTPHeader::remove(std::string_view name){
+  if (name.empty()) return false;
+  HeaderNode::headerField_t field = HeaderTable::find(name);
+  bool removed = false;
+  HeaderNode **link = &this->node;
+  while (*link != nullptr){
+    HeaderNode *current = *link;
+    if (!__isNamed(current, field, name)){
+      link = &current->next;
+      continue;
+    }
+    *link = current->next;
+    delete current;
+    removed = true;
+  }
+  return removed;
+}
+
+/**
+ * @brief Set HTTP Status Code.
+ *
+ * This method is responsible for setting the HTTP Status Code of the response status line.
+ *
+ * @param[in] code The HTTP Status Code.
+ */
+void HTTPHeader::setHTTPStatusCode(HttpStatus::Code_t code){
+  this->code = code;
+}
+
+/**
+ * @brief Gets the HTTP Status Code.
+ *
+ * @return The HTTP Status Code.
+ */
+HttpStatus::Code_t HTTPHeader::getHTTPStatusCode() const {
+  return this->code;
+}
+
+/**
+ * @brief Set the request line.
+ *
+ * This method is responsible for setting the method and the target of the request line, the head is
+ * serialized as a request after this call.
+ *
+ * @param[in] method The request method (e.g. "GET").
+ * @param[in] target The request target (e.g. "/index.html").
+ */
+void HTTPHeader::setRequestLine(const std::string &method, const std::string &target){
+  this->method = method;
+  this->target = target;
+}
+
+/**
+ * @brief Write the start line and all available nodes to the payload.
+ *
+ * This method is responsible to append the start line (the request line of a parsed request, otherwise the
+ * status line) and one row for each node to the payload buffer. The terminating empty row is not written, so
+ * other rows (e.g. `HTTPSetCookie::serialize`) can be appended directly to the same buffer before the head is
+ * closed with CRLF.
+ *
+ * @param[in,out] payload The payload buffer.
+ */
+void HTTPHeader::serialize(std::string &payload){
+  if (!this->method.empty()){
+    payload.append(this->method);
+    payload.push_back(' ');
+    payload.append(this->target);
+    payload.append(" HTTP/");
+    payload.append(this->version);
+    payload.append("\r\n");
+  }
+  else {
+    payload.append("HTTP/");
+    payload.append(this->version);
+    payload.push_back(' ');
+    payload.append(std::to_string(static_cast<int>(this->code)));
+    payload.push_back(' ');
+    payload.append(HttpStatus::getReasonPhrase(this->code));
+    payload.append("\r\n");
+  }
+  for (HeaderNode *current = this->node; current != nullptr; current = current->next){
+    payload.append(current->getFieldNameView());
+    payload.append(": ");
+    payload.append(current->getValue());
+    payload.append("\r\n");
+  }
+}
+
+/**
+ * @brief Gets HTTP Header as String.
+ *
+ * This method is responsible to create HTTP Header Payload form all available nodes.
+ *
+ * @return HTTP Header payload as string
+ */
+std::string HTTPHeader::getPayload(){
+  std::string payload;
+  this->serialize(payload);
+  payload.append("\r\n");
+  return payload;
+}
+
+
+/**
+ * @brief Parse one HTTP Header from the buffer.
+ *
+ * This method is responsible to find the end of the first head available in the buffer (empty row) and parse
+ * the start line and all rows into this (blank) HTTP Header. The buffer may hold more data after the head
+ * (body or the next pipelined request), it is not consumed.
+ *
+ * @param[in] buffer The received data.
+ * @param[in] length The length of the received data.
+ * @return The number of bytes of the head (including the empty row).
+ * @return `0` if the head is not complete yet.
+ * @return `-1` if the head is malformed (including a head without start line).
+ */
+ssize_t HTTPHeader::parse(const char *buffer, size_t length){
+  HTTPHeader::limits_t limits;
+  HttpStatus::Code_t status = HttpStatus::OK;
+  return this->parse(buffer, length, limits, status);
+}
+
+/**
+ * @brief Overloading of `parse` method with limits.
+ *
+ * This method is responsible to check the limits while the head is scanned, so an oversized head is rejected
+ * as soon as the received part exceeds a limit, before the rest of it is buffered.
+ *
+ * @param[in] buffer The received data.
+ * @param[in] length The length of the received data.
+ * @param[in] limits The limits (line length, request target length, number of rows, head size, value length).
+ * @param[out] status The rejection status if the head is rejected: `URI_TOO_LONG` (request line or target),
+ * `REQUEST_HEADER_FIELDS_TOO_LARGE` (row, number of rows, head or value) or `BAD_REQUEST` (malformed).
+ * @return The number of bytes of the head (including the empty row).
+ * @return `0` if the head is not complete yet.
+ * @return `-1` if the head is rejected.
+ */
+ssize_t HTTPHeader::parse(const char *buffer, size_t length, const HTTPHeader::limits_t &limits, HttpStatus::Code_t &status){
+  HTTPHeader::scan_t scan;
+  return this->parse(buffer, length, limits, status, scan);
+}
+
+/**
+ * @brief Overloading of `parse` method with limits and scan state.
+ *
+ * This method is responsible to continue the scan of an incomplete head after the rows which were complete in
+ * the previous call, so a head which arrives in many small reads is scanned once. The buffer must start at the
+ * same byte as in the previous call. The state is reset when the head is complete or rejected.
+ *
+ * @param[in] buffer The received data.
+ * @param[in] length The length of the received data.
+ * @param[in] limits The limits (line length, request target length, number of rows, head size, value length).
+ * @param[out] status The rejection status if the head is rejected (see the overloading with limits).
+ * @param[in,out] scan The scan state of the head.
+ * @return The number of bytes of the head (including the empty row).
+ * @return `0` if the head is not complete yet.
+ * @return `-1` if the head is rejected.
+ */
+ssize_t HTTPHeader::parse(const char *buffer, size_t length, const HTTPHeader::limits_t &limits, HttpStatus::Code_t &status, HTTPHeader::scan_t &scan){
+  status = HttpStatus::OK;
+  if (scan.offset > length) scan = HTTPHeader::scan_t();
+  const char *current = buffer + scan.offset;
+  const char *end = buffer + length;
+  /* the rows are scanned as they arrive, a row is never searched beyond the line limit */
+  for (;;){
+    bool start = !scan.start;
+    size_t available = end - current;
+    size_t window = (available < limits.line + 2 ? available : limits.line + 2);
+    size_t lf = HTTPSimd::find(current, window, '\n', '\n');
+    if (lf == window){
+      if (available > limits.line + 1){
+        status = __tooLarge(current, available, start);
+        break;
+      }
+      if (length > limits.size){
+        status = HttpStatus::REQUEST_HEADER_FIELDS_TOO_LARGE;
+        break;
+      }
+      return 0;
+    }
+    size_t lineLength = lf;
+    if (lineLength > 0 && current[lineLength - 1] == '\r') lineLength--;
+    const char *line = current;
+    current += lf + 1;
+    scan.offset = current - buffer;
+    if (lineLength > limits.line){
+      status = __tooLarge(line, lineLength, start);
+      break;
+    }
+    if (scan.offset > limits.size){
+      status = HttpStatus::REQUEST_HEADER_FIELDS_TOO_LARGE;
+      break;
+    }
+    if (start){
+      /* the empty rows before the request line are ignored (RFC 7230 section 3.5), the head size bounds them */
+      if (lineLength == 0) continue;
+      /* unlike the payload constructor, data from the wire must start with the start line */
+      if (!__isStartLine(line, lineLength)){
+        status = HttpStatus::BAD_REQUEST;
+        break;
+      }
+      scan.start = true;
+      if (memcmp(line, "HTTP/", 5) != 0){
+        const char *first = static_cast<const char *>(memchr(line, ' ', lineLength));
+        const char *last = static_cast<const char *>(memrchr(line, ' ', lineLength));
+        if (first != nullptr && last > first && static_cast<size_t>(last - first - 1) > limits.target){
+          status = HttpStatus::URI_TOO_LONG;
+          break;
+        }
+      }
+      continue;
+    }
+    if (lineLength == 0) break;
+    const char *value = static_cast<const char *>(memchr(line, ':', lineLength));
+    if (value != nullptr){
+      value++;
+      while (value < line + lineLength && (*value == ' ' || *value == '\t')) value++;
+    }
+    if (++scan.rows > limits.count || (value != nullptr && static_cast<size_t>(line + lineLength - value) > limits.value)){
+      status = HttpStatus::REQUEST_HEADER_FIELDS_TOO_LARGE;
+      break;
+    }
+  }
+  scan = HTTPHeader::scan_t();
+  if (status != HttpStatus::OK) return -1;
+  if (!this->parseHead(buffer, current - buffer)){
+    status = HttpStatus::BAD_REQUEST;
+    return -1;
+  }
+  return current - buffer;
+}
+
+/**
+ * @brief Parse the complete head.
+ *
+ * This method is responsible to parse the start line (if any) and all rows of the head.
+ *
+ * @return `true` in success.
+ * @return `false` if the start line, the field name or the value of one row is malformed, or the body framing is
+ * ambiguous.
+ */
+bool HTTPHeader::parseHead(const char *head, size_t length){
+  HeaderNode *tail = this->node;
+  const char *current = head;
+  const char *end = head + length;
+  bool first = true;
+  while (tail != nullptr && tail->next != nullptr) tail = tail->next;
+  while (current < end){
+    const char *lf = static_cast<const char *>(memchr(current, '\n', end - current));
+    const char *line = current;
+    size_t lineLength = (lf == nullptr ? end : lf) - current;
+    current = (lf == nullptr ? end : lf + 1);
+    if (lineLength > 0 && line[lineLength - 1] == '\r') lineLength--;
+    if (lineLength == 0){
+      /* leading empty rows are ignored, the first empty row after the start line ends the head */
+      if (first) continue;
+      break;
+    }
+    if (first && __isStartLine(line, lineLength)){
+      first = false;
+      if (!this->parseStartLine(line, lineLength)) return false;
+      continue;
+    }
+    first = false;
+    HeaderNode::headerField_t field = HeaderNode::UNKNOWN;
+    std::string_view name;
+    std::string_view value;
+    /* a row which is not `<token>:` (e.g. space before the colon) is never skipped silently */
+    if (!HeaderNode::parseRow(line, lineLength, field, name, value)) return false;
+    HeaderNode *next = __node(field, name, std::string(value));
+    if (next == nullptr) return false;
+    if (tail == nullptr) this->node = next;
+    else tail->next = next;
+    tail = next;
+  }
+  /*
+   * the body framing must be unambiguous (RFC 9112 section 6.3): differing `Content-Length` values, or a request
+   * with both `Content-Length` and `Transfer-Encoding`, would let two parsers split the stream differently
+   */
+  long contentLength = -1;
+  bool chunked = false;
+  for (HeaderNode *current = this->node; current != nullptr; current = current->next){
+    if (current->getField() == HeaderNode::TRANSFER_ENCODING) chunked = true;
+    if (current->getField() != HeaderNode::CONTENT_LENGTH) continue;
+    long number = 0;
+    if (!current->getNumber(number) || (contentLength >= 0 && number != contentLength)) return false;
+    contentLength = number;
+  }
+  return !(chunked && contentLength >= 0 && !this->method.empty());
+}
+
+/**
+ * @brief Parse the start line.
+ *
+ * This method is responsible to parse the status line (`HTTP/<version> <code> <reason>`) or the request
+ * line (`<method> <target> HTTP/<version>`).
+ *
+ * @return `true` in success.
+ * @return `false` if the start line is malformed.
+ */
+bool HTTPHeader::parseStartLine(const char *line, size_t length){
+  std::string_view start(line, length);
+  if (start.substr(0, 5) == "HTTP/"){
+    size_t space = start.find(' ');
+    if (space == std::string_view::npos || space == 5 || space + 4 > length) return false;
+    int code = 0;
+    for (size_t i = space + 1; i < space + 4; i++){
+      if (start[i] < '0' || start[i] > '9') return false;
+      code = code * 10 + (start[i] - '0');
+    }
+    this->version.assign(start.substr(5, space - 5));
+    this->code = static_cast<HttpStatus::Code_t>(code);
+    return true;
+  }
+  size_t first = start.find(' ');
+  size_t last = start.rfind(' ');
+  if (first == std::string_view::npos || first == 0 || last <= first + 1) return false;
+  this->method.assign(start.substr(0, first));
+  this->target.assign(start.substr(first + 1, last - first - 1));
+  this->version.assign(start.substr(last + 6));
+  return true;
+}
+
+/**
+ * @brief Gets the request method.
+ *
+ * @return The request method or empty string if the head is not a request.
+ */
+const std::string &HTTPHeader::getMethod() const {
+  return this->method;
+}
+
+/**
+ * @brief Gets the request target.
+ *
+ * @return The request target or empty string if the head is not a request.
+ */
+const std::string &HTTPHeader::getTarget() const {
+  return this->target;
+}
+
+/**
+ * @brief Gets the HTTP version.
+ *
+ * @return The HTTP version (e.g. "1.1").
+ */
+const std::string &HTTPHeader::getVersion() const {
+  return this->version;
+}
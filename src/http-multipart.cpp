@@ -0,0 +1,339 @@
+/*
+ * $Id: http-multipart.cpp,v 1.0.0 2026/10/18 15:27:44 Jaya Wikrama Exp $
+ *
+ * Copyright (c) 2024 Jaya Wikrama
+ * jayawikrama89@gmail.com
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *  claim that you wrote the original software. If you use this software
+ *  in a product, an acknowledgment in the product documentation would be
+ *  appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *  misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <strings.h>
+#include <unistd.h>
+#include "http-multipart.hpp"
+
+/* parameters of the header value (`type; name="value"; name=value`), quotes and escapes are removed */
+static bool __parameter(const std::string &value, const char *name, std::string &result){
+  size_t nameLength = strlen(name);
+  size_t pos = value.find(';');
+  while (pos != std::string::npos){
+    pos++;
+    while (pos < value.length() && (value[pos] == ' ' || value[pos] == '\t')) pos++;
+    size_t equal = value.find('=', pos);
+    if (equal == std::string::npos) return false;
+    size_t end = equal;
+    while (end > pos && (value[end - 1] == ' ' || value[end - 1] == '\t')) end--;
+    bool match = (end - pos == nameLength && strncasecmp(value.c_str() + pos, name, nameLength) == 0);
+    pos = equal + 1;
+    while (pos < value.length() && (value[pos] == ' ' || value[pos] == '\t')) pos++;
+    std::string parameter;
+    if (pos < value.length() && value[pos] == '"'){
+      for (pos++; pos < value.length() && value[pos] != '"'; pos++){
+        if (value[pos] == '\\' && pos + 1 < value.length()) pos++;
+        parameter.push_back(value[pos]);
+      }
+      pos = value.find(';', pos);
+    }
+    else {
+      size_t next = value.find(';', pos);
+      parameter = value.substr(pos, (next == std::string::npos ? value.length() : next) - pos);
+      while (!parameter.empty() && (parameter.back() == ' ' || parameter.back() == '\t')) parameter.pop_back();
+      pos = next;
+    }
+    if (match){
+      result = parameter;
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief Custom constructor.
+ *
+ * Every handler may be `nullptr` and every handler may return `false` to stop the parser.
+ * This method will throw an error if the boundary is empty or longer than `HTTP_MULTIPART_MAX_BOUNDARY`.
+ *
+ * @param[in] boundary The boundary (see `getBoundary`).
+ * @param[in] onPart The handler of the parsed part header.
+ * @param[in] onData The handler of the part body slices (not called while the output is set).
+ * @param[in] onPartEnd The handler of the end of the part.
+ * @param[in] context The handlers context.
+ */
+HTTPMultipart::HTTPMultipart(const std::string &boundary, HTTPMultipart::part_t onPart, HTTPMultipart::data_t onData, HTTPMultipart::end_t onPartEnd, void *context){
+  if (boundary.empty() || boundary.length() > HTTP_MULTIPART_MAX_BOUNDARY) throw std::runtime_error(std::string(__func__) + ": invalid boundary");
+  this->delimiter = "\r\n--" + boundary;
+  size_t length = this->delimiter.length();
+  for (size_t i = 0; i < 256; i++) this->skip[i] = length;
+  for (size_t i = 0; i + 1 < length; i++) this->skip[static_cast<unsigned char>(this->delimiter[i])] = length - 1 - i;
+  /* the first delimiter may start the body, the virtual CRLF lets it match like the others */
+  this->carry = "\r\n";
+  this->onPart = onPart;
+  this->onData = onData;
+  this->onPartEnd = onPartEnd;
+  this->context = context;
+  this->state = HTTPMultipart::PREAMBLE;
+  this->partOpen = false;
+  this->output = -1;
+}
+
+/* Boyer-Moore-Horspool, the position of the first delimiter or npos */
+size_t HTTPMultipart::search(const char *data, size_t length) const {
+  size_t m = this->delimiter.length();
+  if (length < m) return std::string::npos;
+  const char *pattern = this->delimiter.data();
+  size_t i = 0;
+  while (i <= length - m){
+    unsigned char last = static_cast<unsigned char>(data[i + m - 1]);
+    if (last == static_cast<unsigned char>(pattern[m - 1]) && memcmp(data + i, pattern, m - 1) == 0) return i;
+    i += this->skip[last];
+  }
+  return std::string::npos;
+}
+
+/* the position of the longest tail which is a prefix of the delimiter (the earliest one), length if there is none */
+size_t HTTPMultipart::partial(const char *data, size_t length) const {
+  size_t m = this->delimiter.length();
+  size_t i = (length >= m ? length - m + 1 : 0);
+  for (; i < length; i++){
+    if (memcmp(data + i, this->delimiter.data(), length - i) == 0) return i;
+  }
+  return length;
+}
+
+bool HTTPMultipart::deliver(const char *data, size_t length){
+  if (this->state != HTTPMultipart::BODY || length == 0) return true;
+  if (this->output < 0){
+    return (this->onData == nullptr || this->onData(*this, data, length, this->context));
+  }
+  while (length > 0){
+    ssize_t ret = write(this->output, data, length);
+    if (ret < 0){
+      if (errno == EINTR) continue;
+      return false;
+    }
+    data += ret;
+    length -= static_cast<size_t>(ret);
+  }
+  return true;
+}
+
+bool HTTPMultipart::parseHead(){
+  HTTPHeader part;
+  size_t pos = 0;
+  while (pos < this->head.length()){
+    size_t end = this->head.find('\n', pos);
+    if (end == std::string::npos) end = this->head.length();
+    size_t length = end - pos;
+    if (length > 0 && this->head[end - 1] == '\r') length--;
+    HeaderNode::headerField_t field = HeaderNode::UNKNOWN;
+    std::string_view name;
+    std::string_view value;
+    /* a row which is not a field would be lost silently, the part is rejected instead */
+    if (length > 0){
+      if (!HeaderNode::parseRow(this->head.data() + pos, length, field, name, value)) return false;
+      part.append(name, std::string(value));
+    }
+    pos = end + 1;
+  }
+  this->head.clear();
+  this->partOpen = true;
+  return (this->onPart == nullptr || this->onPart(*this, part, this->context));
+}
+
+bool HTTPMultipart::closePart(){
+  if (!this->partOpen) return true;
+  this->partOpen = false;
+  this->output = -1;
+  return (this->onPartEnd == nullptr || this->onPartEnd(*this, this->context));
+}
+
+/**
+ * @brief Parse the next slice of the body.
+ *
+ * This method is responsible to parse the slice and call the handlers. The slice is not referenced after the
+ * method returns.
+ *
+ * @param[in] data The body slice.
+ * @param[in] length The slice length.
+ * @return `true` in success (call `isComplete` to check the final delimiter).
+ * @return `false` if the body is malformed (e.g. a part header row is not a field), a handler stopped the parser or
+ * the output can not be written.
+ */
+bool HTTPMultipart::feed(const char *data, size_t length){
+  size_t m = this->delimiter.length();
+  size_t pos = 0;
+  while (pos < length){
+    switch (this->state){
+      case HTTPMultipart::PREAMBLE:
+      case HTTPMultipart::BODY: {
+        const char *current = data + pos;
+        size_t available = length - pos;
+        if (!this->carry.empty()){
+          /* a delimiter which starts in the carried tail ends in the first m - 1 bytes of the slice */
+          size_t take = (available < m - 1 ? available : m - 1);
+          std::string window(this->carry);
+          window.append(current, take);
+          size_t found = this->search(window.data(), window.length());
+          if (found != std::string::npos && found < this->carry.length()){
+            if (!this->deliver(window.data(), found)) break;
+            pos += found + m - this->carry.length();
+            this->carry.clear();
+            this->state = HTTPMultipart::DELIMITER;
+            continue;
+          }
+          size_t tail = this->partial(window.data(), window.length());
+          if (tail < this->carry.length()){
+            if (!this->deliver(window.data(), tail)) break;
+            this->carry = window.substr(tail);
+            return true;
+          }
+          if (!this->deliver(this->carry.data(), this->carry.length())) break;
+          this->carry.clear();
+        }
+        size_t found = this->search(current, available);
+        if (found != std::string::npos){
+          if (!this->deliver(current, found)) break;
+          pos += found + m;
+          this->state = HTTPMultipart::DELIMITER;
+          continue;
+        }
+        size_t tail = this->partial(current, available);
+        if (!this->deliver(current, tail)) break;
+        this->carry.assign(current + tail, available - tail);
+        return true;
+      }
+      case HTTPMultipart::DELIMITER: {
+        /* transport padding is allowed between the boundary and the CRLF */
+        char c = data[pos++];
+        if (c == ' ' || c == '\t') continue;
+        if (c == '-') this->state = HTTPMultipart::DELIMITER_DASH;
+        else if (c == '\r') this->state = HTTPMultipart::DELIMITER_CR;
+        else this->state = HTTPMultipart::FAILED;
+        continue;
+      }
+      case HTTPMultipart::DELIMITER_DASH:
+        if (data[pos++] != '-' || !this->closePart()){
+          this->state = HTTPMultipart::FAILED;
+          continue;
+        }
+        this->state = HTTPMultipart::EPILOGUE;
+        return true;
+      case HTTPMultipart::DELIMITER_CR:
+        if (data[pos++] != '\n' || !this->closePart()){
+          this->state = HTTPMultipart::FAILED;
+          continue;
+        }
+        this->head.clear();
+        this->state = HTTPMultipart::HEAD;
+        continue;
+      case HTTPMultipart::HEAD: {
+        const char *lf = static_cast<const char *>(memchr(data + pos, '\n', length - pos));
+        size_t end = (lf == nullptr ? length : static_cast<size_t>(lf - data) + 1);
+        this->head.append(data + pos, end - pos);
+        pos = end;
+        if (this->head.length() > HTTP_MULTIPART_MAX_HEAD){
+          this->state = HTTPMultipart::FAILED;
+          continue;
+        }
+        size_t headLength = this->head.length();
+        bool complete = (this->head == "\r\n" || this->head == "\n");
+        if (!complete && headLength >= 2 && this->head[headLength - 1] == '\n'){
+          complete = (this->head[headLength - 2] == '\n' || (headLength >= 3 && this->head.compare(headLength - 3, 3, "\n\r\n") == 0));
+        }
+        if (!complete) continue;
+        this->state = HTTPMultipart::BODY;
+        if (!this->parseHead()) this->state = HTTPMultipart::FAILED;
+        continue;
+      }
+      case HTTPMultipart::EPILOGUE:
+        return true;
+      case HTTPMultipart::FAILED:
+        return false;
+    }
+    /* a handler stopped the parser or the output failed */
+    this->state = HTTPMultipart::FAILED;
+  }
+  return (this->state != HTTPMultipart::FAILED);
+}
+
+/**
+ * @brief Check the final delimiter.
+ *
+ * @return `true` if the final delimiter is parsed.
+ * @return `false` if the body is not complete yet.
+ */
+bool HTTPMultipart::isComplete() const {
+  return (this->state == HTTPMultipart::EPILOGUE);
+}
+
+/**
+ * @brief Write the current part body to the file descriptor.
+ *
+ * This method is responsible to write the rest of the current part body straight from the fed slices to the
+ * file descriptor instead of calling the data handler. The output is reset at the end of the part, the file
+ * descriptor is not closed.
+ *
+ * @param[in] fd The output file descriptor.
+ */
+void HTTPMultipart::setOutput(int fd){
+  this->output = fd;
+}
+
+/**
+ * @brief Gets the boundary of the request.
+ *
+ * This method is responsible to get the boundary parameter of `Content-Type: multipart/form-data`.
+ *
+ * @param[in] request The request header.
+ * @param[out] boundary The boundary.
+ * @return `true` in success.
+ * @return `false` if the request is not multipart or the boundary is malformed.
+ */
+bool HTTPMultipart::getBoundary(const HTTPHeader &request, std::string &boundary){
+  HeaderNode *node = request.getNode(HeaderNode::CONTENT_TYPE);
+  if (node == nullptr) return false;
+  std::string value = node->getValue();
+  if (value.length() < 10 || strncasecmp(value.c_str(), "multipart/", 10) != 0) return false;
+  if (!__parameter(value, "boundary", boundary)) return false;
+  return (!boundary.empty() && boundary.length() <= HTTP_MULTIPART_MAX_BOUNDARY);
+}
+
+/**
+ * @brief Gets the form field of the part.
+ *
+ * This method is responsible to get the `name` and `filename` parameters of `Content-Disposition: form-data`.
+ *
+ * @param[in] part The part header.
+ * @param[out] name The form field name.
+ * @param[out] filename The file name or empty string.
+ * @return `true` in success.
+ * @return `false` if the part has no form-data disposition.
+ */
+bool HTTPMultipart::getDisposition(const HTTPHeader &part, std::string &name, std::string &filename){
+  name.clear();
+  filename.clear();
+  HeaderNode *node = part.getNode(HeaderNode::CONTENT_DISPOSITION);
+  if (node == nullptr) return false;
+  std::string value = node->getValue();
+  if (value.length() < 9 || strncasecmp(value.c_str(), "form-data", 9) != 0) return false;
+  if (!__parameter(value, "name", name)) return false;
+  __parameter(value, "filename", filename);
+  return true;
+}
@@ -0,0 +1,327 @@
+/*
+ * $Id: http-negotiation.cpp,v 1.0.0 2026/10/18 10:02:15 Jaya Wikrama Exp $
+ *
+ * Copyright (c) 2024 Jaya Wikrama
+ * jayawikrama89@gmail.com
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *  claim that you wrote the original software. If you use this software
+ *  in a product, an acknowledgment in the product documentation would be
+ *  appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *  misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include <algorithm>
+#include <stdexcept>
+#include "http-negotiation.hpp"
+#include "http-simd.hpp"
+
+#define MAX_PREFERENCES 255
+
+typedef struct _cacheEntry_t {
+  uint64_t hash;
+  uint64_t tick;
+  HTTPPreferenceList::kind_t kind;
+  std::string value;
+  HTTPPreferenceList list;
+} cacheEntry_t;
+
+typedef struct _cache_t {
+  uint64_t tick;
+  size_t used;
+  cacheEntry_t entry[HTTP_NEGOTIATION_CACHE_SIZE];
+} cache_t;
+
+static thread_local cache_t __cache;
+
+static inline char __lower(char c){
+  if (c >= 'A' && c <= 'Z') return c - 'A' + 'a';
+  return c;
+}
+
+static std::string_view __trim(std::string_view input){
+  while (!input.empty() && (input.front() == ' ' || input.front() == '\t')) input.remove_prefix(1);
+  while (!input.empty() && (input.back() == ' ' || input.back() == '\t')) input.remove_suffix(1);
+  return input;
+}
+
+/* token must be lower-cased, offer is compared case-insensitively */
+static bool __equals(std::string_view token, std::string_view offer){
+  if (token.length() != offer.length()) return false;
+  for (size_t i = 0; i < token.length(); i++){
+    if (token[i] != __lower(offer[i])) return false;
+  }
+  return true;
+}
+
+static bool __startsWith(std::string_view offer, std::string_view token){
+  if (offer.length() < token.length()) return false;
+  return __equals(token, offer.substr(0, token.length()));
+}
+
+static int __parseQuality(std::string_view params){
+  while (!params.empty()){
+    size_t end = params.find(';');
+    std::string_view param = __trim(params.substr(0, end));
+    params = (end == std::string_view::npos ? std::string_view() : params.substr(end + 1));
+    if (param.length() < 2 || __lower(param[0]) != 'q') continue;
+    param = __trim(param.substr(1));
+    if (param.empty() || param[0] != '=') continue;
+    param = __trim(param.substr(1));
+    if (param.empty() || (param[0] != '0' && param[0] != '1')) return -1;
+    int quality = (param[0] - '0') * 1000;
+    int scale = 100;
+    for (size_t i = 2; i < param.length() && i < 5 && param[1] == '.'; i++){
+      if (param[i] < '0' || param[i] > '9') return -1;
+      quality += (param[i] - '0') * scale;
+      scale /= 10;
+    }
+    return (quality > 1000 ? 1000 : quality);
+  }
+  return 1000;
+}
+
+/**
+ * @brief Default constructor for empty preference list.
+ *
+ * This method is responsible for create blank preference list (every offer is acceptable).
+ */
+HTTPPreferenceList::HTTPPreferenceList(){
+  this->kind = HTTPPreferenceList::KIND_MEDIA_TYPE;
+}
+
+/**
+ * @brief Custom constructor for header value.
+ *
+ * This method is responsible for parse the header value into preference list sorted by quality
+ * (highest first). Elements with the same quality keep the header order.
+ */
+HTTPPreferenceList::HTTPPreferenceList(HTTPPreferenceList::kind_t kind, std::string_view headerValue){
+  this->kind = kind;
+  this->tokens.reserve(headerValue.length());
+  while (!headerValue.empty() && this->preferences.size() < MAX_PREFERENCES){
+    size_t end = headerValue.find(',');
+    std::string_view element = __trim(headerValue.substr(0, end));
+    headerValue = (end == std::string_view::npos ? std::string_view() : headerValue.substr(end + 1));
+    size_t semicolon = element.find(';');
+    std::string_view token = __trim(element.substr(0, semicolon));
+    if (token.empty() || this->tokens.length() + token.length() > UINT16_MAX) continue;
+    int quality = 1000;
+    if (semicolon != std::string_view::npos) quality = __parseQuality(element.substr(semicolon + 1));
+    if (quality < 0) continue;
+    HTTPPreferenceList::preference_t preference;
+    preference.offset = static_cast<uint16_t>(this->tokens.length());
+    preference.length = static_cast<uint16_t>(token.length());
+    preference.quality = static_cast<uint16_t>(quality);
+    preference.order = static_cast<uint8_t>(this->preferences.size());
+    this->tokens.append(token.data(), token.length());
+    HTTPSimd::lower(&this->tokens[preference.offset], token.length());
+    std::string_view lowered = std::string_view(this->tokens).substr(preference.offset);
+    if (lowered == "*" || lowered == "*/*"){
+      preference.specificity = 0;
+    }
+    else if (kind == HTTPPreferenceList::KIND_MEDIA_TYPE){
+      preference.specificity = (lowered.length() > 2 && lowered.substr(lowered.length() - 2) == "/*" ? 1 : 2);
+    }
+    else if (kind == HTTPPreferenceList::KIND_LANGUAGE){
+      preference.specificity = static_cast<uint8_t>(std::min<size_t>(lowered.length(), UINT8_MAX));
+    }
+    else {
+      preference.specificity = 1;
+    }
+    this->preferences.push_back(preference);
+  }
+  std::stable_sort(this->preferences.begin(), this->preferences.end(),
+    [](const HTTPPreferenceList::preference_t &a, const HTTPPreferenceList::preference_t &b){
+      return a.quality > b.quality;
+    }
+  );
+}
+
+/**
+ * @brief Gets the number of preferences.
+ *
+ * @return The number of preferences.
+ */
+size_t HTTPPreferenceList::size() const {
+  return this->preferences.size();
+}
+
+/**
+ * @brief Gets the preference token (lower-cased, without parameters).
+ *
+ * @param[in] idx The preference index (0 is the most preferred).
+ * @return The preference token.
+ */
+std::string_view HTTPPreferenceList::getToken(size_t idx) const {
+  if (idx >= this->preferences.size()) return std::string_view();
+  return std::string_view(this->tokens).substr(this->preferences[idx].offset, this->preferences[idx].length);
+}
+
+/**
+ * @brief Gets the preference quality (q-value multiplied by 1000).
+ *
+ * @param[in] idx The preference index (0 is the most preferred).
+ * @return The preference quality.
+ */
+int HTTPPreferenceList::getQuality(size_t idx) const {
+  if (idx >= this->preferences.size()) return 0;
+  return this->preferences[idx].quality;
+}
+
+/**
+ * @brief Gets the quality of one offer.
+ *
+ * This method is responsible to find the most specific preference which matches the offer and
+ * return its quality.
+ *
+ * @param[in] offer The offered representation (media type, coding, language tag or charset).
+ * @return The quality (0 to 1000) or 0 if the offer is not acceptable.
+ */
+int HTTPPreferenceList::getQuality(std::string_view offer) const {
+  offer = __trim(offer.substr(0, offer.find(';')));
+  if (this->preferences.empty()){
+    if (this->kind == HTTPPreferenceList::KIND_ENCODING) return (__equals("identity", offer) ? 1000 : 0);
+    return 1000;
+  }
+  int best = -1;
+  int quality = 0;
+  for (const HTTPPreferenceList::preference_t &preference : this->preferences){
+    if (static_cast<int>(preference.specificity) <= best) continue;
+    std::string_view token = std::string_view(this->tokens).substr(preference.offset, preference.length);
+    bool match = false;
+    if (preference.specificity == 0){
+      match = true;
+    }
+    else if (this->kind == HTTPPreferenceList::KIND_MEDIA_TYPE && preference.specificity == 1){
+      match = __startsWith(offer, token.substr(0, token.length() - 1));
+    }
+    else if (this->kind == HTTPPreferenceList::KIND_LANGUAGE){
+      match = (__equals(token, offer) || (__startsWith(offer, token) && offer[token.length()] == '-'));
+    }
+    else {
+      match = __equals(token, offer);
+    }
+    if (match){
+      best = preference.specificity;
+      quality = preference.quality;
+    }
+  }
+  /* identity is always acceptable unless it is excluded, but never preferred over a listed coding */
+  if (best < 0 && this->kind == HTTPPreferenceList::KIND_ENCODING && __equals("identity", offer)) return 1;
+  return quality;
+}
+
+/**
+ * @brief Gets the parsed preference list of the header value.
+ *
+ * This method is responsible to return the memoized preference list of the header value. The header
+ * value is parsed only if it is not available in the per-thread cache. The returned reference is valid
+ * until the next call on the same thread.
+ *
+ * @param[in] kind The preference list kind.
+ * @param[in] headerValue The raw header value.
+ * @return The preference list.
+ */
+const HTTPPreferenceList &HTTPNegotiation::getPreferences(HTTPPreferenceList::kind_t kind, std::string_view headerValue){
+  uint64_t hash = HTTPNegotiation::hash(headerValue);
+  size_t victim = 0;
+  __cache.tick++;
+  for (size_t i = 0; i < __cache.used; i++){
+    cacheEntry_t &entry = __cache.entry[i];
+    if (entry.hash == hash && entry.kind == kind && entry.value == headerValue){
+      entry.tick = __cache.tick;
+      return entry.list;
+    }
+    if (entry.tick < __cache.entry[victim].tick) victim = i;
+  }
+  if (__cache.used < HTTP_NEGOTIATION_CACHE_SIZE) victim = __cache.used++;
+  cacheEntry_t &entry = __cache.entry[victim];
+  entry.hash = hash;
+  entry.tick = __cache.tick;
+  entry.kind = kind;
+  entry.value.assign(headerValue.data(), headerValue.length());
+  entry.list = HTTPPreferenceList(kind, headerValue);
+  return entry.list;
+}
+
+/**
+ * @brief Select the best offer.
+ *
+ * This method is responsible to pick the offer with the highest quality. Offers with the same quality
+ * are selected by the server order (first offer wins).
+ *
+ * @param[in] kind The preference list kind.
+ * @param[in] headerValue The raw header value.
+ * @param[in] offers The offered representations ordered by server preference.
+ * @param[in] count The number of offers.
+ * @return The index of the selected offer.
+ * @return `-1` if no offer is acceptable (`NOT_ACCEPTABLE`).
+ */
+int HTTPNegotiation::select(HTTPPreferenceList::kind_t kind, std::string_view headerValue, const std::string_view *offers, size_t count){
+  const HTTPPreferenceList &preferences = HTTPNegotiation::getPreferences(kind, headerValue);
+  int selected = -1;
+  int best = 0;
+  for (size_t i = 0; i < count; i++){
+    int quality = preferences.getQuality(offers[i]);
+    if (quality > best){
+      best = quality;
+      selected = static_cast<int>(i);
+      if (best == 1000) break;
+    }
+  }
+  return selected;
+}
+
+/**
+ * @brief Overloading of `select` method.
+ *
+ * This method is responsible to pick the best offer based on the `Accept`, `Accept-Encoding`,
+ * `Accept-Language` or `Accept-Charset` node of the HTTP Header. A missing `Accept-Encoding` node
+ * accepts `identity` only, the other missing nodes accept any offer.
+ *
+ * @param[in] header The request HTTP Header.
+ * @param[in] field The negotiated field.
+ * @param[in] offers The offered representations ordered by server preference.
+ * @param[in] count The number of offers.
+ * @return The index of the selected offer.
+ * @return `-1` if no offer is acceptable (`NOT_ACCEPTABLE`).
+ */
+int HTTPNegotiation::select(const HTTPHeader &header, HeaderNode::headerField_t field, const std::string_view *offers, size_t count){
+  HTTPPreferenceList::kind_t kind = HTTPPreferenceList::KIND_MEDIA_TYPE;
+  switch (field){
+    case HeaderNode::ACCEPT: kind = HTTPPreferenceList::KIND_MEDIA_TYPE; break;
+    case HeaderNode::ACCEPT_ENCODING: kind = HTTPPreferenceList::KIND_ENCODING; break;
+    case HeaderNode::ACCEPT_LANGUAGE: kind = HTTPPreferenceList::KIND_LANGUAGE; break;
+    case HeaderNode::ACCEPT_CHARSET: kind = HTTPPreferenceList::KIND_CHARSET; break;
+    default: throw std::runtime_error(std::string(__func__) + ": field is not negotiable");
+  }
+  const HeaderNode *node = header.getNode(field);
+  return HTTPNegotiation::select(kind, (node == nullptr ? std::string_view() : node->getValueView()), offers, count);
+}
+
+/**
+ * @brief Gets the hash of the header value.
+ *
+ * This method is responsible to compute the 64 bit FNV-1a hash used as the cache key.
+ *
+ * @return The hash value.
+ */
+uint64_t HTTPNegotiation::hash(std::string_view value){
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  for (size_t i = 0; i < value.length(); i++){
+    hash ^= static_cast<unsigned char>(value[i]);
+    hash *= 0x100000001b3ULL;
+  }
+  return hash;
+}
@@ -0,0 +1,235 @@
+/*
+ * $Id: http-pipeline.cpp,v 1.0.0 2026/10/18 13:31:08 Jaya Wikrama Exp $
+ *
+ * Copyright (c) 2024 Jaya Wikrama
+ * jayawikrama89@gmail.com
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *  claim that you wrote the original software. If you use this software
+ *  in a product, an acknowledgment in the product documentation would be
+ *  appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *  misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include <cerrno>
+#include <sys/uio.h>
+#include "http-pipeline.hpp"
+#include "http-static-response.hpp"
+
+static constexpr auto __badRequest = HTTPStaticResponse<128>::build(
+  HttpStatus::BAD_REQUEST,
+  HeaderNode::CONNECTION, "close"
+);
+
+static constexpr auto __uriTooLong = HTTPStaticResponse<128>::build(
+  HttpStatus::URI_TOO_LONG,
+  HeaderNode::CONNECTION, "close"
+);
+
+static constexpr auto __fieldsTooLarge = HTTPStaticResponse<128>::build(
+  HttpStatus::REQUEST_HEADER_FIELDS_TOO_LARGE,
+  HeaderNode::CONNECTION, "close"
+);
+
+static bool __hasBody(const HTTPHeader &header){
+  HeaderNode *length = header.getNode(HeaderNode::CONTENT_LENGTH);
+  long number = 0;
+  if (length != nullptr && (!length->getNumber(number) || number > 0)) return true;
+  return (header.getNode(HeaderNode::TRANSFER_ENCODING) != nullptr);
+}
+
+/**
+ * @brief Default constructor for empty pipeline.
+ */
+HTTPPipeline::HTTPPipeline(){
+  this->offset = 0;
+}
+
+/**
+ * @brief Parse all complete request heads.
+ *
+ * This method is responsible to parse every complete request head available in the buffer in one call.
+ * Parsing stops after a request which carries a body (`Content-Length` greater than zero or
+ * `Transfer-Encoding`), because the body must be read before the next head. The returned headers are
+ * valid until the next call of `parse`. The scanned rows of an incomplete head are kept, so the next call
+ * must pass the buffer from the first byte which was not consumed.
+ *
+ * @param[in] buffer The received data.
+ * @param[in] length The length of the received data.
+ * @return The parsed headers, the number of bytes consumed by them, and the malformed flag which is set
+ * if the head after the parsed ones is malformed or exceeds the limits (the connection should be closed after
+ * the responses, with the rejection response of the status, see `getRejection`). An incomplete head which
+ * already exceeds the limits is rejected, so the caller stops reading.
+ */
+HTTPPipeline::batch_t HTTPPipeline::parse(const char *buffer, size_t length){
+  HTTPPipeline::batch_t batch = { nullptr, 0, 0, false, HttpStatus::OK };
+  this->headers.clear();
+  while (batch.consumed < length){
+    HTTPHeader header;
+    ssize_t ret = header.parse(buffer + batch.consumed, length - batch.consumed, this->limits, batch.status, this->scan);
+    if (ret == 0) break;
+    if (ret < 0){
+      batch.malformed = true;
+      break;
+    }
+    batch.consumed += static_cast<size_t>(ret);
+    bool body = __hasBody(header);
+    this->headers.push_back(std::move(header));
+    if (body) break;
+  }
+  batch.headers = this->headers.data();
+  batch.count = this->headers.size();
+  return batch;
+}
+
+/**
+ * @brief Set the head limits.
+ *
+ * @param[in] limits The limits checked while the request heads are scanned (see `HTTPHeader::limits_t`).
+ */
+void HTTPPipeline::setLimits(const HTTPHeader::limits_t &limits){
+  this->limits = limits;
+}
+
+/**
+ * @brief Gets the rejection response.
+ *
+ * @param[in] code The rejection status of the batch.
+ * @return The precompiled response (`400`, `414` or `431` with `Connection: close`) or an empty view.
+ */
+std::string_view HTTPPipeline::getRejection(HttpStatus::Code_t code){
+  switch (code){
+    case HttpStatus::BAD_REQUEST: return __badRequest.view();
+    case HttpStatus::URI_TOO_LONG: return __uriTooLong.view();
+    case HttpStatus::REQUEST_HEADER_FIELDS_TOO_LARGE: return __fieldsTooLarge.view();
+    default: break;
+  }
+  return std::string_view();
+}
+
+/**
+ * @brief Queue one response.
+ *
+ * This method is responsible to queue one serialized response, the pipeline takes the ownership of the data.
+ */
+void HTTPPipeline::queue(std::string &&response){
+  if (response.empty()) return;
+  this->responses.push_back(HTTPPipeline::response_t{ std::move(response), nullptr, nullptr, 0 });
+  this->responses.back().length = this->responses.back().owned.length();
+}
+
+/**
+ * @brief Queue one response without copying it.
+ *
+ * This method is responsible to queue one serialized response (e.g. `HTTPStaticResponse`) which is owned by
+ * the caller. The data must be available until it is flushed.
+ */
+void HTTPPipeline::queue(const char *data, size_t length){
+  if (data == nullptr || length == 0) return;
+  this->responses.push_back(HTTPPipeline::response_t{ std::string(), nullptr, data, length });
+}
+
+/**
+ * @brief Queue one shared response.
+ *
+ * This method is responsible to queue one serialized response which is shared with other pipelines (e.g. one
+ * WebSocket frame sent to many connections). The pipeline keeps a reference until the data is flushed.
+ */
+void HTTPPipeline::queue(std::shared_ptr<const std::string> response){
+  if (response == nullptr || response->empty()) return;
+  const char *data = response->data();
+  size_t length = response->length();
+  this->responses.push_back(HTTPPipeline::response_t{ std::string(), std::move(response), data, length });
+}
+
+/**
+ * @brief Gets the write buffer.
+ *
+ * This method is responsible to return the last queued response if it is owned by the pipeline, otherwise a
+ * new empty owned response is queued. The data appended to the buffer is written by the next `flush`, so small
+ * writes (e.g. streamed events) are coalesced without one queued response per write.
+ *
+ * @return The write buffer.
+ */
+std::string &HTTPPipeline::getBuffer(){
+  if (this->responses.empty() || this->responses.back().data != nullptr){
+    this->responses.push_back(HTTPPipeline::response_t{ std::string(), nullptr, nullptr, 0 });
+  }
+  return this->responses.back().owned;
+}
+
+/**
+ * @brief Write the queued responses.
+ *
+ * This method is responsible to write all queued responses with as few `writev` calls as possible (one for up
+ * to `HTTP_PIPELINE_MAX_IOV` responses). On non-blocking socket, the unwritten data stays queued if the socket
+ * buffer is full.
+ *
+ * @param[in] fd The socket file descriptor.
+ * @return The number of bytes written.
+ * @return `-1` on fail (see `errno`).
+ */
+ssize_t HTTPPipeline::flush(int fd){
+  /* the owned response may grow after it is queued (see `getBuffer`) */
+  auto length = [](const HTTPPipeline::response_t &response){
+    return (response.data == nullptr ? response.owned.length() : response.length);
+  };
+  struct iovec iov[HTTP_PIPELINE_MAX_IOV];
+  ssize_t total = 0;
+  while (!this->responses.empty()){
+    int count = 0;
+    for (const HTTPPipeline::response_t &response : this->responses){
+      if (count >= HTTP_PIPELINE_MAX_IOV) break;
+      /* owned data is resolved here, the string storage may move while the response is queued */
+      const char *data = (response.data == nullptr ? response.owned.data() : response.data);
+      size_t skip = (count == 0 ? this->offset : 0);
+      iov[count].iov_base = const_cast<char *>(data + skip);
+      iov[count].iov_len = length(response) - skip;
+      count++;
+    }
+    ssize_t ret = writev(fd, iov, count);
+    if (ret < 0){
+      if (errno == EINTR) continue;
+      if (errno == EAGAIN || errno == EWOULDBLOCK) return total;
+      return -1;
+    }
+    total += ret;
+    size_t written = static_cast<size_t>(ret) + this->offset;
+    while (!this->responses.empty() && written >= length(this->responses.front())){
+      written -= length(this->responses.front());
+      this->responses.pop_front();
+    }
+    this->offset = written;
+  }
+  return total;
+}
+
+/**
+ * @brief Check the queued responses.
+ *
+ * @return `true` if some responses are not written yet.
+ * @return `false` if the queue is empty.
+ */
+bool HTTPPipeline::isPending() const {
+  return !this->responses.empty();
+}
+
+/**
+ * @brief Remove all parsed headers and queued responses.
+ */
+void HTTPPipeline::clear(){
+  this->headers.clear();
+  this->responses.clear();
+  this->offset = 0;
+  this->scan = HTTPHeader::scan_t();
+}
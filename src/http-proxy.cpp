@@ -0,0 +1,531 @@
+/*
+ * $Id: http-proxy.cpp,v 1.0.0 2026/10/18 16:14:08 Jaya Wikrama Exp $
+ *
+ * Copyright (c) 2024 Jaya Wikrama
+ * jayawikrama89@gmail.com
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *  claim that you wrote the original software. If you use this software
+ *  in a product, an acknowledgment in the product documentation would be
+ *  appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *  misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <strings.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/time.h>
+#include "http-proxy.hpp"
+#include "http-header-table.hpp"
+
+typedef enum _framing_t {
+  NONE = 0,
+  LENGTH,
+  CHUNKED,
+  UNTIL_CLOSE
+} framing_t;
+
+typedef struct _pipe_t {
+  int fd[2];
+
+  _pipe_t(){
+    this->open();
+  }
+
+  ~_pipe_t(){
+    this->close();
+  }
+
+  void open(){
+    if (pipe2(this->fd, O_CLOEXEC) != 0){
+      this->fd[0] = this->fd[1] = -1;
+      return;
+    }
+    fcntl(this->fd[1], F_SETPIPE_SZ, HTTP_PROXY_SPLICE_SIZE);
+  }
+
+  void close(){
+    if (this->fd[0] >= 0) ::close(this->fd[0]);
+    if (this->fd[1] >= 0) ::close(this->fd[1]);
+    this->fd[0] = this->fd[1] = -1;
+  }
+} pipe_t;
+
+static std::string __trim(const std::string &text){
+  size_t first = text.find_first_not_of(" \t");
+  if (first == std::string::npos) return std::string();
+  size_t last = text.find_last_not_of(" \t");
+  return text.substr(first, last - first + 1);
+}
+
+static std::vector<std::string> __tokens(const std::string &value){
+  std::vector<std::string> tokens;
+  size_t start = 0;
+  while (start <= value.length()){
+    size_t end = value.find(',', start);
+    if (end == std::string::npos) end = value.length();
+    std::string item = __trim(value.substr(start, end - start));
+    if (!item.empty()) tokens.push_back(item);
+    start = end + 1;
+  }
+  return tokens;
+}
+
+static bool __hasToken(const HTTPHeader &header, HeaderNode::headerField_t field, const char *token){
+  HeaderNode *node = (field == HeaderNode::UNKNOWN ? nullptr : header.getNode(field));
+  if (node == nullptr) return false;
+  for (const std::string &item : __tokens(node->getValue())){
+    if (strcasecmp(item.c_str(), token) == 0) return true;
+  }
+  return false;
+}
+
+static bool __number(const std::string &text, uint64_t &number){
+  std::string value = __trim(text);
+  if (value.empty() || value.length() > 19) return false;
+  number = 0;
+  for (char c : value){
+    if (c < '0' || c > '9') return false;
+    number = number * 10 + static_cast<uint64_t>(c - '0');
+  }
+  return true;
+}
+
+static bool __idempotent(const std::string &method){
+  return (method == "GET" || method == "HEAD" || method == "OPTIONS" || method == "TRACE" || method == "PUT" || method == "DELETE");
+}
+
+static bool __acceptable(const HTTPHeader &request, uint64_t &contentLength){
+  bool found = false;
+  contentLength = 0;
+  for (HeaderNode *current = request.node; current != nullptr; current = current->next){
+    std::string_view value = current->getValueView();
+    for (unsigned char c : value){
+      if ((c < 0x20 && c != '\t') || c == 0x7F) return false;
+    }
+    if (current->getField() != HeaderNode::CONTENT_LENGTH) continue;
+    uint64_t number = 0;
+    if (!__number(current->getValue(), number) || (found && number != contentLength)) return false;
+    contentLength = number;
+    found = true;
+  }
+  return true;
+}
+
+static bool __sendAll(int fd, const char *data, size_t length){
+  while (length > 0){
+    ssize_t ret = ::send(fd, data, length, MSG_NOSIGNAL);
+    if (ret < 0 && errno == EINTR) continue;
+    if (ret <= 0) return false;
+    data += ret;
+    length -= static_cast<size_t>(ret);
+  }
+  return true;
+}
+
+static bool __receive(int fd, std::string &buffer){
+  char chunk[4096];
+  for (;;){
+    ssize_t ret = recv(fd, chunk, sizeof(chunk), 0);
+    if (ret < 0 && errno == EINTR) continue;
+    if (ret <= 0) return false;
+    buffer.append(chunk, static_cast<size_t>(ret));
+    return true;
+  }
+}
+
+static ssize_t __readHead(int fd, std::string &buffer, HTTPHeader &header){
+  for (;;){
+    if (!buffer.empty()){
+      ssize_t ret = header.parse(buffer.data(), buffer.length());
+      if (ret != 0) return ret;
+    }
+    if (buffer.length() >= HTTP_PROXY_MAX_HEAD || !__receive(fd, buffer)) return -1;
+  }
+}
+
+static bool __splice(int from, int to, uint64_t length, bool untilClose){
+  thread_local pipe_t channel;
+  if (channel.fd[0] < 0) channel.open();
+  if (channel.fd[0] < 0) return false;
+  while (untilClose || length > 0){
+    size_t step = ((untilClose || length > HTTP_PROXY_SPLICE_SIZE) ? HTTP_PROXY_SPLICE_SIZE : static_cast<size_t>(length));
+    ssize_t ret = splice(from, nullptr, channel.fd[1], nullptr, step, SPLICE_F_MOVE | SPLICE_F_MORE);
+    if (ret < 0 && errno == EINTR) continue;
+    if (ret == 0) return untilClose;
+    if (ret < 0) return false;
+    if (!untilClose) length -= static_cast<uint64_t>(ret);
+    size_t pending = static_cast<size_t>(ret);
+    while (pending > 0){
+      ssize_t moved = splice(channel.fd[0], nullptr, to, nullptr, pending, SPLICE_F_MOVE | SPLICE_F_MORE);
+      if (moved < 0 && errno == EINTR) continue;
+      if (moved <= 0){
+        /* the pipe still holds data of this stream, it can not be reused */
+        channel.close();
+        return false;
+      }
+      pending -= static_cast<size_t>(moved);
+    }
+  }
+  return true;
+}
+
+static bool __relayChunked(int from, int to, std::string &buffer){
+  for (;;){
+    size_t eol;
+    while ((eol = buffer.find("\r\n")) == std::string::npos){
+      if (buffer.length() >= HTTP_PROXY_MAX_HEAD || !__receive(from, buffer)) return false;
+    }
+    std::string line = buffer.substr(0, eol);
+    size_t extension = line.find(';');
+    if (extension != std::string::npos) line.erase(extension);
+    line = __trim(line);
+    if (line.empty() || line.length() > 15 || line.find_first_not_of("0123456789abcdefABCDEF") != std::string::npos) return false;
+    uint64_t size = strtoull(line.c_str(), nullptr, 16);
+    if (size == 0){
+      /* the last chunk is followed by the trailer fields and an empty row */
+      size_t end;
+      while ((end = buffer.find("\r\n\r\n", eol)) == std::string::npos){
+        if (buffer.length() >= HTTP_PROXY_MAX_HEAD || !__receive(from, buffer)) return false;
+      }
+      end += 4;
+      if (!__sendAll(to, buffer.data(), end)) return false;
+      buffer.erase(0, end);
+      return true;
+    }
+    uint64_t data = eol + 2 + size;
+    if (buffer.length() < data){
+      if (!__sendAll(to, buffer.data(), buffer.length())) return false;
+      uint64_t rest = data - buffer.length();
+      buffer.clear();
+      if (!__splice(from, to, rest, false)) return false;
+      data = 0;
+    }
+    /* the chunk data must be followed by CRLF, anything else means the framing is lost */
+    while (buffer.length() < data + 2){
+      if (!__receive(from, buffer)) return false;
+    }
+    if (buffer.compare(static_cast<size_t>(data), 2, "\r\n") != 0) return false;
+    if (!__sendAll(to, buffer.data(), static_cast<size_t>(data + 2))) return false;
+    buffer.erase(0, static_cast<size_t>(data + 2));
+  }
+}
+
+/**
+ * @brief Default constructor for empty upstream list.
+ */
+HTTPProxy::HTTPProxy(){}
+
+/**
+ * @brief Destructor.
+ *
+ * This method is responsible to close all idle upstream connections.
+ */
+HTTPProxy::~HTTPProxy(){
+  for (std::unique_ptr<HTTPProxy::upstream_t> &upstream : this->upstreams){
+    for (int fd : upstream->idle) close(fd);
+  }
+}
+
+int HTTPProxy::acquire(HTTPProxy::upstream_t &upstream, bool &reused){
+  for (;;){
+    int fd = -1;
+    {
+      std::lock_guard<std::mutex> guard(upstream.lock);
+      if (upstream.idle.empty()) break;
+      fd = upstream.idle.back();
+      upstream.idle.pop_back();
+    }
+    /* an idle connection must have nothing to read, otherwise it is closed by the upstream */
+    char probe;
+    ssize_t ret = recv(fd, &probe, 1, MSG_PEEK | MSG_DONTWAIT);
+    if (ret < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)){
+      reused = true;
+      return fd;
+    }
+    close(fd);
+  }
+  reused = false;
+  int fd = socket(upstream.address.ss_family, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (fd < 0) return -1;
+  if (upstream.timeout > 0){
+    /* the send timeout also limits connect */
+    struct timeval timeout;
+    timeout.tv_sec = static_cast<time_t>(upstream.timeout / 1000);
+    timeout.tv_usec = static_cast<suseconds_t>((upstream.timeout % 1000) * 1000);
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+  }
+  if (connect(fd, reinterpret_cast<const struct sockaddr *>(&upstream.address), upstream.addressLength) != 0){
+    close(fd);
+    return -1;
+  }
+  int enable = 1;
+  setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+  return fd;
+}
+
+void HTTPProxy::release(HTTPProxy::upstream_t &upstream, int fd){
+  {
+    std::lock_guard<std::mutex> guard(upstream.lock);
+    if (upstream.idle.size() < upstream.maxIdle){
+      upstream.idle.push_back(fd);
+      return;
+    }
+  }
+  close(fd);
+}
+
+/**
+ * @brief Add one upstream.
+ *
+ * This method is responsible to resolve the upstream address once and create its connection pool.
+ * This method will throw an error if the address can not be resolved.
+ *
+ * @param[in] host The upstream host name or address.
+ * @param[in] port The upstream port.
+ * @param[in] maxIdle The maximum number of idle keep-alive connections.
+ * @param[in] timeout The send and receive timeout of the upstream sockets in milliseconds (0 for none).
+ * @return The upstream index.
+ */
+size_t HTTPProxy::addUpstream(const std::string &host, uint16_t port, size_t maxIdle, uint32_t timeout){
+  struct addrinfo hints;
+  struct addrinfo *result = nullptr;
+  memset(&hints, 0, sizeof(hints));
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  if (getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &result) != 0 || result == nullptr){
+    throw std::runtime_error(std::string(__func__) + ": failed to resolve the upstream address");
+  }
+  std::unique_ptr<HTTPProxy::upstream_t> upstream(new HTTPProxy::upstream_t());
+  memcpy(&upstream->address, result->ai_addr, result->ai_addrlen);
+  upstream->addressLength = result->ai_addrlen;
+  upstream->maxIdle = maxIdle;
+  upstream->timeout = timeout;
+  freeaddrinfo(result);
+  this->upstreams.push_back(std::move(upstream));
+  return this->upstreams.size() - 1;
+}
+
+/**
+ * @brief Forward one request.
+ *
+ * This method is responsible to rewrite the request, write it and its body (`Content-Length`) to the upstream
+ * and relay the response (interim responses, head and body) to the client. The upstream connection returns
+ * to the pool if the response allows it. A stale pooled connection is replaced once if the method is idempotent.
+ *
+ * @param[in] client The client socket.
+ * @param[in] request The parsed request header (it is rewritten in place).
+ * @param[in] upstream The upstream index.
+ * @param[in] clientAddress The client address for `X-Forwarded-For` and `X-Real-IP`.
+ * @param[in] secure `true` if the client connection uses TLS.
+ * @param[in] body The part of the request body which is already received with the head.
+ * @param[in] bodyLength The length of the received part of the request body.
+ * @return `HTTPProxy::COMPLETE` if the response is relayed and the client connection may be kept.
+ * @return `HTTPProxy::CLOSE` if the response ends with the upstream connection or the relay failed after the
+ * response head is written (the client connection must be closed).
+ * @return `HTTPProxy::BAD_GATEWAY` if nothing is written to the client (the caller should respond with 502).
+ * @return `HTTPProxy::BAD_REQUEST` if the request has differing `Content-Length` values, a control byte in a
+ * value or a `Connection` field which lists a framing field (the caller should respond with 400).
+ */
+HTTPProxy::result_t HTTPProxy::forward(int client, HTTPHeader &request, size_t upstream, const std::string &clientAddress, bool secure, const char *body, size_t bodyLength){
+  if (upstream >= this->upstreams.size()) return HTTPProxy::BAD_GATEWAY;
+  HTTPProxy::upstream_t &target = *this->upstreams[upstream];
+
+  /* the request body is relayed by length only, a chunked request body is not supported */
+  if (request.getNode(HeaderNode::TRANSFER_ENCODING) != nullptr) return HTTPProxy::BAD_GATEWAY;
+  uint64_t contentLength = 0;
+  if (!__acceptable(request, contentLength)) return HTTPProxy::BAD_REQUEST;
+  bool head = (request.getMethod() == "HEAD");
+  bool idempotent = __idempotent(request.getMethod());
+
+  if (!HTTPProxy::rewrite(request, clientAddress, secure)) return HTTPProxy::BAD_REQUEST;
+  std::string payload;
+  request.serialize(payload);
+  payload.append("\r\n");
+  size_t received = (bodyLength < contentLength ? bodyLength : static_cast<size_t>(contentLength));
+  if (received > 0) payload.append(body, received);
+  uint64_t rest = contentLength - received;
+
+  for (int attempt = 0; attempt < 2; attempt++){
+    bool reused = false;
+    int fd = this->acquire(target, reused);
+    if (fd < 0) return HTTPProxy::BAD_GATEWAY;
+    /* a stale pooled connection is retried as long as the client body is not consumed and a replay is safe */
+    bool retry = (reused && attempt == 0 && rest == 0 && idempotent);
+    if (!__sendAll(fd, payload.data(), payload.length())){
+      close(fd);
+      if (retry) continue;
+      return HTTPProxy::BAD_GATEWAY;
+    }
+    if (rest > 0 && !__splice(client, fd, rest, false)){
+      close(fd);
+      return HTTPProxy::CLOSE;
+    }
+
+    std::string buffer;
+    HTTPHeader response;
+    ssize_t headLength = __readHead(fd, buffer, response);
+    if (headLength < 0){
+      close(fd);
+      if (retry && buffer.empty()) continue;
+      return (rest > 0 ? HTTPProxy::CLOSE : HTTPProxy::BAD_GATEWAY);
+    }
+    int code = static_cast<int>(response.getHTTPStatusCode());
+    while (code >= 100 && code < 200){
+      /* interim responses are relayed as they are, the final response follows */
+      if (!__sendAll(client, buffer.data(), static_cast<size_t>(headLength))){
+        close(fd);
+        return HTTPProxy::CLOSE;
+      }
+      buffer.erase(0, static_cast<size_t>(headLength));
+      response = HTTPHeader();
+      headLength = __readHead(fd, buffer, response);
+      if (headLength < 0){
+        close(fd);
+        return HTTPProxy::CLOSE;
+      }
+      code = static_cast<int>(response.getHTTPStatusCode());
+    }
+    buffer.erase(0, static_cast<size_t>(headLength));
+
+    bool reusable = (response.getVersion() == "1.1" ?
+      !__hasToken(response, HeaderNode::CONNECTION, "close") :
+      __hasToken(response, HeaderNode::CONNECTION, "keep-alive"));
+    framing_t framing = UNTIL_CLOSE;
+    uint64_t responseLength = 0;
+    HeaderNode *responseEncoding = response.getNode(HeaderNode::TRANSFER_ENCODING);
+    if (head || code == 204 || code == 304){
+      framing = NONE;
+    }
+    else if (responseEncoding != nullptr){
+      std::vector<std::string> codings = __tokens(responseEncoding->getValue());
+      if (!codings.empty() && strcasecmp(codings.back().c_str(), "chunked") == 0) framing = CHUNKED;
+    }
+    else if (response.getNode(HeaderNode::CONTENT_LENGTH) != nullptr){
+      if (!__number(response.getNode(HeaderNode::CONTENT_LENGTH)->getValue(), responseLength)){
+        close(fd);
+        return HTTPProxy::BAD_GATEWAY;
+      }
+      framing = LENGTH;
+    }
+
+    if (!HTTPProxy::strip(response)){
+      close(fd);
+      return HTTPProxy::BAD_GATEWAY;
+    }
+    std::string out;
+    response.serialize(out);
+    out.append("\r\n");
+    if (!__sendAll(client, out.data(), out.length())){
+      close(fd);
+      return HTTPProxy::CLOSE;
+    }
+
+    bool success = true;
+    switch (framing){
+      case NONE:
+        break;
+      case LENGTH: {
+        size_t buffered = (buffer.length() < responseLength ? buffer.length() : static_cast<size_t>(responseLength));
+        success = __sendAll(client, buffer.data(), buffered);
+        buffer.erase(0, buffered);
+        if (success && responseLength > buffered) success = __splice(fd, client, responseLength - buffered, false);
+        break;
+      }
+      case CHUNKED:
+        success = __relayChunked(fd, client, buffer);
+        break;
+      case UNTIL_CLOSE:
+        reusable = false;
+        success = (__sendAll(client, buffer.data(), buffer.length()) && __splice(fd, client, 0, true));
+        break;
+    }
+    /* data after the response means the upstream framing is broken */
+    if (!success || !buffer.empty()) reusable = false;
+    if (reusable) this->release(target, fd);
+    else close(fd);
+    return ((success && framing != UNTIL_CLOSE) ? HTTPProxy::COMPLETE : HTTPProxy::CLOSE);
+  }
+  return HTTPProxy::BAD_GATEWAY;
+}
+
+/**
+ * @brief Rewrite the request for the upstream.
+ *
+ * This method is responsible to remove the hop-by-hop fields, append the client address to `X-Forwarded-For`
+ * and set `X-Forwarded-Proto` and `X-Real-IP`.
+ *
+ * @param[in] request The request header.
+ * @param[in] clientAddress The client address.
+ * @param[in] secure `true` if the client connection uses TLS.
+ * @return `false` if the hop-by-hop fields can not be removed (see `strip`).
+ */
+bool HTTPProxy::rewrite(HTTPHeader &request, const std::string &clientAddress, bool secure){
+  if (!HTTPProxy::strip(request)) return false;
+  std::string chain;
+  for (HeaderNode *current = request.node; current != nullptr; current = current->next){
+    if (current->getField() != HeaderNode::X_FORWARDED_FOR) continue;
+    chain.append(current->getValue());
+    chain.append(", ");
+  }
+  chain.append(clientAddress);
+  request.remove(HeaderNode::X_FORWARDED_FOR);
+  request.remove(HeaderNode::X_FORWARDED_PROTO);
+  request.remove(HeaderNode::X_REAL_IP);
+  request.append(HeaderNode::X_FORWARDED_FOR, std::move(chain));
+  request.append(HeaderNode::X_FORWARDED_PROTO, (secure ? "https" : "http"));
+  request.append(HeaderNode::X_REAL_IP, clientAddress);
+  return true;
+}
+
+/**
+ * @brief Remove the hop-by-hop fields.
+ *
+ * This method is responsible to remove `Connection`, every field listed by `Connection`, `Keep-Alive`,
+ * `Proxy-Authenticate`, `Proxy-Authorization`, `TE`, `Trailer` and `Upgrade`. `Transfer-Encoding` is kept
+ * because the body is relayed with its original framing. The header is left as it is if `Connection` lists
+ * `Content-Length`, `Transfer-Encoding` or `Host`, removing them would change how the message is framed or
+ * routed by the next hop.
+ *
+ * @param[in] header The header.
+ * @return `true` on success.
+ * @return `false` if `Connection` lists `Content-Length`, `Transfer-Encoding` or `Host`.
+ */
+bool HTTPProxy::strip(HTTPHeader &header){
+  std::vector<std::string> listed;
+  for (HeaderNode *current = header.node; current != nullptr; current = current->next){
+    if (current->getField() != HeaderNode::CONNECTION) continue;
+    for (std::string &token : __tokens(current->getValue())){
+      HeaderNode::headerField_t field = HeaderTable::find(token);
+      if (field == HeaderNode::CONTENT_LENGTH || field == HeaderNode::TRANSFER_ENCODING || field == HeaderNode::HOST) return false;
+      if (field != HeaderNode::CONNECTION) listed.push_back(std::move(token));
+    }
+  }
+  /* the listed names are usually not in the HeaderTable, they are removed by name */
+  for (const std::string &token : listed) header.remove(std::string_view(token));
+  header.remove(HeaderNode::CONNECTION);
+  header.remove(HeaderNode::PROXY_AUTHENTICATE);
+  header.remove(HeaderNode::PROXY_AUTHORIZATION);
+  header.remove(HeaderNode::TE);
+  header.remove(HeaderNode::KEEP_ALIVE);
+  header.remove(HeaderNode::TRAILER);
+  header.remove(HeaderNode::UPGRADE);
+  return true;
+}
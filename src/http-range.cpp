@@ -0,0 +1,425 @@
+/*
+ * $Id: http-range.cpp,v 1.0.0 2026/10/18 15:02:13 Jaya Wikrama Exp $
+ *
+ * Copyright (c) 2024 Jaya Wikrama
+ * jayawikrama89@gmail.com
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *  claim that you wrote the original software. If you use this software
+ *  in a product, an acknowledgment in the product documentation would be
+ *  appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *  misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <strings.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/sendfile.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include "http-range.hpp"
+
+#define MAX_IOV 64
+#define MAX_SENDFILE 0x7ffff000
+
+static std::string __formatDate(long epoch){
+  char buffer[40];
+  struct tm date;
+  time_t value = static_cast<time_t>(epoch);
+  gmtime_r(&value, &date);
+  strftime(buffer, sizeof(buffer), "%a, %d %b %Y %H:%M:%S GMT", &date);
+  return std::string(buffer);
+}
+
+static std::string __boundary(){
+  static std::atomic<uint64_t> counter(0);
+  struct timespec ts;
+  clock_gettime(CLOCK_REALTIME, &ts);
+  char buffer[40];
+  snprintf(buffer, sizeof(buffer), "cwl%016llx%08llx",
+    static_cast<unsigned long long>(ts.tv_sec) * 1000000000ULL + static_cast<unsigned long long>(ts.tv_nsec),
+    static_cast<unsigned long long>(counter.fetch_add(1, std::memory_order_relaxed)));
+  return std::string(buffer);
+}
+
+static std::string __trim(const std::string &text){
+  size_t first = text.find_first_not_of(" \t");
+  if (first == std::string::npos) return std::string();
+  size_t last = text.find_last_not_of(" \t");
+  return text.substr(first, last - first + 1);
+}
+
+/* digits only, `false` on empty value or overflow */
+static bool __number(const std::string &text, uint64_t &number){
+  number = 0;
+  if (text.empty()) return false;
+  for (char c : text){
+    if (c < '0' || c > '9') return false;
+    if (number > (UINT64_MAX - 9) / 10) return false;
+    number = number * 10 + static_cast<uint64_t>(c - '0');
+  }
+  return true;
+}
+
+/* the ranges are sorted and the overlapping or adjacent ones are merged */
+static void __coalesce(std::vector<HTTPRange::range_t> &ranges){
+  if (ranges.size() < 2) return;
+  std::sort(ranges.begin(), ranges.end(), [](const HTTPRange::range_t &a, const HTTPRange::range_t &b){ return a.first < b.first; });
+  size_t count = 0;
+  for (size_t i = 1; i < ranges.size(); i++){
+    HTTPRange::range_t &merged = ranges[count];
+    if (ranges[i].first <= merged.last || ranges[i].first - merged.last == 1){
+      if (ranges[i].last > merged.last) merged.last = ranges[i].last;
+      continue;
+    }
+    ranges[++count] = ranges[i];
+  }
+  ranges.resize(count + 1);
+}
+
+/* If-Range holds either a strong entity tag or the exact Last-Modified date (RFC 9110 section 13.1.5) */
+static bool __ifRange(const HTTPHeader &request, const std::string &etag, long lastModified){
+  HeaderNode *node = request.getNode(HeaderNode::IF_RANGE);
+  if (node == nullptr) return true;
+  std::string value = node->getValue();
+  if (value.empty()) return false;
+  if (value[0] == '"') return (!etag.empty() && etag[0] == '"' && value == etag);
+  if (value.compare(0, 2, "W/") == 0) return false;
+  long date = convertToUnixEpoch(value);
+  return (date >= 0 && lastModified >= 0 && date == lastModified);
+}
+
+/**
+ * @brief Default constructor for empty source.
+ */
+HTTPRange::HTTPRange(){
+  this->fd = -1;
+  this->mapping = nullptr;
+  this->size = 0;
+  this->lastModified = -1;
+  this->current = 0;
+  this->written = 0;
+}
+
+/**
+ * @brief Destructor.
+ *
+ * This method is responsible to close and unmap the file.
+ */
+HTTPRange::~HTTPRange(){
+  this->release();
+}
+
+void HTTPRange::release(){
+  if (this->mapping != nullptr) munmap(this->mapping, this->size);
+  if (this->fd >= 0) close(this->fd);
+  this->fd = -1;
+  this->mapping = nullptr;
+  this->size = 0;
+  this->lastModified = -1;
+  this->etag.clear();
+  this->body.reset();
+  this->head.clear();
+  this->parts.clear();
+  this->segments.clear();
+  this->current = 0;
+  this->written = 0;
+}
+
+/* the file is mapped only when a multipart response needs the slices */
+const char *HTTPRange::getData(){
+  if (this->body) return this->body->data();
+  if (this->fd < 0 || this->size == 0) return nullptr;
+  if (this->mapping == nullptr){
+    void *mapping = mmap(nullptr, this->size, PROT_READ, MAP_SHARED, this->fd, 0);
+    if (mapping == MAP_FAILED) return nullptr;
+    this->mapping = mapping;
+  }
+  return static_cast<const char *>(this->mapping);
+}
+
+/**
+ * @brief Use the file as source.
+ *
+ * This method is responsible to open the file and create the validators (`ETag` from the size and the
+ * modification time, `Last-Modified` from the modification time).
+ *
+ * @param[in] path The file path.
+ * @return `true` in success.
+ * @return `false` if the file is not a readable regular file.
+ */
+bool HTTPRange::open(const std::string &path){
+  this->release();
+  int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) return false;
+  struct stat info;
+  if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)){
+    close(fd);
+    return false;
+  }
+  char etag[64];
+  snprintf(etag, sizeof(etag), "\"%llx-%llx\"", static_cast<unsigned long long>(info.st_mtime), static_cast<unsigned long long>(info.st_size));
+  this->fd = fd;
+  this->size = static_cast<uint64_t>(info.st_size);
+  this->lastModified = static_cast<long>(info.st_mtime);
+  this->etag = etag;
+  return true;
+}
+
+/**
+ * @brief Use the cached body as source.
+ *
+ * @param[in] body The body (shared with the cache).
+ * @param[in] etag The entity tag (including the quotes) or empty string.
+ * @param[in] lastModified The modification time (Unix epoch) or `-1`.
+ */
+void HTTPRange::assign(std::shared_ptr<const std::string> body, const std::string &etag, long lastModified){
+  this->release();
+  this->body = std::move(body);
+  this->size = (this->body ? this->body->length() : 0);
+  this->etag = etag;
+  this->lastModified = lastModified;
+}
+
+/**
+ * @brief Prepare the response of the request.
+ *
+ * This method is responsible to evaluate the `Range` and `If-Range` of the request, complete the response
+ * header and plan the body. The response header may contain the `Content-Type` of the source. An invalid
+ * `Range`, a failed `If-Range`, more than `HTTP_RANGE_MAX` ranges or a request other than `GET` gets the
+ * full source. Overlapping and adjacent ranges are coalesced (RFC 9110 section 15.3.7.2), so no byte of the
+ * source is sent twice.
+ *
+ * @param[in] request The request header.
+ * @param[in] response The response header.
+ * @return `HttpStatus::OK`, `HttpStatus::PARTIAL_CONTENT` or `HttpStatus::RANGE_NOT_SATISFIABLE`.
+ */
+HttpStatus::Code_t HTTPRange::prepare(const HTTPHeader &request, HTTPHeader &response){
+  this->head.clear();
+  this->parts.clear();
+  this->segments.clear();
+  this->current = 0;
+  this->written = 0;
+
+  response.remove(HeaderNode::ACCEPT_RANGES);
+  response.remove(HeaderNode::CONTENT_RANGE);
+  response.remove(HeaderNode::CONTENT_LENGTH);
+  response.append(HeaderNode::ACCEPT_RANGES, "bytes");
+  if (!this->etag.empty() && response.getNode(HeaderNode::ETAG) == nullptr) response.append(HeaderNode::ETAG, this->etag);
+  if (this->lastModified >= 0 && response.getNode(HeaderNode::LAST_MODIFIED) == nullptr){
+    response.append(HeaderNode::LAST_MODIFIED, __formatDate(this->lastModified));
+  }
+
+  std::vector<HTTPRange::range_t> ranges;
+  HTTPRange::status_t status = HTTPRange::INVALID;
+  HeaderNode *range = request.getNode(HeaderNode::RANGE);
+  if (range != nullptr && request.getMethod() == "GET" && __ifRange(request, this->etag, this->lastModified)){
+    status = HTTPRange::parse(range->getValue(), this->size, ranges);
+  }
+  if (status == HTTPRange::SATISFIABLE && ranges.size() > HTTP_RANGE_MAX) status = HTTPRange::INVALID;
+  if (status == HTTPRange::SATISFIABLE) __coalesce(ranges);
+  if (status == HTTPRange::SATISFIABLE && ranges.size() > 1 && this->getData() == nullptr) status = HTTPRange::INVALID;
+
+  HttpStatus::Code_t code = HttpStatus::OK;
+  uint64_t length = 0;
+  if (status == HTTPRange::UNSATISFIABLE){
+    code = HttpStatus::RANGE_NOT_SATISFIABLE;
+    response.append(HeaderNode::CONTENT_RANGE, "bytes */" + std::to_string(this->size));
+    ranges.clear();
+  }
+  else if (status == HTTPRange::SATISFIABLE && ranges.size() == 1){
+    code = HttpStatus::PARTIAL_CONTENT;
+    length = ranges[0].last - ranges[0].first + 1;
+    response.append(HeaderNode::CONTENT_RANGE, "bytes " + std::to_string(ranges[0].first) + "-" + std::to_string(ranges[0].last) + "/" + std::to_string(this->size));
+  }
+  else if (status == HTTPRange::SATISFIABLE){
+    code = HttpStatus::PARTIAL_CONTENT;
+    std::string boundary = __boundary();
+    HeaderNode *type = response.getNode(HeaderNode::CONTENT_TYPE);
+    std::string contentType = (type == nullptr ? std::string() : type->getValue());
+    response.remove(HeaderNode::CONTENT_TYPE);
+    response.append(HeaderNode::CONTENT_TYPE, "multipart/byteranges; boundary=" + boundary);
+    for (const HTTPRange::range_t &item : ranges){
+      std::string part = "\r\n--" + boundary + "\r\n";
+      if (!contentType.empty()) part += std::string(fieldName[HeaderNode::CONTENT_TYPE]) + ": " + contentType + "\r\n";
+      part += std::string(fieldName[HeaderNode::CONTENT_RANGE]) + ": bytes " + std::to_string(item.first) + "-" + std::to_string(item.last) + "/" + std::to_string(this->size) + "\r\n\r\n";
+      length += part.length() + (item.last - item.first + 1);
+      this->parts.push_back(std::move(part));
+    }
+    this->parts.push_back("\r\n--" + boundary + "--\r\n");
+    length += this->parts.back().length();
+  }
+  else {
+    length = this->size;
+    ranges.clear();
+    if (this->size > 0) ranges.push_back(HTTPRange::range_t{ 0, this->size - 1 });
+  }
+  response.append(HeaderNode::CONTENT_LENGTH, std::to_string(length));
+  response.setHTTPStatusCode(code);
+  this->head = response.getPayload();
+
+  /* the segments refer to head and parts, both are complete before the first segment is created */
+  this->segments.push_back(HTTPRange::segment_t{ this->head.data(), 0, this->head.length() });
+  if (request.getMethod() == "HEAD") return code;
+  bool multipart = (this->parts.size() > 0);
+  for (size_t i = 0; i < ranges.size(); i++){
+    if (multipart) this->segments.push_back(HTTPRange::segment_t{ this->parts[i].data(), 0, this->parts[i].length() });
+    uint64_t count = ranges[i].last - ranges[i].first + 1;
+    if (this->body || multipart){
+      this->segments.push_back(HTTPRange::segment_t{ this->getData() + ranges[i].first, 0, count });
+    }
+    else {
+      this->segments.push_back(HTTPRange::segment_t{ nullptr, ranges[i].first, count });
+    }
+  }
+  if (multipart) this->segments.push_back(HTTPRange::segment_t{ this->parts.back().data(), 0, this->parts.back().length() });
+  return code;
+}
+
+/**
+ * @brief Send the prepared response.
+ *
+ * This method is responsible to write the prepared head and body. On non-blocking socket, the method returns
+ * when the socket buffer is full and continues from the same position in the next call.
+ *
+ * @param[in] fd The socket file descriptor.
+ * @return The number of bytes written in this call.
+ * @return `-1` on fail (see `errno`).
+ */
+ssize_t HTTPRange::send(int fd){
+  struct iovec iov[MAX_IOV];
+  ssize_t total = 0;
+  while (this->current < this->segments.size()){
+    const HTTPRange::segment_t &segment = this->segments[this->current];
+    ssize_t ret = 0;
+    if (segment.data == nullptr){
+      off_t offset = static_cast<off_t>(segment.offset + this->written);
+      uint64_t count = segment.length - this->written;
+      ret = sendfile(fd, this->fd, &offset, (count > MAX_SENDFILE ? MAX_SENDFILE : count));
+      if (ret == 0){
+        /* the file is truncated after it is opened */
+        errno = EIO;
+        return -1;
+      }
+    }
+    else {
+      int count = 0;
+      for (size_t i = this->current; i < this->segments.size() && count < MAX_IOV && this->segments[i].data != nullptr; i++){
+        uint64_t skip = (i == this->current ? this->written : 0);
+        iov[count].iov_base = const_cast<char *>(this->segments[i].data + skip);
+        iov[count].iov_len = this->segments[i].length - skip;
+        count++;
+      }
+      ret = writev(fd, iov, count);
+    }
+    if (ret < 0){
+      if (errno == EINTR) continue;
+      if (errno == EAGAIN || errno == EWOULDBLOCK) return total;
+      return -1;
+    }
+    total += ret;
+    uint64_t progress = this->written + static_cast<uint64_t>(ret);
+    while (this->current < this->segments.size() && progress >= this->segments[this->current].length){
+      progress -= this->segments[this->current].length;
+      this->current++;
+    }
+    this->written = progress;
+  }
+  return total;
+}
+
+/**
+ * @brief Check the prepared response.
+ *
+ * @return `true` if the whole prepared response is written.
+ * @return `false` if some data is not written yet.
+ */
+bool HTTPRange::isComplete() const {
+  return (this->current >= this->segments.size());
+}
+
+/**
+ * @brief Gets the source size.
+ *
+ * @return The number of bytes of the source.
+ */
+uint64_t HTTPRange::getSize() const {
+  return this->size;
+}
+
+/**
+ * @brief Gets the source entity tag.
+ *
+ * @return The entity tag (including the quotes).
+ */
+const std::string &HTTPRange::getETag() const {
+  return this->etag;
+}
+
+/**
+ * @brief Parse the `Range` value.
+ *
+ * This method is responsible to parse the byte ranges (`bytes=0-499`, `bytes=500-`, `bytes=-500` and the comma
+ * separated lists of them) of the source size. The ranges are clipped to the source.
+ *
+ * @param[in] value The `Range` value.
+ * @param[in] size The source size.
+ * @param[out] ranges The satisfiable ranges (inclusive).
+ * @return `HTTPRange::SATISFIABLE` if at least one range is satisfiable.
+ * @return `HTTPRange::UNSATISFIABLE` if no range is satisfiable.
+ * @return `HTTPRange::INVALID` if the value is malformed (the `Range` must be ignored).
+ */
+HTTPRange::status_t HTTPRange::parse(const std::string &value, uint64_t size, std::vector<HTTPRange::range_t> &ranges){
+  ranges.clear();
+  std::string spec = __trim(value);
+  if (spec.length() < 6 || strncasecmp(spec.c_str(), "bytes=", 6) != 0) return HTTPRange::INVALID;
+  size_t pos = 6;
+  size_t count = 0;
+  while (pos <= spec.length()){
+    size_t comma = spec.find(',', pos);
+    if (comma == std::string::npos) comma = spec.length();
+    std::string item = __trim(spec.substr(pos, comma - pos));
+    pos = comma + 1;
+    if (item.empty()) continue;
+    count++;
+    size_t dash = item.find('-');
+    if (dash == std::string::npos) return HTTPRange::INVALID;
+    uint64_t first = 0;
+    uint64_t last = 0;
+    if (dash == 0){
+      /* suffix range, the last bytes of the source */
+      if (!__number(item.substr(1), last)) return HTTPRange::INVALID;
+      if (last == 0 || size == 0) continue;
+      ranges.push_back(HTTPRange::range_t{ (last >= size ? 0 : size - last), size - 1 });
+      continue;
+    }
+    if (!__number(item.substr(0, dash), first)) return HTTPRange::INVALID;
+    if (dash + 1 < item.length()){
+      if (!__number(item.substr(dash + 1), last) || last < first) return HTTPRange::INVALID;
+    }
+    else {
+      last = UINT64_MAX;
+    }
+    if (first >= size) continue;
+    ranges.push_back(HTTPRange::range_t{ first, (last >= size ? size - 1 : last) });
+  }
+  if (count == 0) return HTTPRange::INVALID;
+  return (ranges.empty() ? HTTPRange::UNSATISFIABLE : HTTPRange::SATISFIABLE);
+}
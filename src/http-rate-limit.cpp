@@ -0,0 +1,394 @@
+/*
+ * $Id: http-rate-limit.cpp,v 1.0.0 2026/10/18 17:06:12 Jaya Wikrama Exp $
+ *
+ * Copyright (c) 2024 Jaya Wikrama
+ * jayawikrama89@gmail.com
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *  claim that you wrote the original software. If you use this software
+ *  in a product, an acknowledgment in the product documentation would be
+ *  appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *  misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include <cstring>
+#include <ctime>
+#include <stdexcept>
+#include <cerrno>
+#include <arpa/inet.h>
+#include <sys/random.h>
+#include <sys/socket.h>
+#include "http-rate-limit.hpp"
+#include "http-static-response.hpp"
+
+#define HTTP_RATE_LIMIT_TIME_MASK 0x0000FFFFFFFFFFFFULL
+
+typedef HTTPStaticResponse<192> rejection_t;
+
+static constexpr rejection_t __rejection(uint32_t seconds){
+  char value[4] = {};
+  int count = 0;
+  if (seconds >= 10) value[count++] = static_cast<char>('0' + seconds / 10);
+  value[count++] = static_cast<char>('0' + seconds % 10);
+  return rejection_t::buildWithBody(
+    HttpStatus::TOO_MANY_REQUESTS, "Too Many Requests\n",
+    HeaderNode::RETRY_AFTER, static_cast<const char *>(value),
+    HeaderNode::CONTENT_TYPE, "text/plain"
+  );
+}
+
+typedef struct _rejections_t {
+  rejection_t response[HTTP_RATE_LIMIT_MAX_RETRY + 1];
+
+  constexpr _rejections_t() : response{} {
+    for (uint32_t i = 1; i <= HTTP_RATE_LIMIT_MAX_RETRY; i++) this->response[i] = __rejection(i);
+  }
+} rejections_t;
+
+static_assert(HTTP_RATE_LIMIT_MAX_RETRY < 100, "HTTPRateLimiter: Retry-After must have at most two digits");
+static constexpr rejections_t __rejections;
+
+static uint64_t __now(){
+  /* microseconds, the coarse clock is enough for the bucket refill and it is the cheapest one */
+  static const uint64_t start = [](){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000ULL + static_cast<uint64_t>(ts.tv_nsec / 1000);
+  }();
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+  /* the bucket time starts above zero, so the empty slots are always idle */
+  return static_cast<uint64_t>(ts.tv_sec) * 1000000ULL + static_cast<uint64_t>(ts.tv_nsec / 1000) - start + 1000000ULL;
+}
+
+/* SipHash-2-4, the message is fed in parts so the namespace prefix and the key are hashed without a copy */
+typedef struct _siphash_t {
+  uint64_t v[4];
+  uint64_t pending;
+  size_t length;
+
+  explicit _siphash_t(const uint64_t key[2]) : pending(0), length(0) {
+    this->v[0] = key[0] ^ 0x736F6D6570736575ULL;
+    this->v[1] = key[1] ^ 0x646F72616E646F6DULL;
+    this->v[2] = key[0] ^ 0x6C7967656E657261ULL;
+    this->v[3] = key[1] ^ 0x7465646279746573ULL;
+  }
+
+  static uint64_t rotate(uint64_t value, int bits){
+    return (value << bits) | (value >> (64 - bits));
+  }
+
+  void round(){
+    this->v[0] += this->v[1]; this->v[1] = rotate(this->v[1], 13); this->v[1] ^= this->v[0]; this->v[0] = rotate(this->v[0], 32);
+    this->v[2] += this->v[3]; this->v[3] = rotate(this->v[3], 16); this->v[3] ^= this->v[2];
+    this->v[0] += this->v[3]; this->v[3] = rotate(this->v[3], 21); this->v[3] ^= this->v[0];
+    this->v[2] += this->v[1]; this->v[1] = rotate(this->v[1], 17); this->v[1] ^= this->v[2]; this->v[2] = rotate(this->v[2], 32);
+  }
+
+  void compress(uint64_t word){
+    this->v[3] ^= word;
+    this->round();
+    this->round();
+    this->v[0] ^= word;
+  }
+
+  void update(std::string_view data){
+    for (unsigned char c : data){
+      this->pending |= static_cast<uint64_t>(c) << (8 * (this->length % 8));
+      if (++this->length % 8 == 0){
+        this->compress(this->pending);
+        this->pending = 0;
+      }
+    }
+  }
+
+  uint64_t finish(){
+    this->compress(this->pending | (static_cast<uint64_t>(this->length & 0xFF) << 56));
+    this->v[2] ^= 0xFF;
+    for (int i = 0; i < 4; i++) this->round();
+    return this->v[0] ^ this->v[1] ^ this->v[2] ^ this->v[3];
+  }
+} siphash_t;
+
+static const uint64_t *__secret(){
+  static const struct _secret_t {
+    uint64_t key[2];
+
+    _secret_t() : key{ 0, 0 } {
+      size_t filled = 0;
+      while (filled < sizeof(this->key)){
+        ssize_t ret = getrandom(reinterpret_cast<uint8_t *>(this->key) + filled, sizeof(this->key) - filled, 0);
+        if (ret < 0){
+          if (errno == EINTR) continue;
+          break;
+        }
+        filled += static_cast<size_t>(ret);
+      }
+    }
+  } secret;
+  return secret.key;
+}
+
+static uint64_t __hash(std::string_view prefix, std::string_view key){
+  siphash_t hash(__secret());
+  hash.update(prefix);
+  hash.update(key);
+  return hash.finish();
+}
+
+static bool __parseAddress(std::string_view text, int &family, uint8_t address[16]){
+  char buffer[INET6_ADDRSTRLEN];
+  memset(address, 0, 16);
+  if (text.length() >= sizeof(buffer)) return false;
+  memcpy(buffer, text.data(), text.length());
+  buffer[text.length()] = '\0';
+  if (inet_pton(AF_INET, buffer, address) == 1){
+    family = AF_INET;
+    return true;
+  }
+  if (inet_pton(AF_INET6, buffer, address) == 1){
+    family = AF_INET6;
+    return true;
+  }
+  return false;
+}
+
+static std::string_view __trim(std::string_view text){
+  size_t first = text.find_first_not_of(" \t");
+  if (first == std::string_view::npos) return std::string_view();
+  size_t last = text.find_last_not_of(" \t");
+  return text.substr(first, last - first + 1);
+}
+
+/**
+ * @brief Custom constructor.
+ *
+ * This method will throw an error if the rate is not positive or the burst is less than one request.
+ *
+ * @param[in] rate The sustained rate in requests per second.
+ * @param[in] burst The bucket size in requests.
+ * @param[in] capacity The number of buckets (rounded up to a power of two).
+ */
+HTTPRateLimiter::HTTPRateLimiter(double rate, double burst, size_t capacity){
+  if (!(rate > 0.0) || !(burst >= 1.0)){
+    throw std::runtime_error(std::string(__func__) + ": invalid rate or burst");
+  }
+  size_t count = 1;
+  while (count * HTTP_RATE_LIMIT_SHARD_SLOTS < capacity) count <<= 1;
+  this->shards.reset(new HTTPRateLimiter::shard_t[count]);
+  for (size_t i = 0; i < count; i++){
+    for (size_t j = 0; j < HTTP_RATE_LIMIT_SHARD_SLOTS; j++){
+      this->shards[i].slot[j].store(0, std::memory_order_relaxed);
+      this->shards[i].hash[j].store(0, std::memory_order_relaxed);
+    }
+  }
+  this->mask = count - 1;
+  this->interval = static_cast<uint64_t>(1000000.0 / rate);
+  if (this->interval == 0) this->interval = 1;
+  this->tolerance = static_cast<uint64_t>(static_cast<double>(this->interval) * (burst - 1.0));
+  this->keyField = HeaderNode::UNKNOWN;
+}
+
+/**
+ * @brief Add one trusted proxy.
+ *
+ * This method is responsible to add the address or the network (CIDR notation) of a proxy whose
+ * `X-Forwarded-For` and `X-Real-IP` are trusted. The proxies must be added before the limiter is shared
+ * between threads.
+ *
+ * @param[in] network The address (e.g. `10.0.0.1`) or the network (e.g. `10.0.0.0/8`, `fd00::/8`).
+ * @return `true` in success.
+ * @return `false` if the network is malformed.
+ */
+bool HTTPRateLimiter::addTrustedProxy(const std::string &network){
+  HTTPRateLimiter::network_t entry;
+  size_t slash = network.find('/');
+  if (!__parseAddress(network.substr(0, slash), entry.family, entry.address)) return false;
+  unsigned int bits = (entry.family == AF_INET ? 32 : 128);
+  entry.prefix = bits;
+  if (slash != std::string::npos){
+    std::string prefix = network.substr(slash + 1);
+    if (prefix.empty() || prefix.length() > 3 || prefix.find_first_not_of("0123456789") != std::string::npos) return false;
+    entry.prefix = static_cast<unsigned int>(std::stoul(prefix));
+    if (entry.prefix > bits) return false;
+  }
+  this->trusted.push_back(entry);
+  return true;
+}
+
+/**
+ * @brief Use the API key as the bucket key.
+ *
+ * This method is responsible to set the field which carries the API key (e.g. `Authorization` or an
+ * extension field). Requests without the field are keyed by the client address.
+ *
+ * @param[in] field The API key field or `HeaderNode::UNKNOWN` to key by the client address only.
+ */
+void HTTPRateLimiter::setKeyField(HeaderNode::headerField_t field){
+  this->keyField = field;
+}
+
+bool HTTPRateLimiter::isTrusted(std::string_view address) const {
+  if (this->trusted.empty()) return false;
+  int family;
+  uint8_t bytes[16];
+  if (!__parseAddress(address, family, bytes)) return false;
+  for (const HTTPRateLimiter::network_t &network : this->trusted){
+    if (network.family != family) continue;
+    unsigned int full = network.prefix / 8;
+    unsigned int rest = network.prefix % 8;
+    if (memcmp(network.address, bytes, full) != 0) continue;
+    if (rest > 0){
+      uint8_t mask = static_cast<uint8_t>(0xFF << (8 - rest));
+      if ((network.address[full] & mask) != (bytes[full] & mask)) continue;
+    }
+    return true;
+  }
+  return false;
+}
+
+/**
+ * @brief Gets the client address.
+ *
+ * This method is responsible to return the peer address, or, if the peer is a trusted proxy, the nearest
+ * untrusted address of `X-Forwarded-For` (or `X-Real-IP` if it is missing).
+ *
+ * @param[in] request The request header.
+ * @param[in] peerAddress The address of the connected peer.
+ * @return The client address.
+ */
+std::string HTTPRateLimiter::getClientAddress(const HTTPHeader &request, const std::string &peerAddress) const {
+  return std::string(this->findClientAddress(request, peerAddress));
+}
+
+std::string_view HTTPRateLimiter::findClientAddress(const HTTPHeader &request, std::string_view peerAddress) const {
+  if (!this->isTrusted(peerAddress)) return peerAddress;
+  /* the addresses appended by the trusted proxies are skipped from the right, so the last untrusted one wins */
+  std::string_view first;
+  std::string_view client;
+  for (HeaderNode *current = request.node; current != nullptr; current = current->next){
+    if (current->getField() != HeaderNode::X_FORWARDED_FOR) continue;
+    std::string_view value = current->getValueView();
+    size_t start = 0;
+    while (start <= value.length()){
+      size_t end = value.find(',', start);
+      if (end == std::string_view::npos) end = value.length();
+      std::string_view item = __trim(value.substr(start, end - start));
+      start = end + 1;
+      if (item.empty()) continue;
+      if (first.empty()) first = item;
+      if (!this->isTrusted(item)) client = item;
+    }
+  }
+  if (first.empty()){
+    HeaderNode *realIp = request.getNode(HeaderNode::X_REAL_IP);
+    std::string_view value = (realIp == nullptr ? std::string_view() : __trim(realIp->getValueView()));
+    return (value.empty() ? peerAddress : value);
+  }
+  return (client.empty() ? first : client);
+}
+
+/**
+ * @brief Take one token for the request.
+ *
+ * @param[in] request The request header.
+ * @param[in] peerAddress The address of the connected peer.
+ * @return `0` if the request is admitted.
+ * @return The number of seconds until the next token (for `Retry-After`) if the request is rejected.
+ */
+uint32_t HTTPRateLimiter::admit(const HTTPHeader &request, const std::string &peerAddress){
+  /* the API keys and the addresses are hashed in their own namespaces, the views are hashed without copies */
+  HeaderNode *key = (this->keyField == HeaderNode::UNKNOWN ? nullptr : request.getNode(this->keyField));
+  if (key != nullptr){
+    std::string_view value = key->getValueView();
+    if (!value.empty()) return this->take(__hash("k:", value));
+  }
+  return this->take(__hash("a:", this->findClientAddress(request, peerAddress)));
+}
+
+/**
+ * @brief Take one token of the key.
+ *
+ * @param[in] key The bucket key.
+ * @return `0` if the request is admitted.
+ * @return The number of seconds until the next token (for `Retry-After`) if the request is rejected.
+ */
+uint32_t HTTPRateLimiter::admit(std::string_view key){
+  return this->take(__hash(std::string_view(), key));
+}
+
+uint32_t HTTPRateLimiter::take(uint64_t hash){
+  uint64_t tag = hash >> 48;
+  HTTPRateLimiter::shard_t &shard = this->shards[hash & this->mask];
+  uint64_t now = __now();
+
+  size_t position = HTTP_RATE_LIMIT_SHARD_SLOTS;
+  size_t stalest = 0;
+  uint64_t current = 0;
+  uint64_t oldest = HTTP_RATE_LIMIT_TIME_MASK;
+  for (size_t i = 0; i < HTTP_RATE_LIMIT_SHARD_SLOTS; i++){
+    uint64_t value = shard.slot[i].load(std::memory_order_relaxed);
+    /* the short tag filters, the full hash decides */
+    if ((value >> 48) == tag && shard.hash[i].load(std::memory_order_relaxed) == hash){
+      position = i;
+      current = value;
+      break;
+    }
+    /* an idle bucket is full, taking it over is the same as starting a new bucket */
+    if (position == HTTP_RATE_LIMIT_SHARD_SLOTS && (value & HTTP_RATE_LIMIT_TIME_MASK) <= now){
+      position = i;
+      current = value;
+    }
+    if ((value & HTTP_RATE_LIMIT_TIME_MASK) < oldest){
+      stalest = i;
+      oldest = (value & HTTP_RATE_LIMIT_TIME_MASK);
+    }
+  }
+  if (position == HTTP_RATE_LIMIT_SHARD_SLOTS){
+    /* every bucket is busy, the one nearest to idle is evicted, its key starts with a full bucket when it returns */
+    position = stalest;
+    current = shard.slot[position].load(std::memory_order_relaxed);
+  }
+  std::atomic<uint64_t> *slot = &shard.slot[position];
+
+  for (;;){
+    /* a bucket of another key (idle, evicted or taken by a concurrent request) restarts as a full bucket */
+    bool owned = ((current >> 48) == tag && shard.hash[position].load(std::memory_order_relaxed) == hash);
+    uint64_t arrival = (current & HTTP_RATE_LIMIT_TIME_MASK);
+    if (!owned || arrival < now) arrival = now;
+    if (arrival - now > this->tolerance){
+      uint64_t wait = arrival - now - this->tolerance;
+      uint64_t seconds = (wait + 999999ULL) / 1000000ULL;
+      if (seconds < 1) seconds = 1;
+      if (seconds > HTTP_RATE_LIMIT_MAX_RETRY) seconds = HTTP_RATE_LIMIT_MAX_RETRY;
+      return static_cast<uint32_t>(seconds);
+    }
+    uint64_t next = (tag << 48) | ((arrival + this->interval) & HTTP_RATE_LIMIT_TIME_MASK);
+    if (slot->compare_exchange_weak(current, next, std::memory_order_relaxed, std::memory_order_relaxed)){
+      if (!owned) shard.hash[position].store(hash, std::memory_order_relaxed);
+      return 0;
+    }
+  }
+}
+
+/**
+ * @brief Gets the precompiled rejection.
+ *
+ * @param[in] retryAfter The `Retry-After` seconds (clamped to `1` ... `HTTP_RATE_LIMIT_MAX_RETRY`).
+ * @return The serialized `429 Too Many Requests` response.
+ */
+std::string_view HTTPRateLimiter::getResponse(uint32_t retryAfter){
+  if (retryAfter < 1) retryAfter = 1;
+  if (retryAfter > HTTP_RATE_LIMIT_MAX_RETRY) retryAfter = HTTP_RATE_LIMIT_MAX_RETRY;
+  return __rejections.response[retryAfter].view();
+}
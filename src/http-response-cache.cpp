@@ -0,0 +1,440 @@
+/*
+ * $Id: http-response-cache.cpp,v 1.0.0 2026/10/18 14:34:50 Jaya Wikrama Exp $
+ *
+ * Copyright (c) 2024 Jaya Wikrama
+ * jayawikrama89@gmail.com
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *  claim that you wrote the original software. If you use this software
+ *  in a product, an acknowledgment in the product documentation would be
+ *  appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *  misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <time.h>
+#include "http-response-cache.hpp"
+#include "http-header-table.hpp"
+
+typedef struct _directive_t {
+  long maxAge;
+  bool noStore;
+  bool noCache;
+  bool isPrivate;
+  bool isPublic;
+  bool sMaxAge;
+  bool mustRevalidate;
+} directive_t;
+
+static uint64_t __now(){
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+  return static_cast<uint64_t>(ts.tv_sec);
+}
+
+static bool __has(const HTTPHeader &header, HeaderNode::headerField_t field){
+  return (field != HeaderNode::UNKNOWN && header.getNode(field) != nullptr);
+}
+
+static std::string __value(const HTTPHeader &header, HeaderNode::headerField_t field){
+  HeaderNode *node = header.getNode(field);
+  return (node == nullptr ? std::string() : node->getValue());
+}
+
+static std::string_view __trim(std::string_view token){
+  while (!token.empty() && (token.front() == ' ' || token.front() == '\t')) token.remove_prefix(1);
+  while (!token.empty() && (token.back() == ' ' || token.back() == '\t')) token.remove_suffix(1);
+  return token;
+}
+
+static bool __equals(std::string_view a, const char *b){
+  size_t length = strlen(b);
+  if (a.length() != length) return false;
+  for (size_t i = 0; i < length; i++){
+    if (tolower(static_cast<unsigned char>(a[i])) != b[i]) return false;
+  }
+  return true;
+}
+
+static bool __hasToken(const std::string &value, const char *token){
+  std::string_view rest(value);
+  while (!rest.empty()){
+    size_t comma = rest.find(',');
+    if (__equals(__trim(rest.substr(0, comma)), token)) return true;
+    rest = (comma == std::string_view::npos ? std::string_view() : rest.substr(comma + 1));
+  }
+  return false;
+}
+
+/*
+ * Cache-Control directives, s-maxage wins over max-age because this is a shared cache, `Pragma: no-cache` is
+ * no-cache if there is no Cache-Control (RFC 9111 section 5.4)
+ */
+static directive_t __directives(const HTTPHeader &header){
+  directive_t directive = { -1, false, false, false, false, false, false };
+  std::string value = __value(header, HeaderNode::CACHE_CONTROL);
+  if (value.empty()) value = __value(header, HeaderNode::CACHE_CONTROL_H);
+  if (value.empty()){
+    directive.noCache = __hasToken(__value(header, HeaderNode::PRAGMA), "no-cache");
+    return directive;
+  }
+  std::string_view rest(value);
+  bool shared = false;
+  while (!rest.empty()){
+    size_t comma = rest.find(',');
+    std::string_view token = __trim(rest.substr(0, comma));
+    rest = (comma == std::string_view::npos ? std::string_view() : rest.substr(comma + 1));
+    size_t equal = token.find('=');
+    std::string_view name = __trim(token.substr(0, equal));
+    if (__equals(name, "no-store")) directive.noStore = true;
+    else if (__equals(name, "no-cache")) directive.noCache = true;
+    else if (__equals(name, "private")) directive.isPrivate = true;
+    else if (__equals(name, "public")) directive.isPublic = true;
+    else if (__equals(name, "must-revalidate")) directive.mustRevalidate = true;
+    else if (equal != std::string_view::npos && (__equals(name, "max-age") || __equals(name, "s-maxage"))){
+      bool sMaxAge = __equals(name, "s-maxage");
+      if (shared && !sMaxAge) continue;
+      std::string number(__trim(token.substr(equal + 1)));
+      char *end = nullptr;
+      long age = strtol(number.c_str(), &end, 10);
+      if (number.empty() || *end != 0x00 || age < 0) continue;
+      directive.maxAge = age;
+      directive.sMaxAge = (directive.sMaxAge || sMaxAge);
+      shared = sMaxAge;
+    }
+  }
+  return directive;
+}
+
+static bool __isCacheableMethod(const HTTPHeader &request){
+  return (request.getMethod() == "GET" || request.getMethod() == "HEAD");
+}
+
+static std::string __primary(const HTTPHeader &request){
+  std::string key(request.getMethod());
+  key += ' ';
+  key += __value(request, HeaderNode::HOST);
+  key += ' ';
+  key += request.getTarget();
+  return key;
+}
+
+static std::string __key(const std::string &primary, const HTTPHeader &request, const std::vector<std::string> &fields){
+  std::string key(primary);
+  for (const std::string &field : fields){
+    HeaderNode *node = request.getNode(std::string_view(field));
+    key += '\n';
+    if (node != nullptr) key += node->getValue();
+  }
+  return key;
+}
+
+/* the names are matched case-insensitively and never interned, `false` for `Vary: *` */
+static bool __varyFields(const HTTPHeader &response, std::vector<std::string> &fields){
+  std::string value = __value(response, HeaderNode::VARY);
+  std::string_view rest(value);
+  fields.clear();
+  while (!rest.empty()){
+    size_t comma = rest.find(',');
+    std::string_view token = __trim(rest.substr(0, comma));
+    rest = (comma == std::string_view::npos ? std::string_view() : rest.substr(comma + 1));
+    if (token.empty()) continue;
+    if (token == "*") return false;
+    if (token.length() > HTTP_HEADER_NAME_MAX) return false;
+    fields.emplace_back(token);
+  }
+  return true;
+}
+
+/* the bytes of the Vary entry of the primary key, they are charged to the budget like the slots */
+static size_t __varySize(const std::string &primary, const std::vector<std::string> &fields){
+  size_t size = primary.length();
+  for (const std::string &field : fields) size += field.length();
+  return size;
+}
+
+/* weak comparison of the entity tags (RFC 9110 section 13.1.2) */
+static bool __matchETag(const std::string &ifNoneMatch, const std::string &etag){
+  if (etag.empty()) return false;
+  std::string_view tag(etag);
+  if (tag.substr(0, 2) == "W/") tag.remove_prefix(2);
+  std::string_view rest(ifNoneMatch);
+  while (!rest.empty()){
+    size_t comma = rest.find(',');
+    std::string_view token = __trim(rest.substr(0, comma));
+    rest = (comma == std::string_view::npos ? std::string_view() : rest.substr(comma + 1));
+    if (token == "*") return true;
+    if (token.substr(0, 2) == "W/") token.remove_prefix(2);
+    if (token == tag) return true;
+  }
+  return false;
+}
+
+/* the 304 response keeps only the fields which describe the cached representation */
+static std::string __notModified(const HTTPHeader &response){
+  static const HeaderNode::headerField_t fields[] = {
+    HeaderNode::ETAG,
+    HeaderNode::LAST_MODIFIED,
+    HeaderNode::CACHE_CONTROL,
+    HeaderNode::CACHE_CONTROL_H,
+    HeaderNode::EXPIRES,
+    HeaderNode::VARY,
+    HeaderNode::CONTENT_LOCATION
+  };
+  HTTPHeader header;
+  header.setHTTPStatusCode(HttpStatus::NOT_MODIFIED);
+  for (HeaderNode::headerField_t field : fields){
+    if (__has(response, field)) header.append(field, __value(response, field));
+  }
+  return header.getPayload();
+}
+
+/**
+ * @brief Custom constructor.
+ *
+ * @param[in] budget The maximum number of bytes of all cached responses.
+ * @param[in] shards The number of shards (the budget is shared equally).
+ */
+HTTPResponseCache::HTTPResponseCache(size_t budget, size_t shards){
+  if (shards == 0) shards = 1;
+  this->budget = budget / shards;
+  for (size_t i = 0; i < shards; i++){
+    this->shards.emplace_back(new shard_t());
+    this->shards.back()->hand = 0;
+    this->shards.back()->size = 0;
+  }
+}
+
+/* the entries of the old Vary are not reachable with the new Vary of the primary key */
+void HTTPResponseCache::evictPrimary(shard_t &shard, const std::string &primary){
+  for (size_t i = 0; i < shard.ring.size(); i++){
+    const std::string &key = shard.ring[i].key;
+    if (!shard.ring[i].used || key.compare(0, primary.length(), primary) != 0) continue;
+    if (key.length() == primary.length() || key[primary.length()] == '\n') this->evict(shard, i);
+  }
+}
+
+/* the response is shared with the senders of the previous hits, so the new Age is written to a copy */
+void HTTPResponseCache::refreshAge(shard_t &shard, slot_t &slot){
+  long age = slot.age + static_cast<long>(__now() - slot.stored);
+  if (age == slot.served) return;
+  std::string value = std::to_string(age);
+  std::string response;
+  response.reserve(slot.response->length() - slot.ageLength + value.length());
+  response.append(*slot.response, 0, slot.agePosition);
+  response.append(value);
+  response.append(*slot.response, slot.agePosition + slot.ageLength, std::string::npos);
+  shard.size = shard.size - slot.ageLength + value.length();
+  slot.response = std::make_shared<const std::string>(std::move(response));
+  slot.ageLength = value.length();
+  slot.served = age;
+}
+
+void HTTPResponseCache::evict(shard_t &shard, size_t position){
+  slot_t &slot = shard.ring[position];
+  shard.index.erase(slot.key);
+  shard.size -= slot.key.length() + slot.etag.length() + slot.response->length() + slot.notModified->length();
+  auto vary = shard.vary.find(slot.key.substr(0, slot.primaryLength));
+  if (vary != shard.vary.end() && --vary->second.variants == 0){
+    shard.size -= __varySize(vary->first, vary->second.fields);
+    shard.vary.erase(vary);
+  }
+  slot = slot_t();
+  slot.used = false;
+  shard.free.push_back(position);
+}
+
+/**
+ * @brief Find the response of the request.
+ *
+ * This method is responsible to find the fresh response of the request and evaluate the conditional fields.
+ * A request with `Cache-Control: no-cache` or `no-store` always misses.
+ *
+ * @param[in] request The request header.
+ * @param[out] response The serialized response (the cached response or the `304 Not Modified` response).
+ * @return `HTTPResponseCache::HIT` if the cached response is available.
+ * @return `HTTPResponseCache::NOT_MODIFIED` if the conditional request matches the cached response.
+ * @return `HTTPResponseCache::MISS` if the handler must be called.
+ */
+HTTPResponseCache::result_t HTTPResponseCache::lookup(const HTTPHeader &request, std::shared_ptr<const std::string> &response){
+  response.reset();
+  if (!__isCacheableMethod(request)) return HTTPResponseCache::MISS;
+  directive_t directive = __directives(request);
+  if (directive.noCache || directive.noStore) return HTTPResponseCache::MISS;
+  std::string primary = __primary(request);
+  shard_t &shard = *this->shards[std::hash<std::string>{}(primary) % this->shards.size()];
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  auto vary = shard.vary.find(primary);
+  if (vary == shard.vary.end()) return HTTPResponseCache::MISS;
+  auto entry = shard.index.find(__key(primary, request, vary->second.fields));
+  if (entry == shard.index.end()) return HTTPResponseCache::MISS;
+  slot_t &slot = shard.ring[entry->second];
+  if (slot.expire <= __now()){
+    this->evict(shard, entry->second);
+    return HTTPResponseCache::MISS;
+  }
+  slot.referenced = true;
+  /* If-None-Match takes precedence, If-Modified-Since is ignored when it is present (RFC 9110 section 13.2.2) */
+  if (__has(request, HeaderNode::IF_NONE_MATCH)){
+    if (__matchETag(__value(request, HeaderNode::IF_NONE_MATCH), slot.etag)){
+      response = slot.notModified;
+      return HTTPResponseCache::NOT_MODIFIED;
+    }
+  }
+  else if (slot.lastModified >= 0 && __has(request, HeaderNode::IF_MODIFIED_SINCE)){
+    long since = convertToUnixEpoch(__value(request, HeaderNode::IF_MODIFIED_SINCE));
+    if (since >= 0 && slot.lastModified <= since){
+      response = slot.notModified;
+      return HTTPResponseCache::NOT_MODIFIED;
+    }
+  }
+  this->refreshAge(shard, slot);
+  response = slot.response;
+  return HTTPResponseCache::HIT;
+}
+
+/**
+ * @brief Store the response of the request.
+ *
+ * This method is responsible to serialize and store the response if it is cacheable.
+ *
+ * @param[in] request The request header.
+ * @param[in] response The response header.
+ * @param[in] body The response body.
+ * @return `true` if the response is stored.
+ * @return `false` if the response is not cacheable or larger than the shard budget.
+ */
+bool HTTPResponseCache::store(const HTTPHeader &request, HTTPHeader &response, const std::string &body){
+  if (!__isCacheableMethod(request)) return false;
+  switch (response.getHTTPStatusCode()){
+    case HttpStatus::OK:
+    case HttpStatus::NON_AUTHORITATIVE_INFORMATION:
+    case HttpStatus::NO_CONTENT:
+    case HttpStatus::MULTIPLE_CHOICES:
+    case HttpStatus::MOVED_PERMANENTLY:
+    case HttpStatus::NOT_FOUND:
+    case HttpStatus::GONE:
+      break;
+    default:
+      return false;
+  }
+  if (__directives(request).noStore) return false;
+  directive_t directive = __directives(response);
+  if (directive.noStore || directive.noCache || directive.isPrivate || directive.maxAge <= 0) return false;
+  /* the response of the authorized request is private unless it says otherwise (RFC 9111 section 3.5) */
+  if (__has(request, HeaderNode::AUTHORIZATION) && !directive.isPublic && !directive.sMaxAge && !directive.mustRevalidate) return false;
+  if (__has(response, HeaderNode::SET_COOKIE)) return false;
+  std::vector<std::string> fields;
+  if (!__varyFields(response, fields)) return false;
+  long age = 0;
+  if (__has(response, HeaderNode::AGE) && !response.getNode(HeaderNode::AGE)->getNumber(age)) age = 0;
+  if (age >= directive.maxAge) return false;
+
+  slot_t slot;
+  std::string primary = __primary(request);
+  slot.key = __key(primary, request, fields);
+  slot.primaryLength = primary.length();
+  /* the Age row is the last row of the head, so it can be rewritten on hit */
+  HTTPHeader head = response.clone();
+  head.remove(HeaderNode::AGE);
+  std::string payload;
+  head.serialize(payload);
+  payload.append("Age: ");
+  slot.agePosition = payload.length();
+  slot.age = age;
+  slot.served = age;
+  slot.stored = __now();
+  std::string value = std::to_string(age);
+  slot.ageLength = value.length();
+  payload.append(value);
+  payload.append("\r\n\r\n");
+  payload.append(body);
+  slot.response = std::make_shared<const std::string>(std::move(payload));
+  slot.notModified = std::make_shared<const std::string>(__notModified(response));
+  slot.etag = __value(response, HeaderNode::ETAG);
+  slot.lastModified = (__has(response, HeaderNode::LAST_MODIFIED) ? convertToUnixEpoch(__value(response, HeaderNode::LAST_MODIFIED)) : -1);
+  slot.expire = __now() + static_cast<uint64_t>(directive.maxAge - age);
+  slot.referenced = false;
+  slot.used = true;
+  size_t size = slot.key.length() + slot.etag.length() + slot.response->length() + slot.notModified->length();
+  size_t varySize = __varySize(primary, fields);
+  if (size + varySize > this->budget) return false;
+
+  shard_t &shard = *this->shards[std::hash<std::string>{}(primary) % this->shards.size()];
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  auto vary = shard.vary.find(primary);
+  if (vary != shard.vary.end() && vary->second.fields != fields) this->evictPrimary(shard, primary);
+  auto entry = shard.index.find(slot.key);
+  if (entry != shard.index.end()) this->evict(shard, entry->second);
+  /* CLOCK: a referenced slot gets a second chance, the first unreferenced slot is evicted */
+  for (;;){
+    size_t needed = size + (shard.vary.count(primary) == 0 ? varySize : 0);
+    if (shard.size + needed <= this->budget || shard.ring.empty()) break;
+    if (shard.hand >= shard.ring.size()) shard.hand = 0;
+    slot_t &candidate = shard.ring[shard.hand];
+    if (candidate.used){
+      if (candidate.referenced) candidate.referenced = false;
+      else this->evict(shard, shard.hand);
+    }
+    shard.hand++;
+  }
+  size_t position = shard.ring.size();
+  if (!shard.free.empty()){
+    position = shard.free.back();
+    shard.free.pop_back();
+  }
+  else {
+    shard.ring.emplace_back();
+  }
+  vary = shard.vary.find(primary);
+  if (vary == shard.vary.end()){
+    vary = shard.vary.emplace(primary, HTTPResponseCache::vary_t{ std::move(fields), 0 }).first;
+    shard.size += varySize;
+  }
+  vary->second.variants++;
+  shard.index[slot.key] = position;
+  shard.ring[position] = std::move(slot);
+  shard.size += size;
+  return true;
+}
+
+/**
+ * @brief Remove all cached responses.
+ */
+void HTTPResponseCache::clear(){
+  for (std::unique_ptr<shard_t> &shard : this->shards){
+    std::lock_guard<std::mutex> lock(shard->mutex);
+    shard->vary.clear();
+    shard->index.clear();
+    shard->ring.clear();
+    shard->free.clear();
+    shard->hand = 0;
+    shard->size = 0;
+  }
+}
+
+/**
+ * @brief Gets the number of bytes of all cached responses.
+ *
+ * @return The number of bytes.
+ */
+size_t HTTPResponseCache::getSize(){
+  size_t size = 0;
+  for (std::unique_ptr<shard_t> &shard : this->shards){
+    std::lock_guard<std::mutex> lock(shard->mutex);
+    size += shard->size;
+  }
+  return size;
+}
@@ -0,0 +1,489 @@
+/*
+ * $Id: http-simd.cpp,v 1.0.0 2026/10/18 17:52:10 Jaya Wikrama Exp $
+ *
+ * Copyright (c) 2024 Jaya Wikrama
+ * jayawikrama89@gmail.com
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *  claim that you wrote the original software. If you use this software
+ *  in a product, an acknowledgment in the product documentation would be
+ *  appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *  misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include <cstring>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+#include "http-simd.hpp"
+
+typedef struct _kernels_t {
+  HTTPSimd::level_t level;
+  size_t (*find)(const char *data, size_t length, char first, char second);
+  void (*lower)(char *data, size_t length);
+  void (*mask)(char *data, size_t length, uint32_t pattern);
+  uint32_t (*crc32c)(const char *data, size_t length, uint32_t crc);
+  size_t (*lowerToken)(const char *data, size_t length, char *output);
+} kernels_t;
+
+typedef struct _crcTable_t {
+  uint32_t value[256];
+
+  constexpr _crcTable_t() : value{} {
+    for (uint32_t i = 0; i < 256; i++){
+      uint32_t crc = i;
+      for (int bit = 0; bit < 8; bit++) crc = (crc >> 1) ^ (0x82F63B78U & (0U - (crc & 1U)));
+      this->value[i] = crc;
+    }
+  }
+} crcTable_t;
+
+static constexpr crcTable_t __crcTable;
+
+/* RFC 7230 tchar, `nibble` holds for every low nibble the bit set of the high nibbles which make a tchar */
+typedef struct _tokenTable_t {
+  bool valid[256];
+  uint8_t nibble[16];
+
+  constexpr _tokenTable_t() : valid{}, nibble{} {
+    const char special[] = "!#$%&'*+-.^_`|~";
+    for (int c = 0; c < 256; c++){
+      bool token = ((c >= '0' && c <= '9') || (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z'));
+      for (size_t i = 0; i + 1 < sizeof(special); i++) token = (token || c == special[i]);
+      this->valid[c] = token;
+      if (token) this->nibble[c & 0x0F] = static_cast<uint8_t>(this->nibble[c & 0x0F] | (1U << (c >> 4)));
+    }
+  }
+} tokenTable_t;
+
+static constexpr tokenTable_t __tokenTable;
+
+static size_t __findScalar(const char *data, size_t length, char first, char second){
+  for (size_t i = 0; i < length; i++){
+    if (data[i] == first || data[i] == second) return i;
+  }
+  return length;
+}
+
+static void __lowerScalar(char *data, size_t length){
+  for (size_t i = 0; i < length; i++){
+    if (static_cast<unsigned char>(data[i] - 'A') < 26) data[i] = static_cast<char>(data[i] + ('a' - 'A'));
+  }
+}
+
+static void __maskScalar(char *data, size_t length, uint32_t pattern){
+  uint64_t wide = (static_cast<uint64_t>(pattern) << 32) | pattern;
+  uint8_t key[4];
+  memcpy(key, &pattern, sizeof(key));
+  size_t i = 0;
+  for (; i + 8 <= length; i += 8){
+    uint64_t block;
+    memcpy(&block, data + i, sizeof(block));
+    block ^= wide;
+    memcpy(data + i, &block, sizeof(block));
+  }
+  for (; i < length; i++) data[i] = static_cast<char>(data[i] ^ key[i & 3]);
+}
+
+static uint32_t __crc32cScalar(const char *data, size_t length, uint32_t crc){
+  crc = ~crc;
+  for (size_t i = 0; i < length; i++) crc = __crcTable.value[(crc ^ static_cast<uint8_t>(data[i])) & 0xFF] ^ (crc >> 8);
+  return ~crc;
+}
+
+static size_t __lowerTokenScalar(const char *data, size_t length, char *output){
+  for (size_t i = 0; i < length; i++){
+    char c = data[i];
+    if (!__tokenTable.valid[static_cast<unsigned char>(c)]) return i;
+    output[i] = (static_cast<unsigned char>(c - 'A') < 26 ? static_cast<char>(c + ('a' - 'A')) : c);
+  }
+  return length;
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+/* every vector loop stops at the last full vector and leaves the tail to the scalar kernel */
+__attribute__((target("sse2"))) static size_t __findSSE2(const char *data, size_t length, char first, char second){
+  __m128i a = _mm_set1_epi8(first);
+  __m128i b = _mm_set1_epi8(second);
+  size_t i = 0;
+  for (; i + 16 <= length; i += 16){
+    __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+    int match = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(block, a), _mm_cmpeq_epi8(block, b)));
+    if (match != 0) return i + static_cast<size_t>(__builtin_ctz(static_cast<unsigned int>(match)));
+  }
+  return i + __findScalar(data + i, length - i, first, second);
+}
+
+__attribute__((target("sse2"))) static void __lowerSSE2(char *data, size_t length){
+  /* the signed compare keeps the bytes above 0x7F out of the range */
+  __m128i low = _mm_set1_epi8('A' - 1);
+  __m128i high = _mm_set1_epi8('Z' + 1);
+  __m128i bit = _mm_set1_epi8(0x20);
+  size_t i = 0;
+  for (; i + 16 <= length; i += 16){
+    __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+    __m128i upper = _mm_and_si128(_mm_cmpgt_epi8(block, low), _mm_cmplt_epi8(block, high));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(data + i), _mm_or_si128(block, _mm_and_si128(upper, bit)));
+  }
+  __lowerScalar(data + i, length - i);
+}
+
+__attribute__((target("sse2"))) static void __maskSSE2(char *data, size_t length, uint32_t pattern){
+  __m128i key = _mm_set1_epi32(static_cast<int>(pattern));
+  size_t i = 0;
+  for (; i + 16 <= length; i += 16){
+    __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(data + i), _mm_xor_si128(block, key));
+  }
+  /* the vector step is a multiple of 4 bytes, so the pattern stays aligned with the tail */
+  __maskScalar(data + i, length - i, pattern);
+}
+
+__attribute__((target("sse2"))) static size_t __lowerTokenSSE2(const char *data, size_t length, char *output){
+  /* no byte shuffle in SSE2: the visible ASCII range without the delimiters `"(),/:;<=>?@[\]{}` */
+  __m128i low = _mm_set1_epi8('A' - 1);
+  __m128i high = _mm_set1_epi8('Z' + 1);
+  __m128i bit = _mm_set1_epi8(0x20);
+  size_t i = 0;
+  for (; i + 16 <= length; i += 16){
+    __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+    __m128i valid = _mm_and_si128(_mm_cmpgt_epi8(block, _mm_set1_epi8(0x20)), _mm_cmplt_epi8(block, _mm_set1_epi8(0x7F)));
+    __m128i delimiter = _mm_and_si128(_mm_cmpgt_epi8(block, _mm_set1_epi8(0x27)), _mm_cmplt_epi8(block, _mm_set1_epi8(0x2A)));
+    delimiter = _mm_or_si128(delimiter, _mm_and_si128(_mm_cmpgt_epi8(block, _mm_set1_epi8(0x39)), _mm_cmplt_epi8(block, _mm_set1_epi8(0x41))));
+    delimiter = _mm_or_si128(delimiter, _mm_and_si128(_mm_cmpgt_epi8(block, _mm_set1_epi8(0x5A)), _mm_cmplt_epi8(block, _mm_set1_epi8(0x5E))));
+    delimiter = _mm_or_si128(delimiter, _mm_cmpeq_epi8(block, _mm_set1_epi8('"')));
+    delimiter = _mm_or_si128(delimiter, _mm_cmpeq_epi8(block, _mm_set1_epi8(',')));
+    delimiter = _mm_or_si128(delimiter, _mm_cmpeq_epi8(block, _mm_set1_epi8('/')));
+    delimiter = _mm_or_si128(delimiter, _mm_cmpeq_epi8(block, _mm_set1_epi8('{')));
+    delimiter = _mm_or_si128(delimiter, _mm_cmpeq_epi8(block, _mm_set1_epi8('}')));
+    __m128i upper = _mm_and_si128(_mm_cmpgt_epi8(block, low), _mm_cmplt_epi8(block, high));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(output + i), _mm_or_si128(block, _mm_and_si128(upper, bit)));
+    int invalid = _mm_movemask_epi8(_mm_andnot_si128(delimiter, valid)) ^ 0xFFFF;
+    if (invalid != 0) return i + static_cast<size_t>(__builtin_ctz(static_cast<unsigned int>(invalid)));
+  }
+  return i + __lowerTokenScalar(data + i, length - i, output + i);
+}
+
+__attribute__((target("avx2"))) static size_t __findAVX2(const char *data, size_t length, char first, char second){
+  __m256i a = _mm256_set1_epi8(first);
+  __m256i b = _mm256_set1_epi8(second);
+  size_t i = 0;
+  for (; i + 32 <= length; i += 32){
+    __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+    int match = _mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(block, a), _mm256_cmpeq_epi8(block, b)));
+    if (match != 0) return i + static_cast<size_t>(__builtin_ctz(static_cast<unsigned int>(match)));
+  }
+  return i + __findSSE2(data + i, length - i, first, second);
+}
+
+__attribute__((target("avx2"))) static void __lowerAVX2(char *data, size_t length){
+  __m256i low = _mm256_set1_epi8('A' - 1);
+  __m256i high = _mm256_set1_epi8('Z' + 1);
+  __m256i bit = _mm256_set1_epi8(0x20);
+  size_t i = 0;
+  for (; i + 32 <= length; i += 32){
+    __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+    __m256i upper = _mm256_and_si256(_mm256_cmpgt_epi8(block, low), _mm256_cmpgt_epi8(high, block));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(data + i), _mm256_or_si256(block, _mm256_and_si256(upper, bit)));
+  }
+  __lowerSSE2(data + i, length - i);
+}
+
+__attribute__((target("avx2"))) static void __maskAVX2(char *data, size_t length, uint32_t pattern){
+  __m256i key = _mm256_set1_epi32(static_cast<int>(pattern));
+  size_t i = 0;
+  for (; i + 32 <= length; i += 32){
+    __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(data + i), _mm256_xor_si256(block, key));
+  }
+  __maskSSE2(data + i, length - i, pattern);
+}
+
+__attribute__((target("avx2"))) static size_t __lowerTokenAVX2(const char *data, size_t length, char *output){
+  /* one byte shuffle per nibble classifies 32 bytes, the bytes above 0x7F have no bit in `row` */
+  __m256i column = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(__tokenTable.nibble)));
+  __m256i row = _mm256_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 0, 0, 0, 0, 0, 0, 0, 0,
+    1, 2, 4, 8, 16, 32, 64, -128, 0, 0, 0, 0, 0, 0, 0, 0);
+  __m256i nibble = _mm256_set1_epi8(0x0F);
+  __m256i low = _mm256_set1_epi8('A' - 1);
+  __m256i high = _mm256_set1_epi8('Z' + 1);
+  __m256i bit = _mm256_set1_epi8(0x20);
+  size_t i = 0;
+  for (; i + 32 <= length; i += 32){
+    __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+    __m256i bits = _mm256_shuffle_epi8(column, _mm256_and_si256(block, nibble));
+    bits = _mm256_and_si256(bits, _mm256_shuffle_epi8(row, _mm256_and_si256(_mm256_srli_epi16(block, 4), nibble)));
+    __m256i upper = _mm256_and_si256(_mm256_cmpgt_epi8(block, low), _mm256_cmpgt_epi8(high, block));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(output + i), _mm256_or_si256(block, _mm256_and_si256(upper, bit)));
+    unsigned int invalid = static_cast<unsigned int>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(bits, _mm256_setzero_si256())));
+    if (invalid != 0) return i + static_cast<size_t>(__builtin_ctz(invalid));
+  }
+  return i + __lowerTokenSSE2(data + i, length - i, output + i);
+}
+
+__attribute__((target("sse4.2"))) static uint32_t __crc32cSSE42(const char *data, size_t length, uint32_t crc){
+  crc = ~crc;
+  size_t i = 0;
+#if defined(__x86_64__)
+  uint64_t wide = crc;
+  for (; i + 8 <= length; i += 8){
+    uint64_t block;
+    memcpy(&block, data + i, sizeof(block));
+    wide = _mm_crc32_u64(wide, block);
+  }
+  crc = static_cast<uint32_t>(wide);
+#endif
+  for (; i + 4 <= length; i += 4){
+    uint32_t block;
+    memcpy(&block, data + i, sizeof(block));
+    crc = _mm_crc32_u32(crc, block);
+  }
+  for (; i < length; i++) crc = _mm_crc32_u8(crc, static_cast<uint8_t>(data[i]));
+  return ~crc;
+}
+#endif
+
+static bool __variant(HTTPSimd::level_t level, kernels_t &kernels){
+  kernels = { HTTPSimd::SCALAR, __findScalar, __lowerScalar, __maskScalar, __crc32cScalar, __lowerTokenScalar };
+  if (level == HTTPSimd::SCALAR) return true;
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_cpu_init();
+  if (level == HTTPSimd::SSE2 && __builtin_cpu_supports("sse2")){
+    kernels = { HTTPSimd::SSE2, __findSSE2, __lowerSSE2, __maskSSE2, __crc32cScalar, __lowerTokenSSE2 };
+  }
+  else if (level == HTTPSimd::AVX2 && __builtin_cpu_supports("avx2")){
+    kernels = { HTTPSimd::AVX2, __findAVX2, __lowerAVX2, __maskAVX2, __crc32cScalar, __lowerTokenAVX2 };
+  }
+  else {
+    return false;
+  }
+  if (__builtin_cpu_supports("sse4.2")) kernels.crc32c = __crc32cSSE42;
+  return true;
+#else
+  return false;
+#endif
+}
+
+/* constant initialized, so the scalar kernels are usable before the selection below runs */
+static kernels_t __kernels = { HTTPSimd::SCALAR, __findScalar, __lowerScalar, __maskScalar, __crc32cScalar, __lowerTokenScalar };
+
+__attribute__((constructor)) static void __select(){
+  kernels_t kernels;
+  for (int level = HTTPSimd::AVX2; level > HTTPSimd::SCALAR; level--){
+    if (__variant(static_cast<HTTPSimd::level_t>(level), kernels)){
+      __kernels = kernels;
+      return;
+    }
+  }
+}
+
+static int __hexValue(char c){
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  return -1;
+}
+
+static bool __percentDecode(const kernels_t &kernels, const char *data, size_t length, std::string &output, bool plus){
+  size_t start = output.length();
+  size_t i = 0;
+  while (i < length){
+    size_t next = i + kernels.find(data + i, length - i, '%', (plus ? '+' : '%'));
+    output.append(data + i, next - i);
+    if (next >= length) break;
+    if (data[next] == '+'){
+      output.push_back(' ');
+      i = next + 1;
+      continue;
+    }
+    int high = (next + 2 < length ? __hexValue(data[next + 1]) : -1);
+    int low = (high >= 0 ? __hexValue(data[next + 2]) : -1);
+    if (low < 0){
+      output.resize(start);
+      return false;
+    }
+    output.push_back(static_cast<char>((high << 4) | low));
+    i = next + 3;
+  }
+  return true;
+}
+
+static uint64_t __random(uint64_t &state){
+  state ^= state << 13;
+  state ^= state >> 7;
+  state ^= state << 17;
+  return state;
+}
+
+static bool __verify(const kernels_t &reference, const kernels_t &kernels){
+  static const char hex[] = "0123456789abcdefABCDEFxyz%+";
+  uint64_t state = 0x9E3779B97F4A7C15ULL;
+  char input[300 + 8];
+  char expected[sizeof(input)];
+  char result[sizeof(input)];
+  for (size_t length = 0; length <= 300; length++){
+    for (size_t offset = 0; offset < 4; offset++){
+      for (size_t i = 0; i < length; i++) input[offset + i] = static_cast<char>(__random(state));
+      const char *data = input + offset;
+
+      char first = static_cast<char>(__random(state));
+      char second = (length & 1 ? first : static_cast<char>(__random(state)));
+      for (size_t i = 0; i < length; i++){
+        if (data[i] == first || data[i] == second) input[offset + i] = static_cast<char>(first + 1 == second ? first + 2 : first + 1);
+      }
+      for (int round = 0; round < 2; round++){
+        if (reference.find(data, length, first, second) != kernels.find(data, length, first, second)) return false;
+        if (length > 0) input[offset + __random(state) % length] = (round == 0 ? second : first);
+      }
+
+      memcpy(expected + offset, data, length);
+      memcpy(result + offset, data, length);
+      reference.lower(expected + offset, length);
+      kernels.lower(result + offset, length);
+      if (memcmp(expected + offset, result + offset, length) != 0) return false;
+
+      uint32_t pattern = static_cast<uint32_t>(__random(state));
+      reference.mask(expected + offset, length, pattern);
+      kernels.mask(result + offset, length, pattern);
+      if (memcmp(expected + offset, result + offset, length) != 0) return false;
+
+      if (reference.crc32c(data, length, 0) != kernels.crc32c(data, length, 0)) return false;
+
+      /* mostly token characters, so the invalid byte lands at every position */
+      for (size_t i = 0; i < length; i++){
+        if (__random(state) % 64 != 0) input[offset + i] = static_cast<char>(0x21 + __random(state) % 0x5E);
+      }
+      size_t token = reference.lowerToken(data, length, expected);
+      if (token != kernels.lowerToken(data, length, result) || memcmp(expected, result, token) != 0) return false;
+
+      for (size_t i = 0; i < length; i++){
+        if (__random(state) % 4 == 0) input[offset + i] = hex[__random(state) % (sizeof(hex) - 1)];
+      }
+      std::string decodedReference, decoded;
+      bool plus = (length & 2) != 0;
+      if (__percentDecode(reference, data, length, decodedReference, plus) != __percentDecode(kernels, data, length, decoded, plus)) return false;
+      if (decodedReference != decoded) return false;
+    }
+  }
+  return kernels.crc32c("123456789", 9, 0) == 0xE3069283U;
+}
+
+/**
+ * @brief Gets the selected variant.
+ *
+ * @return The instruction set of the selected variant.
+ */
+HTTPSimd::level_t HTTPSimd::getLevel(){
+  return __kernels.level;
+}
+
+/**
+ * @brief Find the first of two bytes.
+ *
+ * @param[in] data The input.
+ * @param[in] length The length of the input.
+ * @param[in] first The first byte to find.
+ * @param[in] second The second byte to find (pass `first` again to find one byte).
+ * @return The position of the first match or `length` if there is none.
+ */
+size_t HTTPSimd::find(const char *data, size_t length, char first, char second){
+  return __kernels.find(data, length, first, second);
+}
+
+/**
+ * @brief Lowercase the ASCII letters in place.
+ *
+ * @param[in,out] data The input.
+ * @param[in] length The length of the input.
+ */
+void HTTPSimd::lower(char *data, size_t length){
+  __kernels.lower(data, length);
+}
+
+/**
+ * @brief Apply the XOR mask in place.
+ *
+ * This method is responsible to XOR the input with the repeated 4 byte pattern (the first byte of the pattern
+ * in memory is applied to the first byte of the input), as used by the WebSocket frames.
+ *
+ * @param[in,out] data The input.
+ * @param[in] length The length of the input.
+ * @param[in] pattern The 4 byte pattern.
+ */
+void HTTPSimd::mask(char *data, size_t length, uint32_t pattern){
+  __kernels.mask(data, length, pattern);
+}
+
+/**
+ * @brief Compute the CRC-32C (Castagnoli) checksum.
+ *
+ * @param[in] data The input.
+ * @param[in] length The length of the input.
+ * @param[in] crc The checksum of the previous input (to continue a checksum) or `0`.
+ * @return The checksum.
+ */
+uint32_t HTTPSimd::crc32c(const char *data, size_t length, uint32_t crc){
+  return __kernels.crc32c(data, length, crc);
+}
+
+/**
+ * @brief Decode the percent-encoded input.
+ *
+ * This method is responsible to append the decoded input to the output. The runs without escapes are copied
+ * as a whole, they are found with `find`.
+ *
+ * @param[in] data The input.
+ * @param[in] length The length of the input.
+ * @param[out] output The decoded input is appended here.
+ * @param[in] plus `true` to decode `+` as space (`application/x-www-form-urlencoded`).
+ * @return `true` in success.
+ * @return `false` if the input has a malformed escape (the output is left unchanged).
+ */
+bool HTTPSimd::percentDecode(const char *data, size_t length, std::string &output, bool plus){
+  return __percentDecode(__kernels, data, length, output, plus);
+}
+
+/**
+ * @brief Validate and lowercase the token.
+ *
+ * This method is responsible to copy the leading token characters (RFC 7230 `tchar`) of the input to the output
+ * in lowercase, one pass over the input. The vector variants write whole vectors, so the output bytes after the
+ * token (up to `length`) are unspecified.
+ *
+ * @param[in] data The input.
+ * @param[in] length The length of the input.
+ * @param[out] output The lowercased token (at least `length` bytes).
+ * @return The length of the token (the position of the first byte which is not a `tchar` or `length`).
+ */
+size_t HTTPSimd::lowerToken(const char *data, size_t length, char *output){
+  return __kernels.lowerToken(data, length, output);
+}
+
+/**
+ * @brief Verify the variants.
+ *
+ * This method is responsible to run every kernel of every variant supported by the CPU against the scalar
+ * reference with generated inputs (all byte values, lengths and alignments around the vector widths).
+ *
+ * @return `true` if every variant matches the scalar reference.
+ */
+bool HTTPSimd::verify(){
+  kernels_t reference;
+  kernels_t kernels;
+  __variant(HTTPSimd::SCALAR, reference);
+  for (int level = HTTPSimd::SCALAR; level <= HTTPSimd::AVX2; level++){
+    if (!__variant(static_cast<HTTPSimd::level_t>(level), kernels)) continue;
+    if (!__verify(reference, kernels)) return false;
+  }
+  return true;
+}
@@ -0,0 +1,269 @@
+/*
+ * $Id: http-timer-wheel.cpp,v 1.0.0 2026/10/18 14:10:26 Jaya Wikrama Exp $
+ *
+ * Copyright (c) 2024 Jaya Wikrama
+ * jayawikrama89@gmail.com
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *  claim that you wrote the original software. If you use this software
+ *  in a product, an acknowledgment in the product documentation would be
+ *  appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *  misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include <climits>
+#include <time.h>
+#include "http-timer-wheel.hpp"
+
+#define SLOT_BITS 8
+#define SLOT_MASK (HTTP_TIMER_WHEEL_SLOT - 1)
+
+/**
+ * @brief Default constructor for idle timer.
+ *
+ * @param[in] data The user data (e.g. the connection), available in the expired handler.
+ */
+HTTPTimer::HTTPTimer(void *data){
+  this->kind = HTTPTimer::HEADER_READ;
+  this->data = data;
+  this->next = nullptr;
+  this->prev = nullptr;
+  this->wheel = nullptr;
+  this->expire = 0;
+}
+
+/**
+ * @brief Destructor.
+ *
+ * This method is responsible to cancel the timer if it is still scheduled.
+ */
+HTTPTimer::~HTTPTimer(){
+  if (this->wheel != nullptr) this->wheel->cancel(*this);
+}
+
+/**
+ * @brief Check the timer state.
+ *
+ * @return `true` if the timer is scheduled.
+ * @return `false` if the timer is idle (cancelled or expired).
+ */
+bool HTTPTimer::isPending() const {
+  return (this->wheel != nullptr);
+}
+
+/**
+ * @brief Default constructor.
+ *
+ * @param[in] resolution The tick length in milliseconds.
+ */
+HTTPTimerWheel::HTTPTimerWheel(uint64_t resolution){
+  for (int level = 0; level < HTTP_TIMER_WHEEL_LEVEL; level++){
+    for (int i = 0; i < HTTP_TIMER_WHEEL_SLOT; i++) this->slot[level][i] = nullptr;
+  }
+  this->timeout[HTTPTimer::HEADER_READ] = HTTP_TIMEOUT_HEADER_READ;
+  this->timeout[HTTPTimer::KEEP_ALIVE] = HTTP_TIMEOUT_KEEP_ALIVE;
+  this->timeout[HTTPTimer::WRITE_STALL] = HTTP_TIMEOUT_WRITE_STALL;
+  this->timeout[HTTPTimer::EVENT_PING] = HTTP_TIMEOUT_EVENT_PING;
+  this->resolution = (resolution > 0 ? resolution : 1);
+  /* current is the next tick to be processed */
+  this->current = HTTPTimerWheel::now() / this->resolution + 1;
+  this->count = 0;
+}
+
+/**
+ * @brief Destructor.
+ *
+ * This method is responsible to detach all scheduled timers.
+ */
+HTTPTimerWheel::~HTTPTimerWheel(){
+  for (int level = 0; level < HTTP_TIMER_WHEEL_LEVEL; level++){
+    for (int i = 0; i < HTTP_TIMER_WHEEL_SLOT; i++){
+      while (this->slot[level][i] != nullptr){
+        HTTPTimer *timer = this->slot[level][i];
+        this->unlink(*timer);
+        timer->wheel = nullptr;
+      }
+    }
+  }
+}
+
+/**
+ * @brief Set the timeout of the timer kind.
+ *
+ * @param[in] kind The timer kind.
+ * @param[in] timeout The timeout in milliseconds.
+ */
+void HTTPTimerWheel::setTimeout(HTTPTimer::kind_t kind, uint64_t timeout){
+  if (kind < 0 || kind >= HTTPTimer::SZ_KIND) return;
+  this->timeout[kind] = timeout;
+}
+
+void HTTPTimerWheel::link(HTTPTimer &timer){
+  uint64_t delta = (timer.expire > this->current ? timer.expire - this->current : 0);
+  int level = 0;
+  if (delta >= (1ULL << (SLOT_BITS * HTTP_TIMER_WHEEL_LEVEL))){
+    /* beyond the wheel range, the timer is re-linked by the cascade until it really expires */
+    delta = (1ULL << (SLOT_BITS * HTTP_TIMER_WHEEL_LEVEL)) - 1;
+  }
+  while (level < HTTP_TIMER_WHEEL_LEVEL - 1 && delta >= (1ULL << (SLOT_BITS * (level + 1)))) level++;
+  uint64_t expire = (timer.expire > this->current ? this->current + delta : this->current);
+  HTTPTimer **head = &this->slot[level][(expire >> (SLOT_BITS * level)) & SLOT_MASK];
+  timer.next = *head;
+  if (timer.next != nullptr) timer.next->prev = &timer.next;
+  timer.prev = head;
+  *head = &timer;
+}
+
+void HTTPTimerWheel::unlink(HTTPTimer &timer){
+  *timer.prev = timer.next;
+  if (timer.next != nullptr) timer.next->prev = timer.prev;
+  timer.prev = nullptr;
+  timer.next = nullptr;
+}
+
+void HTTPTimerWheel::cascade(int level){
+  HTTPTimer *list = this->slot[level][(this->current >> (SLOT_BITS * level)) & SLOT_MASK];
+  this->slot[level][(this->current >> (SLOT_BITS * level)) & SLOT_MASK] = nullptr;
+  while (list != nullptr){
+    HTTPTimer *timer = list;
+    list = timer->next;
+    this->link(*timer);
+  }
+}
+
+/**
+ * @brief Schedule or reset the timer.
+ *
+ * This method is responsible to (re)schedule the timer to expire after the timeout of the kind. A scheduled timer
+ * is moved, so resetting a keep-alive timer is O(1). The header read timer should be scheduled once per request
+ * and not reset on every received byte, otherwise a slow client keeps the connection open forever.
+ *
+ * @param[in] timer The timer.
+ * @param[in] kind The timer kind.
+ */
+void HTTPTimerWheel::schedule(HTTPTimer &timer, HTTPTimer::kind_t kind){
+  if (kind < 0 || kind >= HTTPTimer::SZ_KIND) return;
+  this->schedule(timer, kind, this->timeout[kind]);
+}
+
+/**
+ * @brief Schedule or reset the timer with explicit timeout.
+ *
+ * The timeout counts from the current time, also if `advance` was not called for a while.
+ *
+ * @param[in] timer The timer.
+ * @param[in] kind The timer kind.
+ * @param[in] timeout The timeout in milliseconds.
+ */
+void HTTPTimerWheel::schedule(HTTPTimer &timer, HTTPTimer::kind_t kind, uint64_t timeout){
+  if (timer.wheel != nullptr) timer.wheel->cancel(timer);
+  timer.kind = kind;
+  /* the wheel lags behind the clock between the calls of advance, the current tick is taken from the clock */
+  uint64_t tick = HTTPTimerWheel::now() / this->resolution + 1;
+  if (tick < this->current) tick = this->current;
+  timer.expire = tick + (timeout + this->resolution - 1) / this->resolution;
+  timer.wheel = this;
+  this->link(timer);
+  this->count++;
+}
+
+/**
+ * @brief Cancel the timer.
+ *
+ * @param[in] timer The timer (cancelling an idle timer has no effect).
+ */
+void HTTPTimerWheel::cancel(HTTPTimer &timer){
+  if (timer.wheel != this) return;
+  this->unlink(timer);
+  timer.wheel = nullptr;
+  this->count--;
+}
+
+/**
+ * @brief Expire the timers.
+ *
+ * This method is responsible to move the wheel to the time and call the handler for every expired timer. The timer
+ * is idle when the handler is called, so the handler may schedule it again or destroy it.
+ *
+ * @param[in] now The current time in milliseconds (see `now`).
+ * @param[in] handler The expired handler.
+ * @param[in] context The handler context.
+ * @return The number of expired timers.
+ */
+size_t HTTPTimerWheel::advance(uint64_t now, HTTPTimerWheel::handler_t handler, void *context){
+  uint64_t target = now / this->resolution;
+  size_t expired = 0;
+  while (this->current <= target){
+    if (this->count == 0){
+      this->current = target + 1;
+      break;
+    }
+    for (int level = 1; level < HTTP_TIMER_WHEEL_LEVEL; level++){
+      if (((this->current >> (SLOT_BITS * (level - 1))) & SLOT_MASK) != 0) break;
+      this->cascade(level);
+    }
+    /* the expired list is detached first, so the handler can re-schedule or cancel any timer */
+    HTTPTimer *pending = this->slot[0][this->current & SLOT_MASK];
+    this->slot[0][this->current & SLOT_MASK] = nullptr;
+    if (pending != nullptr) pending->prev = &pending;
+    this->current++;
+    while (pending != nullptr){
+      HTTPTimer *timer = pending;
+      this->unlink(*timer);
+      timer->wheel = nullptr;
+      this->count--;
+      expired++;
+      if (handler != nullptr) handler(*timer, context);
+    }
+  }
+  return expired;
+}
+
+/**
+ * @brief Gets the wait timeout for the event loop.
+ *
+ * This method is responsible to get the time until the wheel must be advanced. It never sleeps past the next
+ * expiry, but it may return earlier (at the next cascade of the upper levels).
+ *
+ * @param[in] now The current time in milliseconds (see `now`).
+ * @return The timeout in milliseconds or `-1` if no timer is scheduled.
+ */
+int HTTPTimerWheel::getTimeout(uint64_t now) const {
+  if (this->count == 0) return -1;
+  /* stop at the first block boundary, the upper levels are cascaded there */
+  uint64_t tick = this->current;
+  while ((tick & SLOT_MASK) != 0 && this->slot[0][tick & SLOT_MASK] == nullptr) tick++;
+  uint64_t at = tick * this->resolution;
+  if (at <= now) return 0;
+  return (at - now > INT_MAX ? INT_MAX : static_cast<int>(at - now));
+}
+
+/**
+ * @brief Gets the number of scheduled timers.
+ *
+ * @return The number of scheduled timers.
+ */
+size_t HTTPTimerWheel::size() const {
+  return this->count;
+}
+
+/**
+ * @brief Gets the monotonic time.
+ *
+ * @return The coarse monotonic time in milliseconds.
+ */
+uint64_t HTTPTimerWheel::now(){
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+  return static_cast<uint64_t>(ts.tv_sec) * 1000ULL + static_cast<uint64_t>(ts.tv_nsec) / 1000000ULL;
+}
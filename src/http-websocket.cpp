@@ -0,0 +1,553 @@
+/*
+ * $Id: http-websocket.cpp,v 1.0.0 2026/10/18 15:52:31 Jaya Wikrama Exp $
+ *
+ * Copyright (c) 2024 Jaya Wikrama
+ * jayawikrama89@gmail.com
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *  claim that you wrote the original software. If you use this software
+ *  in a product, an acknowledgment in the product documentation would be
+ *  appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *  misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include <cerrno>
+#include <cstring>
+#include <strings.h>
+#include <sys/random.h>
+#include "http-websocket.hpp"
+#include "http-simd.hpp"
+
+static const char __guid[] = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+static const char __base64[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+static uint32_t __rotate(uint32_t value, int bits){
+  return (value << bits) | (value >> (32 - bits));
+}
+
+static void __sha1(const std::string &text, uint8_t digest[20]){
+  uint32_t h[5] = { 0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0 };
+  std::string data = text;
+  uint64_t bits = static_cast<uint64_t>(text.length()) * 8;
+  data.push_back(static_cast<char>(0x80));
+  while (data.length() % 64 != 56) data.push_back('\0');
+  for (int shift = 56; shift >= 0; shift -= 8) data.push_back(static_cast<char>(bits >> shift));
+  for (size_t block = 0; block < data.length(); block += 64){
+    uint32_t w[80];
+    for (int i = 0; i < 16; i++){
+      const uint8_t *p = reinterpret_cast<const uint8_t *>(data.data() + block + i * 4);
+      w[i] = (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) | (static_cast<uint32_t>(p[2]) << 8) | p[3];
+    }
+    for (int i = 16; i < 80; i++) w[i] = __rotate(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+    uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+    for (int i = 0; i < 80; i++){
+      uint32_t f, k;
+      if (i < 20){ f = (b & c) | (~b & d); k = 0x5A827999; }
+      else if (i < 40){ f = b ^ c ^ d; k = 0x6ED9EBA1; }
+      else if (i < 60){ f = (b & c) | (b & d) | (c & d); k = 0x8F1BBCDC; }
+      else { f = b ^ c ^ d; k = 0xCA62C1D6; }
+      uint32_t temp = __rotate(a, 5) + f + e + k + w[i];
+      e = d;
+      d = c;
+      c = __rotate(b, 30);
+      b = a;
+      a = temp;
+    }
+    h[0] += a;
+    h[1] += b;
+    h[2] += c;
+    h[3] += d;
+    h[4] += e;
+  }
+  for (int i = 0; i < 20; i++) digest[i] = static_cast<uint8_t>(h[i / 4] >> (24 - (i % 4) * 8));
+}
+
+static std::string __encodeBase64(const uint8_t *data, size_t length){
+  std::string result;
+  result.reserve((length + 2) / 3 * 4);
+  for (size_t i = 0; i < length; i += 3){
+    uint32_t chunk = static_cast<uint32_t>(data[i]) << 16;
+    if (i + 1 < length) chunk |= static_cast<uint32_t>(data[i + 1]) << 8;
+    if (i + 2 < length) chunk |= data[i + 2];
+    result.push_back(__base64[(chunk >> 18) & 0x3F]);
+    result.push_back(__base64[(chunk >> 12) & 0x3F]);
+    result.push_back(i + 1 < length ? __base64[(chunk >> 6) & 0x3F] : '=');
+    result.push_back(i + 2 < length ? __base64[chunk & 0x3F] : '=');
+  }
+  return result;
+}
+
+static std::string __trim(const std::string &text){
+  size_t first = text.find_first_not_of(" \t");
+  if (first == std::string::npos) return std::string();
+  size_t last = text.find_last_not_of(" \t");
+  return text.substr(first, last - first + 1);
+}
+
+static bool __value(const HTTPHeader &request, HeaderNode::headerField_t field, std::string &value){
+  HeaderNode *node = request.getNode(field);
+  if (node == nullptr) return false;
+  value = __trim(node->getValue());
+  return true;
+}
+
+static bool __hasToken(const std::string &value, const char *token){
+  size_t length = strlen(token);
+  size_t start = 0;
+  while (start <= value.length()){
+    size_t end = value.find(',', start);
+    if (end == std::string::npos) end = value.length();
+    std::string item = __trim(value.substr(start, end - start));
+    if (item.length() == length && strncasecmp(item.c_str(), token, length) == 0) return true;
+    start = end + 1;
+  }
+  return false;
+}
+
+static bool __isKey(const std::string &key){
+  /* base64 of 16 bytes */
+  if (key.length() != 24 || key.compare(22, 2, "==") != 0) return false;
+  for (size_t i = 0; i < 22; i++){
+    if (strchr(__base64, key[i]) == nullptr) return false;
+  }
+  return true;
+}
+
+/* the masking keys must be unpredictable (RFC 6455 section 10.3), one getrandom call fills the keys of 64 frames */
+static void __randomKey(uint8_t key[4]){
+  thread_local uint8_t pool[256];
+  thread_local size_t used = sizeof(pool);
+  if (used + 4 > sizeof(pool)){
+    size_t filled = 0;
+    while (filled < sizeof(pool)){
+      ssize_t ret = getrandom(pool + filled, sizeof(pool) - filled, 0);
+      if (ret < 0){
+        if (errno == EINTR) continue;
+        break;
+      }
+      filled += static_cast<size_t>(ret);
+    }
+    used = 0;
+  }
+  memcpy(key, pool + used, 4);
+  used += 4;
+}
+
+/*
+ * the length of the valid UTF-8 prefix, an incomplete sequence at the end is not counted (the next fragment may
+ * complete it). `valid` is cleared on the first byte which can not be part of a well-formed sequence
+ */
+static size_t __utf8(const uint8_t *data, size_t length, bool &valid){
+  size_t pos = 0;
+  valid = true;
+  while (pos < length){
+    if (pos + 8 <= length){
+      uint64_t word;
+      memcpy(&word, data + pos, 8);
+      if ((word & 0x8080808080808080ULL) == 0){
+        pos += 8;
+        continue;
+      }
+    }
+    uint8_t c = data[pos];
+    if (c < 0x80){
+      pos++;
+      continue;
+    }
+    size_t need = 0;
+    uint8_t low = 0x80;
+    uint8_t high = 0xBF;
+    if (c >= 0xC2 && c <= 0xDF) need = 1;
+    else if (c >= 0xE0 && c <= 0xEF){
+      need = 2;
+      if (c == 0xE0) low = 0xA0;
+      else if (c == 0xED) high = 0x9F;
+    }
+    else if (c >= 0xF0 && c <= 0xF4){
+      need = 3;
+      if (c == 0xF0) low = 0x90;
+      else if (c == 0xF4) high = 0x8F;
+    }
+    else {
+      valid = false;
+      return pos;
+    }
+    for (size_t i = 1; i <= need; i++){
+      if (pos + i >= length) return pos;
+      if (data[pos + i] < low || data[pos + i] > high){
+        valid = false;
+        return pos;
+      }
+      low = 0x80;
+      high = 0xBF;
+    }
+    pos += need + 1;
+  }
+  return pos;
+}
+
+static size_t __headLength(const uint8_t *head, size_t length){
+  if (length < 2) return 2;
+  size_t size = 2;
+  uint8_t code = head[1] & 0x7F;
+  if (code == 126) size += 2;
+  else if (code == 127) size += 8;
+  if (head[1] & 0x80) size += 4;
+  return size;
+}
+
+
+/**
+ * @brief Custom constructor.
+ *
+ * @param[in] server `true` for the server side (the received frames must be masked) or `false` for the client
+ * side (the received frames must not be masked).
+ * @param[in] maxMessage The maximum size of the reassembled message.
+ */
+HTTPWebSocket::HTTPWebSocket(bool server, size_t maxMessage){
+  this->server = server;
+  this->maxMessage = maxMessage;
+  this->state = HTTPWebSocket::HEAD;
+  this->headLength = 0;
+  this->fin = false;
+  this->opcode = HTTPWebSocket::CONTINUATION;
+  memset(this->key, 0, sizeof(this->key));
+  this->masked = false;
+  this->remaining = 0;
+  this->offset = 0;
+  this->messageOpcode = HTTPWebSocket::CONTINUATION;
+  this->fragmented = false;
+  this->validated = 0;
+  this->closeCode = 0;
+}
+
+bool HTTPWebSocket::fail(HTTPWebSocket::close_t code){
+  this->closeCode = static_cast<uint16_t>(code);
+  this->state = HTTPWebSocket::FAILED;
+  return false;
+}
+
+bool HTTPWebSocket::parseHead(){
+  uint8_t first = this->head[0];
+  uint8_t second = this->head[1];
+  /* no extension is negotiated, so the reserved bits must be clear */
+  if (first & 0x70) return this->fail(HTTPWebSocket::PROTOCOL_ERROR);
+  this->fin = ((first & 0x80) != 0);
+  this->opcode = static_cast<HTTPWebSocket::opcode_t>(first & 0x0F);
+  this->masked = ((second & 0x80) != 0);
+  switch (this->opcode){
+    case HTTPWebSocket::CONTINUATION:
+    case HTTPWebSocket::TEXT:
+    case HTTPWebSocket::BINARY:
+    case HTTPWebSocket::CLOSE:
+    case HTTPWebSocket::PING:
+    case HTTPWebSocket::PONG:
+      break;
+    default:
+      return this->fail(HTTPWebSocket::PROTOCOL_ERROR);
+  }
+  if (this->masked != this->server) return this->fail(HTTPWebSocket::PROTOCOL_ERROR);
+
+  uint64_t length = second & 0x7F;
+  size_t pos = 2;
+  if (length == 126){
+    length = (static_cast<uint64_t>(this->head[2]) << 8) | this->head[3];
+    pos = 4;
+  }
+  else if (length == 127){
+    length = 0;
+    for (pos = 2; pos < 10; pos++) length = (length << 8) | this->head[pos];
+    if (length >> 63) return this->fail(HTTPWebSocket::PROTOCOL_ERROR);
+  }
+  if (this->masked) memcpy(this->key, this->head + pos, 4);
+
+  if (this->opcode & 0x8){
+    if (!this->fin || length > HTTP_WEBSOCKET_MAX_CONTROL) return this->fail(HTTPWebSocket::PROTOCOL_ERROR);
+    this->control.clear();
+  }
+  else {
+    if (this->opcode == HTTPWebSocket::CONTINUATION){
+      if (!this->fragmented) return this->fail(HTTPWebSocket::PROTOCOL_ERROR);
+    }
+    else {
+      if (this->fragmented) return this->fail(HTTPWebSocket::PROTOCOL_ERROR);
+      this->messageOpcode = this->opcode;
+      this->message.clear();
+      this->validated = 0;
+    }
+    /* the message grows as the payload arrives, the declared length is not reserved up front */
+    if (length > this->maxMessage - this->message.length()) return this->fail(HTTPWebSocket::MESSAGE_TOO_BIG);
+  }
+  this->remaining = length;
+  this->offset = 0;
+  this->headLength = 0;
+  this->state = HTTPWebSocket::PAYLOAD;
+  return true;
+}
+
+bool HTTPWebSocket::complete(HTTPWebSocket::message_t handler, void *context){
+  this->state = HTTPWebSocket::HEAD;
+  bool ret = true;
+  if (this->opcode & 0x8){
+    if (this->opcode == HTTPWebSocket::CLOSE){
+      if (this->control.length() == 1) return this->fail(HTTPWebSocket::PROTOCOL_ERROR);
+      this->closeCode = HTTPWebSocket::NO_STATUS;
+      if (this->control.length() >= 2){
+        bool valid = true;
+        size_t reason = this->control.length() - 2;
+        if (__utf8(reinterpret_cast<const uint8_t *>(this->control.data() + 2), reason, valid) != reason){
+          return this->fail(HTTPWebSocket::INVALID_PAYLOAD);
+        }
+        this->closeCode = static_cast<uint16_t>((static_cast<uint8_t>(this->control[0]) << 8) | static_cast<uint8_t>(this->control[1]));
+      }
+      this->state = HTTPWebSocket::CLOSED;
+    }
+    if (handler != nullptr) ret = handler(*this, this->opcode, this->control.data(), this->control.length(), context);
+    if (this->state == HTTPWebSocket::CLOSED) return true;
+  }
+  else if (!this->fin){
+    this->fragmented = true;
+  }
+  else {
+    this->fragmented = false;
+    if (this->messageOpcode == HTTPWebSocket::TEXT && this->validated != this->message.length()){
+      return this->fail(HTTPWebSocket::INVALID_PAYLOAD);
+    }
+    if (handler != nullptr) ret = handler(*this, this->messageOpcode, this->message.data(), this->message.length(), context);
+    this->message.clear();
+  }
+  if (!ret) this->state = HTTPWebSocket::FAILED;
+  return ret;
+}
+
+/**
+ * @brief Decode the next slice of the stream.
+ *
+ * This method is responsible to decode the frames of the slice and call the handler with every complete
+ * message (`TEXT` or `BINARY`, reassembled from the fragments) and every control frame (`CLOSE`, `PING`,
+ * `PONG`, which may arrive between the fragments). The handler data is unmasked and valid until the handler
+ * returns. Nothing is decoded after the `CLOSE` frame. A `TEXT` message or a close reason which is not valid
+ * UTF-8 fails with `INVALID_PAYLOAD`, the text is validated as it arrives.
+ *
+ * @param[in] data The received data.
+ * @param[in] length The length of the received data.
+ * @param[in] handler The message handler, it may return `false` to stop the decoder.
+ * @param[in] context The handler context.
+ * @return `true` in success.
+ * @return `false` if the stream violates the protocol (see `getCloseCode`) or the handler stopped the decoder.
+ */
+bool HTTPWebSocket::feed(const char *data, size_t length, HTTPWebSocket::message_t handler, void *context){
+  size_t pos = 0;
+  while (pos < length || (this->state == HTTPWebSocket::PAYLOAD && this->remaining == 0)){
+    if (this->state == HTTPWebSocket::CLOSED) return true;
+    if (this->state == HTTPWebSocket::FAILED) return false;
+    if (this->state == HTTPWebSocket::HEAD){
+      size_t need = __headLength(this->head, this->headLength);
+      while (this->headLength < need && pos < length){
+        this->head[this->headLength++] = static_cast<uint8_t>(data[pos++]);
+        need = __headLength(this->head, this->headLength);
+      }
+      if (this->headLength < need) return true;
+      if (!this->parseHead()) return false;
+      continue;
+    }
+    size_t take = (this->remaining < length - pos ? static_cast<size_t>(this->remaining) : length - pos);
+    if (take > 0){
+      std::string &payload = ((this->opcode & 0x8) ? this->control : this->message);
+      size_t start = payload.length();
+      payload.append(data + pos, take);
+      if (this->masked) HTTPWebSocket::mask(&payload[start], take, this->key, this->offset);
+      /* the text is validated as it arrives, so an invalid message fails before the rest of it is buffered */
+      if (!(this->opcode & 0x8) && this->messageOpcode == HTTPWebSocket::TEXT){
+        bool valid = true;
+        this->validated += __utf8(reinterpret_cast<const uint8_t *>(payload.data() + this->validated), payload.length() - this->validated, valid);
+        if (!valid) return this->fail(HTTPWebSocket::INVALID_PAYLOAD);
+      }
+      this->offset += take;
+      this->remaining -= take;
+      pos += take;
+    }
+    if (this->remaining == 0 && !this->complete(handler, context)) return false;
+  }
+  return (this->state != HTTPWebSocket::FAILED);
+}
+
+/**
+ * @brief Check the closing handshake.
+ *
+ * @return `true` if the `CLOSE` frame is received.
+ * @return `false` if the stream is open.
+ */
+bool HTTPWebSocket::isClosed() const {
+  return (this->state == HTTPWebSocket::CLOSED);
+}
+
+/**
+ * @brief Gets the close code.
+ *
+ * @return The status code of the received `CLOSE` frame, or the code that should be sent to the peer after
+ * the protocol violation, or `0` if the stream is open.
+ */
+uint16_t HTTPWebSocket::getCloseCode() const {
+  return this->closeCode;
+}
+
+/**
+ * @brief Complete the handshake response.
+ *
+ * This method is responsible to validate the upgrade request (`GET`, `Upgrade: websocket`,
+ * `Connection: Upgrade`, `Sec-WebSocket-Key` and `Sec-WebSocket-Version: 13`), set the status code of the
+ * response and append the `Upgrade`, `Connection` and `Sec-WebSocket-Accept` fields.
+ *
+ * @param[in] request The request header.
+ * @param[in] response The response header.
+ * @param[in] protocol The selected subprotocol or empty string.
+ * @return `HttpStatus::SWITCHING_PROTOCOLS` in success.
+ * @return `HttpStatus::UPGRADE_REQUIRED` if the version is not supported (`Sec-WebSocket-Version: 13` is appended).
+ * @return `HttpStatus::BAD_REQUEST` if the request is not a valid upgrade request.
+ */
+HttpStatus::Code_t HTTPWebSocket::handshake(const HTTPHeader &request, HTTPHeader &response, const std::string &protocol){
+  std::string value;
+  HeaderNode *connection = request.getNode(HeaderNode::CONNECTION);
+  if (request.getMethod() != "GET" || connection == nullptr || !__hasToken(connection->getValue(), "upgrade") ||
+      !__value(request, HeaderNode::UPGRADE, value) || !__hasToken(value, "websocket")){
+    response.setHTTPStatusCode(HttpStatus::BAD_REQUEST);
+    return HttpStatus::BAD_REQUEST;
+  }
+  if (!__value(request, HeaderNode::SEC_WEBSOCKET_VERSION, value) || value != HTTP_WEBSOCKET_VERSION){
+    response.setHTTPStatusCode(HttpStatus::UPGRADE_REQUIRED);
+    response.append(HeaderNode::UPGRADE, "websocket");
+    response.append(HeaderNode::SEC_WEBSOCKET_VERSION, HTTP_WEBSOCKET_VERSION);
+    return HttpStatus::UPGRADE_REQUIRED;
+  }
+  if (!__value(request, HeaderNode::SEC_WEBSOCKET_KEY, value) || !__isKey(value)){
+    response.setHTTPStatusCode(HttpStatus::BAD_REQUEST);
+    return HttpStatus::BAD_REQUEST;
+  }
+  response.setHTTPStatusCode(HttpStatus::SWITCHING_PROTOCOLS);
+  response.remove(HeaderNode::CONNECTION);
+  response.append(HeaderNode::UPGRADE, "websocket");
+  response.append(HeaderNode::CONNECTION, "Upgrade");
+  response.append(HeaderNode::SEC_WEBSOCKET_ACCEPT, HTTPWebSocket::getAcceptKey(value));
+  if (!protocol.empty()) response.append(HeaderNode::SEC_WEBSOCKET_PROTOCOL, protocol);
+  return HttpStatus::SWITCHING_PROTOCOLS;
+}
+
+/**
+ * @brief Gets the accept key.
+ *
+ * This method is responsible to compute the `Sec-WebSocket-Accept` value, base64 of the SHA-1 of the key and
+ * the WebSocket GUID.
+ *
+ * @param[in] key The `Sec-WebSocket-Key` value.
+ * @return The `Sec-WebSocket-Accept` value.
+ */
+std::string HTTPWebSocket::getAcceptKey(const std::string &key){
+  uint8_t digest[20];
+  __sha1(key + __guid, digest);
+  return __encodeBase64(digest, sizeof(digest));
+}
+
+/**
+ * @brief Append one frame.
+ *
+ * This method is responsible to append the frame header and the payload to the output. The client side
+ * frames are masked with a random key.
+ *
+ * @param[out] frame The output.
+ * @param[in] opcode The frame opcode.
+ * @param[in] data The payload.
+ * @param[in] length The payload length.
+ * @param[in] fin `false` if more fragments of the message follow.
+ * @param[in] masked `true` for the client side frame.
+ */
+void HTTPWebSocket::encode(std::string &frame, HTTPWebSocket::opcode_t opcode, const char *data, size_t length, bool fin, bool masked){
+  uint8_t head[14];
+  size_t headLength = 0;
+  uint8_t maskBit = (masked ? 0x80 : 0x00);
+  head[headLength++] = static_cast<uint8_t>((fin ? 0x80 : 0x00) | opcode);
+  if (length < 126){
+    head[headLength++] = static_cast<uint8_t>(maskBit | length);
+  }
+  else if (length <= 0xFFFF){
+    head[headLength++] = maskBit | 126;
+    head[headLength++] = static_cast<uint8_t>(length >> 8);
+    head[headLength++] = static_cast<uint8_t>(length);
+  }
+  else {
+    head[headLength++] = maskBit | 127;
+    for (int shift = 56; shift >= 0; shift -= 8) head[headLength++] = static_cast<uint8_t>(static_cast<uint64_t>(length) >> shift);
+  }
+  uint8_t key[4];
+  if (masked){
+    __randomKey(key);
+    memcpy(head + headLength, key, 4);
+    headLength += 4;
+  }
+  size_t start = frame.length() + headLength;
+  frame.reserve(start + length);
+  frame.append(reinterpret_cast<const char *>(head), headLength);
+  if (length > 0) frame.append(data, length);
+  if (masked) HTTPWebSocket::mask(&frame[start], length, key, 0);
+}
+
+/**
+ * @brief Build one shared server side frame.
+ *
+ * This method is responsible to encode the message once for any number of recipients.
+ *
+ * @param[in] opcode The frame opcode.
+ * @param[in] data The payload.
+ * @param[in] length The payload length.
+ * @return The frame.
+ */
+std::shared_ptr<const std::string> HTTPWebSocket::encode(HTTPWebSocket::opcode_t opcode, const char *data, size_t length){
+  std::shared_ptr<std::string> frame = std::make_shared<std::string>();
+  HTTPWebSocket::encode(*frame, opcode, data, length);
+  return frame;
+}
+
+/**
+ * @brief Append one close frame.
+ *
+ * @param[out] frame The output.
+ * @param[in] code The close code.
+ * @param[in] reason The close reason (truncated to fit the control frame).
+ * @param[in] masked `true` for the client side frame.
+ */
+void HTTPWebSocket::encodeClose(std::string &frame, uint16_t code, const std::string &reason, bool masked){
+  std::string payload;
+  payload.push_back(static_cast<char>(code >> 8));
+  payload.push_back(static_cast<char>(code & 0xFF));
+  payload.append(reason, 0, HTTP_WEBSOCKET_MAX_CONTROL - 2);
+  HTTPWebSocket::encode(frame, HTTPWebSocket::CLOSE, payload.data(), payload.length(), true, masked);
+}
+
+/**
+ * @brief Apply the masking key.
+ *
+ * This method is responsible to mask or unmask the data in place with `HTTPSimd::mask` (32 bytes per step with
+ * AVX2, 16 bytes per step with SSE2 and 8 bytes per step otherwise).
+ *
+ * @param[in] data The data.
+ * @param[in] length The data length.
+ * @param[in] key The masking key (wire order).
+ * @param[in] offset The position of the data in the payload.
+ */
+void HTTPWebSocket::mask(char *data, size_t length, const uint8_t key[4], size_t offset){
+  uint8_t rotated[4];
+  for (size_t i = 0; i < 4; i++) rotated[i] = key[(offset + i) & 3];
+  uint32_t pattern;
+  memcpy(&pattern, rotated, sizeof(pattern));
+  HTTPSimd::mask(data, length, pattern);
+}
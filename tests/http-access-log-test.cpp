@@ -0,0 +1,80 @@
+/*
+ * $Id: http-access-log-test.cpp,v 1.0.0 2026/10/18 23:12:27 Jaya Wikrama Exp $
+ *
+ * Copyright (c) 2024 Jaya Wikrama
+ * jayawikrama89@gmail.com
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *  claim that you wrote the original software. If you use this software
+ *  in a product, an acknowledgment in the product documentation would be
+ *  appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *  misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <unistd.h>
+#include <gtest/gtest.h>
+#include "http-access-log.hpp"
+
+class HTTPAccessLogTest : public ::testing::Test {
+  protected:
+    std::string path;
+
+    void SetUp() override {
+      char name[] = "/tmp/cwl-access-log-XXXXXX";
+      int fd = mkstemp(name);
+      ASSERT_GE(fd, 0);
+      close(fd);
+      this->path = name;
+    }
+
+    void TearDown() override {
+      unlink(this->path.c_str());
+    }
+
+    std::string read() const {
+      std::ifstream input(this->path);
+      return std::string((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+    }
+};
+
+static HTTPHeader __request(const char *method, const char *target){
+  HTTPHeader request;
+  request.setRequestLine(method, target);
+  return request;
+}
+
+TEST_F(HTTPAccessLogTest, CommonLine){
+  {
+    HTTPAccessLog log(this->path, HTTPAccessLog::COMMON, 1);
+    ASSERT_TRUE(log.log(0, __request("GET", "/index.html"), HttpStatus::OK, 2326, 10, "192.0.2.1"));
+  }
+  std::string line = this->read();
+  ASSERT_EQ(line.compare(0, 15, "192.0.2.1 - - ["), 0) << line;
+  EXPECT_NE(line.find(" +0000] \"GET /index.html HTTP/1.1\" 200 2326\n"), std::string::npos) << line;
+}
+
+TEST_F(HTTPAccessLogTest, EscapesEveryPartOfCommonLine){
+  {
+    HTTPAccessLog log(this->path, HTTPAccessLog::COMMON, 1);
+    ASSERT_TRUE(log.log(0, __request("GE\"T", "/a b"), HttpStatus::OK, 1, 10, "x\n1.2.3.4 - - [forged]"));
+  }
+  std::string line = this->read();
+  EXPECT_EQ(line.find('\n'), line.length() - 1) << line;
+  EXPECT_EQ(line.compare(0, 16, "x\\x0A1.2.3.4\\x20"), 0) << line;
+  EXPECT_NE(line.find("\"GE\\x22T /a\\x20b HTTP/1.1\""), std::string::npos) << line;
+}
@@ -0,0 +1,120 @@
+/*
+ * $Id: http-bundle-test.cpp,v 1.0.0 2026/10/18 23:48:12 Jaya Wikrama Exp $
+ *
+ * Copyright (c) 2024 Jaya Wikrama
+ * jayawikrama89@gmail.com
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *  claim that you wrote the original software. If you use this software
+ *  in a product, an acknowledgment in the product documentation would be
+ *  appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *  misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <gtest/gtest.h>
+#include "http-bundle.hpp"
+#include "http-simd.hpp"
+
+/* one asset with the identity variant only, the layout of `cwl-pack` */
+static void __pack(const std::string &path, const std::string &asset, const std::string &head, const std::string &body){
+  HTTPBundle::header_t header;
+  memset(&header, 0, sizeof(header));
+  header.magic = HTTP_BUNDLE_MAGIC;
+  header.version = HTTP_BUNDLE_VERSION;
+  header.count = 1;
+  header.slots = 2;
+  header.index = sizeof(header);
+  header.entries = header.index + 8;
+  HTTPBundle::entry_t entry;
+  memset(&entry, 0, sizeof(entry));
+  uint64_t base = header.entries + sizeof(entry);
+  entry.path = base;
+  entry.pathLength = static_cast<uint32_t>(asset.length());
+  entry.hash = HTTPSimd::crc32c(asset.data(), asset.length());
+  entry.variant[HTTPBundle::IDENTITY].head = base + asset.length();
+  entry.variant[HTTPBundle::IDENTITY].headLength = static_cast<uint32_t>(head.length());
+  entry.variant[HTTPBundle::IDENTITY].body = base + asset.length() + head.length();
+  entry.variant[HTTPBundle::IDENTITY].bodyLength = body.length();
+  header.size = base + asset.length() + head.length() + body.length();
+  uint32_t index[2] = { 0, 0 };
+  index[entry.hash & 1] = 1;
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  file.write(reinterpret_cast<const char *>(index), sizeof(index));
+  file.write(reinterpret_cast<const char *>(&entry), sizeof(entry));
+  file << asset << head << body;
+}
+
+class HTTPBundleTest : public ::testing::Test {
+  protected:
+    std::string path;
+    std::string head;
+    std::string body;
+
+    void SetUp() override {
+      char name[] = "/tmp/cwl-bundle-XXXXXX";
+      int fd = mkstemp(name);
+      ASSERT_GE(fd, 0);
+      close(fd);
+      this->path = name;
+      this->body.resize(1 << 20);
+      for (size_t i = 0; i < this->body.length(); i++) this->body[i] = static_cast<char>('a' + i % 26);
+      this->head = "HTTP/1.1 200 OK\r\nContent-Length: " + std::to_string(this->body.length()) + "\r\n\r\n";
+      __pack(this->path, "/a.txt", this->head, this->body);
+    }
+
+    void TearDown() override {
+      unlink(this->path.c_str());
+    }
+};
+
+TEST_F(HTTPBundleTest, SendResumesFromOffset){
+  HTTPBundle bundle(this->path);
+  const HTTPBundle::entry_t *asset = bundle.find("/a.txt?v=1");
+  ASSERT_NE(asset, nullptr);
+  size_t total = bundle.getLength(asset, HTTPBundle::IDENTITY);
+  ASSERT_EQ(total, this->head.length() + this->body.length());
+  EXPECT_EQ(bundle.getLength(asset, HTTPBundle::IDENTITY, true), this->head.length());
+  int fd[2];
+  ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fd), 0);
+  fcntl(fd[0], F_SETFL, fcntl(fd[0], F_GETFL) | O_NONBLOCK);
+  fcntl(fd[1], F_SETFL, fcntl(fd[1], F_GETFL) | O_NONBLOCK);
+  std::string received;
+  size_t offset = 0;
+  size_t calls = 0;
+  while (offset < total){
+    ssize_t ret = bundle.send(fd[0], asset, HTTPBundle::IDENTITY, false, offset);
+    ASSERT_GE(ret, 0);
+    offset += static_cast<size_t>(ret);
+    calls++;
+    char buffer[65536];
+    ssize_t length;
+    while ((length = read(fd[1], buffer, sizeof(buffer))) > 0) received.append(buffer, static_cast<size_t>(length));
+  }
+  close(fd[0]);
+  close(fd[1]);
+  EXPECT_GT(calls, 1u);
+  EXPECT_EQ(received, this->head + this->body);
+  errno = 0;
+  EXPECT_EQ(bundle.send(fd[0], asset, HTTPBundle::IDENTITY, false, total + 1), -1);
+  EXPECT_EQ(errno, EINVAL);
+}
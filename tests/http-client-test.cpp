@@ -0,0 +1,175 @@
+/*
+ * $Id: http-client-test.cpp,v 1.0.0 2026/10/19 10:42:18 Jaya Wikrama Exp $
+ *
+ * Copyright (c) 2024 Jaya Wikrama
+ * jayawikrama89@gmail.com
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *  claim that you wrote the original software. If you use this software
+ *  in a product, an acknowledgment in the product documentation would be
+ *  appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *  misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+
+#include <atomic>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include <poll.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <gtest/gtest.h>
+#include "http-client.hpp"
+
+/* the upstream reads one request head and writes the response in the given pieces, then closes the connection */
+class ScriptServer {
+  public:
+    explicit ScriptServer(const std::vector<std::string> &pieces) : pieces(pieces), stop(false) {
+      this->fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+      struct sockaddr_in address;
+      memset(&address, 0, sizeof(address));
+      address.sin_family = AF_INET;
+      address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+      socklen_t length = sizeof(address);
+      if (bind(this->fd, reinterpret_cast<struct sockaddr *>(&address), length) != 0 || listen(this->fd, 8) != 0 ||
+          getsockname(this->fd, reinterpret_cast<struct sockaddr *>(&address), &length) != 0){
+        throw std::runtime_error("ScriptServer: failed to listen");
+      }
+      this->port = ntohs(address.sin_port);
+      this->worker = std::thread(&ScriptServer::run, this);
+    }
+
+    ~ScriptServer(){
+      this->stop = true;
+      this->worker.join();
+      close(this->fd);
+    }
+
+    uint16_t getPort() const {
+      return this->port;
+    }
+
+  private:
+    std::vector<std::string> pieces;
+    int fd;
+    uint16_t port;
+    std::atomic<bool> stop;
+    std::thread worker;
+
+    void run(){
+      while (!this->stop){
+        struct pollfd event = { this->fd, POLLIN, 0 };
+        if (poll(&event, 1, 20) <= 0) continue;
+        int connection = accept4(this->fd, nullptr, nullptr, SOCK_CLOEXEC);
+        if (connection < 0) continue;
+        this->serve(connection);
+        close(connection);
+      }
+    }
+
+    void serve(int connection){
+      std::string input;
+      char buffer[4096];
+      while (input.find("\r\n\r\n") == std::string::npos){
+        struct pollfd event = { connection, POLLIN, 0 };
+        if (this->stop || poll(&event, 1, 20) < 0) return;
+        if (event.revents == 0) continue;
+        ssize_t ret = read(connection, buffer, sizeof(buffer));
+        if (ret <= 0) return;
+        input.append(buffer, static_cast<size_t>(ret));
+      }
+      for (const std::string &piece : this->pieces){
+        if (write(connection, piece.data(), piece.length()) != static_cast<ssize_t>(piece.length())) return;
+        /* every piece arrives in its own read */
+        usleep(20000);
+      }
+    }
+};
+
+static bool __fetch(const std::vector<std::string> &pieces, HTTPHeader &response, std::string &body){
+  ScriptServer server(pieces);
+  HTTPClient client;
+  HTTPHeader request;
+  request.setRequestLine("GET", "/");
+  request.append(HeaderNode::HOST, "127.0.0.1");
+  return client.request("127.0.0.1", server.getPort(), request, "", response, body, 2000);
+}
+
+TEST(HTTPClientTest, ReadsContentLengthBody){
+  HTTPHeader response;
+  std::string body;
+  ASSERT_TRUE(__fetch({ "HTTP/1.1 200 OK\r\nContent-Length: 5\r\n\r\nhello" }, response, body));
+  EXPECT_EQ(response.getHTTPStatusCode(), HttpStatus::OK);
+  EXPECT_EQ(body, "hello");
+}
+
+TEST(HTTPClientTest, ReadsChunkedBody){
+  HTTPHeader response;
+  std::string body;
+  ASSERT_TRUE(__fetch({
+    "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n"
+    "5\r\nhello\r\n"
+    "6 ;name=value\r\n world\r\n"
+    "0\r\nX-Trailer: done\r\n\r\n" }, response, body));
+  EXPECT_EQ(body, "hello world");
+}
+
+TEST(HTTPClientTest, ReadsCloseDelimitedBody){
+  HTTPHeader response;
+  std::string body;
+  ASSERT_TRUE(__fetch({ "HTTP/1.1 200 OK\r\nContent-Type: text/plain\r\n\r\nuntil ", "the close" }, response, body));
+  EXPECT_EQ(body, "until the close");
+}
+
+TEST(HTTPClientTest, ReadsResponseSplitAcrossReads){
+  HTTPHeader response;
+  std::string body;
+  ASSERT_TRUE(__fetch({
+    "HTTP/1.1 200 OK\r\nTransfer-",
+    "Encoding: chunked\r\n\r\n5",
+    "\r\nhel",
+    "lo\r",
+    "\n6\r\n world",
+    "\r\n0\r\n",
+    "\r\n" }, response, body));
+  EXPECT_EQ(body, "hello world");
+  ASSERT_TRUE(__fetch({ "HTTP/1.1 200 OK\r\nContent-Len", "gth: 11\r\n\r\nhello", " world" }, response, body));
+  EXPECT_EQ(body, "hello world");
+}
+
+TEST(HTTPClientTest, RejectsMalformedChunks){
+  const char *chunks[] = {
+    "5x\r\nhello\r\n0\r\n\r\n",
+    "\r\nhello\r\n0\r\n\r\n",
+    "-5\r\nhello\r\n0\r\n\r\n",
+    "10000000000000005\r\nhello\r\n0\r\n\r\n",
+    "5\r\nhelloXX0\r\n\r\n",
+    "5;\x01\r\nhello\r\n0\r\n\r\n"
+  };
+  for (const char *chunk : chunks){
+    HTTPHeader response;
+    std::string body;
+    EXPECT_FALSE(__fetch({ std::string("HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n") + chunk }, response, body)) << chunk;
+  }
+}
+
+TEST(HTTPClientTest, RejectsOversizedBody){
+  HTTPHeader response;
+  std::string body;
+  EXPECT_FALSE(__fetch({ "HTTP/1.1 200 OK\r\nContent-Length: " + std::to_string(HTTP_CLIENT_MAX_BODY + 1) + "\r\n\r\nhello" }, response, body));
+  EXPECT_FALSE(__fetch({ "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n4000001\r\n" }, response, body));
+}
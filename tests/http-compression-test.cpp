@@ -0,0 +1,119 @@
+/*
+ * $Id: http-compression-test.cpp,v 1.0.0 2026/10/19 00:04:38 Jaya Wikrama Exp $
+ *
+ * Copyright (c) 2024 Jaya Wikrama
+ * jayawikrama89@gmail.com
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *  claim that you wrote the original software. If you use this software
+ *  in a product, an acknowledgment in the product documentation would be
+ *  appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *  misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+
+#include <cstring>
+#include <random>
+#include <string>
+#include <zlib.h>
+#include <gtest/gtest.h>
+#include "http-compression.hpp"
+
+static HTTPHeader __request(){
+  HTTPHeader request;
+  request.setRequestLine("GET", "/");
+  request.append(HeaderNode::ACCEPT_ENCODING, "gzip");
+  return request;
+}
+
+static size_t __count(const HTTPHeader &header, HeaderNode::headerField_t field){
+  size_t count = 0;
+  for (HeaderNode *current = header.node; current != nullptr; current = current->next){
+    if (current->getField() == field) count++;
+  }
+  return count;
+}
+
+TEST(HTTPCompressionTest, PrepareMergesVary){
+  static const char *rows[][2] = {
+    { nullptr, "Accept-Encoding" },
+    { "Origin", "Origin, Accept-Encoding" },
+    { "origin, accept-encoding", "origin, accept-encoding" },
+    { "*", "*" }
+  };
+  for (const auto &row : rows){
+    HTTPHeader response;
+    response.append(HeaderNode::CONTENT_TYPE, "text/html");
+    if (row[0] != nullptr) response.append(HeaderNode::VARY, row[0]);
+    EXPECT_EQ(HTTPCompressor::prepare(__request(), response, 4096), HTTPCompressor::ENCODING_GZIP);
+    EXPECT_EQ(__count(response, HeaderNode::VARY), 1u);
+    EXPECT_EQ(response.getNode(HeaderNode::VARY)->getValue(), row[1]);
+  }
+}
+
+TEST(HTTPCompressionTest, CacheIsKeyedOnVersion){
+  HTTPCompressionCache cache(1 << 20);
+  std::string body(4096, 'a');
+  std::shared_ptr<const std::string> first = cache.get("/", "\"v1\"", "text/html", body, HTTPCompressor::ENCODING_GZIP);
+  ASSERT_NE(first, nullptr);
+  EXPECT_EQ(cache.get("/", "\"v1\"", "text/html", body, HTTPCompressor::ENCODING_GZIP), first);
+  std::string changed(4096, 'b');
+  std::shared_ptr<const std::string> second = cache.get("/", "\"v2\"", "text/html", changed, HTTPCompressor::ENCODING_GZIP);
+  ASSERT_NE(second, nullptr);
+  EXPECT_NE(second, first);
+  /* the key ("/", separator and encoding) and the version are charged with the data */
+  EXPECT_EQ(cache.getSize(), second->length() + 3 + 4);
+}
+
+static std::string __gunzip(const std::string &data){
+  z_stream stream;
+  memset(&stream, 0, sizeof(stream));
+  if (inflateInit2(&stream, 16 + MAX_WBITS) != Z_OK) return std::string();
+  std::string output;
+  char buffer[4096];
+  stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data.data()));
+  stream.avail_in = static_cast<uInt>(data.length());
+  int ret = Z_OK;
+  while (ret == Z_OK){
+    stream.next_out = reinterpret_cast<Bytef *>(buffer);
+    stream.avail_out = sizeof(buffer);
+    ret = inflate(&stream, Z_NO_FLUSH);
+    output.append(buffer, sizeof(buffer) - stream.avail_out);
+  }
+  inflateEnd(&stream);
+  return (ret == Z_STREAM_END ? output : std::string());
+}
+
+TEST(HTTPCompressionTest, CachedVariantDecompressesToBody){
+  HTTPCompressionCache cache(1 << 20);
+  std::string body;
+  for (int i = 0; i < 512; i++) body += "<li>item " + std::to_string(i) + "</li>\n";
+  std::shared_ptr<const std::string> variant = cache.get("/list", "\"v1\"", "text/html", body, HTTPCompressor::ENCODING_GZIP);
+  ASSERT_NE(variant, nullptr);
+  EXPECT_LT(variant->length(), body.length());
+  EXPECT_EQ(__gunzip(*variant), body);
+  EXPECT_EQ(__gunzip(*cache.get("/list", "\"v1\"", "text/html", body, HTTPCompressor::ENCODING_GZIP)), body);
+}
+
+TEST(HTTPCompressionTest, CacheBoundsUncompressibleBodies){
+  HTTPCompressionCache cache(4096);
+  std::mt19937 random(7);
+  std::string body(2048, '\0');
+  for (char &c : body) c = static_cast<char>(random());
+  for (int i = 0; i < 10000; i++){
+    std::string key = "/random/" + std::to_string(i);
+    EXPECT_EQ(cache.get(key, "\"v1\"", "text/plain", body, HTTPCompressor::ENCODING_GZIP), nullptr);
+    ASSERT_LE(cache.getSize(), static_cast<size_t>(4096));
+  }
+  EXPECT_GT(cache.getSize(), static_cast<size_t>(0));
+}
@@ -0,0 +1,130 @@
+/*
+ * $Id: http-cookie-test.cpp,v 1.0.0 2026/10/18 22:58:51 Jaya Wikrama Exp $
+ *
+ * Copyright (c) 2024 Jaya Wikrama
+ * jayawikrama89@gmail.com
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *  claim that you wrote the original software. If you use this software
+ *  in a product, an acknowledgment in the product documentation would be
+ *  appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *  misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include "http-cookie.hpp"
+
+TEST(HTTPSetCookieTest, SerializesAttributes){
+  HTTPSetCookie cookie("session", "abc123");
+  cookie.setPath("/app");
+  cookie.setDomain("example.com");
+  cookie.setMaxAge(60);
+  cookie.setSecure(true);
+  cookie.setHttpOnly(true);
+  cookie.setSameSite(HTTPSetCookie::SAME_SITE_LAX);
+  std::string payload;
+  ASSERT_TRUE(cookie.serialize(payload));
+  EXPECT_EQ(payload, "Set-Cookie: session=abc123; Path=/app; Domain=example.com; Max-Age=60; Secure; HttpOnly; SameSite=Lax\r\n");
+}
+
+TEST(HTTPSetCookieTest, AcceptsQuotedValue){
+  HTTPSetCookie cookie("id", "\"a-b\"");
+  std::string payload;
+  ASSERT_TRUE(cookie.serialize(payload));
+  EXPECT_EQ(payload, "Set-Cookie: id=\"a-b\"\r\n");
+}
+
+TEST(HTTPSetCookieTest, RefusesInjection){
+  static const char *names[] = { "", "a b", "a=b", "a;b", "a\r\nX-Injected: 1" };
+  for (const char *name : names){
+    HTTPSetCookie cookie(name, "value");
+    std::string payload("kept");
+    EXPECT_FALSE(cookie.serialize(payload)) << name;
+    EXPECT_EQ(payload, "kept");
+  }
+  static const char *values[] = { "a b", "a;Secure", "a,b", "a\"b", "a\\b", "a\r\nX-Injected: 1", "\x80" };
+  for (const char *value : values){
+    HTTPSetCookie cookie("name", value);
+    std::string payload;
+    EXPECT_FALSE(cookie.serialize(payload)) << value;
+    EXPECT_TRUE(payload.empty());
+  }
+  for (const char *attribute : { "/a; Domain=evil.example", "/a\r\nX-Injected: 1" }){
+    HTTPSetCookie path("name", "value");
+    path.setPath(attribute);
+    std::string payload;
+    EXPECT_FALSE(path.serialize(payload)) << attribute;
+    HTTPSetCookie domain("name", "value");
+    domain.setDomain(attribute);
+    EXPECT_FALSE(domain.serialize(payload)) << attribute;
+    EXPECT_TRUE(payload.empty());
+  }
+}
+
+TEST(HTTPCookieTest, ParsesPairs){
+  HTTPCookie cookie(" session=abc123;theme = \"dark\" ; ;empty=; flag; =orphan; last=x=y");
+  HTTPCookie::cookie_t pair;
+  size_t pos = 0;
+  std::vector<std::pair<std::string, std::string>> pairs;
+  while (cookie.next(pos, pair)) pairs.emplace_back(std::string(pair.name), std::string(pair.value));
+  std::vector<std::pair<std::string, std::string>> expected = {
+    { "session", "abc123" },
+    { "theme", "dark" },
+    { "empty", "" },
+    { "last", "x=y" }
+  };
+  EXPECT_EQ(pairs, expected);
+  EXPECT_FALSE(cookie.next(pos, pair));
+}
+
+TEST(HTTPCookieTest, LooksUpByName){
+  HTTPCookie cookie("a=1; flag; b=2; a=3; c=\"4\"");
+  EXPECT_EQ(cookie.get("b"), "2");
+  /* the first pair wins, answered from the index */
+  EXPECT_EQ(cookie.get("a"), "1");
+  EXPECT_EQ(cookie.get("c"), "4");
+  EXPECT_TRUE(cookie.has("c"));
+  EXPECT_FALSE(cookie.has("flag"));
+  EXPECT_FALSE(cookie.has(""));
+  EXPECT_FALSE(cookie.has("d"));
+  std::string_view value("kept");
+  EXPECT_FALSE(cookie.get("d", value));
+  EXPECT_EQ(value, "kept");
+}
+
+TEST(HTTPCookieTest, LooksUpBeyondIndex){
+  std::string raw;
+  for (size_t i = 0; i < HTTP_COOKIE_INDEX_SIZE + 4; i++){
+    if (i > 0) raw += "; ";
+    raw += "k" + std::to_string(i) + "=v" + std::to_string(i);
+  }
+  HTTPCookie cookie(raw.c_str());
+  std::string last = std::to_string(HTTP_COOKIE_INDEX_SIZE + 3);
+  EXPECT_EQ(cookie.get("k" + last), "v" + last);
+  EXPECT_EQ(cookie.get("k0"), "v0");
+  EXPECT_EQ(cookie.get("k" + last), "v" + last);
+}
+
+TEST(HTTPCookieTest, ReadsHeaderNode){
+  HTTPHeader request;
+  request.setRequestLine("GET", "/");
+  EXPECT_FALSE(HTTPCookie(request).has("session"));
+  request.append(HeaderNode::COOKIE, "session=abc123");
+  HTTPCookie cookie(request);
+  EXPECT_EQ(cookie.get("session"), "abc123");
+  EXPECT_EQ(cookie.getRaw(), "session=abc123");
+  EXPECT_FALSE(HTTPCookie(static_cast<const char *>(nullptr)).has("session"));
+}
@@ -0,0 +1,100 @@
+/*
+ * $Id: http-event-stream-test.cpp,v 1.0.0 2026/10/18 23:31:05 Jaya Wikrama Exp $
+ *
+ * Copyright (c) 2024 Jaya Wikrama
+ * jayawikrama89@gmail.com
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *  claim that you wrote the original software. If you use this software
+ *  in a product, an acknowledgment in the product documentation would be
+ *  appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *  misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+
+#include <string>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <gtest/gtest.h>
+#include "http-event-stream.hpp"
+
+class HTTPEventStreamTest : public ::testing::Test {
+  protected:
+    int fd[2];
+    HTTPTimerWheel wheel;
+    HTTPPipeline pipeline;
+
+    void SetUp() override {
+      ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, this->fd), 0);
+      int size = 4096;
+      setsockopt(this->fd[0], SOL_SOCKET, SO_SNDBUF, &size, sizeof(size));
+      setsockopt(this->fd[1], SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+      fcntl(this->fd[0], F_SETFL, fcntl(this->fd[0], F_GETFL) | O_NONBLOCK);
+      fcntl(this->fd[1], F_SETFL, fcntl(this->fd[1], F_GETFL) | O_NONBLOCK);
+    }
+
+    void TearDown() override {
+      close(this->fd[0]);
+      close(this->fd[1]);
+    }
+
+    size_t drain(){
+      char buffer[65536];
+      size_t total = 0;
+      ssize_t ret;
+      while ((ret = read(this->fd[1], buffer, sizeof(buffer))) > 0) total += static_cast<size_t>(ret);
+      return total;
+    }
+};
+
+TEST_F(HTTPEventStreamTest, BlockedStreamIsPending){
+  HTTPEventHub hub(this->wheel);
+  HTTPEventStream stream(this->pipeline, this->fd[0]);
+  hub.attach(stream);
+  std::string data(1024, 'x');
+  for (int i = 0; i < 256; i++) stream.send(data);
+  EXPECT_EQ(hub.flush(), 0u);
+  ASSERT_TRUE(stream.isPending());
+  ASSERT_EQ(hub.getPending().size(), 1u);
+  EXPECT_EQ(hub.getPending()[0], &stream);
+  /* nothing new was sent, the stream stays listed until it is written */
+  EXPECT_EQ(hub.flush(), 0u);
+  EXPECT_EQ(hub.getPending().size(), 1u);
+  size_t received = 0;
+  while (stream.isPending()){
+    received += this->drain();
+    ASSERT_GE(stream.flush(), 0);
+  }
+  received += this->drain();
+  EXPECT_EQ(stream.getQueued(), 0u);
+  EXPECT_EQ(received, HTTPEventStream::getHead().length() + 256 * (data.length() + 8));
+  EXPECT_EQ(hub.flush(), 0u);
+  EXPECT_TRUE(hub.getPending().empty());
+}
+
+TEST_F(HTTPEventStreamTest, HighWaterClosesStream){
+  HTTPEventHub hub(this->wheel);
+  HTTPEventStream stream(this->pipeline, this->fd[0], 65536);
+  hub.attach(stream);
+  std::shared_ptr<const std::string> event = std::make_shared<const std::string>("data: " + std::string(1024, 'x') + "\n\n");
+  size_t failed = 0;
+  for (int i = 0; i < 1024 && !stream.isClosed(); i++){
+    stream.send(event);
+    failed += hub.flush();
+  }
+  EXPECT_TRUE(stream.isClosed());
+  EXPECT_EQ(failed, 1u);
+  EXPECT_LE(stream.getQueued(), 65536u + event->length());
+  EXPECT_TRUE(hub.getPending().empty());
+}
@@ -0,0 +1,88 @@
+/*
+ * $Id: http-expectation-test.cpp,v 1.0.0 2026/10/19 12:41:05 Jaya Wikrama Exp $
+ *
+ * Copyright (c) 2024 Jaya Wikrama
+ * jayawikrama89@gmail.com
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *  claim that you wrote the original software. If you use this software
+ *  in a product, an acknowledgment in the product documentation would be
+ *  appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *  misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+
+#include <string>
+#include <gtest/gtest.h>
+#include "http-expectation.hpp"
+
+static HTTPHeader __request(const std::string &head){
+  HTTPHeader request;
+  EXPECT_GT(request.parse(head.c_str(), head.length()), 0) << head;
+  return request;
+}
+
+static HttpStatus::Code_t __forbidUpload(const HTTPHeader &request, void *context){
+  (void) context;
+  return (request.getTarget() == "/upload" ? HttpStatus::FORBIDDEN : HttpStatus::OK);
+}
+
+TEST(HTTPExpectationTest, AcceptsContinue){
+  HTTPExpectation expectation(1024);
+  HTTPHeader request = __request("POST /data HTTP/1.1\r\nHost: a\r\nExpect: 100-Continue\r\nContent-Length: 1024\r\n\r\n");
+  EXPECT_TRUE(HTTPExpectation::isExpectingContinue(request));
+  HttpStatus::Code_t code = expectation.evaluate(request);
+  EXPECT_EQ(code, HttpStatus::CONTINUE);
+  EXPECT_EQ(HTTPExpectation::getResponse(code), "HTTP/1.1 100 Continue\r\n\r\n");
+  /* no expectation, no interim response */
+  EXPECT_EQ(expectation.evaluate(__request("POST /data HTTP/1.1\r\nHost: a\r\nContent-Length: 10\r\n\r\n")), HttpStatus::OK);
+  /* the expectation is ignored for HTTP/1.0 */
+  HTTPHeader legacy = __request("POST /data HTTP/1.0\r\nExpect: 100-continue\r\nContent-Length: 10\r\n\r\n");
+  EXPECT_FALSE(HTTPExpectation::isExpectingContinue(legacy));
+  EXPECT_EQ(expectation.evaluate(legacy), HttpStatus::OK);
+}
+
+TEST(HTTPExpectationTest, RejectsBeforeContinue){
+  HTTPExpectation expectation(1024);
+  HttpStatus::Code_t code = expectation.evaluate(__request("POST /data HTTP/1.1\r\nHost: a\r\nExpect: 100-continue\r\nContent-Length: 1025\r\n\r\n"));
+  EXPECT_EQ(code, HttpStatus::PAYLOAD_TOO_LARGE);
+  EXPECT_EQ(HTTPExpectation::getResponse(code).substr(0, 12), "HTTP/1.1 413");
+  code = expectation.evaluate(__request("POST /data HTTP/1.1\r\nHost: a\r\nExpect: 200-ok\r\nContent-Length: 10\r\n\r\n"));
+  EXPECT_EQ(code, HttpStatus::EXPECTATION_FAILED);
+  EXPECT_EQ(HTTPExpectation::getResponse(code).substr(0, 12), "HTTP/1.1 417");
+  EXPECT_TRUE(HTTPExpectation::getResponse(HttpStatus::OK).empty());
+}
+
+TEST(HTTPExpectationTest, RejectsMalformedContentLength){
+  HTTPExpectation expectation(1024);
+  static const char *values[] = { "abc", "-1", "1 0", "12x", "99999999999999999999999" };
+  for (const char *value : values){
+    /* the head parser already refuses these, the expectation must not rely on it */
+    HTTPHeader request;
+    request.setRequestLine("POST", "/data");
+    request.append(HeaderNode::EXPECT, "100-continue");
+    request.append(HeaderNode::CONTENT_LENGTH, value);
+    HttpStatus::Code_t code = expectation.evaluate(request);
+    EXPECT_EQ(code, HttpStatus::BAD_REQUEST) << value;
+    EXPECT_EQ(HTTPExpectation::getResponse(code).substr(0, 12), "HTTP/1.1 400");
+  }
+}
+
+TEST(HTTPExpectationTest, RunsChecksInOrder){
+  HTTPExpectation expectation(1024);
+  expectation.addCheck(__forbidUpload, nullptr);
+  EXPECT_EQ(expectation.evaluate(__request("POST /upload HTTP/1.1\r\nHost: a\r\nExpect: 100-continue\r\nContent-Length: 10\r\n\r\n")), HttpStatus::FORBIDDEN);
+  EXPECT_EQ(expectation.evaluate(__request("POST /data HTTP/1.1\r\nHost: a\r\nExpect: 100-continue\r\nContent-Length: 10\r\n\r\n")), HttpStatus::CONTINUE);
+  /* the body limit is checked before the checks */
+  EXPECT_EQ(expectation.evaluate(__request("POST /upload HTTP/1.1\r\nHost: a\r\nExpect: 100-continue\r\nContent-Length: 2048\r\n\r\n")), HttpStatus::PAYLOAD_TOO_LARGE);
+}
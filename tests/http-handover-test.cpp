@@ -0,0 +1,155 @@
+/*
+ * $Id: http-handover-test.cpp,v 1.0.0 2026/10/18 22:17:36 Jaya Wikrama Exp $
+ *
+ * Copyright (c) 2024 Jaya Wikrama
+ * jayawikrama89@gmail.com
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *  claim that you wrote the original software. If you use this software
+ *  in a product, an acknowledgment in the product documentation would be
+ *  appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *  misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+
+#include <cstring>
+#include <string>
+#include <vector>
+#include <poll.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <gtest/gtest.h>
+#include "http-handover.hpp"
+#include "http-timer-wheel.hpp"
+
+/* the new process side: receive the listener, check it is the same socket, then report ready (or hang) */
+static int __next(const std::string &path, uint16_t port, bool reportReady){
+  HTTPHandover handover(path);
+  std::vector<int> listeners;
+  if (!handover.connect(listeners, 2000) || listeners.size() != 1) return 1;
+  struct sockaddr_in address;
+  socklen_t length = sizeof(address);
+  if (getsockname(listeners[0], reinterpret_cast<struct sockaddr *>(&address), &length) != 0 || ntohs(address.sin_port) != port) return 2;
+  if (!reportReady){
+    pause();
+    return 3;
+  }
+  return (handover.ready() ? 0 : 4);
+}
+
+static HTTPHandover::state_t __waitFor(HTTPHandover &handover, HTTPHandover::state_t expected, int timeout){
+  uint64_t end = HTTPTimerWheel::now() + static_cast<uint64_t>(timeout);
+  while (handover.getState() != expected && HTTPTimerWheel::now() < end){
+    struct pollfd event = { handover.getFd(), POLLIN, 0 };
+    if (event.fd >= 0 && poll(&event, 1, 10) > 0) handover.process(1000, 200);
+    else if (event.fd < 0) usleep(10000);
+    handover.check(HTTPTimerWheel::now());
+  }
+  return handover.getState();
+}
+
+class HTTPHandoverTest : public ::testing::Test {
+  protected:
+    std::string path;
+    int listener;
+    uint16_t port;
+
+    void SetUp() override {
+      char directory[] = "/tmp/cwl-handover-XXXXXX";
+      ASSERT_NE(mkdtemp(directory), nullptr);
+      this->path = std::string(directory) + "/control.sock";
+      this->listener = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+      struct sockaddr_in address;
+      memset(&address, 0, sizeof(address));
+      address.sin_family = AF_INET;
+      address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+      socklen_t length = sizeof(address);
+      ASSERT_EQ(bind(this->listener, reinterpret_cast<struct sockaddr *>(&address), length), 0);
+      ASSERT_EQ(listen(this->listener, 8), 0);
+      ASSERT_EQ(getsockname(this->listener, reinterpret_cast<struct sockaddr *>(&address), &length), 0);
+      this->port = ntohs(address.sin_port);
+    }
+
+    void TearDown() override {
+      close(this->listener);
+      unlink(this->path.c_str());
+      rmdir(this->path.substr(0, this->path.rfind('/')).c_str());
+    }
+
+    pid_t spawn(bool reportReady){
+      pid_t child = fork();
+      if (child == 0) _exit(__next(this->path, this->port, reportReady));
+      return child;
+    }
+};
+
+TEST_F(HTTPHandoverTest, HandsOverToNextProcess){
+  HTTPHandover handover(this->path);
+  ASSERT_TRUE(handover.serve({ this->listener }));
+  struct stat info;
+  ASSERT_EQ(stat(this->path.c_str(), &info), 0);
+  EXPECT_EQ(info.st_mode & 0777, 0600u);
+  pid_t child = this->spawn(true);
+  ASSERT_GT(child, 0);
+  EXPECT_EQ(__waitFor(handover, HTTPHandover::DRAINING, 5000), HTTPHandover::DRAINING);
+  int status = -1;
+  ASSERT_EQ(waitpid(child, &status, 0), child);
+  EXPECT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0) << status;
+  /* the control socket file of the old process is removed when it starts draining */
+  EXPECT_NE(access(this->path.c_str(), F_OK), 0);
+  HTTPHeader response;
+  EXPECT_TRUE(handover.prepare(response));
+  EXPECT_FALSE(handover.isExpired(HTTPTimerWheel::now()));
+}
+
+TEST_F(HTTPHandoverTest, KeepsServingWhenNextProcessHangs){
+  HTTPHandover handover(this->path);
+  ASSERT_TRUE(handover.serve({ this->listener }));
+  pid_t child = this->spawn(false);
+  ASSERT_GT(child, 0);
+  EXPECT_EQ(__waitFor(handover, HTTPHandover::HANDING_OVER, 5000), HTTPHandover::HANDING_OVER);
+  /* no READY within the 200 ms of __waitFor */
+  EXPECT_EQ(__waitFor(handover, HTTPHandover::SERVING, 5000), HTTPHandover::SERVING);
+  kill(child, SIGKILL);
+  waitpid(child, nullptr, 0);
+  EXPECT_EQ(access(this->path.c_str(), F_OK), 0);
+}
+
+TEST_F(HTTPHandoverTest, KeepsServingWhenNextProcessDies){
+  HTTPHandover handover(this->path);
+  ASSERT_TRUE(handover.serve({ this->listener }));
+  pid_t child = this->spawn(false);
+  ASSERT_GT(child, 0);
+  EXPECT_EQ(__waitFor(handover, HTTPHandover::HANDING_OVER, 5000), HTTPHandover::HANDING_OVER);
+  kill(child, SIGKILL);
+  waitpid(child, nullptr, 0);
+  EXPECT_EQ(__waitFor(handover, HTTPHandover::SERVING, 5000), HTTPHandover::SERVING);
+}
+
+TEST_F(HTTPHandoverTest, KeepsControlFileOfNextProcess){
+  {
+    HTTPHandover next(this->path);
+    {
+      HTTPHandover old(this->path);
+      ASSERT_TRUE(old.serve({ this->listener }));
+      /* the next process replaces the control socket file */
+      ASSERT_TRUE(next.serve({ this->listener }));
+    }
+    EXPECT_EQ(access(this->path.c_str(), F_OK), 0);
+  }
+  EXPECT_NE(access(this->path.c_str(), F_OK), 0);
+}
@@ -0,0 +1,61 @@
+/*
+ * $Id: http-head-index-test.cpp,v 1.0.0 2026/10/19 00:38:16 Jaya Wikrama Exp $
+ *
+ * Copyright (c) 2024 Jaya Wikrama
+ * jayawikrama89@gmail.com
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *  claim that you wrote the original software. If you use this software
+ *  in a product, an acknowledgment in the product documentation would be
+ *  appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *  misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+
+#include <string>
+#include <gtest/gtest.h>
+#include "http-head-index.hpp"
+
+/* several megabytes of heads, the LF only heads have no `\r\n\r\n` to split on */
+static std::string __capture(size_t heads, bool crlf){
+  const char *eol = (crlf ? "\r\n" : "\n");
+  std::string capture;
+  for (size_t i = 0; i < heads; i++){
+    capture += std::string("GET /") + std::to_string(i) + " HTTP/1.1" + eol;
+    capture += std::string("Host: h") + std::to_string(i % 7) + eol;
+    if (i % 3 == 0) capture += std::string("User-Agent: ua") + std::to_string(i % 5) + eol;
+    capture += std::string("X-Padding: ") + std::string(64, 'p') + eol;
+    capture += eol;
+  }
+  return capture;
+}
+
+TEST(HTTPHeadIndexTest, SplitsOnEveryEmptyRow){
+  for (bool crlf : { false, true }){
+    std::string capture = __capture(40000, crlf);
+    HTTPHeadIndex index;
+    index.assign(capture.data(), capture.length());
+    ASSERT_TRUE(index.build(4));
+    ASSERT_EQ(index.getCount(), 40000u);
+    for (size_t i : { static_cast<size_t>(0), static_cast<size_t>(12345), static_cast<size_t>(39999) }){
+      std::string_view line(capture.data() + index.getStartLines()[i].offset, index.getStartLines()[i].length);
+      EXPECT_EQ(line, "GET /" + std::to_string(i) + " HTTP/1.1");
+      EXPECT_EQ(index.getValue(HeaderNode::HOST, i), "h" + std::to_string(i % 7));
+      EXPECT_EQ(index.getValue(HeaderNode::USER_AGENT, i), (i % 3 == 0 ? "ua" + std::to_string(i % 5) : std::string()));
+    }
+    std::unordered_map<std::string_view, size_t> hosts = index.countValues(HeaderNode::HOST);
+    EXPECT_EQ(hosts.size(), 7u);
+    EXPECT_EQ(hosts["h0"], 40000u / 7 + 1);
+    EXPECT_EQ(index.countValues(HeaderNode::USER_AGENT)["ua0"], 2667u);
+  }
+}
@@ -0,0 +1,119 @@
+/*
+ * $Id: http-header-test.cpp,v 1.0.0 2026/10/18 22:41:09 Jaya Wikrama Exp $
+ *
+ * Copyright (c) 2024 Jaya Wikrama
+ * jayawikrama89@gmail.com
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *  claim that you wrote the original software. If you use this software
+ *  in a product, an acknowledgment in the product documentation would be
+ *  appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *  misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+
+#include <string>
+#include <gtest/gtest.h>
+#include "http-header.hpp"
+
+static ssize_t __parse(const std::string &raw, HttpStatus::Code_t &status){
+  HTTPHeader header;
+  return header.parse(raw.data(), raw.length(), HTTPHeader::limits_t(), status);
+}
+
+TEST(HTTPHeaderTest, RejectsMalformedRows){
+  static const char *rows[] = {
+    "Host : example.com",
+    "Host\t: example.com",
+    "Ho(st: example.com",
+    "Host example.com",
+    " Host: example.com",
+    "H\xC3\xB6st: example.com",
+    ": example.com"
+  };
+  for (const char *row : rows){
+    HttpStatus::Code_t status = HttpStatus::OK;
+    EXPECT_EQ(__parse(std::string("GET / HTTP/1.1\r\n") + row + "\r\nAccept: */*\r\n\r\n", status), -1) << row;
+    EXPECT_EQ(status, HttpStatus::BAD_REQUEST) << row;
+  }
+}
+
+TEST(HTTPHeaderTest, RejectsOverlongName){
+  HttpStatus::Code_t status = HttpStatus::OK;
+  std::string raw = "GET / HTTP/1.1\r\n" + std::string(300, 'X') + ": 1\r\n\r\n";
+  EXPECT_EQ(__parse(raw, status), -1);
+  EXPECT_EQ(status, HttpStatus::BAD_REQUEST);
+}
+
+TEST(HTTPHeaderTest, KeepsUnknownFieldNames){
+  std::string raw = "GET / HTTP/1.1\r\nHost: example.com\r\nX-Request-Id: 42\r\n\r\n";
+  HTTPHeader header;
+  HttpStatus::Code_t status = HttpStatus::OK;
+  ASSERT_EQ(header.parse(raw.data(), raw.length(), HTTPHeader::limits_t(), status), static_cast<ssize_t>(raw.length()));
+  HeaderNode *node = header.getNode("x-request-id");
+  ASSERT_NE(node, nullptr);
+  EXPECT_EQ(node->getFieldName(), "X-Request-Id");
+  EXPECT_EQ(node->getValue(), "42");
+}
+
+TEST(HTTPHeaderTest, KeepsValuesAsWritten){
+  std::string raw = "HTTP/1.1 200 OK\r\nDate: Sun, 06 Nov 1994 08:49:37 GMT\r\nStrict-Transport-Security: max-age=60\r\nAge: 12\r\n\r\n";
+  HTTPHeader header;
+  ASSERT_EQ(header.parse(raw.data(), raw.length()), static_cast<ssize_t>(raw.length()));
+  EXPECT_EQ(header.getPayload(), raw);
+  long value = 0;
+  EXPECT_TRUE(header.getNode(HeaderNode::DATE)->getDate(value));
+  EXPECT_EQ(value, 784111777);
+  EXPECT_TRUE(header.getNode(HeaderNode::AGE)->getNumber(value));
+  EXPECT_EQ(value, 12);
+}
+
+TEST(HTTPHeaderTest, RejectsMalformedContentLength){
+  std::string raw = "HTTP/1.1 200 OK\r\nContent-Length: 12x\r\n\r\n";
+  HTTPHeader header;
+  EXPECT_EQ(header.parse(raw.data(), raw.length()), -1);
+}
+
+TEST(HTTPHeaderTest, IgnoresEmptyRowsBeforeRequestLine){
+  std::string raw = "\r\n\nGET / HTTP/1.1\r\nHost: example.com\r\n\r\n";
+  HTTPHeader header;
+  HttpStatus::Code_t status = HttpStatus::OK;
+  ASSERT_EQ(header.parse(raw.data(), raw.length(), HTTPHeader::limits_t(), status), static_cast<ssize_t>(raw.length()));
+  EXPECT_EQ(header.getMethod(), "GET");
+  ASSERT_NE(header.getNode(HeaderNode::HOST), nullptr);
+}
+
+TEST(HTTPHeaderTest, ResumesScanAfterCompleteRows){
+  std::string raw = "GET / HTTP/1.1\r\nHost: example.com\r\nAccept: */*\r\nX-A: 1\r\n\r\n";
+  HTTPHeader::limits_t limits;
+  HTTPHeader::scan_t scan;
+  HttpStatus::Code_t status = HttpStatus::OK;
+  for (size_t length = 1; length < raw.length(); length++){
+    HTTPHeader header;
+    ASSERT_EQ(header.parse(raw.data(), length, limits, status, scan), 0) << length;
+    EXPECT_LE(scan.offset, length);
+    EXPECT_TRUE(scan.offset == 0 || raw[scan.offset - 1] == '\n') << length;
+  }
+  EXPECT_EQ(scan.rows, 3u);
+  HTTPHeader header;
+  ASSERT_EQ(header.parse(raw.data(), raw.length(), limits, status, scan), static_cast<ssize_t>(raw.length()));
+  EXPECT_EQ(scan.offset, 0u);
+  ASSERT_NE(header.getNode("x-a"), nullptr);
+  /* the rows counted in the earlier calls still count against the limit */
+  limits.count = 2;
+  for (size_t length = 1; length < raw.length(); length++){
+    HTTPHeader partial;
+    if (partial.parse(raw.data(), length, limits, status, scan) < 0) break;
+  }
+  EXPECT_EQ(status, HttpStatus::REQUEST_HEADER_FIELDS_TOO_LARGE);
+}
@@ -0,0 +1,158 @@
+/*
+ * $Id: http-multipart-test.cpp,v 1.0.0 2026/10/19 11:05:41 Jaya Wikrama Exp $
+ *
+ * Copyright (c) 2024 Jaya Wikrama
+ * jayawikrama89@gmail.com
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *  claim that you wrote the original software. If you use this software
+ *  in a product, an acknowledgment in the product documentation would be
+ *  appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *  misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include "http-multipart.hpp"
+
+typedef struct _part_t {
+  std::string name;
+  std::string filename;
+  std::string data;
+  bool ended;
+} part_t;
+
+static bool __onPart(HTTPMultipart &parser, HTTPHeader &header, void *context){
+  (void) parser;
+  std::vector<part_t> *parts = static_cast<std::vector<part_t> *>(context);
+  parts->push_back(part_t{ "", "", "", false });
+  HTTPMultipart::getDisposition(header, parts->back().name, parts->back().filename);
+  return true;
+}
+
+static bool __onData(HTTPMultipart &parser, const char *data, size_t length, void *context){
+  (void) parser;
+  static_cast<std::vector<part_t> *>(context)->back().data.append(data, length);
+  return true;
+}
+
+static bool __onPartEnd(HTTPMultipart &parser, void *context){
+  (void) parser;
+  static_cast<std::vector<part_t> *>(context)->back().ended = true;
+  return true;
+}
+
+/* the body is fed in slices of the given size, `false` as soon as one slice fails */
+static bool __feed(const std::string &body, size_t slice, std::vector<part_t> &parts, bool &complete){
+  HTTPMultipart parser("XyZ", __onPart, __onData, __onPartEnd, &parts);
+  for (size_t pos = 0; pos < body.length(); pos += slice){
+    size_t length = (body.length() - pos < slice ? body.length() - pos : slice);
+    if (!parser.feed(body.data() + pos, length)) return false;
+  }
+  complete = parser.isComplete();
+  return true;
+}
+
+static const std::string __body =
+  "This is the preamble, it is ignored.\r\n"
+  "--XyZ\r\n"
+  "Content-Disposition: form-data; name=\"title\"\r\n"
+  "\r\n"
+  "hello\r\n--Xy world\r\n"
+  "--XyZ  \r\n"
+  "Content-Disposition: form-data; name=\"file\"; filename=\"a.txt\"\r\n"
+  "Content-Type: text/plain\r\n"
+  "\r\n"
+  "line one\r\n-\r\nline two\r\n"
+  "--XyZ--\r\n"
+  "This is the epilogue, --XyZ\r\n it is ignored too.";
+
+TEST(HTTPMultipartTest, ParsesPartsInEverySlicing){
+  for (size_t slice = 1; slice <= __body.length(); slice++){
+    std::vector<part_t> parts;
+    bool complete = false;
+    ASSERT_TRUE(__feed(__body, slice, parts, complete)) << slice;
+    EXPECT_TRUE(complete) << slice;
+    ASSERT_EQ(parts.size(), 2u) << slice;
+    EXPECT_EQ(parts[0].name, "title");
+    EXPECT_EQ(parts[0].filename, "");
+    /* a partial delimiter inside the data is data */
+    EXPECT_EQ(parts[0].data, "hello\r\n--Xy world") << slice;
+    EXPECT_EQ(parts[1].name, "file");
+    EXPECT_EQ(parts[1].filename, "a.txt");
+    EXPECT_EQ(parts[1].data, "line one\r\n-\r\nline two") << slice;
+    EXPECT_TRUE(parts[0].ended && parts[1].ended) << slice;
+  }
+}
+
+TEST(HTTPMultipartTest, FirstDelimiterMayStartTheBody){
+  std::vector<part_t> parts;
+  bool complete = false;
+  ASSERT_TRUE(__feed("--XyZ\r\nContent-Disposition: form-data; name=a\r\n\r\nvalue\r\n--XyZ--", 3, parts, complete));
+  EXPECT_TRUE(complete);
+  ASSERT_EQ(parts.size(), 1u);
+  EXPECT_EQ(parts[0].name, "a");
+  EXPECT_EQ(parts[0].data, "value");
+}
+
+TEST(HTTPMultipartTest, IncompleteWithoutFinalDelimiter){
+  std::vector<part_t> parts;
+  bool complete = true;
+  ASSERT_TRUE(__feed("--XyZ\r\nContent-Disposition: form-data; name=a\r\n\r\nvalue\r\n--XyZ\r\n", 4, parts, complete));
+  EXPECT_FALSE(complete);
+  ASSERT_EQ(parts.size(), 1u);
+  EXPECT_TRUE(parts[0].ended);
+}
+
+TEST(HTTPMultipartTest, RejectsMalformedPartHeads){
+  const char *heads[] = {
+    "Content-Disposition form-data; name=a\r\n",
+    "Content-Disposition: form-data; name=a\r\n: no name\r\n",
+    "Content-Disposition: form-data; name=\"a\x01\"\r\n",
+    "Content-Disposition: form-data; name=a\r\nX-Test: a\rb\r\n"
+  };
+  for (const char *head : heads){
+    for (size_t slice : { static_cast<size_t>(1), static_cast<size_t>(7), static_cast<size_t>(4096) }){
+      std::vector<part_t> parts;
+      bool complete = false;
+      std::string body = std::string("--XyZ\r\n") + head + "\r\nvalue\r\n--XyZ--";
+      EXPECT_FALSE(__feed(body, slice, parts, complete)) << head << slice;
+      EXPECT_TRUE(parts.empty()) << head;
+    }
+  }
+}
+
+TEST(HTTPMultipartTest, RejectsMalformedDelimiters){
+  std::vector<part_t> parts;
+  bool complete = false;
+  EXPECT_FALSE(__feed("--XyZx\r\n\r\nvalue\r\n--XyZ--", 4096, parts, complete));
+  EXPECT_FALSE(__feed("--XyZ-x", 4096, parts, complete));
+  std::string large = "--XyZ\r\nX-Large: " + std::string(HTTP_MULTIPART_MAX_HEAD, 'a') + "\r\n\r\nvalue\r\n--XyZ--";
+  EXPECT_FALSE(__feed(large, 512, parts, complete));
+}
+
+TEST(HTTPMultipartTest, GetsBoundary){
+  HTTPHeader request;
+  request.append(HeaderNode::CONTENT_TYPE, "multipart/form-data; charset=utf-8; boundary=\"XyZ 1\"");
+  std::string boundary;
+  ASSERT_TRUE(HTTPMultipart::getBoundary(request, boundary));
+  EXPECT_EQ(boundary, "XyZ 1");
+  HTTPHeader plain;
+  plain.append(HeaderNode::CONTENT_TYPE, "text/plain; boundary=XyZ");
+  EXPECT_FALSE(HTTPMultipart::getBoundary(plain, boundary));
+  HTTPHeader empty;
+  empty.append(HeaderNode::CONTENT_TYPE, "multipart/form-data; boundary=\"\"");
+  EXPECT_FALSE(HTTPMultipart::getBoundary(empty, boundary));
+}
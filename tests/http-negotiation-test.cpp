@@ -0,0 +1,108 @@
+/*
+ * $Id: http-negotiation-test.cpp,v 1.0.0 2026/10/19 12:20:47 Jaya Wikrama Exp $
+ *
+ * Copyright (c) 2024 Jaya Wikrama
+ * jayawikrama89@gmail.com
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *  claim that you wrote the original software. If you use this software
+ *  in a product, an acknowledgment in the product documentation would be
+ *  appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *  misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+
+#include <string_view>
+#include <gtest/gtest.h>
+#include "http-negotiation.hpp"
+
+static int __select(HTTPPreferenceList::kind_t kind, std::string_view value, std::initializer_list<std::string_view> offers){
+  return HTTPNegotiation::select(kind, value, offers.begin(), offers.size());
+}
+
+TEST(HTTPNegotiationTest, SortsByQuality){
+  HTTPPreferenceList list(HTTPPreferenceList::KIND_MEDIA_TYPE, "text/plain;q=0.5, Text/HTML, application/json;q=0.8, image/png;q=1.5");
+  ASSERT_EQ(list.size(), 4u);
+  /* the same quality keeps the header order, the tokens are lower-cased and q is capped at 1 */
+  EXPECT_EQ(list.getToken(0), "text/html");
+  EXPECT_EQ(list.getToken(1), "image/png");
+  EXPECT_EQ(list.getToken(2), "application/json");
+  EXPECT_EQ(list.getQuality(static_cast<size_t>(2)), 800);
+  EXPECT_EQ(list.getToken(3), "text/plain");
+  EXPECT_EQ(list.getQuality(static_cast<size_t>(3)), 500);
+  /* malformed q-values drop the element */
+  HTTPPreferenceList malformed(HTTPPreferenceList::KIND_MEDIA_TYPE, "text/plain;q=2, text/html;q=0.5x, application/json;q=0.125");
+  ASSERT_EQ(malformed.size(), 1u);
+  EXPECT_EQ(malformed.getQuality(static_cast<size_t>(0)), 125);
+}
+
+TEST(HTTPNegotiationTest, SelectsHighestQuality){
+  EXPECT_EQ(__select(HTTPPreferenceList::KIND_MEDIA_TYPE, "application/json;q=0.9, text/html", { "application/json", "text/html" }), 1);
+  /* the same quality is decided by the server order */
+  EXPECT_EQ(__select(HTTPPreferenceList::KIND_MEDIA_TYPE, "text/html, application/json", { "application/json", "text/html" }), 0);
+  EXPECT_EQ(__select(HTTPPreferenceList::KIND_CHARSET, "iso-8859-1;q=0.2, UTF-8", { "iso-8859-1", "utf-8" }), 1);
+}
+
+TEST(HTTPNegotiationTest, ExcludesQualityZero){
+  EXPECT_EQ(__select(HTTPPreferenceList::KIND_MEDIA_TYPE, "*/*, application/json;q=0", { "application/json", "text/html" }), 1);
+  EXPECT_EQ(__select(HTTPPreferenceList::KIND_ENCODING, "gzip;q=0, br", { "gzip", "br", "identity" }), 1);
+  /* identity is acceptable unless it is excluded */
+  EXPECT_EQ(__select(HTTPPreferenceList::KIND_ENCODING, "gzip;q=0", { "gzip", "identity" }), 1);
+  EXPECT_EQ(__select(HTTPPreferenceList::KIND_ENCODING, "identity;q=0, gzip;q=0", { "gzip", "identity" }), -1);
+  EXPECT_EQ(__select(HTTPPreferenceList::KIND_ENCODING, "*;q=0", { "gzip", "identity" }), -1);
+}
+
+TEST(HTTPNegotiationTest, MatchesWildcards){
+  HTTPPreferenceList media(HTTPPreferenceList::KIND_MEDIA_TYPE, "text/*;q=0.6, */*;q=0.1, text/html");
+  EXPECT_EQ(media.getQuality("text/html"), 1000);
+  EXPECT_EQ(media.getQuality("text/plain; charset=utf-8"), 600);
+  EXPECT_EQ(media.getQuality("image/png"), 100);
+  HTTPPreferenceList language(HTTPPreferenceList::KIND_LANGUAGE, "en;q=0.5, en-gb, *;q=0.1");
+  EXPECT_EQ(language.getQuality("en-GB"), 1000);
+  EXPECT_EQ(language.getQuality("en-us"), 500);
+  EXPECT_EQ(language.getQuality("eng"), 100);
+  EXPECT_EQ(language.getQuality("de"), 100);
+  HTTPPreferenceList encoding(HTTPPreferenceList::KIND_ENCODING, "br, *;q=0.3");
+  EXPECT_EQ(encoding.getQuality("gzip"), 300);
+  EXPECT_EQ(encoding.getQuality("identity"), 300);
+}
+
+TEST(HTTPNegotiationTest, ReportsNotAcceptable){
+  EXPECT_EQ(__select(HTTPPreferenceList::KIND_MEDIA_TYPE, "image/png", { "application/json", "text/html" }), -1);
+  EXPECT_EQ(__select(HTTPPreferenceList::KIND_LANGUAGE, "fr, de;q=0.5", { "en", "en-us" }), -1);
+  EXPECT_EQ(__select(HTTPPreferenceList::KIND_MEDIA_TYPE, "text/html", { }), -1);
+  HTTPHeader request;
+  request.setRequestLine("GET", "/");
+  request.append(HeaderNode::ACCEPT, "application/xml");
+  std::string_view offers[] = { "application/json", "text/html" };
+  EXPECT_EQ(HTTPNegotiation::select(request, HeaderNode::ACCEPT, offers, 2), -1);
+  EXPECT_THROW(HTTPNegotiation::select(request, HeaderNode::HOST, offers, 2), std::runtime_error);
+}
+
+TEST(HTTPNegotiationTest, MissingFieldsAcceptDefaults){
+  HTTPHeader request;
+  request.setRequestLine("GET", "/");
+  std::string_view media[] = { "application/json", "text/html" };
+  EXPECT_EQ(HTTPNegotiation::select(request, HeaderNode::ACCEPT, media, 2), 0);
+  /* without Accept-Encoding only identity is acceptable */
+  std::string_view codings[] = { "gzip", "identity" };
+  EXPECT_EQ(HTTPNegotiation::select(request, HeaderNode::ACCEPT_ENCODING, codings, 2), 1);
+}
+
+TEST(HTTPNegotiationTest, MemoizesParsedLists){
+  const HTTPPreferenceList &first = HTTPNegotiation::getPreferences(HTTPPreferenceList::KIND_LANGUAGE, "en, de;q=0.5");
+  EXPECT_EQ(&HTTPNegotiation::getPreferences(HTTPPreferenceList::KIND_LANGUAGE, "en, de;q=0.5"), &first);
+  /* the same value of another kind is another list */
+  const HTTPPreferenceList &charset = HTTPNegotiation::getPreferences(HTTPPreferenceList::KIND_CHARSET, "en, de;q=0.5");
+  EXPECT_NE(&charset, &first);
+}
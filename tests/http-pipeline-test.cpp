@@ -0,0 +1,108 @@
+/*
+ * $Id: http-pipeline-test.cpp,v 1.0.0 2026/10/19 09:14:02 Jaya Wikrama Exp $
+ *
+ * Copyright (c) 2024 Jaya Wikrama
+ * jayawikrama89@gmail.com
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *  claim that you wrote the original software. If you use this software
+ *  in a product, an acknowledgment in the product documentation would be
+ *  appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *  misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+
+#include <cstring>
+#include <string>
+#include <gtest/gtest.h>
+#include "http-pipeline.hpp"
+
+TEST(HTTPPipelineTest, ParsesEveryHeadOfTheBuffer){
+  std::string input = "GET /a HTTP/1.1\r\nHost: x\r\n\r\nGET /b HTTP/1.1\r\nHost: x\r\n\r\nGET /c HTTP/1.1\r\nHo";
+  HTTPPipeline pipeline;
+  HTTPPipeline::batch_t batch = pipeline.parse(input.data(), input.length());
+  ASSERT_EQ(batch.count, 2u);
+  EXPECT_FALSE(batch.malformed);
+  EXPECT_EQ(batch.headers[0].getTarget(), "/a");
+  EXPECT_EQ(batch.headers[1].getTarget(), "/b");
+  EXPECT_EQ(input.substr(batch.consumed), "GET /c HTTP/1.1\r\nHo");
+}
+
+TEST(HTTPPipelineTest, StopsAfterHeadWithBody){
+  std::string input = "POST /a HTTP/1.1\r\nContent-Length: 3\r\n\r\nabcGET /b HTTP/1.1\r\n\r\n";
+  HTTPPipeline pipeline;
+  HTTPPipeline::batch_t batch = pipeline.parse(input.data(), input.length());
+  ASSERT_EQ(batch.count, 1u);
+  EXPECT_EQ(input.substr(batch.consumed, 3), "abc");
+}
+
+TEST(HTTPPipelineTest, ParsesHeadSplitAcrossReads){
+  std::string input = "GET /split HTTP/1.1\r\nHost: example.com\r\nAccept: */*\r\n\r\n";
+  HTTPPipeline pipeline;
+  std::string buffer;
+  for (size_t i = 0; i < input.length(); i++){
+    buffer.push_back(input[i]);
+    HTTPPipeline::batch_t batch = pipeline.parse(buffer.data(), buffer.length());
+    ASSERT_FALSE(batch.malformed) << i;
+    if (i + 1 < input.length()){
+      ASSERT_EQ(batch.count, 0u) << i;
+      continue;
+    }
+    ASSERT_EQ(batch.count, 1u);
+    EXPECT_EQ(batch.consumed, input.length());
+    EXPECT_EQ(batch.headers[0].getNode(HeaderNode::ACCEPT)->getValue(), "*/*");
+  }
+}
+
+TEST(HTTPPipelineTest, RejectsAmbiguousFraming){
+  static const char *inputs[] = {
+    /* the body is a request of its own if one parser takes the first length and the other the last */
+    "POST /a HTTP/1.1\r\nContent-Length: 0\r\nContent-Length: 29\r\n\r\nGET /admin HTTP/1.1\r\nX: y\r\n\r\n",
+    "POST /a HTTP/1.1\r\nContent-Length: 29\r\nContent-Length: 0\r\n\r\nGET /admin HTTP/1.1\r\nX: y\r\n\r\n",
+    "POST /a HTTP/1.1\r\nContent-Length: 5\r\nTransfer-Encoding: chunked\r\n\r\n0\r\n\r\n",
+    "POST /a HTTP/1.1\r\nContent-Length: 1x\r\n\r\n"
+  };
+  for (const char *input : inputs){
+    HTTPPipeline pipeline;
+    HTTPPipeline::batch_t batch = pipeline.parse(input, strlen(input));
+    EXPECT_EQ(batch.count, 0u) << input;
+    EXPECT_TRUE(batch.malformed) << input;
+    EXPECT_EQ(batch.status, HttpStatus::BAD_REQUEST) << input;
+  }
+  /* equal duplicates are the same framing */
+  std::string input = "POST /a HTTP/1.1\r\nContent-Length: 2\r\nContent-Length: 2\r\n\r\nab";
+  HTTPPipeline pipeline;
+  EXPECT_EQ(pipeline.parse(input.data(), input.length()).count, 1u);
+}
+
+TEST(HTTPPipelineTest, RejectsControlBytesInValues){
+  static const char *values[] = { "a\rb", "a\x01", "a\x7F" };
+  for (const char *value : values){
+    std::string input = std::string("GET / HTTP/1.1\r\nX-A: ") + value + "\r\n\r\n";
+    HTTPPipeline pipeline;
+    HTTPPipeline::batch_t batch = pipeline.parse(input.data(), input.length());
+    EXPECT_EQ(batch.count, 0u);
+    EXPECT_TRUE(batch.malformed);
+  }
+  std::string input("GET / HTTP/1.1\r\nX-A: a\0b\r\n\r\n", 29);
+  HTTPPipeline pipeline;
+  EXPECT_TRUE(pipeline.parse(input.data(), input.length()).malformed);
+}
+
+TEST(HTTPPipelineTest, TrimsOptionalWhiteSpace){
+  std::string input = "GET / HTTP/1.1\r\nX-A: \t a\tb \t\r\n\r\n";
+  HTTPPipeline pipeline;
+  HTTPPipeline::batch_t batch = pipeline.parse(input.data(), input.length());
+  ASSERT_EQ(batch.count, 1u);
+  EXPECT_EQ(batch.headers[0].getNode("x-a")->getValue(), "a\tb");
+}
@@ -0,0 +1,344 @@
+/*
+ * $Id: http-proxy-test.cpp,v 1.0.0 2026/10/18 21:32:40 Jaya Wikrama Exp $
+ *
+ * Copyright (c) 2024 Jaya Wikrama
+ * jayawikrama89@gmail.com
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *  claim that you wrote the original software. If you use this software
+ *  in a product, an acknowledgment in the product documentation would be
+ *  appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *  misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <poll.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <gtest/gtest.h>
+#include "http-proxy.hpp"
+
+/* the upstream answers every request with the received head and body as body, so the test sees what was
+ * forwarded, or with a fixed reply if one is given */
+class EchoServer {
+  public:
+    std::atomic<int> connections;
+
+    explicit EchoServer(const std::string &reply = std::string()) : connections(0), reply(reply), stop(false) {
+      this->fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+      struct sockaddr_in address;
+      memset(&address, 0, sizeof(address));
+      address.sin_family = AF_INET;
+      address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+      socklen_t length = sizeof(address);
+      if (bind(this->fd, reinterpret_cast<struct sockaddr *>(&address), length) != 0 || listen(this->fd, 8) != 0 ||
+          getsockname(this->fd, reinterpret_cast<struct sockaddr *>(&address), &length) != 0){
+        throw std::runtime_error("EchoServer: failed to listen");
+      }
+      this->port = ntohs(address.sin_port);
+      this->worker = std::thread(&EchoServer::run, this);
+    }
+
+    ~EchoServer(){
+      this->stop = true;
+      this->worker.join();
+      close(this->fd);
+    }
+
+    uint16_t getPort() const {
+      return this->port;
+    }
+
+  private:
+    int fd;
+    uint16_t port;
+    std::string reply;
+    std::atomic<bool> stop;
+    std::thread worker;
+
+    void run(){
+      while (!this->stop){
+        struct pollfd event = { this->fd, POLLIN, 0 };
+        if (poll(&event, 1, 20) <= 0) continue;
+        int connection = accept4(this->fd, nullptr, nullptr, SOCK_CLOEXEC);
+        if (connection < 0) continue;
+        this->connections++;
+        this->serve(connection);
+        close(connection);
+      }
+    }
+
+    void serve(int connection){
+      std::string input;
+      char buffer[4096];
+      while (!this->stop){
+        size_t end = input.find("\r\n\r\n");
+        if (end == std::string::npos){
+          struct pollfd event = { connection, POLLIN, 0 };
+          if (poll(&event, 1, 20) <= 0) continue;
+          ssize_t ret = read(connection, buffer, sizeof(buffer));
+          if (ret <= 0) return;
+          input.append(buffer, static_cast<size_t>(ret));
+          continue;
+        }
+        size_t length = 0;
+        size_t field = input.find("Content-Length: ");
+        if (field != std::string::npos && field < end) length = std::stoul(input.substr(field + 16));
+        if (input.length() < end + 4 + length){
+          struct pollfd event = { connection, POLLIN, 0 };
+          if (poll(&event, 1, 20) <= 0) continue;
+          ssize_t ret = read(connection, buffer, sizeof(buffer));
+          if (ret <= 0) return;
+          input.append(buffer, static_cast<size_t>(ret));
+          continue;
+        }
+        std::string head = input.substr(0, end + 4 + length);
+        input.erase(0, end + 4 + length);
+        std::string response = (!this->reply.empty() ? this->reply :
+          "HTTP/1.1 200 OK\r\n"
+          "Date: Sun, 06 Nov 1994 08:49:37 GMT\r\n"
+          "Strict-Transport-Security: max-age=31536000; includeSubDomains\r\n"
+          "X-XSS-Protection: 1; mode=block\r\n"
+          "Connection: keep-alive, X-Upstream-Hop\r\n"
+          "X-Upstream-Hop: secret\r\n"
+          "Keep-Alive: timeout=5\r\n"
+          "Content-Length: " + std::to_string(head.length()) + "\r\n"
+          "\r\n" + head);
+        if (write(connection, response.data(), response.length()) != static_cast<ssize_t>(response.length())) return;
+      }
+    }
+};
+
+static std::string __readResponse(int fd){
+  std::string output;
+  char buffer[4096];
+  for (;;){
+    size_t end = output.find("\r\n\r\n");
+    if (end != std::string::npos){
+      size_t field = output.find("Content-Length: ");
+      if (field != std::string::npos && field < end && output.length() >= end + 4 + std::stoul(output.substr(field + 16))) break;
+    }
+    struct pollfd event = { fd, POLLIN, 0 };
+    if (poll(&event, 1, 2000) <= 0) break;
+    ssize_t ret = read(fd, buffer, sizeof(buffer));
+    if (ret <= 0) break;
+    output.append(buffer, static_cast<size_t>(ret));
+  }
+  return output;
+}
+
+static std::string __readUntil(int fd, const std::string &terminator){
+  std::string output;
+  char buffer[4096];
+  while (output.find(terminator) == std::string::npos){
+    struct pollfd event = { fd, POLLIN, 0 };
+    if (poll(&event, 1, 2000) <= 0) break;
+    ssize_t ret = read(fd, buffer, sizeof(buffer));
+    if (ret <= 0) break;
+    output.append(buffer, static_cast<size_t>(ret));
+  }
+  return output;
+}
+
+static HTTPHeader __request(const char *raw){
+  HTTPHeader request;
+  EXPECT_GT(request.parse(raw, strlen(raw)), 0);
+  return request;
+}
+
+class HTTPProxyTest : public ::testing::Test {
+  protected:
+    EchoServer upstream;
+    HTTPProxy proxy;
+    int client[2];
+
+    void SetUp() override {
+      ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, this->client), 0);
+      this->proxy.addUpstream("127.0.0.1", this->upstream.getPort());
+    }
+
+    void TearDown() override {
+      close(this->client[0]);
+      close(this->client[1]);
+    }
+};
+
+TEST_F(HTTPProxyTest, RelaysResponseFieldsVerbatim){
+  HTTPHeader request = __request("GET /echo HTTP/1.1\r\nHost: example.com\r\n\r\n");
+  ASSERT_EQ(this->proxy.forward(this->client[0], request, 0, "10.0.0.1"), HTTPProxy::COMPLETE);
+  std::string response = __readResponse(this->client[1]);
+  EXPECT_NE(response.find("\r\nDate: Sun, 06 Nov 1994 08:49:37 GMT\r\n"), std::string::npos) << response;
+  EXPECT_NE(response.find("\r\nStrict-Transport-Security: max-age=31536000; includeSubDomains\r\n"), std::string::npos) << response;
+  EXPECT_NE(response.find("\r\nX-XSS-Protection: 1; mode=block\r\n"), std::string::npos) << response;
+}
+
+TEST_F(HTTPProxyTest, StripsHopByHopFields){
+  HTTPHeader request = __request(
+    "GET /echo HTTP/1.1\r\n"
+    "Host: example.com\r\n"
+    "Connection: keep-alive, X-Client-Hop\r\n"
+    "X-Client-Hop: secret\r\n"
+    "Keep-Alive: timeout=5\r\n"
+    "Upgrade: h2c\r\n"
+    "X-Forwarded-For: 192.0.2.1\r\n"
+    "\r\n");
+  ASSERT_EQ(this->proxy.forward(this->client[0], request, 0, "10.0.0.1"), HTTPProxy::COMPLETE);
+  std::string response = __readResponse(this->client[1]);
+  size_t end = response.find("\r\n\r\n");
+  ASSERT_NE(end, std::string::npos);
+  std::string head = response.substr(0, end + 2);
+  std::string forwarded = response.substr(end + 4);
+  EXPECT_EQ(head.find("Connection:"), std::string::npos) << head;
+  EXPECT_EQ(head.find("X-Upstream-Hop"), std::string::npos) << head;
+  EXPECT_EQ(head.find("Keep-Alive"), std::string::npos) << head;
+  EXPECT_EQ(forwarded.find("X-Client-Hop"), std::string::npos) << forwarded;
+  EXPECT_EQ(forwarded.find("Keep-Alive"), std::string::npos) << forwarded;
+  EXPECT_EQ(forwarded.find("Upgrade"), std::string::npos) << forwarded;
+  EXPECT_NE(forwarded.find("\r\nX-Forwarded-For: 192.0.2.1, 10.0.0.1\r\n"), std::string::npos) << forwarded;
+  EXPECT_NE(forwarded.find("\r\nX-Forwarded-Proto: http\r\n"), std::string::npos) << forwarded;
+  EXPECT_NE(forwarded.find("\r\nX-Real-IP: 10.0.0.1\r\n"), std::string::npos) << forwarded;
+}
+
+TEST_F(HTTPProxyTest, ReusesUpstreamConnection){
+  for (int i = 0; i < 3; i++){
+    HTTPHeader request = __request("GET /echo HTTP/1.1\r\nHost: example.com\r\n\r\n");
+    ASSERT_EQ(this->proxy.forward(this->client[0], request, 0, "10.0.0.1"), HTTPProxy::COMPLETE);
+    EXPECT_NE(__readResponse(this->client[1]).find("GET /echo HTTP/1.1\r\n"), std::string::npos);
+  }
+  EXPECT_EQ(this->upstream.connections.load(), 1);
+}
+
+TEST_F(HTTPProxyTest, UnknownUpstream){
+  HTTPHeader request = __request("GET / HTTP/1.1\r\nHost: example.com\r\n\r\n");
+  EXPECT_EQ(this->proxy.forward(this->client[0], request, 1, "10.0.0.1"), HTTPProxy::BAD_GATEWAY);
+}
+
+TEST_F(HTTPProxyTest, RelaysRequestBody){
+  HTTPHeader request = __request("POST /echo HTTP/1.1\r\nHost: example.com\r\nContent-Length: 11\r\n\r\n");
+  /* the first part arrived with the head, the rest is still in the client socket */
+  ASSERT_EQ(write(this->client[1], " world", 6), 6);
+  ASSERT_EQ(this->proxy.forward(this->client[0], request, 0, "10.0.0.1", false, "hello", 5), HTTPProxy::COMPLETE);
+  std::string response = __readResponse(this->client[1]);
+  EXPECT_NE(response.find("POST /echo HTTP/1.1\r\n"), std::string::npos) << response;
+  EXPECT_EQ(response.substr(response.length() - 15), "\r\n\r\nhello world") << response;
+}
+
+TEST_F(HTTPProxyTest, RejectsConnectionListingFramingFields){
+  const char *requests[] = {
+    "POST /echo HTTP/1.1\r\nHost: example.com\r\nConnection: Content-Length\r\nContent-Length: 5\r\n\r\n",
+    "GET /echo HTTP/1.1\r\nHost: example.com\r\nConnection: close, host\r\n\r\n",
+    "GET /echo HTTP/1.1\r\nHost: example.com\r\nConnection: Transfer-Encoding\r\n\r\n"
+  };
+  for (const char *raw : requests){
+    HTTPHeader request = __request(raw);
+    EXPECT_EQ(this->proxy.forward(this->client[0], request, 0, "10.0.0.1", false, "hello", 5), HTTPProxy::BAD_REQUEST) << raw;
+  }
+  EXPECT_EQ(this->upstream.connections.load(), 0);
+}
+
+TEST_F(HTTPProxyTest, RejectsDifferingContentLength){
+  HTTPHeader request = __request("POST /echo HTTP/1.1\r\nHost: example.com\r\nContent-Length: 0\r\n\r\n");
+  request.append(HeaderNode::CONTENT_LENGTH, "40");
+  EXPECT_EQ(this->proxy.forward(this->client[0], request, 0, "10.0.0.1"), HTTPProxy::BAD_REQUEST);
+  EXPECT_EQ(this->upstream.connections.load(), 0);
+
+  /* equal duplicates describe the same body */
+  request = __request("POST /echo HTTP/1.1\r\nHost: example.com\r\nContent-Length: 5\r\n\r\n");
+  request.append(HeaderNode::CONTENT_LENGTH, "5");
+  ASSERT_EQ(this->proxy.forward(this->client[0], request, 0, "10.0.0.1", false, "hello", 5), HTTPProxy::COMPLETE);
+  EXPECT_EQ(__readResponse(this->client[1]).substr(0, 15), "HTTP/1.1 200 OK");
+}
+
+TEST_F(HTTPProxyTest, RejectsControlBytesInValues){
+  HTTPHeader request = __request("GET /echo HTTP/1.1\r\nHost: example.com\r\n\r\n");
+  request.append("X-Injected", std::string("a\rGET /admin HTTP/1.1"));
+  EXPECT_EQ(this->proxy.forward(this->client[0], request, 0, "10.0.0.1"), HTTPProxy::BAD_REQUEST);
+  request = __request("GET /echo HTTP/1.1\r\nHost: example.com\r\n\r\n");
+  request.append("X-Injected", std::string("a\0b", 3));
+  EXPECT_EQ(this->proxy.forward(this->client[0], request, 0, "10.0.0.1"), HTTPProxy::BAD_REQUEST);
+  EXPECT_EQ(this->upstream.connections.load(), 0);
+}
+
+TEST(HTTPProxy, RelaysChunkedResponse){
+  std::string large(100000, 'x');
+  char size[32];
+  snprintf(size, sizeof(size), "%zx", large.length());
+  std::string body =
+    "5\r\nhello\r\n"
+    "6;ext=1\r\n world\r\n" +
+    std::string(size) + "\r\n" + large + "\r\n"
+    "0\r\n"
+    "X-Trailer: done\r\n"
+    "\r\n";
+  EchoServer upstream("HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n" + body);
+  HTTPProxy proxy;
+  proxy.addUpstream("127.0.0.1", upstream.getPort());
+  int client[2];
+  ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, client), 0);
+  std::string response;
+  std::thread reader([&](){ response = __readUntil(client[1], "X-Trailer: done\r\n\r\n"); });
+  HTTPHeader request = __request("GET /chunked HTTP/1.1\r\nHost: example.com\r\n\r\n");
+  EXPECT_EQ(proxy.forward(client[0], request, 0, "10.0.0.1"), HTTPProxy::COMPLETE);
+  reader.join();
+  size_t end = response.find("\r\n\r\n");
+  ASSERT_NE(end, std::string::npos);
+  EXPECT_NE(response.substr(0, end).find("Transfer-Encoding: chunked"), std::string::npos);
+  EXPECT_EQ(response.substr(end + 4), body);
+  close(client[0]);
+  close(client[1]);
+}
+
+TEST(HTTPProxy, FailsChunkWithoutCRLF){
+  EchoServer upstream("HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n5\r\nhelloXX0\r\n\r\n");
+  HTTPProxy proxy;
+  proxy.addUpstream("127.0.0.1", upstream.getPort());
+  int client[2];
+  ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, client), 0);
+  HTTPHeader request = __request("GET /chunked HTTP/1.1\r\nHost: example.com\r\n\r\n");
+  EXPECT_EQ(proxy.forward(client[0], request, 0, "10.0.0.1"), HTTPProxy::CLOSE);
+  EXPECT_EQ(__readUntil(client[1], "\r\n\r\n").find("hello"), std::string::npos);
+  close(client[0]);
+  close(client[1]);
+}
+
+TEST(HTTPProxy, TimesOutOnStalledUpstream){
+  /* the listener never accepts, so the connection is established but nothing is answered */
+  int listener = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  struct sockaddr_in address;
+  memset(&address, 0, sizeof(address));
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  socklen_t length = sizeof(address);
+  ASSERT_EQ(bind(listener, reinterpret_cast<struct sockaddr *>(&address), length), 0);
+  ASSERT_EQ(listen(listener, 8), 0);
+  ASSERT_EQ(getsockname(listener, reinterpret_cast<struct sockaddr *>(&address), &length), 0);
+  HTTPProxy proxy;
+  proxy.addUpstream("127.0.0.1", ntohs(address.sin_port), HTTP_PROXY_MAX_IDLE, 100);
+  int client[2];
+  ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, client), 0);
+  HTTPHeader request = __request("GET /stall HTTP/1.1\r\nHost: example.com\r\n\r\n");
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  EXPECT_EQ(proxy.forward(client[0], request, 0, "10.0.0.1"), HTTPProxy::BAD_GATEWAY);
+  EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(2));
+  close(client[0]);
+  close(client[1]);
+  close(listener);
+}
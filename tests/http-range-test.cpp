@@ -0,0 +1,192 @@
+/*
+ * $Id: http-range-test.cpp,v 1.0.0 2026/10/19 11:58:23 Jaya Wikrama Exp $
+ *
+ * Copyright (c) 2024 Jaya Wikrama
+ * jayawikrama89@gmail.com
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *  claim that you wrote the original software. If you use this software
+ *  in a product, an acknowledgment in the product documentation would be
+ *  appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *  misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <gtest/gtest.h>
+#include "http-range.hpp"
+
+static const std::string __source = "0123456789abcdefghijklmnopqrstuvwxyz";
+
+static HTTPHeader __request(const std::string &fields){
+  std::string raw = "GET /file HTTP/1.1\r\nHost: example.com\r\n" + fields + "\r\n";
+  HTTPHeader request;
+  EXPECT_GT(request.parse(raw.data(), raw.length()), 0) << raw;
+  return request;
+}
+
+/* the prepared response is sent through a socket pair and returned as it is written */
+static std::string __send(HTTPRange &range){
+  int pair[2];
+  if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, pair) != 0) return std::string();
+  std::string output;
+  char buffer[4096];
+  while (!range.isComplete()){
+    if (range.send(pair[0]) < 0) break;
+    ssize_t ret = read(pair[1], buffer, sizeof(buffer));
+    if (ret <= 0) break;
+    output.append(buffer, static_cast<size_t>(ret));
+  }
+  close(pair[0]);
+  close(pair[1]);
+  return output;
+}
+
+static std::string __body(const std::string &response){
+  size_t end = response.find("\r\n\r\n");
+  return (end == std::string::npos ? std::string() : response.substr(end + 4));
+}
+
+static void __assign(HTTPRange &range){
+  range.assign(std::make_shared<const std::string>(__source), "\"v1\"", 784111777);
+}
+
+TEST(HTTPRangeTest, ParsesRanges){
+  std::vector<HTTPRange::range_t> ranges;
+  ASSERT_EQ(HTTPRange::parse("bytes=0-9, 20-, -5", 36, ranges), HTTPRange::SATISFIABLE);
+  ASSERT_EQ(ranges.size(), 3u);
+  EXPECT_EQ(ranges[0].first, 0u);
+  EXPECT_EQ(ranges[0].last, 9u);
+  EXPECT_EQ(ranges[1].first, 20u);
+  EXPECT_EQ(ranges[1].last, 35u);
+  EXPECT_EQ(ranges[2].first, 31u);
+  EXPECT_EQ(ranges[2].last, 35u);
+  /* the ranges are clipped to the source */
+  ASSERT_EQ(HTTPRange::parse("bytes=30-99,-100", 36, ranges), HTTPRange::SATISFIABLE);
+  EXPECT_EQ(ranges[0].last, 35u);
+  EXPECT_EQ(ranges[1].first, 0u);
+  EXPECT_EQ(HTTPRange::parse("bytes=36-,-0", 36, ranges), HTTPRange::UNSATISFIABLE);
+  for (const char *value : { "items=0-1", "bytes=", "bytes=5", "bytes=5-1", "bytes=a-b", "bytes=99999999999999999999-" }){
+    EXPECT_EQ(HTTPRange::parse(value, 36, ranges), HTTPRange::INVALID) << value;
+  }
+}
+
+TEST(HTTPRangeTest, ServesSingleRange){
+  HTTPRange range;
+  __assign(range);
+  HTTPHeader response(HeaderNode::CONTENT_TYPE, "text/plain");
+  ASSERT_EQ(range.prepare(__request("Range: bytes=10-15\r\n"), response), HttpStatus::PARTIAL_CONTENT);
+  std::string output = __send(range);
+  EXPECT_NE(output.find("\r\nContent-Range: bytes 10-15/36\r\n"), std::string::npos) << output;
+  EXPECT_NE(output.find("\r\nContent-Length: 6\r\n"), std::string::npos) << output;
+  EXPECT_EQ(__body(output), "abcdef");
+
+  HTTPHeader unsatisfiable;
+  ASSERT_EQ(range.prepare(__request("Range: bytes=40-\r\n"), unsatisfiable), HttpStatus::RANGE_NOT_SATISFIABLE);
+  EXPECT_NE(__send(range).find("\r\nContent-Range: bytes */36\r\n"), std::string::npos);
+}
+
+TEST(HTTPRangeTest, EvaluatesIfRange){
+  HTTPRange range;
+  __assign(range);
+  struct {
+    const char *ifRange;
+    HttpStatus::Code_t code;
+  } cases[] = {
+    { "\"v1\"", HttpStatus::PARTIAL_CONTENT },
+    { "\"v2\"", HttpStatus::OK },
+    { "W/\"v1\"", HttpStatus::OK },
+    { "Sun, 06 Nov 1994 08:49:37 GMT", HttpStatus::PARTIAL_CONTENT },
+    { "Sun, 06 Nov 1994 08:49:38 GMT", HttpStatus::OK }
+  };
+  for (const auto &item : cases){
+    HTTPHeader response;
+    EXPECT_EQ(range.prepare(__request(std::string("Range: bytes=0-3\r\nIf-Range: ") + item.ifRange + "\r\n"), response), item.code) << item.ifRange;
+    EXPECT_EQ(__body(__send(range)), (item.code == HttpStatus::OK ? __source : std::string("0123"))) << item.ifRange;
+  }
+}
+
+TEST(HTTPRangeTest, ServesMultipartByteranges){
+  HTTPRange range;
+  __assign(range);
+  HTTPHeader response(HeaderNode::CONTENT_TYPE, "text/plain");
+  ASSERT_EQ(range.prepare(__request("Range: bytes=0-1, 10-12, -2\r\n"), response), HttpStatus::PARTIAL_CONTENT);
+  std::string output = __send(range);
+  size_t type = output.find("\r\nContent-Type: multipart/byteranges; boundary=");
+  ASSERT_NE(type, std::string::npos) << output;
+  size_t start = type + 47;
+  std::string boundary = output.substr(start, output.find("\r\n", start) - start);
+  std::string expected =
+    "\r\n--" + boundary + "\r\nContent-Type: text/plain\r\nContent-Range: bytes 0-1/36\r\n\r\n01"
+    "\r\n--" + boundary + "\r\nContent-Type: text/plain\r\nContent-Range: bytes 10-12/36\r\n\r\nabc"
+    "\r\n--" + boundary + "\r\nContent-Type: text/plain\r\nContent-Range: bytes 34-35/36\r\n\r\nyz"
+    "\r\n--" + boundary + "--\r\n";
+  EXPECT_EQ(__body(output), expected);
+  EXPECT_NE(output.find("\r\nContent-Length: " + std::to_string(expected.length()) + "\r\n"), std::string::npos) << output;
+}
+
+TEST(HTTPRangeTest, CoalescesOverlappingRanges){
+  HTTPRange range;
+  __assign(range);
+  /* overlapping and adjacent ranges become one single part response */
+  HTTPHeader response;
+  ASSERT_EQ(range.prepare(__request("Range: bytes=5-9, 0-6, 10-11\r\n"), response), HttpStatus::PARTIAL_CONTENT);
+  std::string output = __send(range);
+  EXPECT_NE(output.find("\r\nContent-Range: bytes 0-11/36\r\n"), std::string::npos) << output;
+  EXPECT_EQ(__body(output), "0123456789ab");
+
+  /* the same range repeated is sent once */
+  std::string repeated = "Range: bytes=0-35";
+  for (int i = 1; i < HTTP_RANGE_MAX; i++) repeated += ",0-35";
+  HTTPHeader full;
+  ASSERT_EQ(range.prepare(__request(repeated + "\r\n"), full), HttpStatus::PARTIAL_CONTENT);
+  EXPECT_EQ(__body(__send(range)), __source);
+
+  HTTPHeader sorted;
+  ASSERT_EQ(range.prepare(__request("Range: bytes=20-21, 0-1, 1-3\r\n"), sorted), HttpStatus::PARTIAL_CONTENT);
+  output = __send(range);
+  size_t first = output.find("Content-Range: bytes 0-3/36");
+  size_t second = output.find("Content-Range: bytes 20-21/36");
+  EXPECT_NE(first, std::string::npos) << output;
+  EXPECT_NE(second, std::string::npos) << output;
+  EXPECT_LT(first, second);
+}
+
+TEST(HTTPRangeTest, ServesFileRanges){
+  char path[] = "/tmp/cwl-range-XXXXXX";
+  int fd = mkstemp(path);
+  ASSERT_GE(fd, 0);
+  ASSERT_EQ(write(fd, __source.data(), __source.length()), static_cast<ssize_t>(__source.length()));
+  close(fd);
+  HTTPRange range;
+  ASSERT_TRUE(range.open(path));
+  EXPECT_EQ(range.getSize(), __source.length());
+  HTTPHeader single;
+  ASSERT_EQ(range.prepare(__request("Range: bytes=-3\r\n"), single), HttpStatus::PARTIAL_CONTENT);
+  EXPECT_EQ(__body(__send(range)), "xyz");
+  HTTPHeader multiple;
+  ASSERT_EQ(range.prepare(__request("Range: bytes=0-0,35-35\r\n"), multiple), HttpStatus::PARTIAL_CONTENT);
+  std::string body = __body(__send(range));
+  EXPECT_NE(body.find("Content-Range: bytes 0-0/36\r\n\r\n0\r\n"), std::string::npos) << body;
+  EXPECT_NE(body.find("Content-Range: bytes 35-35/36\r\n\r\nz\r\n"), std::string::npos) << body;
+  HTTPHeader whole;
+  ASSERT_EQ(range.prepare(__request(""), whole), HttpStatus::OK);
+  EXPECT_EQ(__body(__send(range)), __source);
+  unlink(path);
+}
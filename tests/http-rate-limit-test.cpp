@@ -0,0 +1,64 @@
+/*
+ * $Id: http-rate-limit-test.cpp,v 1.0.0 2026/10/19 00:56:44 Jaya Wikrama Exp $
+ *
+ * Copyright (c) 2024 Jaya Wikrama
+ * jayawikrama89@gmail.com
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *  claim that you wrote the original software. If you use this software
+ *  in a product, an acknowledgment in the product documentation would be
+ *  appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *  misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+
+#include <string>
+#include <gtest/gtest.h>
+#include "http-rate-limit.hpp"
+
+TEST(HTTPRateLimiterTest, FullShardEvictsInsteadOfSharing){
+  /* one shard, every key has one request per 100 seconds */
+  HTTPRateLimiter limiter(0.01, 1.0, HTTP_RATE_LIMIT_SHARD_SLOTS);
+  for (int i = 0; i < HTTP_RATE_LIMIT_SHARD_SLOTS; i++) EXPECT_EQ(limiter.admit("key" + std::to_string(i)), 0u) << i;
+  for (int i = 1; i < HTTP_RATE_LIMIT_SHARD_SLOTS; i++) EXPECT_GT(limiter.admit("key" + std::to_string(i)), 0u) << i;
+  /* the new key gets its own bucket, it does not inherit the empty budget of another key */
+  EXPECT_EQ(limiter.admit("new"), 0u);
+  EXPECT_GT(limiter.admit("new"), 0u);
+}
+
+TEST(HTTPRateLimiterTest, KeysRequestsWithoutCopies){
+  HTTPRateLimiter limiter(0.01, 1.0);
+  ASSERT_TRUE(limiter.addTrustedProxy("10.0.0.0/8"));
+  HTTPHeader request;
+  request.setRequestLine("GET", "/");
+  request.append(HeaderNode::X_FORWARDED_FOR, "192.0.2.1, 198.51.100.7, 10.0.0.2");
+  request.append(HeaderNode::X_FORWARDED_FOR, "10.0.0.3");
+  EXPECT_EQ(limiter.getClientAddress(request, "10.0.0.4"), "198.51.100.7");
+  EXPECT_EQ(limiter.getClientAddress(request, "203.0.113.9"), "203.0.113.9");
+  EXPECT_EQ(limiter.admit(request, "10.0.0.4"), 0u);
+  /* the same namespace and address as the request */
+  EXPECT_GT(limiter.admit("a:198.51.100.7"), 0u);
+  limiter.setKeyField(HeaderNode::AUTHORIZATION);
+  request.append(HeaderNode::AUTHORIZATION, "Bearer abc");
+  EXPECT_EQ(limiter.admit(request, "10.0.0.4"), 0u);
+  EXPECT_GT(limiter.admit("k:Bearer abc"), 0u);
+  HTTPHeader trusted;
+  trusted.append(HeaderNode::X_FORWARDED_FOR, "10.0.0.5, 10.0.0.6");
+  EXPECT_EQ(limiter.getClientAddress(trusted, "10.0.0.4"), "10.0.0.5");
+}
+
+TEST(HTTPRateLimiterTest, KeysNeverShareBucketsByTag){
+  /* one shard, the 16-bit tags of the busy buckets collide with some of the new keys */
+  HTTPRateLimiter limiter(0.01, 1.0, HTTP_RATE_LIMIT_SHARD_SLOTS);
+  for (int i = 0; i < 100000; i++) ASSERT_EQ(limiter.admit("client" + std::to_string(i)), 0u) << i;
+}
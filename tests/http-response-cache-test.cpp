@@ -0,0 +1,181 @@
+/*
+ * $Id: http-response-cache-test.cpp,v 1.0.0 2026/10/18 21:58:03 Jaya Wikrama Exp $
+ *
+ * Copyright (c) 2024 Jaya Wikrama
+ * jayawikrama89@gmail.com
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *  claim that you wrote the original software. If you use this software
+ *  in a product, an acknowledgment in the product documentation would be
+ *  appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *  misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+
+#include <cstring>
+#include <memory>
+#include <string>
+#include <unistd.h>
+#include <gtest/gtest.h>
+#include "http-response-cache.hpp"
+
+static HTTPHeader __parse(const std::string &raw){
+  HTTPHeader header;
+  EXPECT_GT(header.parse(raw.data(), raw.length()), 0) << raw;
+  return header;
+}
+
+static HTTPHeader __response(const char *fields){
+  return __parse(std::string("HTTP/1.1 200 OK\r\n") + fields + "Content-Length: 4\r\n\r\n");
+}
+
+TEST(HTTPResponseCacheTest, StoresAndHits){
+  HTTPResponseCache cache(1 << 20);
+  HTTPHeader request = __parse("GET /a HTTP/1.1\r\nHost: example.com\r\n\r\n");
+  HTTPHeader response = __response("Cache-Control: max-age=60\r\n");
+  ASSERT_TRUE(cache.store(request, response, "body"));
+  std::shared_ptr<const std::string> cached;
+  ASSERT_EQ(cache.lookup(request, cached), HTTPResponseCache::HIT);
+  EXPECT_NE(cached->find("\r\nAge: 0\r\n\r\nbody"), std::string::npos) << *cached;
+}
+
+TEST(HTTPResponseCacheTest, AgeGrowsWhileCached){
+  HTTPResponseCache cache(1 << 20);
+  HTTPHeader request = __parse("GET /a HTTP/1.1\r\nHost: example.com\r\n\r\n");
+  HTTPHeader response = __response("Cache-Control: max-age=60\r\nAge: 7\r\n");
+  ASSERT_TRUE(cache.store(request, response, "body"));
+  std::shared_ptr<const std::string> first;
+  ASSERT_EQ(cache.lookup(request, first), HTTPResponseCache::HIT);
+  EXPECT_NE(first->find("\r\nAge: 7\r\n"), std::string::npos) << *first;
+  usleep(1100000);
+  std::shared_ptr<const std::string> second;
+  ASSERT_EQ(cache.lookup(request, second), HTTPResponseCache::HIT);
+  EXPECT_EQ(second->find("\r\nAge: 7\r\n"), std::string::npos) << *second;
+  EXPECT_NE(second->find("\r\nAge: "), std::string::npos) << *second;
+  EXPECT_EQ(second->find("Age:"), second->rfind("Age:"));
+  /* the response of the previous hit is not changed under its sender */
+  EXPECT_NE(first->find("\r\nAge: 7\r\n"), std::string::npos) << *first;
+}
+
+TEST(HTTPResponseCacheTest, AuthorizedRequestNeedsExplicitPermission){
+  HTTPResponseCache cache(1 << 20);
+  HTTPHeader request = __parse("GET /a HTTP/1.1\r\nHost: example.com\r\nAuthorization: Bearer x\r\n\r\n");
+  HTTPHeader plain = __response("Cache-Control: max-age=60\r\n");
+  EXPECT_FALSE(cache.store(request, plain, "body"));
+  for (const char *fields : { "Cache-Control: public, max-age=60\r\n", "Cache-Control: s-maxage=60\r\n",
+      "Cache-Control: max-age=60, must-revalidate\r\n" }){
+    HTTPHeader response = __response(fields);
+    EXPECT_TRUE(cache.store(request, response, "body")) << fields;
+  }
+}
+
+TEST(HTTPResponseCacheTest, PragmaNoCache){
+  HTTPResponseCache cache(1 << 20);
+  HTTPHeader request = __parse("GET /a HTTP/1.1\r\nHost: example.com\r\n\r\n");
+  HTTPHeader response = __response("Cache-Control: max-age=60\r\n");
+  ASSERT_TRUE(cache.store(request, response, "body"));
+  std::shared_ptr<const std::string> cached;
+  HTTPHeader pragma = __parse("GET /a HTTP/1.1\r\nHost: example.com\r\nPragma: no-cache\r\n\r\n");
+  EXPECT_EQ(cache.lookup(pragma, cached), HTTPResponseCache::MISS);
+  /* Cache-Control takes precedence over Pragma */
+  HTTPHeader both = __parse("GET /a HTTP/1.1\r\nHost: example.com\r\nPragma: no-cache\r\nCache-Control: max-age=10\r\n\r\n");
+  EXPECT_EQ(cache.lookup(both, cached), HTTPResponseCache::HIT);
+}
+
+TEST(HTTPResponseCacheTest, VaryChangeReleasesOldEntries){
+  HTTPResponseCache cache(1 << 20);
+  for (const char *language : { "en", "de", "fr" }){
+    HTTPHeader request = __parse(std::string("GET /a HTTP/1.1\r\nHost: example.com\r\nAccept-Language: ") + language + "\r\n\r\n");
+    HTTPHeader response = __response("Cache-Control: max-age=60\r\nVary: Accept-Language\r\n");
+    ASSERT_TRUE(cache.store(request, response, "body"));
+  }
+  size_t before = cache.getSize();
+  HTTPHeader request = __parse("GET /a HTTP/1.1\r\nHost: example.com\r\nAccept-Encoding: gzip\r\n\r\n");
+  HTTPHeader response = __response("Cache-Control: max-age=60\r\nVary: Accept-Encoding\r\n");
+  ASSERT_TRUE(cache.store(request, response, "body"));
+  EXPECT_LT(cache.getSize(), before);
+  std::shared_ptr<const std::string> cached;
+  EXPECT_EQ(cache.lookup(request, cached), HTTPResponseCache::HIT);
+}
+
+TEST(HTTPResponseCacheTest, NotModifiedOnETagMatch){
+  HTTPResponseCache cache(1 << 20);
+  HTTPHeader request = __parse("GET /a HTTP/1.1\r\nHost: example.com\r\n\r\n");
+  HTTPHeader response = __response("Cache-Control: max-age=60\r\nETag: \"v1\"\r\n");
+  ASSERT_TRUE(cache.store(request, response, "body"));
+  std::shared_ptr<const std::string> cached;
+  for (const char *tags : { "\"v1\"", "\"v0\", W/\"v1\"", "*" }){
+    HTTPHeader conditional = __parse(std::string("GET /a HTTP/1.1\r\nHost: example.com\r\nIf-None-Match: ") + tags + "\r\n\r\n");
+    ASSERT_EQ(cache.lookup(conditional, cached), HTTPResponseCache::NOT_MODIFIED) << tags;
+    EXPECT_EQ(cached->compare(0, 13, "HTTP/1.1 304 "), 0) << *cached;
+    EXPECT_NE(cached->find("\r\nETag: \"v1\"\r\n"), std::string::npos) << *cached;
+    EXPECT_EQ(cached->find("body"), std::string::npos) << *cached;
+  }
+}
+
+TEST(HTTPResponseCacheTest, ETagMismatchServesRefreshedResponse){
+  HTTPResponseCache cache(1 << 20);
+  HTTPHeader request = __parse("GET /a HTTP/1.1\r\nHost: example.com\r\n\r\n");
+  HTTPHeader response = __response("Cache-Control: max-age=60\r\nAge: 7\r\nETag: \"v1\"\r\nLast-Modified: Sun, 06 Nov 1994 08:49:37 GMT\r\n");
+  ASSERT_TRUE(cache.store(request, response, "body"));
+  usleep(1100000);
+  /* If-Modified-Since is ignored when If-None-Match is present */
+  HTTPHeader conditional = __parse(
+    "GET /a HTTP/1.1\r\n"
+    "Host: example.com\r\n"
+    "If-None-Match: \"v2\"\r\n"
+    "If-Modified-Since: Sun, 06 Nov 1994 08:49:37 GMT\r\n"
+    "\r\n");
+  std::shared_ptr<const std::string> cached;
+  ASSERT_EQ(cache.lookup(conditional, cached), HTTPResponseCache::HIT);
+  EXPECT_EQ(cached->find("\r\nAge: 7\r\n"), std::string::npos) << *cached;
+  EXPECT_NE(cached->find("\r\nAge: "), std::string::npos) << *cached;
+  EXPECT_NE(cached->find("\r\n\r\nbody"), std::string::npos) << *cached;
+}
+
+TEST(HTTPResponseCacheTest, NotModifiedSince){
+  HTTPResponseCache cache(1 << 20);
+  HTTPHeader request = __parse("GET /a HTTP/1.1\r\nHost: example.com\r\n\r\n");
+  HTTPHeader response = __response("Cache-Control: max-age=60\r\nLast-Modified: Sun, 06 Nov 1994 08:49:37 GMT\r\n");
+  ASSERT_TRUE(cache.store(request, response, "body"));
+  std::shared_ptr<const std::string> cached;
+  for (const char *since : { "Sun, 06 Nov 1994 08:49:37 GMT", "Mon, 07 Nov 1994 08:49:37 GMT" }){
+    HTTPHeader conditional = __parse(std::string("GET /a HTTP/1.1\r\nHost: example.com\r\nIf-Modified-Since: ") + since + "\r\n\r\n");
+    ASSERT_EQ(cache.lookup(conditional, cached), HTTPResponseCache::NOT_MODIFIED) << since;
+    EXPECT_NE(cached->find("\r\nLast-Modified: Sun, 06 Nov 1994 08:49:37 GMT\r\n"), std::string::npos) << *cached;
+  }
+  /* an older or malformed date gets the full response */
+  for (const char *since : { "Sat, 05 Nov 1994 08:49:37 GMT", "yesterday" }){
+    HTTPHeader conditional = __parse(std::string("GET /a HTTP/1.1\r\nHost: example.com\r\nIf-Modified-Since: ") + since + "\r\n\r\n");
+    ASSERT_EQ(cache.lookup(conditional, cached), HTTPResponseCache::HIT) << since;
+    EXPECT_NE(cached->find("\r\n\r\nbody"), std::string::npos) << *cached;
+  }
+}
+
+TEST(HTTPResponseCacheTest, EvictionReleasesVaryEntries){
+  HTTPHeader first = __parse("GET /a HTTP/1.1\r\nHost: example.com\r\nAccept-Language: en\r\n\r\n");
+  HTTPHeader varying = __response("Cache-Control: max-age=60\r\nVary: Accept-Language\r\n");
+  HTTPHeader second = __parse("GET /b HTTP/1.1\r\nHost: example.com\r\n\r\n");
+  HTTPHeader plain = __response("Cache-Control: max-age=60\r\n");
+  HTTPResponseCache reference(1 << 20, 1);
+  ASSERT_TRUE(reference.store(second, plain, "body"));
+
+  /* the budget holds one response, storing the second one evicts the only variant of the first */
+  HTTPResponseCache cache(2 * reference.getSize() - 1, 1);
+  ASSERT_TRUE(cache.store(first, varying, "body"));
+  ASSERT_TRUE(cache.store(second, plain, "body"));
+  EXPECT_EQ(cache.getSize(), reference.getSize());
+  std::shared_ptr<const std::string> cached;
+  EXPECT_EQ(cache.lookup(first, cached), HTTPResponseCache::MISS);
+  EXPECT_EQ(cache.lookup(second, cached), HTTPResponseCache::HIT);
+}
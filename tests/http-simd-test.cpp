@@ -0,0 +1,142 @@
+/*
+ * $Id: http-simd-test.cpp,v 1.0.0 2026/10/18 21:04:12 Jaya Wikrama Exp $
+ *
+ * Copyright (c) 2024 Jaya Wikrama
+ * jayawikrama89@gmail.com
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *  claim that you wrote the original software. If you use this software
+ *  in a product, an acknowledgment in the product documentation would be
+ *  appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *  misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include <cstring>
+#include <string>
+#include <gtest/gtest.h>
+#include "http-simd.hpp"
+
+/* the vector kernels read 16 or 32 bytes at once, the inputs are placed at every offset of one wide block */
+#define ALIGNMENT 64
+
+TEST(HTTPSimdTest, VerifyAgainstScalar){
+  EXPECT_TRUE(HTTPSimd::verify());
+}
+
+TEST(HTTPSimdTest, FindMatchInTail){
+  alignas(ALIGNMENT) char buffer[ALIGNMENT + 128];
+  for (size_t offset = 0; offset < ALIGNMENT; offset++){
+    for (size_t length = 1; length <= 96; length++){
+      char *data = buffer + offset;
+      memset(data, 'a', length);
+      data[length - 1] = '\n';
+      EXPECT_EQ(HTTPSimd::find(data, length, '\r', '\n'), length - 1) << "offset " << offset << " length " << length;
+      data[length - 1] = 'a';
+      EXPECT_EQ(HTTPSimd::find(data, length, '\r', '\n'), length) << "offset " << offset << " length " << length;
+    }
+  }
+  EXPECT_EQ(HTTPSimd::find(buffer, 0, 'a', 'a'), 0u);
+}
+
+TEST(HTTPSimdTest, FindIgnoresBytesAfterLength){
+  alignas(ALIGNMENT) char buffer[ALIGNMENT];
+  memset(buffer, '\n', sizeof(buffer));
+  memset(buffer, 'a', 5);
+  EXPECT_EQ(HTTPSimd::find(buffer, 5, '\n', '\n'), 5u);
+}
+
+TEST(HTTPSimdTest, LowerKeepsNonLetters){
+  alignas(ALIGNMENT) char buffer[ALIGNMENT + 256];
+  for (size_t offset = 0; offset < 8; offset++){
+    char *data = buffer + offset;
+    for (int i = 0; i < 256; i++) data[i] = static_cast<char>(i);
+    HTTPSimd::lower(data, 256);
+    for (int i = 0; i < 256; i++){
+      int expected = (i >= 'A' && i <= 'Z' ? i + ('a' - 'A') : i);
+      EXPECT_EQ(static_cast<unsigned char>(data[i]), expected) << "offset " << offset << " byte " << i;
+    }
+  }
+}
+
+TEST(HTTPSimdTest, LowerTokenStopsAtHighBytes){
+  alignas(ALIGNMENT) char buffer[ALIGNMENT + 80];
+  char output[80];
+  for (size_t offset = 0; offset < ALIGNMENT; offset++){
+    for (size_t position = 0; position < 70; position += 7){
+      for (int high : { 0x80, 0xC3, 0xFF }){
+        char *data = buffer + offset;
+        memset(data, 'X', 70);
+        data[position] = static_cast<char>(high);
+        EXPECT_EQ(HTTPSimd::lowerToken(data, 70, output), position) << "offset " << offset << " byte " << high;
+        for (size_t i = 0; i < position; i++) EXPECT_EQ(output[i], 'x');
+      }
+    }
+  }
+}
+
+TEST(HTTPSimdTest, LowerTokenStopsAtDelimiters){
+  static const char delimiters[] = "\"(),/:;<=>?@[\\]{} \t\r\n";
+  char output[64];
+  for (size_t i = 0; i < sizeof(delimiters) - 1; i++){
+    std::string name("Content-Type");
+    size_t length = name.length();
+    name.push_back(delimiters[i]);
+    name.append(40, 'A');
+    EXPECT_EQ(HTTPSimd::lowerToken(name.data(), name.length(), output), length) << "delimiter " << static_cast<int>(delimiters[i]);
+    EXPECT_EQ(std::string(output, length), "content-type");
+  }
+  EXPECT_EQ(HTTPSimd::lowerToken("!#$%&'*+-.^_`|~09azAZ", 21, output), 21u);
+  EXPECT_EQ(std::string(output, 21), "!#$%&'*+-.^_`|~09azaz");
+}
+
+TEST(HTTPSimdTest, MaskRoundTrip){
+  alignas(ALIGNMENT) char buffer[ALIGNMENT + 100];
+  for (size_t offset = 0; offset < 8; offset++){
+    for (size_t length = 0; length <= 67; length++){
+      char *data = buffer + offset;
+      for (size_t i = 0; i < length; i++) data[i] = static_cast<char>(i * 7);
+      uint32_t pattern = 0x12345678;
+      HTTPSimd::mask(data, length, pattern);
+      const unsigned char *key = reinterpret_cast<const unsigned char *>(&pattern);
+      for (size_t i = 0; i < length; i++) EXPECT_EQ(static_cast<unsigned char>(data[i]), static_cast<unsigned char>((i * 7) ^ key[i % 4]));
+      HTTPSimd::mask(data, length, pattern);
+      for (size_t i = 0; i < length; i++) EXPECT_EQ(data[i], static_cast<char>(i * 7));
+    }
+  }
+}
+
+TEST(HTTPSimdTest, Crc32cKnownValue){
+  EXPECT_EQ(HTTPSimd::crc32c("123456789", 9), 0xE3069283u);
+  EXPECT_EQ(HTTPSimd::crc32c("56789", 5, HTTPSimd::crc32c("1234", 4)), 0xE3069283u);
+  EXPECT_EQ(HTTPSimd::crc32c("", 0), 0u);
+}
+
+TEST(HTTPSimdTest, PercentDecode){
+  std::string output;
+  EXPECT_TRUE(HTTPSimd::percentDecode("/a%20b%2Fc+d", 12, output));
+  EXPECT_EQ(output, "/a b/c+d");
+  output.clear();
+  EXPECT_TRUE(HTTPSimd::percentDecode("a+b", 3, output, true));
+  EXPECT_EQ(output, "a b");
+}
+
+TEST(HTTPSimdTest, PercentDecodeRejectsEscapeAtEnd){
+  for (const char *input : { "%", "abc%", "abc%4", "abc%4g", "%zz" }){
+    std::string output("keep");
+    EXPECT_FALSE(HTTPSimd::percentDecode(input, strlen(input), output)) << input;
+    EXPECT_EQ(output, "keep") << input;
+  }
+  /* the escape is not completed by the bytes after the length */
+  std::string output;
+  EXPECT_FALSE(HTTPSimd::percentDecode("ab%41", 4, output));
+}
@@ -0,0 +1,148 @@
+/*
+ * $Id: http-timer-wheel-test.cpp,v 1.0.0 2026/10/19 11:31:06 Jaya Wikrama Exp $
+ *
+ * Copyright (c) 2024 Jaya Wikrama
+ * jayawikrama89@gmail.com
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *  claim that you wrote the original software. If you use this software
+ *  in a product, an acknowledgment in the product documentation would be
+ *  appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *  misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+
+#include <vector>
+#include <unistd.h>
+#include <gtest/gtest.h>
+#include "http-timer-wheel.hpp"
+
+typedef struct _expiry_t {
+  uint64_t now;
+  std::vector<std::pair<HTTPTimer *, uint64_t>> fired;
+} expiry_t;
+
+static void __onTimeout(HTTPTimer &timer, void *context){
+  expiry_t *expiry = static_cast<expiry_t *>(context);
+  expiry->fired.emplace_back(&timer, expiry->now);
+}
+
+/* the wheel is advanced tick by tick from `from` to `to`, every expiry records the time of the advance */
+static void __run(HTTPTimerWheel &wheel, expiry_t &expiry, uint64_t from, uint64_t to){
+  for (expiry.now = from; expiry.now <= to; expiry.now += HTTP_TIMER_WHEEL_RESOLUTION) wheel.advance(expiry.now, __onTimeout, &expiry);
+}
+
+/* the timer expires at the first tick at or after its timeout (the tick of the start may be counted twice) */
+static void __expectExpiry(const expiry_t &expiry, const HTTPTimer &timer, uint64_t start, uint64_t timeout){
+  size_t found = 0;
+  for (const std::pair<HTTPTimer *, uint64_t> &fired : expiry.fired){
+    if (fired.first != &timer) continue;
+    found++;
+    EXPECT_GE(fired.second - start, timeout);
+    EXPECT_LE(fired.second - start, timeout + 2 * HTTP_TIMER_WHEEL_RESOLUTION);
+  }
+  EXPECT_EQ(found, 1u);
+}
+
+TEST(HTTPTimerWheelTest, ExpiresOnSlotBoundaries){
+  HTTPTimerWheel wheel;
+  uint64_t start = HTTPTimerWheel::now();
+  /* the timeouts end exactly on the boundaries of the first, second and third level */
+  uint64_t timeouts[] = {
+    HTTP_TIMER_WHEEL_RESOLUTION,
+    HTTP_TIMER_WHEEL_SLOT * HTTP_TIMER_WHEEL_RESOLUTION,
+    HTTP_TIMER_WHEEL_SLOT * HTTP_TIMER_WHEEL_SLOT * HTTP_TIMER_WHEEL_RESOLUTION
+  };
+  HTTPTimer timers[3];
+  for (int i = 0; i < 3; i++) wheel.schedule(timers[i], HTTPTimer::KEEP_ALIVE, timeouts[i]);
+  EXPECT_EQ(wheel.size(), 3u);
+  expiry_t expiry;
+  __run(wheel, expiry, start, start + timeouts[2] + 4 * HTTP_TIMER_WHEEL_RESOLUTION);
+  for (int i = 0; i < 3; i++){
+    __expectExpiry(expiry, timers[i], start, timeouts[i]);
+    EXPECT_FALSE(timers[i].isPending());
+  }
+  EXPECT_EQ(wheel.size(), 0u);
+}
+
+TEST(HTTPTimerWheelTest, CascadesBetweenLevels){
+  HTTPTimerWheel wheel;
+  uint64_t start = HTTPTimerWheel::now();
+  std::vector<uint64_t> timeouts = { 50, 2550, 2570, 3000, 655350, 700000 };
+  std::vector<HTTPTimer> timers(timeouts.size());
+  for (size_t i = 0; i < timeouts.size(); i++) wheel.schedule(timers[i], HTTPTimer::WRITE_STALL, timeouts[i]);
+  expiry_t expiry;
+  __run(wheel, expiry, start, start + 700000 + 4 * HTTP_TIMER_WHEEL_RESOLUTION);
+  ASSERT_EQ(expiry.fired.size(), timeouts.size());
+  for (size_t i = 0; i < timeouts.size(); i++){
+    __expectExpiry(expiry, timers[i], start, timeouts[i]);
+    /* the timers expire in the order of their timeouts */
+    EXPECT_EQ(expiry.fired[i].first, &timers[i]);
+  }
+}
+
+TEST(HTTPTimerWheelTest, CancelsTimers){
+  HTTPTimerWheel wheel;
+  uint64_t start = HTTPTimerWheel::now();
+  HTTPTimer cancelled;
+  HTTPTimer kept;
+  wheel.schedule(cancelled, HTTPTimer::HEADER_READ, 100);
+  wheel.schedule(kept, HTTPTimer::HEADER_READ, 100);
+  {
+    /* the destructor cancels the timer */
+    HTTPTimer destroyed;
+    wheel.schedule(destroyed, HTTPTimer::HEADER_READ, 100);
+    EXPECT_EQ(wheel.size(), 3u);
+  }
+  wheel.cancel(cancelled);
+  wheel.cancel(cancelled);
+  EXPECT_FALSE(cancelled.isPending());
+  EXPECT_EQ(wheel.size(), 1u);
+  expiry_t expiry;
+  __run(wheel, expiry, start, start + 200);
+  ASSERT_EQ(expiry.fired.size(), 1u);
+  EXPECT_EQ(expiry.fired[0].first, &kept);
+  EXPECT_EQ(wheel.getTimeout(start + 200), -1);
+}
+
+TEST(HTTPTimerWheelTest, ReschedulesTimers){
+  HTTPTimerWheel wheel;
+  uint64_t start = HTTPTimerWheel::now();
+  HTTPTimer timer;
+  wheel.schedule(timer, HTTPTimer::KEEP_ALIVE, 100);
+  expiry_t expiry;
+  __run(wheel, expiry, start, start + 50);
+  EXPECT_TRUE(expiry.fired.empty());
+  /* a reset moves the timer, it is not scheduled twice */
+  wheel.schedule(timer, HTTPTimer::KEEP_ALIVE, 3000);
+  EXPECT_EQ(wheel.size(), 1u);
+  __run(wheel, expiry, start + 60, start + 4000);
+  ASSERT_EQ(expiry.fired.size(), 1u);
+  EXPECT_GE(expiry.fired[0].second - start, static_cast<uint64_t>(3000));
+  EXPECT_LE(expiry.fired[0].second - start, static_cast<uint64_t>(3000 + 8 * HTTP_TIMER_WHEEL_RESOLUTION));
+}
+
+TEST(HTTPTimerWheelTest, SchedulesFromTheClock){
+  HTTPTimerWheel wheel;
+  /* the wheel is not advanced while the reactor sleeps without timers */
+  usleep(300000);
+  HTTPTimer timer;
+  uint64_t start = HTTPTimerWheel::now();
+  wheel.schedule(timer, HTTPTimer::KEEP_ALIVE, 200);
+  expiry_t expiry;
+  expiry.now = start;
+  EXPECT_EQ(wheel.advance(start, __onTimeout, &expiry), 0u);
+  EXPECT_TRUE(timer.isPending());
+  __run(wheel, expiry, start, start + 300);
+  __expectExpiry(expiry, timer, start, 200);
+}
@@ -0,0 +1,99 @@
+/*
+ * $Id: http-websocket-test.cpp,v 1.0.0 2026/10/19 00:21:53 Jaya Wikrama Exp $
+ *
+ * Copyright (c) 2024 Jaya Wikrama
+ * jayawikrama89@gmail.com
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *  claim that you wrote the original software. If you use this software
+ *  in a product, an acknowledgment in the product documentation would be
+ *  appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *  misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include "http-websocket.hpp"
+
+static bool __collect(HTTPWebSocket &socket, HTTPWebSocket::opcode_t opcode, const char *data, size_t length, void *context){
+  (void) socket;
+  if (opcode == HTTPWebSocket::TEXT) static_cast<std::vector<std::string> *>(context)->push_back(std::string(data, length));
+  return true;
+}
+
+/* the client frames of the text, split in fragments at the given offsets */
+static std::string __frames(const std::string &text, const std::vector<size_t> &splits){
+  std::string frames;
+  size_t start = 0;
+  for (size_t i = 0; i <= splits.size(); i++){
+    size_t end = (i < splits.size() ? splits[i] : text.length());
+    HTTPWebSocket::opcode_t opcode = (i == 0 ? HTTPWebSocket::TEXT : HTTPWebSocket::CONTINUATION);
+    HTTPWebSocket::encode(frames, opcode, text.data() + start, end - start, i == splits.size(), true);
+    start = end;
+  }
+  return frames;
+}
+
+TEST(HTTPWebSocketTest, AcceptsSplitUtf8){
+  /* the two and four byte sequences are split between the fragments and between the reads */
+  std::string text = "caf\xC3\xA9 \xF0\x9F\x98\x80 end";
+  std::string frames = __frames(text, { 4, 8 });
+  HTTPWebSocket socket;
+  std::vector<std::string> messages;
+  for (size_t i = 0; i < frames.length(); i++) ASSERT_TRUE(socket.feed(frames.data() + i, 1, __collect, &messages)) << i;
+  ASSERT_EQ(messages.size(), 1u);
+  EXPECT_EQ(messages[0], text);
+}
+
+TEST(HTTPWebSocketTest, RejectsInvalidUtf8){
+  static const char *texts[] = {
+    "\xC0\x80",
+    "a\xED\xA0\x80",
+    "\xF4\x90\x80\x80",
+    "\xFF",
+    "ok\xE2\x82"
+  };
+  for (const char *text : texts){
+    std::string frames = __frames(text, {});
+    HTTPWebSocket socket;
+    std::vector<std::string> messages;
+    EXPECT_FALSE(socket.feed(frames.data(), frames.length(), __collect, &messages)) << text;
+    EXPECT_EQ(socket.getCloseCode(), HTTPWebSocket::INVALID_PAYLOAD) << text;
+    EXPECT_TRUE(messages.empty());
+  }
+  /* the binary message is not text */
+  std::string frame;
+  HTTPWebSocket::encode(frame, HTTPWebSocket::BINARY, "\xFF", 1, true, true);
+  HTTPWebSocket socket;
+  EXPECT_TRUE(socket.feed(frame.data(), frame.length(), nullptr, nullptr));
+}
+
+TEST(HTTPWebSocketTest, RejectsInvalidCloseReason){
+  std::string frame;
+  HTTPWebSocket::encodeClose(frame, HTTPWebSocket::NORMAL_CLOSURE, "\xC3", true);
+  HTTPWebSocket socket;
+  EXPECT_FALSE(socket.feed(frame.data(), frame.length(), nullptr, nullptr));
+  EXPECT_EQ(socket.getCloseCode(), HTTPWebSocket::INVALID_PAYLOAD);
+}
+
+TEST(HTTPWebSocketTest, ClientKeysDiffer){
+  std::string first;
+  std::string second;
+  HTTPWebSocket::encode(first, HTTPWebSocket::TEXT, "a", 1, true, true);
+  HTTPWebSocket::encode(second, HTTPWebSocket::TEXT, "a", 1, true, true);
+  ASSERT_EQ(first.length(), 7u);
+  ASSERT_EQ(second.length(), 7u);
+  EXPECT_NE(first.substr(2, 4), second.substr(2, 4));
+}
@@ -0,0 +1,665 @@
+/*
+ * $Id: cwl-load.cpp,v 1.0.0 2026/10/18 20:02:11 Jaya Wikrama Exp $
+ *
+ * Copyright (c) 2024 Jaya Wikrama
+ * jayawikrama89@gmail.com
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *  claim that you wrote the original software. If you use this software
+ *  in a product, an acknowledgment in the product documentation would be
+ *  appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *  misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+/**
+ * @file
+ * @brief The loopback load generator, built on the serializer and the incremental parser of the library.
+ *
+ * Usage:
+ * @code
+ * cwl-load [-c connections] [-t threads] [-d seconds] [-r rate] [-p depth] [-K] [-m method] [-H "Name: value"] [-s] [host:port][/target]
+ * @endcode
+ *
+ * - `-r 0` (default) is the closed loop: every connection keeps `depth` requests in flight.
+ * - `-r <requests per second>` is the open loop: the requests are issued at a constant rate and the latency is
+ *   measured from the intended send time, so a stalled server is not hidden by the generator waiting for it
+ *   (coordinated omission).
+ * - `-K` disables keep-alive, every request opens a new connection (the latency includes the connect).
+ * - `-s` runs the built-in responder (one `HTTPPipeline` per connection, precompiled `200 OK`) on an ephemeral
+ *   loopback port in the same process, so the numbers do not depend on any external tool.
+ *
+ * The latencies are recorded in HDR histograms (3 significant digits, per thread, merged at the end). The
+ * responses must be framed by `Content-Length`.
+ *
+ * @version 1.0.0
+ * @date 2026-10-18
+ * @author Jaya Wikrama
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <csignal>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <string>
+#include <thread>
+#include <vector>
+#include <getopt.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+#include "http-header.hpp"
+#include "http-pipeline.hpp"
+#include "http-static-response.hpp"
+
+#define LOAD_SUB_BITS 11
+#define LOAD_SUB_COUNT (1 << LOAD_SUB_BITS)
+#define LOAD_HALF_COUNT (LOAD_SUB_COUNT / 2)
+#define LOAD_BUCKETS 40
+#define LOAD_EVENTS 256
+#define LOAD_READ_SIZE 65536
+
+typedef struct _histogram_t {
+  std::vector<uint64_t> counts;
+  uint64_t total;
+  uint64_t max;
+  double sum;
+} histogram_t;
+
+typedef struct _config_t {
+  struct sockaddr_storage address;
+  socklen_t addressLength;
+  size_t connections;
+  size_t threads;
+  double duration;
+  double rate;
+  size_t depth;
+  bool keepAlive;
+  bool head;
+  std::string request;
+} config_t;
+
+typedef struct _connection_t {
+  int fd;
+  bool connected;
+  bool closing;
+  std::string output;
+  size_t offset;
+  std::string input;
+  std::deque<uint64_t> inflight;
+  HTTPHeader response;
+  bool haveHead;
+  uint64_t remaining;
+} connection_t;
+
+typedef struct _worker_t {
+  const config_t *config;
+  size_t connections;
+  double rate;
+  histogram_t histogram;
+  uint64_t completed;
+  uint64_t errors;
+  uint64_t bytes;
+  uint64_t backlog;
+} worker_t;
+
+static constexpr auto __keepAliveResponse = HTTPStaticResponse<128>::buildWithBody(
+  HttpStatus::OK,
+  "Hello, World!",
+  HeaderNode::CONTENT_TYPE, "text/plain"
+);
+
+static constexpr auto __closeResponse = HTTPStaticResponse<128>::buildWithBody(
+  HttpStatus::OK,
+  "Hello, World!",
+  HeaderNode::CONTENT_TYPE, "text/plain",
+  HeaderNode::CONNECTION, "close"
+);
+
+static uint64_t __now(){
+  return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+/* log-linear buckets: values below LOAD_SUB_COUNT are exact, every power of two above has LOAD_HALF_COUNT buckets */
+static size_t __index(uint64_t value){
+  if (value < LOAD_SUB_COUNT) return static_cast<size_t>(value);
+  int shift = (63 - __builtin_clzll(value)) - (LOAD_SUB_BITS - 1);
+  size_t index = LOAD_SUB_COUNT + static_cast<size_t>(shift - 1) * LOAD_HALF_COUNT + static_cast<size_t>((value >> shift) - LOAD_HALF_COUNT);
+  return std::min<size_t>(index, LOAD_SUB_COUNT + LOAD_BUCKETS * LOAD_HALF_COUNT - 1);
+}
+
+/* the highest value of the bucket, as reported by HDR histograms */
+static uint64_t __value(size_t index){
+  if (index < LOAD_SUB_COUNT) return index;
+  size_t offset = index - LOAD_SUB_COUNT;
+  int shift = static_cast<int>(offset / LOAD_HALF_COUNT) + 1;
+  return ((static_cast<uint64_t>(offset % LOAD_HALF_COUNT + LOAD_HALF_COUNT) + 1) << shift) - 1;
+}
+
+static void __init(histogram_t &histogram){
+  histogram.counts.assign(LOAD_SUB_COUNT + LOAD_BUCKETS * LOAD_HALF_COUNT, 0);
+  histogram.total = 0;
+  histogram.max = 0;
+  histogram.sum = 0.0;
+}
+
+static void __record(histogram_t &histogram, uint64_t value){
+  histogram.counts[__index(value)]++;
+  histogram.total++;
+  histogram.max = std::max(histogram.max, value);
+  histogram.sum += static_cast<double>(value);
+}
+
+static void __merge(histogram_t &to, const histogram_t &from){
+  for (size_t i = 0; i < to.counts.size(); i++) to.counts[i] += from.counts[i];
+  to.total += from.total;
+  to.max = std::max(to.max, from.max);
+  to.sum += from.sum;
+}
+
+static uint64_t __percentile(const histogram_t &histogram, double percentile){
+  if (histogram.total == 0) return 0;
+  uint64_t target = static_cast<uint64_t>(percentile / 100.0 * static_cast<double>(histogram.total) + 0.5);
+  if (target == 0) target = 1;
+  uint64_t count = 0;
+  for (size_t i = 0; i < histogram.counts.size(); i++){
+    count += histogram.counts[i];
+    if (count >= target) return std::min(__value(i), histogram.max);
+  }
+  return histogram.max;
+}
+
+static bool __resolve(const std::string &authority, config_t &config){
+  size_t colon = authority.rfind(':');
+  if (colon == std::string::npos) return false;
+  std::string host = authority.substr(0, colon);
+  std::string port = authority.substr(colon + 1);
+  if (host.size() >= 2 && host.front() == '[' && host.back() == ']') host = host.substr(1, host.size() - 2);
+  if (host.empty()) host = "127.0.0.1";
+  struct addrinfo hints;
+  struct addrinfo *result = nullptr;
+  memset(&hints, 0, sizeof(hints));
+  hints.ai_socktype = SOCK_STREAM;
+  if (getaddrinfo(host.c_str(), port.c_str(), &hints, &result) != 0 || result == nullptr) return false;
+  memcpy(&config.address, result->ai_addr, result->ai_addrlen);
+  config.addressLength = result->ai_addrlen;
+  freeaddrinfo(result);
+  return true;
+}
+
+static void __close(int epoll, connection_t &connection){
+  if (connection.fd >= 0){
+    epoll_ctl(epoll, EPOLL_CTL_DEL, connection.fd, nullptr);
+    close(connection.fd);
+  }
+  connection.fd = -1;
+  connection.connected = false;
+  connection.closing = false;
+  connection.output.clear();
+  connection.offset = 0;
+  connection.input.clear();
+  connection.response = HTTPHeader();
+  connection.haveHead = false;
+}
+
+static bool __open(int epoll, const config_t &config, connection_t &connection, size_t id){
+  connection.fd = socket(config.address.ss_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (connection.fd < 0) return false;
+  int one = 1;
+  setsockopt(connection.fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+  if (connect(connection.fd, reinterpret_cast<const struct sockaddr *>(&config.address), config.addressLength) != 0 && errno != EINPROGRESS){
+    close(connection.fd);
+    connection.fd = -1;
+    return false;
+  }
+  struct epoll_event event;
+  event.events = EPOLLIN | EPOLLOUT | EPOLLET;
+  event.data.u64 = id;
+  epoll_ctl(epoll, EPOLL_CTL_ADD, connection.fd, &event);
+  return true;
+}
+
+static bool __write(connection_t &connection){
+  if (!connection.connected) return true;
+  while (connection.offset < connection.output.length()){
+    ssize_t ret = send(connection.fd, connection.output.data() + connection.offset, connection.output.length() - connection.offset, MSG_NOSIGNAL);
+    if (ret < 0 && errno == EINTR) continue;
+    if (ret < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return true;
+    if (ret <= 0) return false;
+    connection.offset += static_cast<size_t>(ret);
+  }
+  connection.output.clear();
+  connection.offset = 0;
+  return true;
+}
+
+/* the request is timed from `start`, which is the intended send time in the open loop */
+static bool __issue(int epoll, worker_t &worker, connection_t &connection, size_t id, uint64_t start, bool write = true){
+  if (connection.fd < 0 && !__open(epoll, *worker.config, connection, id)) return false;
+  connection.inflight.push_back(start);
+  connection.output += worker.config->request;
+  return (!write || __write(connection));
+}
+
+/* the in-flight requests of a failed connection are sent again with their original start time */
+static void __reset(int epoll, worker_t &worker, connection_t &connection, size_t id, bool error){
+  std::deque<uint64_t> pending;
+  pending.swap(connection.inflight);
+  __close(epoll, connection);
+  if (error) worker.errors++;
+  for (uint64_t start : pending){
+    if (!__issue(epoll, worker, connection, id, start)){
+      worker.errors++;
+      __close(epoll, connection);
+      connection.inflight.clear();
+      return;
+    }
+  }
+}
+
+static bool __read(worker_t &worker, connection_t &connection, bool &closed){
+  char chunk[LOAD_READ_SIZE];
+  for (;;){
+    ssize_t ret = recv(connection.fd, chunk, sizeof(chunk), 0);
+    if (ret < 0 && errno == EINTR) continue;
+    if (ret < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+    if (ret <= 0){
+      closed = true;
+      break;
+    }
+    worker.bytes += static_cast<uint64_t>(ret);
+    connection.input.append(chunk, static_cast<size_t>(ret));
+  }
+  size_t consumed = 0;
+  while (!connection.inflight.empty()){
+    if (!connection.haveHead){
+      ssize_t ret = connection.response.parse(connection.input.data() + consumed, connection.input.length() - consumed);
+      if (ret < 0) return false;
+      if (ret == 0) break;
+      consumed += static_cast<size_t>(ret);
+      HeaderNode *length = connection.response.getNode(HeaderNode::CONTENT_LENGTH);
+      connection.remaining = (length == nullptr || worker.config->head ? 0 : strtoull(length->getValue().c_str(), nullptr, 10));
+      HeaderNode *connectionField = connection.response.getNode(HeaderNode::CONNECTION);
+      connection.closing = (connectionField != nullptr && connectionField->getValue() == "close");
+      connection.haveHead = true;
+    }
+    size_t step = static_cast<size_t>(std::min<uint64_t>(connection.remaining, connection.input.length() - consumed));
+    consumed += step;
+    connection.remaining -= step;
+    if (connection.remaining > 0) break;
+    __record(worker.histogram, __now() - connection.inflight.front());
+    connection.inflight.pop_front();
+    worker.completed++;
+    connection.response = HTTPHeader();
+    connection.haveHead = false;
+    if (connection.closing) break;
+  }
+  connection.input.erase(0, consumed);
+  return true;
+}
+
+static void __run(worker_t &worker){
+  const config_t &config = *worker.config;
+  std::vector<connection_t> connections(worker.connections);
+  int epoll = epoll_create1(EPOLL_CLOEXEC);
+  int timer = -1;
+  bool open = (worker.rate > 0.0);
+  for (connection_t &connection : connections){
+    connection.fd = -1;
+    connection.connected = false;
+    connection.closing = false;
+    connection.offset = 0;
+    connection.haveHead = false;
+    connection.remaining = 0;
+  }
+  uint64_t begin = __now();
+  uint64_t end = begin + static_cast<uint64_t>(config.duration * 1e9);
+  double interval = (open ? 1e9 / worker.rate : 0.0);
+  uint64_t issued = 0;
+  size_t next = 0;
+  if (open){
+    timer = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    struct epoll_event event;
+    event.events = EPOLLIN;
+    event.data.u64 = connections.size();
+    epoll_ctl(epoll, EPOLL_CTL_ADD, timer, &event);
+  }
+  else {
+    for (size_t i = 0; i < connections.size(); i++){
+      for (size_t j = 0; j < config.depth; j++){
+        if (!__issue(epoll, worker, connections[i], i, __now())) __reset(epoll, worker, connections[i], i, true);
+      }
+    }
+  }
+  struct epoll_event events[LOAD_EVENTS];
+  for (;;){
+    uint64_t now = __now();
+    if (now >= end) break;
+    if (open){
+      /* every due request goes to the next connection with a free slot, the others wait with their intended time */
+      bool full = false;
+      for (;;){
+        uint64_t intended = begin + static_cast<uint64_t>(static_cast<double>(issued) * interval);
+        if (intended > now) break;
+        size_t found = connections.size();
+        for (size_t k = 0; k < connections.size(); k++){
+          size_t i = (next + k) % connections.size();
+          if (connections[i].inflight.size() < config.depth && !connections[i].closing){
+            found = i;
+            break;
+          }
+        }
+        if (found == connections.size()){
+          full = true;
+          break;
+        }
+        next = (found + 1) % connections.size();
+        if (!__issue(epoll, worker, connections[found], found, intended, false)) __reset(epoll, worker, connections[found], found, true);
+        issued++;
+      }
+      /* the requests which became due together are written with one call per connection */
+      for (size_t i = 0; i < connections.size(); i++){
+        if (connections[i].offset < connections[i].output.length() && !__write(connections[i])) __reset(epoll, worker, connections[i], i, true);
+      }
+      /*
+       * the steady clock is CLOCK_MONOTONIC, so the intended time is the absolute expiration of the timer. If every
+       * connection is at depth the timer is disarmed (a zero value), the next response frees a slot
+       */
+      struct itimerspec spec;
+      memset(&spec, 0, sizeof(spec));
+      if (!full){
+        uint64_t at = std::max(begin + static_cast<uint64_t>(static_cast<double>(issued) * interval), now + 1);
+        spec.it_value.tv_sec = static_cast<time_t>(at / 1000000000ULL);
+        spec.it_value.tv_nsec = static_cast<long>(at % 1000000000ULL);
+      }
+      timerfd_settime(timer, TFD_TIMER_ABSTIME, &spec, nullptr);
+    }
+    int timeout = static_cast<int>(std::min<uint64_t>((end - now) / 1000000ULL + 1, 100));
+    int count = epoll_wait(epoll, events, LOAD_EVENTS, timeout);
+    for (int e = 0; e < count; e++){
+      size_t i = static_cast<size_t>(events[e].data.u64);
+      if (i >= connections.size()){
+        uint64_t expirations;
+        while (read(timer, &expirations, sizeof(expirations)) > 0){}
+        continue;
+      }
+      connection_t &connection = connections[i];
+      if (connection.fd < 0) continue;
+      if (!connection.connected && (events[e].events & (EPOLLOUT | EPOLLERR | EPOLLHUP))){
+        int error = 0;
+        socklen_t length = sizeof(error);
+        getsockopt(connection.fd, SOL_SOCKET, SO_ERROR, &error, &length);
+        if (error != 0){
+          __reset(epoll, worker, connection, i, true);
+          continue;
+        }
+        connection.connected = true;
+      }
+      if ((events[e].events & EPOLLOUT) && !__write(connection)){
+        __reset(epoll, worker, connection, i, true);
+        continue;
+      }
+      if (events[e].events & (EPOLLIN | EPOLLHUP | EPOLLERR)){
+        bool closed = false;
+        if (!__read(worker, connection, closed)){
+          __reset(epoll, worker, connection, i, true);
+          continue;
+        }
+        if (connection.closing || closed){
+          __reset(epoll, worker, connection, i, closed && !connection.closing && !connection.inflight.empty());
+        }
+        else if (!config.keepAlive && connection.inflight.empty()){
+          __close(epoll, connection);
+        }
+        while (!open && connection.inflight.size() < config.depth){
+          if (!__issue(epoll, worker, connection, i, __now())){
+            __reset(epoll, worker, connection, i, true);
+            break;
+          }
+        }
+      }
+    }
+  }
+  if (open){
+    uint64_t intended = static_cast<uint64_t>(config.duration * worker.rate);
+    worker.backlog = (intended > issued ? intended - issued : 0);
+  }
+  for (connection_t &connection : connections){
+    worker.backlog += connection.inflight.size();
+    __close(epoll, connection);
+  }
+  if (timer >= 0) close(timer);
+  close(epoll);
+}
+
+/* the built-in responder: one pipeline per connection, the heads are parsed in batches */
+static void __serve(int listener, std::atomic<bool> &running){
+  typedef struct _peer_t {
+    std::string input;
+    HTTPPipeline pipeline;
+    bool closing;
+  } peer_t;
+  int epoll = epoll_create1(EPOLL_CLOEXEC);
+  struct epoll_event event;
+  event.events = EPOLLIN | EPOLLEXCLUSIVE;
+  event.data.ptr = nullptr;
+  epoll_ctl(epoll, EPOLL_CTL_ADD, listener, &event);
+  std::vector<peer_t *> peers;
+  struct epoll_event events[LOAD_EVENTS];
+  char chunk[LOAD_READ_SIZE];
+  while (running.load(std::memory_order_relaxed)){
+    int count = epoll_wait(epoll, events, LOAD_EVENTS, 50);
+    for (int e = 0; e < count; e++){
+      if (events[e].data.ptr == nullptr){
+        for (;;){
+          int fd = accept4(listener, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+          if (fd < 0) break;
+          int one = 1;
+          setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+          peer_t *peer = new peer_t();
+          peer->closing = false;
+          struct epoll_event add;
+          add.events = EPOLLIN | EPOLLOUT | EPOLLET;
+          add.data.u64 = (static_cast<uint64_t>(peers.size()) << 32) | static_cast<uint32_t>(fd);
+          peers.push_back(peer);
+          epoll_ctl(epoll, EPOLL_CTL_ADD, fd, &add);
+        }
+        continue;
+      }
+      int fd = static_cast<int>(events[e].data.u64 & 0xFFFFFFFFULL);
+      peer_t *&peer = peers[static_cast<size_t>(events[e].data.u64 >> 32)];
+      if (peer == nullptr) continue;
+      bool closed = false;
+      for (;;){
+        ssize_t ret = recv(fd, chunk, sizeof(chunk), 0);
+        if (ret < 0 && errno == EINTR) continue;
+        if (ret < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+        if (ret <= 0){
+          closed = true;
+          break;
+        }
+        if (!peer->closing) peer->input.append(chunk, static_cast<size_t>(ret));
+      }
+      if (!peer->closing && !peer->input.empty()){
+        HTTPPipeline::batch_t batch = peer->pipeline.parse(peer->input.data(), peer->input.length());
+        for (size_t i = 0; i < batch.count && !peer->closing; i++){
+          HeaderNode *connection = batch.headers[i].getNode(HeaderNode::CONNECTION);
+          peer->closing = (connection != nullptr && connection->getValue() == "close");
+          std::string_view response = (peer->closing ? __closeResponse.view() : __keepAliveResponse.view());
+          /* the response to HEAD is the same head without the body */
+          if (batch.headers[i].getMethod() == "HEAD") response = response.substr(0, response.find("\r\n\r\n") + 4);
+          peer->pipeline.queue(response.data(), response.length());
+        }
+        if (batch.malformed && !peer->closing){
+          std::string_view response = HTTPPipeline::getRejection(batch.status);
+          peer->pipeline.queue(response.data(), response.length());
+          peer->closing = true;
+        }
+        peer->input.erase(0, batch.consumed);
+      }
+      if (peer->pipeline.flush(fd) < 0) closed = true;
+      if (closed || (peer->closing && !peer->pipeline.isPending())){
+        epoll_ctl(epoll, EPOLL_CTL_DEL, fd, nullptr);
+        close(fd);
+        delete peer;
+        peer = nullptr;
+      }
+    }
+  }
+  for (peer_t *peer : peers) delete peer;
+  close(epoll);
+}
+
+static void __usage(const char *name){
+  fprintf(stderr, "usage: %s [-c connections] [-t threads] [-d seconds] [-r rate] [-p depth] [-K] [-m method] [-H \"Name: value\"] [-s] [host:port][/target]\n", name);
+}
+
+int main(int argc, char **argv){
+  config_t config;
+  config.addressLength = 0;
+  config.connections = 16;
+  config.threads = 1;
+  config.duration = 10.0;
+  config.rate = 0.0;
+  config.depth = 1;
+  config.keepAlive = true;
+  std::string method = "GET";
+  std::vector<std::string> fields;
+  bool serve = false;
+  int option;
+  while ((option = getopt(argc, argv, "c:t:d:r:p:Km:H:sh")) != -1){
+    switch (option){
+      case 'c': config.connections = strtoul(optarg, nullptr, 10); break;
+      case 't': config.threads = strtoul(optarg, nullptr, 10); break;
+      case 'd': config.duration = strtod(optarg, nullptr); break;
+      case 'r': config.rate = strtod(optarg, nullptr); break;
+      case 'p': config.depth = strtoul(optarg, nullptr, 10); break;
+      case 'K': config.keepAlive = false; break;
+      case 'm': method = optarg; break;
+      case 'H': fields.push_back(optarg); break;
+      case 's': serve = true; break;
+      default:
+        __usage(argv[0]);
+        return 2;
+    }
+  }
+  if (config.connections == 0 || config.threads == 0 || config.depth == 0 || config.duration <= 0.0 || config.rate < 0.0){
+    __usage(argv[0]);
+    return 2;
+  }
+  if (!config.keepAlive) config.depth = 1;
+  /* the responder writes with writev, the peers may close first */
+  signal(SIGPIPE, SIG_IGN);
+  config.threads = std::min(config.threads, config.connections);
+  std::string location = (optind < argc ? argv[optind] : "");
+  size_t slash = location.find('/');
+  std::string authority = location.substr(0, slash);
+  std::string target = (slash == std::string::npos ? "/" : location.substr(slash));
+
+  std::atomic<bool> running(true);
+  std::vector<std::thread> responders;
+  int listener = -1;
+  if (serve){
+    listener = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t length = sizeof(address);
+    if (listener < 0 || bind(listener, reinterpret_cast<struct sockaddr *>(&address), length) != 0 || listen(listener, SOMAXCONN) != 0 ||
+      getsockname(listener, reinterpret_cast<struct sockaddr *>(&address), &length) != 0){
+      perror("responder");
+      return 1;
+    }
+    memcpy(&config.address, &address, length);
+    config.addressLength = length;
+    for (size_t i = 0; i < config.threads; i++) responders.emplace_back(__serve, listener, std::ref(running));
+    if (authority.empty()) authority = "127.0.0.1:" + std::to_string(ntohs(address.sin_port));
+  }
+  else if (!__resolve(authority, config)){
+    fprintf(stderr, "%s: invalid address\n", authority.c_str());
+    return 2;
+  }
+
+  /* the request template is serialized once and written as is */
+  config.head = (method == "HEAD");
+  HTTPHeader request;
+  request.setRequestLine(method, target);
+  request.append(HeaderNode::HOST, authority);
+  if (!config.keepAlive) request.append(HeaderNode::CONNECTION, "close");
+  for (const std::string &row : fields){
+    HeaderNode::headerField_t field = HeaderNode::UNKNOWN;
+    std::string_view name;
+    std::string_view value;
+    if (!HeaderNode::parseRow(row.data(), row.length(), field, name, value)){
+      fprintf(stderr, "%s: invalid field\n", row.c_str());
+      return 2;
+    }
+    request.append(name, std::string(value));
+  }
+  request.serialize(config.request);
+  config.request += "\r\n";
+
+  std::vector<worker_t> workers(config.threads);
+  for (size_t i = 0; i < workers.size(); i++){
+    worker_t &worker = workers[i];
+    worker.config = &config;
+    worker.connections = config.connections / config.threads + (i < config.connections % config.threads ? 1 : 0);
+    worker.rate = config.rate * static_cast<double>(worker.connections) / static_cast<double>(config.connections);
+    worker.completed = 0;
+    worker.errors = 0;
+    worker.bytes = 0;
+    worker.backlog = 0;
+    __init(worker.histogram);
+  }
+  uint64_t begin = __now();
+  std::vector<std::thread> pool;
+  for (worker_t &worker : workers) pool.emplace_back(__run, std::ref(worker));
+  for (std::thread &thread : pool) thread.join();
+  double elapsed = static_cast<double>(__now() - begin) / 1e9;
+  running.store(false, std::memory_order_relaxed);
+  for (std::thread &thread : responders) thread.join();
+  if (listener >= 0) close(listener);
+
+  histogram_t histogram;
+  __init(histogram);
+  uint64_t completed = 0, errors = 0, bytes = 0, backlog = 0;
+  for (const worker_t &worker : workers){
+    __merge(histogram, worker.histogram);
+    completed += worker.completed;
+    errors += worker.errors;
+    bytes += worker.bytes;
+    backlog += worker.backlog;
+  }
+  printf("%s %s%s, %zu connections, %zu threads, depth %zu, %s, %s\n", method.c_str(), authority.c_str(), target.c_str(),
+    config.connections, config.threads, config.depth, (config.keepAlive ? "keep-alive" : "close"),
+    (config.rate > 0.0 ? "open loop" : "closed loop"));
+  if (config.rate > 0.0) printf("target rate: %.0f req/s\n", config.rate);
+  printf("requests: %llu in %.2f s, %.0f req/s, %.2f MB/s received\n", static_cast<unsigned long long>(completed), elapsed,
+    static_cast<double>(completed) / elapsed, static_cast<double>(bytes) / elapsed / 1e6);
+  printf("errors: %llu, not completed: %llu\n", static_cast<unsigned long long>(errors), static_cast<unsigned long long>(backlog));
+  printf("latency (us): mean %.1f\n", (histogram.total == 0 ? 0.0 : histogram.sum / static_cast<double>(histogram.total) / 1e3));
+  for (double percentile : { 50.0, 90.0, 99.0, 99.9, 99.99, 100.0 }){
+    printf("  %7.3f%%  %10.1f\n", percentile, static_cast<double>(__percentile(histogram, percentile)) / 1e3);
+  }
+  return (completed > 0 ? 0 : 1);
+}
@@ -0,0 +1,273 @@
+/*
+ * $Id: cwl-pack.cpp,v 1.0.0 2026/10/18 19:21:47 Jaya Wikrama Exp $
+ *
+ * Copyright (c) 2024 Jaya Wikrama
+ * jayawikrama89@gmail.com
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *  claim that you wrote the original software. If you use this software
+ *  in a product, an acknowledgment in the product documentation would be
+ *  appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *  misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+/**
+ * @file
+ * @brief The offline packer of the static asset bundle (see `HTTPBundle`).
+ *
+ * Usage:
+ * @code
+ * cwl-pack <asset directory> <bundle>
+ * @endcode
+ *
+ * Every regular file of the directory is stored as `/<relative path>` with its identity variant, the gzip variant
+ * and (if built with libbrotlienc) the brotli variant. A compressed variant is kept only if the content type is
+ * compressible and the variant saves at least 10% of the identity size.
+ *
+ * @version 1.0.0
+ * @date 2026-10-18
+ * @author Jaya Wikrama
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include <sys/stat.h>
+#include "http-bundle.hpp"
+#include "http-compression.hpp"
+#include "http-simd.hpp"
+#ifdef CWL_PACK_BROTLI
+#include <brotli/encode.h>
+#endif
+
+typedef struct _asset_t {
+  std::string path;
+  std::string head[HTTPBundle::SZ_ENCODING];
+  std::string body[HTTPBundle::SZ_ENCODING];
+} asset_t;
+
+static const char *__types[][2] = {
+  { ".html", "text/html; charset=utf-8" },
+  { ".htm", "text/html; charset=utf-8" },
+  { ".css", "text/css; charset=utf-8" },
+  { ".js", "text/javascript; charset=utf-8" },
+  { ".mjs", "text/javascript; charset=utf-8" },
+  { ".json", "application/json" },
+  { ".map", "application/json" },
+  { ".xml", "application/xml" },
+  { ".txt", "text/plain; charset=utf-8" },
+  { ".csv", "text/csv; charset=utf-8" },
+  { ".svg", "image/svg+xml" },
+  { ".ico", "image/x-icon" },
+  { ".png", "image/png" },
+  { ".jpg", "image/jpeg" },
+  { ".jpeg", "image/jpeg" },
+  { ".gif", "image/gif" },
+  { ".webp", "image/webp" },
+  { ".avif", "image/avif" },
+  { ".woff", "font/woff" },
+  { ".woff2", "font/woff2" },
+  { ".ttf", "font/ttf" },
+  { ".wasm", "application/wasm" },
+  { ".pdf", "application/pdf" },
+  { ".webmanifest", "application/manifest+json" }
+};
+
+static const char *__contentType(const std::filesystem::path &path){
+  std::string extension = path.extension().string();
+  for (char &c : extension) c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+  for (const auto &type : __types){
+    if (extension == type[0]) return type[1];
+  }
+  return "application/octet-stream";
+}
+
+static std::string __httpDate(time_t value){
+  char buffer[64];
+  struct tm tm;
+  gmtime_r(&value, &tm);
+  strftime(buffer, sizeof(buffer), "%a, %d %b %Y %H:%M:%S GMT", &tm);
+  return std::string(buffer);
+}
+
+static bool __gzip(const std::string &input, std::string &output){
+  try {
+    HTTPCompressor compressor(HTTPCompressor::ENCODING_GZIP, 9);
+    return (compressor.compress(input.data(), input.length(), output) && compressor.finish(output));
+  }
+  catch (const std::exception &e){
+    return false;
+  }
+}
+
+static bool __brotli(const std::string &input, std::string &output){
+#ifdef CWL_PACK_BROTLI
+  size_t length = BrotliEncoderMaxCompressedSize(input.length());
+  if (length == 0) return false;
+  output.resize(length);
+  if (!BrotliEncoderCompress(BROTLI_MAX_QUALITY, BROTLI_DEFAULT_WINDOW, BROTLI_MODE_GENERIC, input.length(),
+    reinterpret_cast<const uint8_t *>(input.data()), &length, reinterpret_cast<uint8_t *>(&output[0]))){
+    return false;
+  }
+  output.resize(length);
+  return true;
+#else
+  (void) input;
+  (void) output;
+  return false;
+#endif
+}
+
+static std::string __head(const char *type, const std::string &etag, const std::string &modified, size_t length, HTTPBundle::encoding_t encoding, bool vary){
+  std::string head = "HTTP/1.1 200 OK\r\nContent-Type: ";
+  head += type;
+  head += "\r\nETag: " + etag;
+  head += "\r\nLast-Modified: " + modified;
+  head += "\r\nContent-Length: " + std::to_string(length);
+  if (encoding != HTTPBundle::IDENTITY){
+    head += "\r\nContent-Encoding: ";
+    head += HTTPBundle::getEncodingName(encoding);
+  }
+  if (vary) head += "\r\nVary: Accept-Encoding";
+  head += "\r\n\r\n";
+  return head;
+}
+
+static bool __load(const std::filesystem::path &root, const std::filesystem::path &file, asset_t &asset){
+  std::ifstream input(file, std::ios::binary);
+  if (!input.is_open()) return false;
+  std::string identity((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+  struct stat info;
+  if (stat(file.c_str(), &info) != 0) return false;
+  asset.path = "/" + std::filesystem::relative(file, root).generic_string();
+  const char *type = __contentType(file);
+  char tag[32];
+  snprintf(tag, sizeof(tag), "%zx-%08x", identity.length(), HTTPSimd::crc32c(identity.data(), identity.length()));
+  std::string modified = __httpDate(info.st_mtime);
+  if (HTTPCompressor::isCompressible(type, identity.length())){
+    size_t limit = identity.length() - identity.length() / 10;
+    if (__gzip(identity, asset.body[HTTPBundle::GZIP]) && asset.body[HTTPBundle::GZIP].length() > limit) asset.body[HTTPBundle::GZIP].clear();
+    if (__brotli(identity, asset.body[HTTPBundle::BROTLI]) && asset.body[HTTPBundle::BROTLI].length() > limit) asset.body[HTTPBundle::BROTLI].clear();
+  }
+  asset.body[HTTPBundle::IDENTITY] = std::move(identity);
+  bool vary = (!asset.body[HTTPBundle::GZIP].empty() || !asset.body[HTTPBundle::BROTLI].empty());
+  static const char *suffix[HTTPBundle::SZ_ENCODING] = { "", "-gz", "-br" };
+  for (int i = HTTPBundle::IDENTITY; i < HTTPBundle::SZ_ENCODING; i++){
+    HTTPBundle::encoding_t encoding = static_cast<HTTPBundle::encoding_t>(i);
+    if (encoding != HTTPBundle::IDENTITY && asset.body[i].empty()) continue;
+    /* every variant has its own strong validator */
+    std::string etag = std::string("\"") + tag + suffix[i] + "\"";
+    asset.head[i] = __head(type, etag, modified, asset.body[i].length(), encoding, vary);
+  }
+  return true;
+}
+
+static uint64_t __align(uint64_t value){
+  return (value + 7) & ~static_cast<uint64_t>(7);
+}
+
+static bool __write(const std::vector<asset_t> &assets, const std::string &output){
+  HTTPBundle::header_t header;
+  memset(&header, 0, sizeof(header));
+  header.magic = HTTP_BUNDLE_MAGIC;
+  header.version = HTTP_BUNDLE_VERSION;
+  header.count = static_cast<uint32_t>(assets.size());
+  /* load factor at most 0.5 keeps the probe sequences short */
+  header.slots = 1;
+  while (header.slots < 2 * header.count + 1) header.slots <<= 1;
+  header.index = __align(sizeof(header));
+  header.entries = __align(header.index + header.slots * sizeof(uint32_t));
+  std::vector<uint32_t> index(header.slots, 0);
+  std::vector<HTTPBundle::entry_t> entries(assets.size());
+  std::string data;
+  uint64_t base = header.entries + assets.size() * sizeof(HTTPBundle::entry_t);
+  for (size_t i = 0; i < assets.size(); i++){
+    const asset_t &asset = assets[i];
+    HTTPBundle::entry_t &entry = entries[i];
+    memset(&entry, 0, sizeof(entry));
+    entry.path = base + data.length();
+    entry.pathLength = static_cast<uint32_t>(asset.path.length());
+    entry.hash = HTTPSimd::crc32c(asset.path.data(), asset.path.length());
+    data += asset.path;
+    for (int j = HTTPBundle::IDENTITY; j < HTTPBundle::SZ_ENCODING; j++){
+      if (asset.head[j].empty()) continue;
+      HTTPBundle::variant_t &variant = entry.variant[j];
+      variant.head = base + data.length();
+      variant.headLength = static_cast<uint32_t>(asset.head[j].length());
+      data += asset.head[j];
+      variant.body = base + data.length();
+      variant.bodyLength = asset.body[j].length();
+      data += asset.body[j];
+    }
+    uint32_t slot = entry.hash & (header.slots - 1);
+    while (index[slot] != 0) slot = (slot + 1) & (header.slots - 1);
+    index[slot] = static_cast<uint32_t>(i + 1);
+  }
+  header.size = base + data.length();
+  std::string temporary = output + ".tmp";
+  std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+  if (!file.is_open()) return false;
+  static const char padding[8] = {};
+  file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  file.write(padding, header.index - sizeof(header));
+  file.write(reinterpret_cast<const char *>(index.data()), index.size() * sizeof(uint32_t));
+  file.write(padding, header.entries - header.index - index.size() * sizeof(uint32_t));
+  file.write(reinterpret_cast<const char *>(entries.data()), entries.size() * sizeof(HTTPBundle::entry_t));
+  file.write(data.data(), data.length());
+  file.close();
+  if (!file.good()){
+    remove(temporary.c_str());
+    return false;
+  }
+  /* the running servers keep the mapping of the old bundle */
+  return (rename(temporary.c_str(), output.c_str()) == 0);
+}
+
+int main(int argc, char **argv){
+  if (argc != 3){
+    fprintf(stderr, "usage: %s <asset directory> <bundle>\n", argv[0]);
+    return 2;
+  }
+  std::filesystem::path root(argv[1]);
+  std::vector<asset_t> assets;
+  std::error_code error;
+  std::filesystem::recursive_directory_iterator it(root, error);
+  if (error){
+    fprintf(stderr, "%s: %s\n", argv[1], error.message().c_str());
+    return 1;
+  }
+  for (const std::filesystem::directory_entry &file : it){
+    if (!file.is_regular_file()) continue;
+    asset_t asset;
+    if (!__load(root, file.path(), asset)){
+      fprintf(stderr, "%s: failed to read\n", file.path().c_str());
+      return 1;
+    }
+    assets.push_back(std::move(asset));
+  }
+  if (!__write(assets, argv[2])){
+    fprintf(stderr, "%s: failed to write\n", argv[2]);
+    return 1;
+  }
+  size_t variants = 0;
+  for (const asset_t &asset : assets){
+    variants += (asset.head[HTTPBundle::GZIP].empty() ? 0 : 1) + (asset.head[HTTPBundle::BROTLI].empty() ? 0 : 1);
+  }
+  printf("%zu assets, %zu compressed variants\n", assets.size(), variants);
+  return 0;
+}